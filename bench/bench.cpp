@@ -0,0 +1,737 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <taglib.h>
+#include <tfile.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
+#include <tlayout.h>
+#include <tclock.h>
+#include <trangefetchstream.h>
+#include <tpropertymap.h>
+#include <fileref.h>
+#include <audioproperties.h>
+#include <mpegfile.h>
+#include <apetag.h>
+#include <id3v2tag.h>
+#include <attachedpictureframe.h>
+#include <mp4file.h>
+#include <vorbisfile.h>
+#include <flacfile.h>
+#include <flacpicture.h>
+
+#include "corpus.h"
+
+using namespace TagLib;
+
+namespace
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  // measurement helpers
+  ////////////////////////////////////////////////////////////////////////////////
+
+  long long nanoseconds()
+  {
+    return static_cast<long long>(Utils::monotonicNanoseconds());
+  }
+
+  // Reads the number of read/write system calls issued by this process so far.
+  // Only Linux exposes them, elsewhere -1 is reported.
+
+  long long systemCalls()
+  {
+    std::ifstream io("/proc/self/io");
+    if(!io)
+      return -1;
+
+    long long total = 0;
+    std::string key;
+    long long value;
+    while(io >> key >> value) {
+      if(key == "syscr:" || key == "syscw:")
+        total += value;
+    }
+    return total;
+  }
+
+  // A FileStream wrapped in an InstrumentedStream, which counts the I/O
+  // issued by TagLib.
+
+  unsigned int copyBufferSize = 0;
+
+  class MeasuredFile
+  {
+  public:
+    MeasuredFile(const std::string &path, bool readOnly) :
+      file(path.c_str(), readOnly),
+      stream(&file)
+    {
+      file.setCopyBufferSize(copyBufferSize);
+    }
+
+    FileStream file;
+    InstrumentedStream stream;
+  };
+
+  // Serves range requests from a local file, standing in for an object store.
+  // The requests are counted by the InstrumentedStream.
+
+  class LocalFetcher : public RangeFetchStream::Fetcher
+  {
+  public:
+    explicit LocalFetcher(IOStream *stream) :
+      stream(stream) {}
+
+    ByteVector fetch(long offset, unsigned long length)
+    {
+      stream->seek(offset);
+      return stream->readBlock(length);
+    }
+
+  private:
+    IOStream *stream;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // benchmark runner
+  ////////////////////////////////////////////////////////////////////////////////
+
+  struct Result
+  {
+    std::string corpus;
+    std::string format;
+    std::string operation;
+    long fileSize;
+    int iterations;
+    long long nanoseconds;
+    IOStatistics::Counters counters;
+    long long systemCalls;
+    long long roundTrips;
+  };
+
+  // Accumulates the cost of the timed regions of one benchmark.
+
+  class Sample
+  {
+  public:
+    Sample() :
+      elapsed(0),
+      calls(0),
+      callsAvailable(true),
+      started(0),
+      startCalls(0) {}
+
+    void start()
+    {
+      startCalls = systemCalls();
+      started = nanoseconds();
+    }
+
+    void stop()
+    {
+      elapsed += nanoseconds() - started;
+
+      const long long endCalls = systemCalls();
+      if(startCalls < 0 || endCalls < 0)
+        callsAvailable = false;
+      else
+        calls += endCalls - startCalls - systemCallOverhead;
+    }
+
+    void add(const IOStatistics &s)
+    {
+      counters += s.total();
+    }
+
+    static void calibrate()
+    {
+      const long long before = systemCalls();
+      const long long after  = systemCalls();
+      systemCallOverhead = (before < 0) ? 0 : after - before;
+    }
+
+    long long elapsed;
+    long long calls;
+    bool callsAvailable;
+    IOStatistics::Counters counters;
+
+  private:
+    long long started;
+    long long startCalls;
+
+    static long long systemCallOverhead;
+  };
+
+  long long Sample::systemCallOverhead = 0;
+
+  Result makeResult(const Bench::CorpusFile &file, const std::string &operation,
+                    int iterations, const Sample &sample)
+  {
+    Result result;
+    result.corpus      = file.name;
+    result.format      = file.format;
+    result.operation   = operation;
+    result.fileSize    = FileStream(file.path.c_str(), true).length();
+    result.iterations  = iterations;
+    result.nanoseconds = sample.elapsed;
+    result.counters    = sample.counters;
+    result.systemCalls = sample.callsAvailable ? sample.calls : -1;
+    result.roundTrips  = -1;
+    return result;
+  }
+
+  Result benchOpen(const Bench::CorpusFile &file, int iterations, bool readAudioProperties)
+  {
+    Sample sample;
+
+    for(int i = 0; i < iterations; ++i) {
+      MeasuredFile measured(file.path, true);
+
+      sample.start();
+      {
+        FileRef ref(&measured.stream, readAudioProperties, AudioProperties::Average);
+        if(readAudioProperties && ref.audioProperties())
+          ref.audioProperties()->lengthInMilliseconds();
+      }
+      sample.stop();
+
+      sample.add(measured.stream.statistics());
+    }
+
+    return makeResult(file, readAudioProperties ? "read_audio_properties" : "open", iterations, sample);
+  }
+
+  // Opens a small file many times, which is dominated by the cost of the
+  // individual reads of the header fields rather than by the bytes read.
+
+  const int manyFiles = 10000;
+
+  bool isModule(const std::string &format)
+  {
+    return format == "MOD" || format == "S3M" || format == "IT" || format == "XM";
+  }
+
+  Result benchOpenMany(const Bench::CorpusFile &file)
+  {
+    Result result = benchOpen(file, manyFiles, false);
+    result.operation = "open_10k";
+    return result;
+  }
+
+  // Parses the APE tag of a file again and again, which is dominated by the
+  // per-item work for a tag with many small items.
+
+  bool hasAPETag(const Bench::CorpusFile &file)
+  {
+    return file.format == "MP3" && MPEG::File(file.path.c_str(), false).hasAPETag();
+  }
+
+  Result benchParseAPETag(const Bench::CorpusFile &file, int iterations)
+  {
+    MeasuredFile measured(file.path, true);
+    MPEG::File mpeg(&measured.stream, ID3v2::FrameFactory::instance(), false);
+    const long footerLocation = mpeg.rfind("APETAGEX");
+    measured.stream.resetStatistics();
+
+    Sample sample;
+
+    sample.start();
+    for(int i = 0; i < iterations; ++i) {
+      APE::Tag tag(&mpeg, footerLocation);
+      tag.itemListMap();
+    }
+    sample.stop();
+
+    sample.add(measured.stream.statistics());
+
+    return makeResult(file, "parse_ape_tag", iterations, sample);
+  }
+
+  Result benchRangeFetch(const Bench::CorpusFile &file, int iterations)
+  {
+    Sample sample;
+    long long roundTrips = 0;
+
+    for(int i = 0; i < iterations; ++i) {
+      MeasuredFile measured(file.path, true);
+      LocalFetcher fetcher(&measured.stream);
+      RangeFetchStream stream(&fetcher, measured.stream.length(), file.path.c_str());
+
+      sample.start();
+      {
+        FileRef ref(&stream, true, AudioProperties::Average);
+        if(ref.audioProperties())
+          ref.audioProperties()->lengthInMilliseconds();
+      }
+      sample.stop();
+
+      sample.add(measured.stream.statistics());
+      roundTrips += stream.roundTrips();
+    }
+
+    Result result = makeResult(file, "range_fetch_open", iterations, sample);
+    result.roundTrips = roundTrips;
+    return result;
+  }
+
+  Result benchProperties(const Bench::CorpusFile &file, int iterations)
+  {
+    MeasuredFile measured(file.path, true);
+    FileRef ref(&measured.stream, false);
+    measured.stream.resetStatistics();
+
+    Sample sample;
+
+    sample.start();
+    for(int i = 0; i < iterations; ++i)
+      ref.file()->properties();
+    sample.stop();
+
+    sample.add(measured.stream.statistics());
+
+    return makeResult(file, "properties", iterations, sample);
+  }
+
+  Result benchSetProperties(const Bench::CorpusFile &file, int iterations)
+  {
+    MeasuredFile measured(file.path, true);
+    FileRef ref(&measured.stream, false);
+    measured.stream.resetStatistics();
+
+    PropertyMap properties = ref.file()->properties();
+
+    Sample sample;
+
+    for(int i = 0; i < iterations; ++i) {
+      properties.replace("TITLE", String("title ") + String::number(i));
+
+      sample.start();
+      ref.file()->setProperties(properties);
+      sample.stop();
+    }
+
+    sample.add(measured.stream.statistics());
+
+    return makeResult(file, "set_properties", iterations, sample);
+  }
+
+  Result benchSave(const Bench::CorpusFile &file, const std::string &scratch, int iterations)
+  {
+    Sample sample;
+
+    for(int i = 0; i < iterations; ++i) {
+      Bench::copyFile(file.path, scratch);
+
+      MeasuredFile measured(scratch, false);
+      FileRef ref(&measured.stream, false);
+
+      PropertyMap properties = ref.file()->properties();
+      properties.replace("TITLE", String("a longer title to force the tag to grow ") + String::number(i));
+      ref.file()->setProperties(properties);
+
+      measured.stream.resetStatistics();
+
+      sample.start();
+      ref.save();
+      sample.stop();
+
+      sample.add(measured.stream.statistics());
+    }
+
+    std::remove(scratch.c_str());
+
+    return makeResult(file, "save", iterations, sample);
+  }
+
+  // Replaces the cover art of the formats whose tags hold pictures, so that
+  // saving renders a tag dominated by a single large payload.
+
+  const unsigned int coverArtSize = 4 * 1024 * 1024;
+
+  bool setCoverArt(File *file, const ByteVector &picture)
+  {
+    if(MPEG::File *mpeg = dynamic_cast<MPEG::File *>(file)) {
+      ID3v2::Tag *tag = mpeg->ID3v2Tag(true);
+      tag->removeFrames("APIC");
+      ID3v2::AttachedPictureFrame *frame = new ID3v2::AttachedPictureFrame();
+      frame->setMimeType("image/jpeg");
+      frame->setType(ID3v2::AttachedPictureFrame::FrontCover);
+      frame->setPicture(picture);
+      tag->addFrame(frame);
+      return true;
+    }
+    if(MP4::File *mp4 = dynamic_cast<MP4::File *>(file)) {
+      MP4::CoverArtList covers;
+      covers.append(MP4::CoverArt(MP4::CoverArt::JPEG, picture));
+      mp4->tag()->setItem("covr", covers);
+      return true;
+    }
+
+    FLAC::Picture *cover = new FLAC::Picture();
+    cover->setMimeType("image/jpeg");
+    cover->setType(FLAC::Picture::FrontCover);
+    cover->setData(picture);
+
+    if(Ogg::Vorbis::File *vorbis = dynamic_cast<Ogg::Vorbis::File *>(file)) {
+      vorbis->tag()->removeAllPictures();
+      vorbis->tag()->addPicture(cover);
+      return true;
+    }
+    if(FLAC::File *flac = dynamic_cast<FLAC::File *>(file)) {
+      flac->removePictures();
+      flac->addPicture(cover);
+      return true;
+    }
+
+    delete cover;
+    return false;
+  }
+
+  bool supportsCoverArt(const std::string &format)
+  {
+    return format == "MP3" || format == "MP4" || format == "OGG" || format == "FLAC";
+  }
+
+  Result benchSaveCoverArt(const Bench::CorpusFile &file, const std::string &scratch, int iterations)
+  {
+    ByteVector picture(coverArtSize, '\0');
+    for(unsigned int i = 0; i < picture.size(); ++i)
+      picture[i] = static_cast<char>(i * 31 % 251);
+
+    Sample sample;
+
+    for(int i = 0; i < iterations; ++i) {
+      Bench::copyFile(file.path, scratch);
+
+      MeasuredFile measured(scratch, false);
+      FileRef ref(&measured.stream, false);
+
+      picture[0] = static_cast<char>(i);
+      setCoverArt(ref.file(), picture);
+
+      measured.stream.resetStatistics();
+
+      sample.start();
+      ref.save();
+      sample.stop();
+
+      sample.add(measured.stream.statistics());
+    }
+
+    std::remove(scratch.c_str());
+
+    return makeResult(file, "save_cover_art", iterations, sample);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // header decoding
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Decodes a WavPack block header, once with the ByteVector accessors which
+  // check the bounds of every field, and once with a Layout::View which checks
+  // the length once.
+
+  struct BlockHeader
+  {
+    static const unsigned int size = 32;
+    typedef Layout::U32L<4>  BlockSize;
+    typedef Layout::S16L<8>  Version;
+    typedef Layout::U32L<12> TotalSamples;
+    typedef Layout::U32L<16> BlockIndex;
+    typedef Layout::U32L<20> BlockSamples;
+    typedef Layout::U32L<24> Flags;
+  };
+
+  const int headersPerIteration = 100000;
+
+  Result makeDecodeResult(const std::string &operation, int iterations, const Sample &sample)
+  {
+    Result result;
+    result.corpus      = "micro-header";
+    result.format      = "WavPack";
+    result.operation   = operation;
+    result.fileSize    = BlockHeader::size;
+    result.iterations  = iterations * headersPerIteration;
+    result.nanoseconds = sample.elapsed;
+    result.systemCalls = -1;
+    result.roundTrips  = -1;
+    return result;
+  }
+
+  Result benchDecodeHeader(int iterations, bool layout)
+  {
+    ByteVector data("wvpk", 4);
+    for(unsigned int i = 4; i < BlockHeader::size; ++i)
+      data.append(static_cast<char>(i * 7));
+
+    volatile unsigned long long sink = 0;
+    Sample sample;
+
+    sample.start();
+    for(int i = 0; i < iterations * headersPerIteration; ++i) {
+      data[31] = static_cast<char>(i);
+      unsigned long long sum = 0;
+      if(layout) {
+        typedef BlockHeader H;
+        const Layout::View<H> header(data);
+        if(header.isValid()) {
+          sum += header.get<H::BlockSize>();
+          sum += header.get<H::Version>();
+          sum += header.get<H::TotalSamples>();
+          sum += header.get<H::BlockIndex>();
+          sum += header.get<H::BlockSamples>();
+          sum += header.get<H::Flags>();
+        }
+      }
+      else if(data.size() >= BlockHeader::size) {
+        sum += data.toUInt(4, false);
+        sum += data.toShort(8, false);
+        sum += data.toUInt(12, false);
+        sum += data.toUInt(16, false);
+        sum += data.toUInt(20, false);
+        sum += data.toUInt(24, false);
+      }
+      sink += sum;
+    }
+    sample.stop();
+
+    return makeDecodeResult(layout ? "decode_layout" : "decode_bytevector", iterations, sample);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // device models
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Models the time the counted I/O takes with a cold cache, where each call
+  // pays the access latency of the device and the bytes are transferred at
+  // its sequential throughput.  Moving bytes means reading and writing them.
+
+  struct Device
+  {
+    const char *name;
+    double latencyInMilliseconds;
+    double bytesPerMillisecond;
+  };
+
+  const Device devices[] = {
+    { "hdd",  8.0,  150.0 * 1000 },
+    { "nvme", 0.08, 2000.0 * 1000 }
+  };
+
+  double modeledMilliseconds(const Device &device, const IOStatistics::Counters &c)
+  {
+    const double calls = static_cast<double>(c.readCalls + c.writeCalls);
+    const double bytes = static_cast<double>(c.bytesRead + c.bytesWritten + 2 * c.bytesShifted);
+    return calls * device.latencyInMilliseconds + bytes / device.bytesPerMillisecond;
+  }
+
+  std::string millisecondsPerOp(double value, int iterations)
+  {
+    std::ostringstream s;
+    s.setf(std::ios::fixed);
+    s.precision(3);
+    s << value / iterations;
+    return s.str();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // output
+  ////////////////////////////////////////////////////////////////////////////////
+
+  std::string perOp(long long value, int iterations)
+  {
+    std::ostringstream s;
+    s.setf(std::ios::fixed);
+    s.precision(1);
+    s << static_cast<double>(value) / iterations;
+    return s.str();
+  }
+
+  void writeJSON(std::ostream &out, const std::vector<Result> &results)
+  {
+    out << "{\n";
+    out << "  \"taglib_version\": \"" << TAGLIB_MAJOR_VERSION << "."
+        << TAGLIB_MINOR_VERSION << "." << TAGLIB_PATCH_VERSION << "\",\n";
+    out << "  \"results\": [";
+
+    for(size_t i = 0; i < results.size(); ++i) {
+      const Result &r = results[i];
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    {"
+          << "\"name\": \"" << r.corpus << "/" << r.operation << "\", "
+          << "\"corpus\": \"" << r.corpus << "\", "
+          << "\"format\": \"" << r.format << "\", "
+          << "\"operation\": \"" << r.operation << "\", "
+          << "\"file_size\": " << r.fileSize << ", "
+          << "\"iterations\": " << r.iterations << ", "
+          << "\"ns_per_op\": " << perOp(r.nanoseconds, r.iterations) << ", "
+          << "\"bytes_read_per_op\": " << perOp(r.counters.bytesRead, r.iterations) << ", "
+          << "\"reads_per_op\": " << perOp(r.counters.readCalls, r.iterations) << ", "
+          << "\"seeks_per_op\": " << perOp(r.counters.seekCalls, r.iterations) << ", "
+          << "\"writes_per_op\": " << perOp(r.counters.writeCalls, r.iterations) << ", "
+          << "\"bytes_written_per_op\": " << perOp(r.counters.bytesWritten, r.iterations) << ", "
+          << "\"bytes_shifted_per_op\": " << perOp(r.counters.bytesShifted, r.iterations) << ", "
+          << "\"syscalls_per_op\": "
+          << (r.systemCalls < 0 ? std::string("null") : perOp(r.systemCalls, r.iterations)) << ", "
+          << "\"round_trips_per_op\": "
+          << (r.roundTrips < 0 ? std::string("null") : perOp(r.roundTrips, r.iterations));
+
+      for(size_t j = 0; j < sizeof(devices) / sizeof(devices[0]); ++j) {
+        out << ", \"" << devices[j].name << "_ms_per_op\": "
+            << millisecondsPerOp(modeledMilliseconds(devices[j], r.counters), r.iterations);
+      }
+
+      out << "}";
+    }
+
+    out << "\n  ]\n}\n";
+  }
+
+  void usage()
+  {
+    std::cerr << "Usage: taglib-bench [OPTIONS]\n"
+              << "\n"
+              << "  --corpus-dir DIR   where to generate the synthetic corpus (default: .)\n"
+              << "  --regenerate       regenerate the corpus even if it already exists\n"
+              << "  --iterations N     iterations per benchmark (default: 10)\n"
+              << "  --filter TEXT      only run benchmarks whose name contains TEXT\n"
+              << "  --output FILE      write the JSON report to FILE instead of stdout\n"
+              << "  --scan-buffer-size N\n"
+              << "                     initial size of the blocks read by scans (default: 1024)\n"
+              << "  --copy-buffer-size N\n"
+              << "                     size of the blocks moved by insert and remove (default: 65536)\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  std::string corpusDir = ".";
+  std::string filter;
+  std::string output;
+  int iterations = 10;
+  bool regenerate = false;
+
+  for(int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if(arg == "--regenerate")
+      regenerate = true;
+    else if(arg == "--corpus-dir" && i + 1 < argc)
+      corpusDir = argv[++i];
+    else if(arg == "--iterations" && i + 1 < argc)
+      iterations = std::atoi(argv[++i]);
+    else if(arg == "--filter" && i + 1 < argc)
+      filter = argv[++i];
+    else if(arg == "--output" && i + 1 < argc)
+      output = argv[++i];
+    else if(arg == "--scan-buffer-size" && i + 1 < argc)
+      File::setDefaultScanBufferSize(static_cast<unsigned int>(std::atoi(argv[++i])));
+    else if(arg == "--copy-buffer-size" && i + 1 < argc)
+      copyBufferSize = static_cast<unsigned int>(std::atoi(argv[++i]));
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if(iterations <= 0) {
+    usage();
+    return 1;
+  }
+
+  Sample::calibrate();
+
+  const std::vector<Bench::CorpusFile> corpus = Bench::generateCorpus(corpusDir, regenerate);
+  const std::string operations[] = {
+    "open", "open_10k", "parse_ape_tag", "read_audio_properties", "range_fetch_open",
+    "properties", "set_properties", "save", "save_cover_art"
+  };
+
+  std::vector<Result> results;
+
+  for(size_t i = 0; i < corpus.size(); ++i) {
+    const Bench::CorpusFile &file = corpus[i];
+    const std::string scratch = corpusDir + "/scratch-" + file.path.substr(file.path.rfind('/') + 1);
+
+    for(size_t j = 0; j < sizeof(operations) / sizeof(operations[0]); ++j) {
+      const std::string &operation = operations[j];
+      if(!filter.empty() && (file.name + "/" + operation).find(filter) == std::string::npos)
+        continue;
+      if(operation == "save_cover_art" && !supportsCoverArt(file.format))
+        continue;
+      if(operation == "open_10k" && !isModule(file.format))
+        continue;
+      if(operation == "parse_ape_tag" && !hasAPETag(file))
+        continue;
+
+      std::cerr << file.name << "/" << operation << std::endl;
+
+      if(operation == "open")
+        results.push_back(benchOpen(file, iterations, false));
+      else if(operation == "open_10k")
+        results.push_back(benchOpenMany(file));
+      else if(operation == "parse_ape_tag")
+        results.push_back(benchParseAPETag(file, iterations));
+      else if(operation == "read_audio_properties")
+        results.push_back(benchOpen(file, iterations, true));
+      else if(operation == "range_fetch_open")
+        results.push_back(benchRangeFetch(file, iterations));
+      else if(operation == "properties")
+        results.push_back(benchProperties(file, iterations));
+      else if(operation == "set_properties")
+        results.push_back(benchSetProperties(file, iterations));
+      else if(operation == "save")
+        results.push_back(benchSave(file, scratch, iterations));
+      else if(operation == "save_cover_art")
+        results.push_back(benchSaveCoverArt(file, scratch, iterations));
+    }
+  }
+
+  for(int layout = 0; layout < 2; ++layout) {
+    const std::string name = layout ? "micro-header/decode_layout" : "micro-header/decode_bytevector";
+    if(!filter.empty() && name.find(filter) == std::string::npos)
+      continue;
+
+    std::cerr << name << std::endl;
+    results.push_back(benchDecodeHeader(iterations, layout != 0));
+  }
+
+  if(output.empty()) {
+    writeJSON(std::cout, results);
+  }
+  else {
+    std::ofstream out(output.c_str());
+    writeJSON(out, results);
+  }
+
+  return 0;
+}
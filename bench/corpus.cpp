@@ -0,0 +1,738 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <cstring>
+#include <fstream>
+
+#include <tbytevector.h>
+#include <tstring.h>
+#include <mpegfile.h>
+#include <id3v2tag.h>
+#include <attachedpictureframe.h>
+#include <commentsframe.h>
+#include <textidentificationframe.h>
+#include <apetag.h>
+#include <flacfile.h>
+#include <flacpicture.h>
+#include <xiphcomment.h>
+#include <wavfile.h>
+#include <infotag.h>
+
+#include "corpus.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // A small linear congruential generator, so that the generated payloads are
+  // identical on every platform.
+
+  class Random
+  {
+  public:
+    explicit Random(unsigned int seed) : state(seed) {}
+
+    unsigned int next()
+    {
+      state = state * 1664525U + 1013904223U;
+      return state >> 8;
+    }
+
+    ByteVector bytes(unsigned int length)
+    {
+      ByteVector data(length, '\0');
+      for(unsigned int i = 0; i < length; ++i)
+        data[i] = static_cast<char>(next() & 0xFF);
+      return data;
+    }
+
+  private:
+    unsigned int state;
+  };
+
+  bool fileExists(const std::string &path)
+  {
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    return stream.good();
+  }
+
+  bool writeFile(const std::string &path, const ByteVector &data)
+  {
+    std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+    if(!stream)
+      return false;
+
+    stream.write(data.data(), data.size());
+    return stream.good();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // MPEG
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Renders an MPEG-1 Layer III frame at 44.1 kHz with an empty payload.  Only
+  // the bitrate index varies, which is enough for the VBR cases.
+
+  ByteVector mpegFrame(int bitrateIndex)
+  {
+    static const int bitrates[] = {
+      0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320
+    };
+
+    const unsigned int frameLength = 144000 * bitrates[bitrateIndex] / 44100;
+
+    ByteVector frame(frameLength, '\0');
+    frame[0] = '\xFF';
+    frame[1] = '\xFB';
+    frame[2] = static_cast<char>(bitrateIndex << 4);
+    frame[3] = '\x44';
+    return frame;
+  }
+
+  ByteVector mpegStream(unsigned int frameCount, bool vbr)
+  {
+    Random random(0x4D504547);
+
+    ByteVector data;
+    for(unsigned int i = 0; i < frameCount; ++i)
+      data.append(mpegFrame(vbr ? 9 + random.next() % 6 : 9));
+    return data;
+  }
+
+  void generateHugeID3v2(const std::string &path)
+  {
+    writeFile(path, mpegStream(1000, false));
+
+    MPEG::File file(path.c_str());
+    ID3v2::Tag *tag = file.ID3v2Tag(true);
+
+    tag->setTitle("Huge ID3v2 tag");
+    tag->setArtist("TagLib benchmark");
+    tag->setAlbum("Synthetic corpus");
+
+    for(int i = 0; i < 500; ++i) {
+      ID3v2::UserTextIdentificationFrame *frame = new ID3v2::UserTextIdentificationFrame();
+      frame->setDescription("FIELD " + String::number(i));
+      frame->setText(String("value ") + String::number(i * 7));
+      tag->addFrame(frame);
+    }
+
+    for(int i = 0; i < 4; ++i) {
+      ID3v2::CommentsFrame *frame = new ID3v2::CommentsFrame();
+      frame->setDescription("comment " + String::number(i));
+      frame->setText(String(std::string(2000, 'c')));
+      tag->addFrame(frame);
+    }
+
+    Random random(0x41504943);
+    ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+    picture->setMimeType("image/jpeg");
+    picture->setType(ID3v2::AttachedPictureFrame::FrontCover);
+    picture->setPicture(random.bytes(4 * 1024 * 1024));
+    tag->addFrame(picture);
+
+    file.save(MPEG::File::ID3v2);
+  }
+
+  void generateVBRWithoutXing(const std::string &path)
+  {
+    writeFile(path, mpegStream(10000, true));
+
+    MPEG::File file(path.c_str());
+    file.ID3v2Tag(true)->setTitle("VBR without Xing header");
+    file.save(MPEG::File::ID3v2);
+  }
+
+  void generateLeadingJunk(const std::string &path)
+  {
+    // Junk in front of the ID3v2 tag, as left by broken taggers, which is
+    // scanned through for the tag and the first frame.
+
+    ID3v2::Tag tag;
+    tag.setTitle("Leading junk");
+    writeFile(path, ByteVector(1024 * 1024, '\0') + tag.render() + mpegStream(1000, false));
+  }
+
+  void generateAPE200Items(const std::string &path)
+  {
+    writeFile(path, mpegStream(1000, false));
+
+    MPEG::File file(path.c_str());
+    APE::Tag *tag = file.APETag(true);
+
+    tag->setTitle("APE tag with 200 items");
+    for(int i = 0; i < 198; ++i)
+      tag->addValue("Field " + String::number(i), "value " + String::number(i * 3));
+
+    Random random(0x41504520);
+    tag->setData("Cover Art (Front)", random.bytes(512 * 1024));
+
+    file.save(MPEG::File::APE);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // Ogg Vorbis
+  ////////////////////////////////////////////////////////////////////////////////
+
+  unsigned int oggCRC(const ByteVector &data)
+  {
+    static unsigned int table[256];
+    static bool initialized = false;
+
+    if(!initialized) {
+      for(unsigned int i = 0; i < 256; ++i) {
+        unsigned int r = i << 24;
+        for(int j = 0; j < 8; ++j)
+          r = (r & 0x80000000) ? (r << 1) ^ 0x04C11DB7 : (r << 1);
+        table[i] = r;
+      }
+      initialized = true;
+    }
+
+    unsigned int crc = 0;
+    for(ByteVector::ConstIterator it = data.begin(); it != data.end(); ++it)
+      crc = (crc << 8) ^ table[((crc >> 24) & 0xFF) ^ static_cast<unsigned char>(*it)];
+    return crc;
+  }
+
+  // Renders an Ogg page holding exactly one packet shorter than 255 * 255 bytes.
+
+  ByteVector oggPage(unsigned int sequence, long long granule, char flags, const ByteVector &packet)
+  {
+    ByteVector lacing;
+    unsigned int remaining = packet.size();
+    while(remaining >= 255) {
+      lacing.append('\xFF');
+      remaining -= 255;
+    }
+    lacing.append(static_cast<char>(remaining));
+
+    ByteVector page("OggS");
+    page.append('\0');
+    page.append(flags);
+    page.append(ByteVector::fromLongLong(granule, false));
+    page.append(ByteVector::fromUInt(0x54414742, false));
+    page.append(ByteVector::fromUInt(sequence, false));
+    page.append(ByteVector::fromUInt(0, false));
+    page.append(static_cast<char>(lacing.size()));
+    page.append(lacing);
+    page.append(packet);
+
+    const ByteVector crc = ByteVector::fromUInt(oggCRC(page), false);
+    ::memcpy(page.data() + 22, crc.data(), 4);
+
+    return page;
+  }
+
+  void generateOggManyPages(const std::string &path)
+  {
+    ByteVector identification("\x01vorbis");
+    identification.append(ByteVector::fromUInt(0, false));
+    identification.append('\x02');
+    identification.append(ByteVector::fromUInt(44100, false));
+    identification.append(ByteVector::fromUInt(0, false));
+    identification.append(ByteVector::fromUInt(128000, false));
+    identification.append(ByteVector::fromUInt(0, false));
+    identification.append('\xB8');
+    identification.append('\x01');
+
+    Ogg::XiphComment comment;
+    comment.setTitle("Ogg Vorbis with 100k pages");
+    comment.setArtist("TagLib benchmark");
+    comment.addField("DESCRIPTION", String(std::string(4000, 'd')));
+
+    ByteVector commentPacket("\x03vorbis");
+    commentPacket.append(comment.render(true));
+
+    Random random(0x4F676753);
+
+    ByteVector setup("\x05vorbis");
+    setup.append(random.bytes(3000));
+
+    ByteVector data;
+    unsigned int sequence = 0;
+    data.append(oggPage(sequence++, 0, '\x02', identification));
+    data.append(oggPage(sequence++, 0, '\0', commentPacket));
+    data.append(oggPage(sequence++, 0, '\0', setup));
+
+    const unsigned int audioPages = 100000;
+    for(unsigned int i = 1; i <= audioPages; ++i) {
+      const char flags = (i == audioPages) ? '\x04' : '\0';
+      data.append(oggPage(sequence++, i * 1024LL, flags, random.bytes(32)));
+    }
+
+    writeFile(path, data);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // MP4
+  ////////////////////////////////////////////////////////////////////////////////
+
+  ByteVector atom(const char *name, const ByteVector &payload)
+  {
+    return ByteVector::fromUInt(payload.size() + 8) + ByteVector(name, 4) + payload;
+  }
+
+  ByteVector dataAtom(unsigned int type, const ByteVector &value)
+  {
+    return atom("data", ByteVector::fromUInt(type) + ByteVector::fromUInt(0) + value);
+  }
+
+  void generateM4AHugeStco(const std::string &path)
+  {
+    const unsigned int chunkCount = 1000000;
+    const unsigned int chunkSize  = 4;
+
+    const ByteVector ftyp = atom("ftyp", ByteVector("M4A ") + ByteVector::fromUInt(0) + ByteVector("M4A mp42isom"));
+
+    ByteVector mdhd = ByteVector::fromUInt(0);
+    mdhd.append(ByteVector::fromUInt(0));
+    mdhd.append(ByteVector::fromUInt(0));
+    mdhd.append(ByteVector::fromUInt(44100));
+    mdhd.append(ByteVector::fromUInt(44100 * 240));
+    mdhd.append(ByteVector::fromUInt(0));
+
+    ByteVector hdlr = ByteVector::fromUInt(0);
+    hdlr.append(ByteVector::fromUInt(0));
+    hdlr.append(ByteVector("soun"));
+    hdlr.append(ByteVector(12, '\0'));
+    hdlr.append('\0');
+
+    ByteVector esds = ByteVector::fromUInt(0);
+    esds.append(ByteVector("\x03\x80\x80\x80\x22\x00\x01\x00", 8));
+    esds.append(ByteVector("\x04\x80\x80\x80\x14\x40\x15\x00\x00\x00", 10));
+    esds.append(ByteVector::fromUInt(128000));
+    esds.append(ByteVector::fromUInt(128000));
+    esds.append(ByteVector("\x06\x80\x80\x80\x01\x02", 6));
+
+    ByteVector mp4a(6, '\0');
+    mp4a.append(ByteVector::fromShort(1));
+    mp4a.append(ByteVector(8, '\0'));
+    mp4a.append(ByteVector::fromShort(2));
+    mp4a.append(ByteVector::fromShort(16));
+    mp4a.append(ByteVector(4, '\0'));
+    mp4a.append(ByteVector::fromUInt(44100U << 16));
+    mp4a.append(atom("esds", esds));
+
+    const ByteVector stsd = atom("stsd", ByteVector::fromUInt(0) + ByteVector::fromUInt(1) + atom("mp4a", mp4a));
+
+    ByteVector metaHdlr = ByteVector::fromUInt(0);
+    metaHdlr.append(ByteVector::fromUInt(0));
+    metaHdlr.append(ByteVector("mdirappl"));
+    metaHdlr.append(ByteVector(10, '\0'));
+
+    Random random(0x4D503441);
+
+    ByteVector ilst;
+    ilst.append(atom("\xA9nam", dataAtom(1, "M4A with a huge stco table")));
+    ilst.append(atom("\xA9" "ART", dataAtom(1, "TagLib benchmark")));
+    ilst.append(atom("covr", dataAtom(13, random.bytes(512 * 1024))));
+
+    const ByteVector udta = atom("udta",
+      atom("meta", ByteVector::fromUInt(0) + atom("hdlr", metaHdlr) + atom("ilst", ilst)));
+
+    // The chunk offsets depend on the size of moov, which does not depend on
+    // the offsets themselves.  So render it once with dummy offsets.
+
+    ByteVector stco = ByteVector::fromUInt(0);
+    stco.append(ByteVector::fromUInt(chunkCount));
+    stco.append(ByteVector(chunkCount * 4, '\0'));
+
+    ByteVector moov = atom("moov", atom("trak", atom("mdia",
+      atom("mdhd", mdhd) +
+      atom("hdlr", hdlr) +
+      atom("minf", atom("stbl", stsd + atom("stco", stco))))) + udta);
+
+    const unsigned int mdatDataOffset = ftyp.size() + moov.size() + 8;
+    const int stcoEntries = moov.find("stco") + 12;
+    for(unsigned int i = 0; i < chunkCount; ++i) {
+      const ByteVector offset = ByteVector::fromUInt(mdatDataOffset + i * chunkSize);
+      ::memcpy(moov.data() + stcoEntries + i * 4, offset.data(), 4);
+    }
+
+    writeFile(path, ftyp + moov + atom("mdat", ByteVector(chunkCount * chunkSize, '\0')));
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // FLAC
+  ////////////////////////////////////////////////////////////////////////////////
+
+  void generateFLACLargePictures(const std::string &path)
+  {
+    const unsigned long long totalSamples = 44100ULL * 240;
+
+    ByteVector streamInfo = ByteVector::fromShort(4096);
+    streamInfo.append(ByteVector::fromShort(4096));
+    streamInfo.append(ByteVector(6, '\0'));
+    streamInfo.append(ByteVector::fromLongLong(
+      (44100ULL << 44) | (1ULL << 41) | (15ULL << 36) | totalSamples));
+    streamInfo.append(ByteVector(16, '\0'));
+
+    ByteVector frames(1024 * 1024, '\0');
+    frames[0] = '\xFF';
+    frames[1] = '\xF8';
+
+    ByteVector data("fLaC");
+    data.append(ByteVector::fromUInt(0x80000000 | streamInfo.size()));
+    data.append(streamInfo);
+    data.append(frames);
+    writeFile(path, data);
+
+    FLAC::File file(path.c_str());
+    Ogg::XiphComment *comment = file.xiphComment(true);
+    comment->setTitle("FLAC with large pictures");
+    comment->setArtist("TagLib benchmark");
+
+    Random random(0x664C6143);
+
+    const FLAC::Picture::Type types[] = {
+      FLAC::Picture::FrontCover, FLAC::Picture::BackCover, FLAC::Picture::Artist
+    };
+    for(int i = 0; i < 3; ++i) {
+      FLAC::Picture *picture = new FLAC::Picture();
+      picture->setType(types[i]);
+      picture->setMimeType("image/jpeg");
+      picture->setDescription("picture " + String::number(i));
+      picture->setData(random.bytes(2 * 1024 * 1024));
+      file.addPicture(picture);
+    }
+
+    file.save();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // WAV
+  ////////////////////////////////////////////////////////////////////////////////
+
+  ByteVector riffChunk(const ByteVector &name, const ByteVector &payload)
+  {
+    ByteVector chunk = name + ByteVector::fromUInt(payload.size(), false) + payload;
+    if(payload.size() & 1)
+      chunk.append('\0');
+    return chunk;
+  }
+
+  void generateWAVManyChunks(const std::string &path)
+  {
+    ByteVector format = ByteVector::fromShort(1, false);
+    format.append(ByteVector::fromShort(2, false));
+    format.append(ByteVector::fromUInt(44100, false));
+    format.append(ByteVector::fromUInt(44100 * 4, false));
+    format.append(ByteVector::fromShort(4, false));
+    format.append(ByteVector::fromShort(16, false));
+
+    Random random(0x57415645);
+
+    ByteVector data("WAVE");
+    data.append(riffChunk("fmt ", format));
+    for(int i = 0; i < 2000; ++i) {
+      ByteVector name("x");
+      name.append(static_cast<char>('a' + (i / 676) % 26));
+      name.append(static_cast<char>('a' + (i / 26) % 26));
+      name.append(static_cast<char>('a' + i % 26));
+      data.append(riffChunk(name, random.bytes(64)));
+    }
+    data.append(riffChunk("data", ByteVector(1024 * 1024, '\0')));
+
+    writeFile(path, ByteVector("RIFF") + ByteVector::fromUInt(data.size(), false) + data);
+
+    RIFF::WAV::File file(path.c_str());
+    file.InfoTag()->setTitle("WAV with many chunks");
+    file.ID3v2Tag()->setTitle("WAV with many chunks");
+    file.save();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // tracker modules
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // The module formats keep their tags in the names of the samples and
+  // instruments, so the files have as many of them as the formats allow.  The
+  // pattern and sample data are silent.
+
+  ByteVector paddedName(const String &name, unsigned int length)
+  {
+    ByteVector data = name.data(String::Latin1);
+    data.resize(length, '\0');
+    return data;
+  }
+
+  void generateMOD31Samples(const std::string &path)
+  {
+    ByteVector data = paddedName("MOD with 31 samples", 20);
+    for(int i = 0; i < 31; ++i) {
+      data.append(paddedName(String("sample ") + String::number(i + 1), 22));
+      data.append(ByteVector::fromShort(16, true));
+      data.append('\0');
+      data.append('\x40');
+      data.append(ByteVector::fromShort(0, true));
+      data.append(ByteVector::fromShort(1, true));
+    }
+    data.append('\x01');
+    data.append('\x7F');
+    data.append(ByteVector(128, '\0'));
+    data.append("M.K.");
+    data.append(ByteVector(4 * 4 * 64, '\0'));
+    data.append(ByteVector(31 * 16 * 2, '\0'));
+
+    writeFile(path, data);
+  }
+
+  void generateS3M99Samples(const std::string &path)
+  {
+    const unsigned int sampleCount = 99;
+    const unsigned int orderCount  = 2;
+
+    const unsigned int tableOffset   = 96 + orderCount;
+    const unsigned int sampleOffset  = (tableOffset + 2 * (sampleCount + 1) + 15) & ~15U;
+    const unsigned int patternOffset = sampleOffset + 80 * sampleCount;
+
+    ByteVector data = paddedName("S3M with 99 samples", 28);
+    data.append('\x1A');
+    data.append('\x10');
+    data.append(ByteVector(2, '\0'));
+    data.append(ByteVector::fromShort(orderCount, false));
+    data.append(ByteVector::fromShort(sampleCount, false));
+    data.append(ByteVector::fromShort(1, false));
+    data.append(ByteVector::fromShort(0, false));
+    data.append(ByteVector::fromShort(0x1320, false));
+    data.append(ByteVector::fromShort(2, false));
+    data.append("SCRM");
+    data.append('\x40');
+    data.append('\x06');
+    data.append('\x7D');
+    data.append('\xB0');
+    data.append(ByteVector(12, '\0'));
+    for(int i = 0; i < 32; ++i)
+      data.append(static_cast<char>(i < 16 ? i : 0xFF));
+
+    data.append('\0');
+    data.append('\xFF');
+    for(unsigned int i = 0; i < sampleCount; ++i)
+      data.append(ByteVector::fromShort((sampleOffset + 80 * i) >> 4, false));
+    data.append(ByteVector::fromShort(patternOffset >> 4, false));
+    data.resize(sampleOffset, '\0');
+
+    for(unsigned int i = 0; i < sampleCount; ++i) {
+      data.append('\x01');
+      data.append(paddedName(String("SMP") + String::number(i + 1), 12));
+      data.append(ByteVector(3, '\0'));
+      data.append(ByteVector(12, '\0'));
+      data.append('\x40');
+      data.append(ByteVector(3, '\0'));
+      data.append(ByteVector::fromUInt(8363, false));
+      data.append(ByteVector(12, '\0'));
+      data.append(paddedName(String("sample ") + String::number(i + 1), 28));
+      data.append("SCRS");
+    }
+
+    data.append(ByteVector::fromShort(2 + 64, false));
+    data.append(ByteVector(64, '\0'));
+
+    writeFile(path, data);
+  }
+
+  void generateIT99Instruments(const std::string &path)
+  {
+    const unsigned int instrumentCount = 99;
+    const unsigned int sampleCount     = 99;
+    const unsigned int orderCount      = 2;
+
+    const ByteVector message("IT with 99 instruments\rand a message");
+
+    const unsigned int instrumentOffset = 192 + orderCount + 4 * (instrumentCount + sampleCount);
+    const unsigned int sampleOffset     = instrumentOffset + 554 * instrumentCount;
+    const unsigned int messageOffset    = sampleOffset + 80 * sampleCount;
+
+    ByteVector data("IMPM");
+    data.append(paddedName("IT with 99 instruments", 26));
+    data.append(ByteVector(2, '\0'));
+    data.append(ByteVector::fromShort(orderCount, false));
+    data.append(ByteVector::fromShort(instrumentCount, false));
+    data.append(ByteVector::fromShort(sampleCount, false));
+    data.append(ByteVector::fromShort(0, false));
+    data.append(ByteVector::fromShort(0x0214, false));
+    data.append(ByteVector::fromShort(0x0200, false));
+    data.append(ByteVector::fromShort(0x000D, false));
+    data.append(ByteVector::fromShort(0x0001, false));
+    data.append('\x80');
+    data.append('\x30');
+    data.append('\x06');
+    data.append('\x7D');
+    data.append('\x80');
+    data.append('\0');
+    data.append(ByteVector::fromShort(message.size(), false));
+    data.append(ByteVector::fromUInt(messageOffset, false));
+    data.append(ByteVector(4, '\0'));
+    for(int i = 0; i < 64; ++i)
+      data.append(static_cast<char>(i < 16 ? 32 : 0xA0));
+    data.append(ByteVector(64, '\x40'));
+
+    data.append('\xFF');
+    data.append('\xFF');
+    for(unsigned int i = 0; i < instrumentCount; ++i)
+      data.append(ByteVector::fromUInt(instrumentOffset + 554 * i, false));
+    for(unsigned int i = 0; i < sampleCount; ++i)
+      data.append(ByteVector::fromUInt(sampleOffset + 80 * i, false));
+
+    for(unsigned int i = 0; i < instrumentCount; ++i) {
+      ByteVector instrument("IMPI");
+      instrument.append(paddedName(String("INS") + String::number(i + 1), 12));
+      instrument.append(ByteVector(16, '\0'));
+      instrument.append(paddedName(String("instrument ") + String::number(i + 1), 26));
+      instrument.resize(554, '\0');
+      data.append(instrument);
+    }
+
+    for(unsigned int i = 0; i < sampleCount; ++i) {
+      data.append("IMPS");
+      data.append(paddedName(String("SMP") + String::number(i + 1), 12));
+      data.append('\0');
+      data.append('\x40');
+      data.append('\0');
+      data.append('\x40');
+      data.append(paddedName(String("sample ") + String::number(i + 1), 26));
+      data.append('\x01');
+      data.append('\x20');
+      data.append(ByteVector(12, '\0'));
+      data.append(ByteVector::fromUInt(8363, false));
+      data.append(ByteVector(16, '\0'));
+    }
+
+    data.append(message);
+    data.append('\0');
+
+    writeFile(path, data);
+  }
+
+  void generateXM128Instruments(const std::string &path)
+  {
+    const unsigned int instrumentCount = 128;
+    const unsigned int channels        = 8;
+    const unsigned int rows            = 64;
+    const unsigned int sampleLength    = 32;
+
+    ByteVector data("Extended Module: ");
+    data.append(paddedName("XM 128 instruments", 20));
+    data.append('\x1A');
+    data.append(paddedName("FastTracker v2.00", 20));
+    data.append(ByteVector::fromShort(0x0104, false));
+    data.append(ByteVector::fromUInt(276, false));
+    data.append(ByteVector::fromShort(1, false));
+    data.append(ByteVector::fromShort(0, false));
+    data.append(ByteVector::fromShort(channels, false));
+    data.append(ByteVector::fromShort(1, false));
+    data.append(ByteVector::fromShort(instrumentCount, false));
+    data.append(ByteVector::fromShort(1, false));
+    data.append(ByteVector::fromShort(6, false));
+    data.append(ByteVector::fromShort(125, false));
+    data.append(ByteVector(256, '\0'));
+
+    data.append(ByteVector::fromUInt(9, false));
+    data.append('\0');
+    data.append(ByteVector::fromShort(rows, false));
+    data.append(ByteVector::fromShort(channels * rows, false));
+    data.append(ByteVector(channels * rows, '\x80'));
+
+    for(unsigned int i = 0; i < instrumentCount; ++i) {
+      ByteVector instrument = ByteVector::fromUInt(263, false);
+      instrument.append(paddedName(String("instrument ") + String::number(i + 1), 22));
+      instrument.append('\0');
+      instrument.append(ByteVector::fromShort(1, false));
+      instrument.append(ByteVector::fromUInt(40, false));
+      instrument.resize(263, '\0');
+      data.append(instrument);
+
+      data.append(ByteVector::fromUInt(sampleLength, false));
+      data.append(ByteVector(8, '\0'));
+      data.append('\x40');
+      data.append('\0');
+      data.append('\0');
+      data.append('\x80');
+      data.append('\0');
+      data.append('\0');
+      data.append(paddedName(String("sample ") + String::number(i + 1), 22));
+      data.append(ByteVector(sampleLength, '\0'));
+    }
+
+    writeFile(path, data);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // corpus table
+  ////////////////////////////////////////////////////////////////////////////////
+
+  struct Generator
+  {
+    const char *name;
+    const char *format;
+    const char *extension;
+    void (*generate)(const std::string &path);
+  };
+
+  const Generator generators[] = {
+    { "mp3-huge-id3v2",      "MP3",  "mp3",  generateHugeID3v2 },
+    { "mp3-vbr-no-xing",     "MP3",  "mp3",  generateVBRWithoutXing },
+    { "mp3-ape-200-items",   "MP3",  "mp3",  generateAPE200Items },
+    { "mp3-leading-junk",    "MP3",  "mp3",  generateLeadingJunk },
+    { "ogg-100k-pages",      "OGG",  "ogg",  generateOggManyPages },
+    { "m4a-1m-stco",         "MP4",  "m4a",  generateM4AHugeStco },
+    { "flac-large-pictures", "FLAC", "flac", generateFLACLargePictures },
+    { "wav-many-chunks",     "WAV",  "wav",  generateWAVManyChunks },
+    { "mod-31-samples",      "MOD",  "mod",  generateMOD31Samples },
+    { "s3m-99-samples",      "S3M",  "s3m",  generateS3M99Samples },
+    { "it-99-instruments",   "IT",   "it",   generateIT99Instruments },
+    { "xm-128-instruments",  "XM",   "xm",   generateXM128Instruments },
+  };
+}
+
+std::vector<Bench::CorpusFile> Bench::generateCorpus(const std::string &directory, bool regenerate)
+{
+  std::vector<CorpusFile> files;
+
+  for(size_t i = 0; i < sizeof(generators) / sizeof(generators[0]); ++i) {
+    CorpusFile file;
+    file.name   = generators[i].name;
+    file.format = generators[i].format;
+    file.path   = directory + "/" + generators[i].name + "." + generators[i].extension;
+
+    if(regenerate || !fileExists(file.path))
+      generators[i].generate(file.path);
+
+    files.push_back(file);
+  }
+
+  return files;
+}
+
+bool Bench::copyFile(const std::string &source, const std::string &destination)
+{
+  std::ifstream input(source.c_str(), std::ios::binary);
+  std::ofstream output(destination.c_str(), std::ios::binary | std::ios::trunc);
+  if(!input || !output)
+    return false;
+
+  output << input.rdbuf();
+  return output.good();
+}
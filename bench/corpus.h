@@ -0,0 +1,62 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BENCH_CORPUS_H
+#define TAGLIB_BENCH_CORPUS_H
+
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+  //! A file of the synthetic benchmark corpus.
+
+  struct CorpusFile
+  {
+    //! The short name used to label the benchmark results, e.g. "mp3-huge-id3v2".
+    std::string name;
+
+    //! The container format, e.g. "MP3".
+    std::string format;
+
+    //! The path of the generated file.
+    std::string path;
+  };
+
+  /*!
+   * Generates the synthetic corpus in \a directory, which must exist, and
+   * returns the list of generated files.  The generator is deterministic, so
+   * that results of different builds can be compared.  Files which already
+   * exist are reused unless \a regenerate is true.
+   */
+  std::vector<CorpusFile> generateCorpus(const std::string &directory, bool regenerate);
+
+  /*!
+   * Copies \a source to \a destination.  Returns false if either file can not
+   * be opened.
+   */
+  bool copyFile(const std::string &source, const std::string &destination);
+}
+
+#endif
@@ -24,8 +24,13 @@
 #endif
 
 #include <stdlib.h>
+#include <vector>
 #include <fileref.h>
 #include <tfile.h>
+#include <tfilestream.h>
+#include <tbytevectorstream.h>
+#include <tmemorystream.h>
+#include <tpropertymap.h>
 #include <asffile.h>
 #include <vorbisfile.h>
 #include <mpegfile.h>
@@ -39,16 +44,33 @@
 #include <tag.h>
 #include <string.h>
 #include <id3v2framefactory.h>
+#include <tthreads.h>
+#include <formatutils.h>
 
 #include "tag_c.h"
 
+#if defined(HAVE_STD_ATOMIC)
+# include <atomic>
+#endif
+
 using namespace TagLib;
 
 namespace
 {
+  // The settings and the strings of taglib_tag_title() and friends, which are
+  // shared by all files.  The functions which return strings owned by a file
+  // do not use them.
+
+#if defined(HAVE_STD_ATOMIC)
+  std::atomic<bool> unicodeStrings(true);
+  std::atomic<bool> stringManagementEnabled(true);
+#else
+  volatile bool unicodeStrings = true;
+  volatile bool stringManagementEnabled = true;
+#endif
+
+  Utils::Mutex stringsMutex;
   List<char *> strings;
-  bool unicodeStrings = true;
-  bool stringManagementEnabled = true;
 
   char *stringToCharArray(const String &s)
   {
@@ -56,19 +78,256 @@ namespace
 
 #ifdef HAVE_ISO_STRDUP
 
-    return ::_strdup(str.c_str());
+    char *array = ::_strdup(str.c_str());
 
 #else
 
-    return ::strdup(str.c_str());
+    char *array = ::strdup(str.c_str());
 
 #endif
+
+    if(stringManagementEnabled) {
+      Utils::MutexLocker locker(stringsMutex);
+      strings.append(array);
+    }
+
+    return array;
   }
 
   String charArrayToString(const char *s)
   {
     return String(s, unicodeStrings ? String::UTF8 : String::Latin1);
   }
+
+  // Hands out the strings returned by a file.  They are carved out of larger
+  // chunks and released all at once.
+
+  class StringArena
+  {
+  public:
+    StringArena() :
+      m_chunk(0),
+      m_used(ChunkSize) {}
+
+    ~StringArena()
+    {
+      clear();
+    }
+
+    char *allocate(size_t size, size_t alignment = 1)
+    {
+      if(size > ChunkSize / 4) {
+        char *block = static_cast<char *>(malloc(size));
+        m_blocks.push_back(block);
+        return block;
+      }
+
+      m_used = (m_used + alignment - 1) / alignment * alignment;
+
+      if(m_used + size > ChunkSize) {
+        m_chunk = static_cast<char *>(malloc(ChunkSize));
+        m_blocks.push_back(m_chunk);
+        m_used = 0;
+      }
+
+      char *s = m_chunk + m_used;
+      m_used += size;
+      return s;
+    }
+
+    void clear()
+    {
+      for(std::vector<char *>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+        free(*it);
+      m_blocks.clear();
+      m_chunk = 0;
+      m_used = ChunkSize;
+    }
+
+  private:
+    StringArena(const StringArena &);
+    StringArena &operator=(const StringArena &);
+
+    static const size_t ChunkSize = 4096;
+
+    std::vector<char *> m_blocks;
+    char *m_chunk;
+    size_t m_used;
+  };
+
+  struct FileHandle;
+
+  // What TagLib_Tag points to.  It knows the file which owns the strings.
+
+  struct TagHandle
+  {
+    Tag *tag;
+    FileHandle *file;
+  };
+
+  // A picture of a file.  The strings are null terminated, and all of the
+  // data is kept until the file is freed.
+
+  struct PictureData
+  {
+    ByteVector mimeType;
+    ByteVector description;
+    int type;
+    ByteVector data;
+  };
+
+  // What TagLib_File points to.
+
+  struct FileHandle
+  {
+    FileHandle(const FileRef &r, IOStream *s) :
+      stream(s),
+      ref(r),
+      file(r.file()),
+      picturesRead(false)
+    {
+      tagHandle.tag = 0;
+      tagHandle.file = this;
+    }
+
+    ~FileHandle()
+    {
+      // The file has to be closed before its stream.
+
+      ref = FileRef();
+      delete stream;
+    }
+
+    IOStream *stream;
+    FileRef ref;
+    File *file;
+    TagHandle tagHandle;
+    StringArena strings;
+    bool picturesRead;
+    std::vector<PictureData> pictures;
+  };
+
+  TagLib_File *toFileHandle(File *file)
+  {
+    if(!file)
+      return 0;
+
+    return reinterpret_cast<TagLib_File *>(new FileHandle(FileRef(file), 0));
+  }
+
+  TagLib_File *toFileHandle(IOStream *stream)
+  {
+    const FileRef ref(stream);
+    if(ref.isNull()) {
+      delete stream;
+      return 0;
+    }
+
+    return reinterpret_cast<TagLib_File *>(new FileHandle(ref, stream));
+  }
+
+  FileHandle *fileHandle(const TagLib_File *file)
+  {
+    return reinterpret_cast<FileHandle *>(const_cast<TagLib_File *>(file));
+  }
+
+  const TagHandle *tagHandle(const TagLib_Tag *tag)
+  {
+    return reinterpret_cast<const TagHandle *>(tag);
+  }
+
+  Tag *toTag(const TagLib_Tag *tag)
+  {
+    return tagHandle(tag)->tag;
+  }
+
+  // Encodes s as UTF-8 into at most capacity bytes of buffer without splitting
+  // a character.  Returns the length of the whole encoded string and sets
+  // written to the number of bytes written.  Like String::to8Bit(), a string
+  // with invalid UTF-16 is encoded as empty.
+
+  size_t encodeString(const String &s, char *buffer, size_t capacity, size_t &written)
+  {
+    size_t length = 0;
+    written = 0;
+
+    for(String::ConstIterator it = s.begin(); it != s.end(); ++it) {
+      unsigned int c = static_cast<unsigned short>(*it);
+      char bytes[4];
+      size_t count = 0;
+
+      if(c >= 0xD800 && c <= 0xDBFF) {
+        String::ConstIterator next = it + 1;
+        const unsigned int c2 = (next != s.end()) ? static_cast<unsigned short>(*next) : 0;
+        if(c2 < 0xDC00 || c2 > 0xDFFF) {
+          written = 0;
+          return 0;
+        }
+        c = 0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00);
+        it = next;
+      }
+      else if(c >= 0xDC00 && c <= 0xDFFF) {
+        written = 0;
+        return 0;
+      }
+
+      if(c < 0x80) {
+        bytes[count++] = static_cast<char>(c);
+      }
+      else if(c < 0x800) {
+        bytes[count++] = static_cast<char>(0xC0 | (c >> 6));
+        bytes[count++] = static_cast<char>(0x80 | (c & 0x3F));
+      }
+      else if(c < 0x10000) {
+        bytes[count++] = static_cast<char>(0xE0 | (c >> 12));
+        bytes[count++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        bytes[count++] = static_cast<char>(0x80 | (c & 0x3F));
+      }
+      else {
+        bytes[count++] = static_cast<char>(0xF0 | (c >> 18));
+        bytes[count++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        bytes[count++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        bytes[count++] = static_cast<char>(0x80 | (c & 0x3F));
+      }
+
+      if(written == length && length + count <= capacity) {
+        memcpy(buffer + written, bytes, count);
+        written += count;
+      }
+      length += count;
+    }
+
+    return length;
+  }
+
+  // Returns s encoded as UTF-8 in a string owned by the file.
+
+  const char *fileString(FileHandle *f, const String &s)
+  {
+    size_t written;
+    const size_t length = encodeString(s, 0, 0, written);
+
+    char *array = f->strings.allocate(length + 1);
+    encodeString(s, array, length, written);
+    array[written] = '\0';
+    return array;
+  }
+
+  const char *fileString(const TagLib_Tag *tag, const String &s)
+  {
+    return fileString(tagHandle(tag)->file, s);
+  }
+
+  // Copies s to the buffer of the caller, see taglib_tag_title_into().
+
+  unsigned int stringToBuffer(const String &s, char *buffer, unsigned int size)
+  {
+    size_t written = 0;
+    const size_t length = encodeString(s, buffer, size > 0 ? size - 1 : 0, written);
+    if(size > 0)
+      buffer[written] = '\0';
+    return static_cast<unsigned int>(length);
+  }
 }
 
 void taglib_set_strings_unicode(BOOL unicode)
@@ -92,62 +351,83 @@ void taglib_free(void* pointer)
 
 TagLib_File *taglib_file_new(const char *filename)
 {
-  return reinterpret_cast<TagLib_File *>(FileRef::create(filename));
+  return toFileHandle(FileRef::create(filename));
 }
 
 TagLib_File *taglib_file_new_type(const char *filename, TagLib_File_Type type)
 {
   switch(type) {
   case TagLib_File_MPEG:
-    return reinterpret_cast<TagLib_File *>(new MPEG::File(filename));
+    return toFileHandle(new MPEG::File(filename));
   case TagLib_File_OggVorbis:
-    return reinterpret_cast<TagLib_File *>(new Ogg::Vorbis::File(filename));
+    return toFileHandle(new Ogg::Vorbis::File(filename));
   case TagLib_File_FLAC:
-    return reinterpret_cast<TagLib_File *>(new FLAC::File(filename));
+    return toFileHandle(new FLAC::File(filename));
   case TagLib_File_MPC:
-    return reinterpret_cast<TagLib_File *>(new MPC::File(filename));
+    return toFileHandle(new MPC::File(filename));
   case TagLib_File_OggFlac:
-    return reinterpret_cast<TagLib_File *>(new Ogg::FLAC::File(filename));
+    return toFileHandle(new Ogg::FLAC::File(filename));
   case TagLib_File_WavPack:
-    return reinterpret_cast<TagLib_File *>(new WavPack::File(filename));
+    return toFileHandle(new WavPack::File(filename));
   case TagLib_File_Speex:
-    return reinterpret_cast<TagLib_File *>(new Ogg::Speex::File(filename));
+    return toFileHandle(new Ogg::Speex::File(filename));
   case TagLib_File_TrueAudio:
-    return reinterpret_cast<TagLib_File *>(new TrueAudio::File(filename));
+    return toFileHandle(new TrueAudio::File(filename));
   case TagLib_File_MP4:
-    return reinterpret_cast<TagLib_File *>(new MP4::File(filename));
+    return toFileHandle(new MP4::File(filename));
   case TagLib_File_ASF:
-    return reinterpret_cast<TagLib_File *>(new ASF::File(filename));
+    return toFileHandle(new ASF::File(filename));
   default:
     return 0;
   }
 }
 
+TagLib_File *taglib_file_new_memory(const char *data, unsigned int length)
+{
+  return toFileHandle(new ByteVectorStream(ByteVector(data, length)));
+}
+
+TagLib_File *taglib_file_new_memory_shared(const char *data, unsigned int length)
+{
+  return toFileHandle(new MemoryStream(data, length));
+}
+
+TagLib_File *taglib_file_new_fd(int fd)
+{
+  return toFileHandle(new FileStream(fd));
+}
+
 void taglib_file_free(TagLib_File *file)
 {
-  delete reinterpret_cast<File *>(file);
+  delete fileHandle(file);
+}
+
+void taglib_file_free_strings(TagLib_File *file)
+{
+  fileHandle(file)->strings.clear();
 }
 
 BOOL taglib_file_is_valid(const TagLib_File *file)
 {
-  return reinterpret_cast<const File *>(file)->isValid();
+  return fileHandle(file)->file->isValid();
 }
 
 TagLib_Tag *taglib_file_tag(const TagLib_File *file)
 {
-  const File *f = reinterpret_cast<const File *>(file);
-  return reinterpret_cast<TagLib_Tag *>(f->tag());
+  FileHandle *f = fileHandle(file);
+  f->tagHandle.tag = f->file->tag();
+  return reinterpret_cast<TagLib_Tag *>(&f->tagHandle);
 }
 
 const TagLib_AudioProperties *taglib_file_audioproperties(const TagLib_File *file)
 {
-  const File *f = reinterpret_cast<const File *>(file);
+  const File *f = fileHandle(file)->file;
   return reinterpret_cast<const TagLib_AudioProperties *>(f->audioProperties());
 }
 
 BOOL taglib_file_save(TagLib_File *file)
 {
-  return reinterpret_cast<File *>(file)->save();
+  return fileHandle(file)->file->save();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,101 +436,122 @@ BOOL taglib_file_save(TagLib_File *file)
 
 char *taglib_tag_title(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->title());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return stringToCharArray(toTag(tag)->title());
 }
 
 char *taglib_tag_artist(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->artist());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return stringToCharArray(toTag(tag)->artist());
 }
 
 char *taglib_tag_album(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->album());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return stringToCharArray(toTag(tag)->album());
 }
 
 char *taglib_tag_comment(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->comment());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return stringToCharArray(toTag(tag)->comment());
 }
 
 char *taglib_tag_genre(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  char *s = stringToCharArray(t->genre());
-  if(stringManagementEnabled)
-    strings.append(s);
-  return s;
+  return stringToCharArray(toTag(tag)->genre());
+}
+
+const char *taglib_tag_title_ref(const TagLib_Tag *tag)
+{
+  return fileString(tag, toTag(tag)->title());
+}
+
+const char *taglib_tag_artist_ref(const TagLib_Tag *tag)
+{
+  return fileString(tag, toTag(tag)->artist());
+}
+
+const char *taglib_tag_album_ref(const TagLib_Tag *tag)
+{
+  return fileString(tag, toTag(tag)->album());
+}
+
+const char *taglib_tag_comment_ref(const TagLib_Tag *tag)
+{
+  return fileString(tag, toTag(tag)->comment());
+}
+
+const char *taglib_tag_genre_ref(const TagLib_Tag *tag)
+{
+  return fileString(tag, toTag(tag)->genre());
+}
+
+unsigned int taglib_tag_title_into(const TagLib_Tag *tag, char *buffer, unsigned int size)
+{
+  return stringToBuffer(toTag(tag)->title(), buffer, size);
+}
+
+unsigned int taglib_tag_artist_into(const TagLib_Tag *tag, char *buffer, unsigned int size)
+{
+  return stringToBuffer(toTag(tag)->artist(), buffer, size);
+}
+
+unsigned int taglib_tag_album_into(const TagLib_Tag *tag, char *buffer, unsigned int size)
+{
+  return stringToBuffer(toTag(tag)->album(), buffer, size);
+}
+
+unsigned int taglib_tag_comment_into(const TagLib_Tag *tag, char *buffer, unsigned int size)
+{
+  return stringToBuffer(toTag(tag)->comment(), buffer, size);
+}
+
+unsigned int taglib_tag_genre_into(const TagLib_Tag *tag, char *buffer, unsigned int size)
+{
+  return stringToBuffer(toTag(tag)->genre(), buffer, size);
 }
 
 unsigned int taglib_tag_year(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  return t->year();
+  return toTag(tag)->year();
 }
 
 unsigned int taglib_tag_track(const TagLib_Tag *tag)
 {
-  const Tag *t = reinterpret_cast<const Tag *>(tag);
-  return t->track();
+  return toTag(tag)->track();
 }
 
 void taglib_tag_set_title(TagLib_Tag *tag, const char *title)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setTitle(charArrayToString(title));
+  toTag(tag)->setTitle(charArrayToString(title));
 }
 
 void taglib_tag_set_artist(TagLib_Tag *tag, const char *artist)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setArtist(charArrayToString(artist));
+  toTag(tag)->setArtist(charArrayToString(artist));
 }
 
 void taglib_tag_set_album(TagLib_Tag *tag, const char *album)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setAlbum(charArrayToString(album));
+  toTag(tag)->setAlbum(charArrayToString(album));
 }
 
 void taglib_tag_set_comment(TagLib_Tag *tag, const char *comment)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setComment(charArrayToString(comment));
+  toTag(tag)->setComment(charArrayToString(comment));
 }
 
 void taglib_tag_set_genre(TagLib_Tag *tag, const char *genre)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setGenre(charArrayToString(genre));
+  toTag(tag)->setGenre(charArrayToString(genre));
 }
 
 void taglib_tag_set_year(TagLib_Tag *tag, unsigned int year)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setYear(year);
+  toTag(tag)->setYear(year);
 }
 
 void taglib_tag_set_track(TagLib_Tag *tag, unsigned int track)
 {
-  Tag *t = reinterpret_cast<Tag *>(tag);
-  t->setTrack(track);
+  toTag(tag)->setTrack(track);
 }
 
 void taglib_tag_free_strings()
@@ -258,6 +559,8 @@ void taglib_tag_free_strings()
   if(!stringManagementEnabled)
     return;
 
+  Utils::MutexLocker locker(stringsMutex);
+
   for(List<char *>::ConstIterator it = strings.begin(); it != strings.end(); ++it)
     free(*it);
   strings.clear();
@@ -291,6 +594,306 @@ int taglib_audioproperties_channels(const TagLib_AudioProperties *audioPropertie
   return p->channels();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// TagLib::PropertyMap wrapper
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  // Returns a null terminated array of the strings in list, owned by the file.
+
+  char **toCharArrayList(FileHandle *f, const StringList &list)
+  {
+    char **array = reinterpret_cast<char **>(
+      f->strings.allocate((list.size() + 1) * sizeof(char *), sizeof(char *)));
+
+    char **p = array;
+    for(StringList::ConstIterator it = list.begin(); it != list.end(); ++it)
+      *p++ = const_cast<char *>(fileString(f, *it));
+    *p = 0;
+
+    return array;
+  }
+
+  String toString(const char *s)
+  {
+    return String(s, String::UTF8);
+  }
+}
+
+char **taglib_property_keys(const TagLib_File *file)
+{
+  FileHandle *f = fileHandle(file);
+  const PropertyMap map = f->file->properties();
+
+  StringList keys;
+  for(PropertyMap::ConstIterator it = map.begin(); it != map.end(); ++it)
+    keys.append(it->first);
+
+  return toCharArrayList(f, keys);
+}
+
+char **taglib_property_get(const TagLib_File *file, const char *key)
+{
+  FileHandle *f = fileHandle(file);
+  const PropertyMap map = f->file->properties();
+
+  const PropertyMap::ConstIterator it = map.find(toString(key));
+  return toCharArrayList(f, it != map.end() ? it->second : StringList());
+}
+
+void taglib_property_set(TagLib_File *file, const char *key, const char *value)
+{
+  FileHandle *f = fileHandle(file);
+  PropertyMap map = f->file->properties();
+
+  if(value)
+    map.replace(toString(key), StringList(toString(value)));
+  else
+    map.erase(toString(key));
+
+  f->file->setProperties(map);
+}
+
+void taglib_property_set_append(TagLib_File *file, const char *key, const char *value)
+{
+  FileHandle *f = fileHandle(file);
+  PropertyMap map = f->file->properties();
+
+  if(value)
+    map[toString(key)].append(toString(value));
+
+  f->file->setProperties(map);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Pictures
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  ByteVector toCString(const String &s)
+  {
+    ByteVector v = s.data(String::UTF8);
+    v.append('\0');
+    return v;
+  }
+
+  void readPictures(FileHandle *f)
+  {
+    const Utils::EmbeddedPictureList pictures = Utils::embeddedPictures(f->file);
+    for(Utils::EmbeddedPictureList::const_iterator it = pictures.begin(); it != pictures.end(); ++it) {
+      PictureData picture;
+      picture.mimeType    = toCString(it->mimeType);
+      picture.description = toCString(it->description);
+      picture.type        = it->type;
+      picture.data        = it->data;
+      f->pictures.push_back(picture);
+    }
+  }
+}
+
+unsigned int taglib_picture_count(const TagLib_File *file)
+{
+  FileHandle *f = fileHandle(file);
+  if(!f->picturesRead) {
+    readPictures(f);
+    f->picturesRead = true;
+  }
+
+  return static_cast<unsigned int>(f->pictures.size());
+}
+
+BOOL taglib_picture_get(const TagLib_File *file, unsigned int index, TagLib_Picture *picture)
+{
+  if(index >= taglib_picture_count(file))
+    return 0;
+
+  const PictureData &p = fileHandle(file)->pictures[index];
+  picture->mime_type   = p.mimeType.data();
+  picture->description = p.description.data();
+  picture->type        = p.type;
+  picture->data        = p.data.data();
+  picture->size        = p.data.size();
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Batch API
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  // The strings of a file, which are kept until there is room in the arena.
+
+  struct InfoStrings
+  {
+    String title;
+    String artist;
+    String album;
+    String comment;
+    String genre;
+  };
+
+  // Fills in everything but the strings.
+
+  void readInfo(const char *filename, TagLib_Info *info, InfoStrings &strings)
+  {
+    memset(info, 0, sizeof(TagLib_Info));
+    info->status = TagLib_Info_Invalid;
+
+    const FileRef ref(filename);
+    if(ref.isNull() || !ref.file()->isValid())
+      return;
+
+    info->status = TagLib_Info_OK;
+    info->format = Utils::formatName(ref.file());
+
+    const Tag *tag = ref.tag();
+    if(tag) {
+      strings.title   = tag->title();
+      strings.artist  = tag->artist();
+      strings.album   = tag->album();
+      strings.comment = tag->comment();
+      strings.genre   = tag->genre();
+      info->year  = tag->year();
+      info->track = tag->track();
+    }
+
+    const AudioProperties *properties = ref.audioProperties();
+    if(properties) {
+      info->length     = properties->lengthInMilliseconds();
+      info->bitrate    = properties->bitrate();
+      info->samplerate = properties->sampleRate();
+      info->channels   = properties->channels();
+    }
+  }
+
+  const char *copyToArena(const String &s, char *arena, size_t &used)
+  {
+    size_t written;
+    const size_t length = encodeString(s, 0, 0, written);
+    char *const copy = arena + used;
+    encodeString(s, copy, length, written);
+    copy[written] = '\0';
+    used += written + 1;
+    return copy;
+  }
+
+  // Copies the strings to the arena if all of them fit.
+
+  void storeStrings(TagLib_Info *info, const InfoStrings &strings,
+                    char *arena, size_t arenaSize, size_t &used)
+  {
+    if(info->status != TagLib_Info_OK)
+      return;
+
+    const String *const all[] = {
+      &strings.title, &strings.artist, &strings.album, &strings.comment, &strings.genre
+    };
+    const size_t count = sizeof(all) / sizeof(all[0]);
+
+    size_t needed = 0;
+    for(size_t i = 0; i < count; ++i) {
+      size_t written;
+      needed += encodeString(*all[i], 0, 0, written) + 1;
+    }
+
+    if(!arena || used > arenaSize || arenaSize - used < needed) {
+      info->status = TagLib_Info_ArenaFull;
+      return;
+    }
+
+    info->title   = copyToArena(strings.title, arena, used);
+    info->artist  = copyToArena(strings.artist, arena, used);
+    info->album   = copyToArena(strings.album, arena, used);
+    info->comment = copyToArena(strings.comment, arena, used);
+    info->genre   = copyToArena(strings.genre, arena, used);
+  }
+
+  // The state shared by the threads of taglib_info_read_batch().
+
+  struct Batch
+  {
+    const char *const *filenames;
+    unsigned int count;
+    TagLib_Info *infos;
+    char *arena;
+    size_t arenaSize;
+    size_t used;
+
+    Utils::Mutex mutex;
+    unsigned int next;
+    unsigned int succeeded;
+  };
+
+  void runBatch(void *context)
+  {
+    Batch *batch = static_cast<Batch *>(context);
+
+    for(;;) {
+      unsigned int i;
+      {
+        Utils::MutexLocker locker(batch->mutex);
+        i = batch->next++;
+      }
+
+      if(i >= batch->count)
+        break;
+
+      TagLib_Info *info = &batch->infos[i];
+      InfoStrings strings;
+      readInfo(batch->filenames[i], info, strings);
+
+      Utils::MutexLocker locker(batch->mutex);
+      storeStrings(info, strings, batch->arena, batch->arenaSize, batch->used);
+      if(info->status == TagLib_Info_OK)
+        batch->succeeded++;
+    }
+  }
+}
+
+BOOL taglib_info_read(const char *filename, TagLib_Info *info,
+                      char *arena, size_t arena_size, size_t *arena_used)
+{
+  size_t used = arena_used ? *arena_used : 0;
+
+  InfoStrings strings;
+  readInfo(filename, info, strings);
+  storeStrings(info, strings, arena, arena_size, used);
+
+  if(arena_used)
+    *arena_used = used;
+
+  return info->status == TagLib_Info_OK;
+}
+
+unsigned int taglib_info_read_batch(const char *const *filenames, unsigned int count,
+                                    TagLib_Info *infos,
+                                    char *arena, size_t arena_size, size_t *arena_used,
+                                    unsigned int threads)
+{
+  Batch batch;
+  batch.filenames = filenames;
+  batch.count     = count;
+  batch.infos     = infos;
+  batch.arena     = arena;
+  batch.arenaSize = arena_size;
+  batch.used      = arena_used ? *arena_used : 0;
+  batch.next      = 0;
+  batch.succeeded = 0;
+
+  if(threads > count)
+    threads = count;
+
+  Utils::runParallel(threads, runBatch, &batch);
+
+  if(arena_used)
+    *arena_used = batch.used;
+
+  return batch.succeeded;
+}
+
 void taglib_id3v2_set_default_text_encoding(TagLib_ID3v2_Encoding encoding)
 {
   String::Type type = String::Latin1;
@@ -43,6 +43,8 @@ extern "C" {
 #define TAGLIB_C_EXPORT
 #endif
 
+#include <stddef.h>
+
 #ifndef BOOL
 #define BOOL int
 #endif
@@ -58,8 +60,16 @@ extern "C" {
 
 /*
  * These are used for type provide some type safety to the C API (as opposed to
- * using void *, but pointers to them are simply cast to the corresponding C++
- * types in the implementation.
+ * using void *).  TagLib_File and TagLib_Tag are handles which own the strings
+ * returned by the per-file functions, e.g. taglib_tag_title_ref(), and
+ * TagLib_AudioProperties is simply cast to the corresponding C++ type in the
+ * implementation.
+ *
+ * Different files may be used from different threads at the same time, but a
+ * single file and its tag must not be used by several threads at once.  The
+ * strings of taglib_tag_title() and friends are shared by all files and freed
+ * at once by taglib_tag_free_strings(), so threads should use the per-file
+ * functions instead.
  */
 
 typedef struct { int dummy; } TagLib_File;
@@ -70,14 +80,20 @@ typedef struct { int dummy; } TagLib_AudioProperties;
  * By default all strings coming into or out of TagLib's C API are in UTF8.
  * However, it may be desirable for TagLib to operate on Latin1 (ISO-8859-1)
  * strings in which case this should be set to FALSE.
+ *
+ * \note This applies to taglib_tag_title() and the other functions which do
+ * not return strings owned by a file.  The per-file functions, the property,
+ * picture and batch functions always use UTF8.
  */
 TAGLIB_C_EXPORT void taglib_set_strings_unicode(BOOL unicode);
 
 /*!
  * TagLib can keep track of strings that are created when outputting tag values
- * and clear them using taglib_tag_clear_strings().  This is enabled by default.
+ * and clear them using taglib_tag_free_strings().  This is enabled by default.
  * However if you wish to do more fine grained management of strings, you can do
  * so by setting \a management to FALSE.
+ *
+ * \note This does not apply to the strings owned by a file.
  */
 TAGLIB_C_EXPORT void taglib_set_string_management_enabled(BOOL management);
 
@@ -119,10 +135,43 @@ TAGLIB_C_EXPORT TagLib_File *taglib_file_new(const char *filename);
 TAGLIB_C_EXPORT TagLib_File *taglib_file_new_type(const char *filename, TagLib_File_Type type);
 
 /*!
- * Frees and closes the file.
+ * Creates a TagLib file from the \a length bytes at \a data, which are copied.
+ * TagLib will guess the file type from the content.
+ *
+ * \returns NULL if the file type cannot be determined.
+ */
+TAGLIB_C_EXPORT TagLib_File *taglib_file_new_memory(const char *data, unsigned int length);
+
+/*!
+ * Creates a read only TagLib file from the \a length bytes at \a data, which
+ * are not copied.  The tags and pictures read from the file refer to the
+ * memory, so it must stay valid and unchanged until the file is freed.
+ * TagLib will guess the file type from the content.
+ *
+ * \returns NULL if the file type cannot be determined.
+ */
+TAGLIB_C_EXPORT TagLib_File *taglib_file_new_memory_shared(const char *data, unsigned int length);
+
+/*!
+ * Creates a TagLib file from the open file descriptor \a fd.  TagLib will guess
+ * the file type from the content.  The descriptor is closed when the file is
+ * freed.
+ *
+ * \returns NULL if the file type cannot be determined.
+ */
+TAGLIB_C_EXPORT TagLib_File *taglib_file_new_fd(int fd);
+
+/*!
+ * Frees and closes the file, including the strings owned by it.
  */
 TAGLIB_C_EXPORT void taglib_file_free(TagLib_File *file);
 
+/*!
+ * Frees the strings owned by the file which have been returned so far, e.g. by
+ * taglib_tag_title_ref(), while keeping the file open.
+ */
+TAGLIB_C_EXPORT void taglib_file_free_strings(TagLib_File *file);
+
 /*!
  * Returns true if the file is open and readable and valid information for
  * the Tag and / or AudioProperties was found.
@@ -191,6 +240,71 @@ TAGLIB_C_EXPORT char *taglib_tag_comment(const TagLib_Tag *tag);
  */
 TAGLIB_C_EXPORT char *taglib_tag_genre(const TagLib_Tag *tag);
 
+/*!
+ * Returns this tag's title as a UTF8 encoded string which is owned by the file
+ * of the tag.  It is freed by taglib_file_free() or taglib_file_free_strings(),
+ * so that, unlike taglib_tag_title(), it can be used by several threads which
+ * read different files.
+ */
+TAGLIB_C_EXPORT const char *taglib_tag_title_ref(const TagLib_Tag *tag);
+
+/*!
+ * Returns this tag's artist as a string owned by the file, see
+ * taglib_tag_title_ref().
+ */
+TAGLIB_C_EXPORT const char *taglib_tag_artist_ref(const TagLib_Tag *tag);
+
+/*!
+ * Returns this tag's album name as a string owned by the file, see
+ * taglib_tag_title_ref().
+ */
+TAGLIB_C_EXPORT const char *taglib_tag_album_ref(const TagLib_Tag *tag);
+
+/*!
+ * Returns this tag's comment as a string owned by the file, see
+ * taglib_tag_title_ref().
+ */
+TAGLIB_C_EXPORT const char *taglib_tag_comment_ref(const TagLib_Tag *tag);
+
+/*!
+ * Returns this tag's genre as a string owned by the file, see
+ * taglib_tag_title_ref().
+ */
+TAGLIB_C_EXPORT const char *taglib_tag_genre_ref(const TagLib_Tag *tag);
+
+/*!
+ * Copies this tag's title to \a buffer, which is \a size bytes long, and
+ * terminates it with a null byte.  Characters which do not fit completely are
+ * left out.  No memory is allocated for the string.
+ *
+ * \returns the length of the whole title in bytes, not counting the
+ * terminating null byte.  If it is not less than \a size, the title was
+ * truncated.
+ *
+ * \note The string is UTF8 encoded.
+ */
+TAGLIB_C_EXPORT unsigned int taglib_tag_title_into(const TagLib_Tag *tag, char *buffer, unsigned int size);
+
+/*!
+ * Copies this tag's artist to \a buffer, see taglib_tag_title_into().
+ */
+TAGLIB_C_EXPORT unsigned int taglib_tag_artist_into(const TagLib_Tag *tag, char *buffer, unsigned int size);
+
+/*!
+ * Copies this tag's album name to \a buffer, see taglib_tag_title_into().
+ */
+TAGLIB_C_EXPORT unsigned int taglib_tag_album_into(const TagLib_Tag *tag, char *buffer, unsigned int size);
+
+/*!
+ * Copies this tag's comment to \a buffer, see taglib_tag_title_into().
+ */
+TAGLIB_C_EXPORT unsigned int taglib_tag_comment_into(const TagLib_Tag *tag, char *buffer, unsigned int size);
+
+/*!
+ * Copies this tag's genre to \a buffer, see taglib_tag_title_into().
+ */
+TAGLIB_C_EXPORT unsigned int taglib_tag_genre_into(const TagLib_Tag *tag, char *buffer, unsigned int size);
+
 /*!
  * Returns the tag's year or 0 if year is not set.
  */
@@ -275,6 +389,139 @@ TAGLIB_C_EXPORT int taglib_audioproperties_samplerate(const TagLib_AudioProperti
  */
 TAGLIB_C_EXPORT int taglib_audioproperties_channels(const TagLib_AudioProperties *audioProperties);
 
+/******************************************************************************
+ * Property API
+ *
+ * The keys and values coming into or out of these functions are UTF8 encoded.
+ ******************************************************************************/
+
+/*!
+ * Returns a NULL terminated array of the keys of the properties of \a file,
+ * such as "TITLE", "MUSICBRAINZ_TRACKID" or "REPLAYGAIN_TRACK_GAIN".  See
+ * TagLib::PropertyMap for the supported keys.
+ *
+ * \note The array and the strings are owned by the file, see
+ * taglib_file_free_strings().
+ */
+TAGLIB_C_EXPORT char **taglib_property_keys(const TagLib_File *file);
+
+/*!
+ * Returns a NULL terminated array of the values of the property \a key, which
+ * is empty if the property is not set.
+ *
+ * \note The array and the strings are owned by the file, see
+ * taglib_file_free_strings().
+ */
+TAGLIB_C_EXPORT char **taglib_property_get(const TagLib_File *file, const char *key);
+
+/*!
+ * Sets the property \a key to the single value \a value, or removes it if
+ * \a value is NULL.  The file has to be saved with taglib_file_save().
+ */
+TAGLIB_C_EXPORT void taglib_property_set(TagLib_File *file, const char *key, const char *value);
+
+/*!
+ * Appends \a value to the values of the property \a key.
+ */
+TAGLIB_C_EXPORT void taglib_property_set_append(TagLib_File *file, const char *key, const char *value);
+
+/******************************************************************************
+ * Picture API
+ ******************************************************************************/
+
+/*!
+ * A picture embedded in a file.  The pointers are valid until the file is
+ * freed.
+ */
+typedef struct {
+  /*! The MIME type, e.g. "image/jpeg", or an empty string if it is unknown. */
+  const char *mime_type;
+  const char *description;
+  /*! The picture type as defined by ID3v2 APIC frames, e.g. 3 for the front cover. */
+  int type;
+  /*! The image data, which is not null terminated. */
+  const char *data;
+  unsigned int size;
+} TagLib_Picture;
+
+/*!
+ * Returns the number of pictures in ID3v2 APIC frames, FLAC picture blocks,
+ * Xiph comments, MP4 cover art, ASF WM/Picture attributes and APE cover art
+ * items of \a file.  The pictures are read once, when this or
+ * taglib_picture_get() is first called.
+ */
+TAGLIB_C_EXPORT unsigned int taglib_picture_count(const TagLib_File *file);
+
+/*!
+ * Fills \a picture with the picture at \a index without copying its data.
+ *
+ * \returns FALSE if \a index is out of range.
+ */
+TAGLIB_C_EXPORT BOOL taglib_picture_get(const TagLib_File *file, unsigned int index, TagLib_Picture *picture);
+
+/*******************************************************************************
+ * Batch API
+ *
+ * These read the basic tags and the audio properties of one or many files in a
+ * single call, without allocating memory for the results.
+ ******************************************************************************/
+
+typedef enum {
+  /*! The information was read. */
+  TagLib_Info_OK,
+  /*! The file type could not be determined or the file is invalid. */
+  TagLib_Info_Invalid,
+  /*! The strings did not fit into the arena and are NULL. */
+  TagLib_Info_ArenaFull
+} TagLib_Info_Status;
+
+/*!
+ * The information about a file filled in by taglib_info_read().  The strings
+ * are UTF8 encoded and point into the arena supplied by the caller.  Numbers which are not
+ * available are 0.
+ */
+typedef struct {
+  TagLib_Info_Status status;
+  /*! A static string naming the file format, e.g. "MPEG", or NULL. */
+  const char *format;
+  const char *title;
+  const char *artist;
+  const char *album;
+  const char *comment;
+  const char *genre;
+  unsigned int year;
+  unsigned int track;
+  /*! The length of the audio in milliseconds. */
+  int length;
+  /*! The bitrate in kb/s. */
+  int bitrate;
+  int samplerate;
+  int channels;
+} TagLib_Info;
+
+/*!
+ * Reads the information about \a filename into \a info.  The strings are
+ * copied to \a arena, which is \a arena_size bytes long, starting at offset
+ * \a *arena_used, which is advanced past them.
+ *
+ * \returns TRUE if info->status is TagLib_Info_OK.
+ */
+TAGLIB_C_EXPORT BOOL taglib_info_read(const char *filename, TagLib_Info *info,
+                                      char *arena, size_t arena_size, size_t *arena_used);
+
+/*!
+ * Reads the information about the \a count files in \a filenames into the
+ * corresponding entries of \a infos, like taglib_info_read().  The files are
+ * read by \a threads threads in parallel, or by the calling thread if it is 0
+ * or 1.  The strings of all files share \a arena, in no particular order.
+ *
+ * \returns the number of files whose status is TagLib_Info_OK.
+ */
+TAGLIB_C_EXPORT unsigned int taglib_info_read_batch(const char *const *filenames, unsigned int count,
+                                                    TagLib_Info *infos,
+                                                    char *arena, size_t arena_size, size_t *arena_used,
+                                                    unsigned int threads);
+
 /*******************************************************************************
  * Special convenience ID3v2 functions
  *******************************************************************************/
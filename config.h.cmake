@@ -30,6 +30,12 @@
 /* Indicates whether debug messages are shown even in release mode */
 #cmakedefine   TRACE_IN_RELEASE 1
 
+/* Indicates whether operator new and delete are replaced to count allocations */
+#cmakedefine   TRACK_ALLOCATIONS 1
+
+/* Indicates whether the expensive phases are reported to the TraceListener */
+#cmakedefine   ENABLE_TRACE_EVENTS 1
+
 #cmakedefine TESTS_DIR "@TESTS_DIR@"
 
 #endif
@@ -34,6 +34,8 @@
 #include <tbytevector.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tagunion.h>
 #include <id3v1tag.h>
 #include <id3v2header.h>
@@ -91,7 +93,7 @@ bool APE::File::isSupported(IOStream *stream)
 {
   // An APE file has an ID "MAC " somewhere. An ID3v2 tag may precede.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), true);
   return (buffer.find("MAC ") >= 0);
 }
 
@@ -150,6 +152,9 @@ APE::Properties *APE::File::audioProperties() const
 
 bool APE::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("APE::File::save() -- File is read only.");
     return false;
@@ -252,12 +257,35 @@ bool APE::File::hasID3v1Tag() const
   return (d->ID3v1Location >= 0);
 }
 
+File::RangeList APE::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  long start = 0;
+  if(d->ID3v2Location >= 0)
+    start = d->ID3v2Location + d->ID3v2Size;
+
+  long end = length();
+  if(d->APELocation >= 0)
+    end = d->APELocation;
+  else if(d->ID3v1Location >= 0)
+    end = d->ID3v1Location;
+
+  RangeList ranges;
+  if(end > start)
+    ranges.append(Range(start, end - start));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void APE::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // Look for an ID3v2 tag
 
   d->ID3v2Location = Utils::findID3v2(this);
@@ -268,16 +296,20 @@ void APE::File::read(bool readProperties)
     d->ID3v2Size = d->ID3v2Header->completeTagSize();
   }
 
+  // Look for the tags at the end of the file
+
+  const Utils::TrailingTags trailingTags = Utils::findTrailingTags(this);
+
   // Look for an ID3v1 tag
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->ID3v1Location = trailingTags.ID3v1Location;
 
   if(d->ID3v1Location >= 0)
     d->tag.set(ApeID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
 
   // Look for an APE tag
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = trailingTags.APEFooterLocation;
 
   if(d->APELocation >= 0) {
     d->tag.set(ApeAPEIndex, new APE::Tag(this, d->APELocation));
@@ -291,15 +323,9 @@ void APE::File::read(bool readProperties)
   // Look for APE audio properties
 
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
 
-    long streamLength;
-
-    if(d->APELocation >= 0)
-      streamLength = d->APELocation;
-    else if(d->ID3v1Location >= 0)
-      streamLength = d->ID3v1Location;
-    else
-      streamLength = length();
+    long streamLength = trailingTags.audioEnd;
 
     if(d->ID3v2Location >= 0) {
       seek(d->ID3v2Location + d->ID3v2Size);
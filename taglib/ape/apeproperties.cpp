@@ -29,6 +29,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tlayout.h>
 #include <bitset>
 #include "id3v2tag.h"
 #include "apeproperties.h"
@@ -38,6 +39,47 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // The headers of files created by Monkey's Audio 3.98 and later.
+
+  struct Descriptor
+  {
+    static const unsigned int size = 44;
+    typedef Layout::U32L<0> DescriptorBytes;
+  };
+
+  struct MACHeader
+  {
+    static const unsigned int size = 24;
+    typedef Layout::U32L<4>  BlocksPerFrame;
+    typedef Layout::U32L<8>  FinalFrameBlocks;
+    typedef Layout::U32L<12> TotalFrames;
+    typedef Layout::S16L<16> BitsPerSample;
+    typedef Layout::S16L<18> Channels;
+    typedef Layout::U32L<20> SampleRate;
+  };
+
+  // The header of older files, followed by a RIFF header.
+
+  struct OldHeader
+  {
+    static const unsigned int size = 26;
+    typedef Layout::S16L<0>  CompressionLevel;
+    typedef Layout::S16L<4>  Channels;
+    typedef Layout::U32L<6>  SampleRate;
+    typedef Layout::U32L<18> TotalFrames;
+    typedef Layout::U32L<22> FinalFrameBlocks;
+  };
+
+  struct FormatChunk
+  {
+    static const unsigned int size = 28;
+    typedef Layout::Bytes<0, 8> ID;
+    typedef Layout::S16L<26>    BitsPerSample;
+  };
+}
+
 class APE::Properties::PropertiesPrivate
 {
 public:
@@ -178,53 +220,58 @@ void APE::Properties::analyzeCurrent(File *file)
 {
   // Read the descriptor
   file->seek(2, File::Current);
-  const ByteVector descriptor = file->readBlock(44);
-  if(descriptor.size() < 44) {
+  const ByteVector descriptorData = file->readBlock(Descriptor::size);
+  const Layout::View<Descriptor> descriptor(descriptorData);
+  if(!descriptor.isValid()) {
     debug("APE::Properties::analyzeCurrent() -- descriptor is too short.");
     return;
   }
 
-  const unsigned int descriptorBytes = descriptor.toUInt(0, false);
+  const unsigned int descriptorBytes = descriptor.get<Descriptor::DescriptorBytes>();
 
   if((descriptorBytes - 52) > 0)
     file->seek(descriptorBytes - 52, File::Current);
 
   // Read the header
-  const ByteVector header = file->readBlock(24);
-  if(header.size() < 24) {
+  typedef MACHeader H;
+  const ByteVector headerData = file->readBlock(H::size);
+  const Layout::View<H> header(headerData);
+  if(!header.isValid()) {
     debug("APE::Properties::analyzeCurrent() -- MAC header is too short.");
     return;
   }
 
   // Get the APE info
-  d->channels      = header.toShort(18, false);
-  d->sampleRate    = header.toUInt(20, false);
-  d->bitsPerSample = header.toShort(16, false);
+  d->channels      = header.get<H::Channels>();
+  d->sampleRate    = header.get<H::SampleRate>();
+  d->bitsPerSample = header.get<H::BitsPerSample>();
 
-  const unsigned int totalFrames = header.toUInt(12, false);
+  const unsigned int totalFrames = header.get<H::TotalFrames>();
   if(totalFrames == 0)
     return;
 
-  const unsigned int blocksPerFrame   = header.toUInt(4, false);
-  const unsigned int finalFrameBlocks = header.toUInt(8, false);
+  const unsigned int blocksPerFrame   = header.get<H::BlocksPerFrame>();
+  const unsigned int finalFrameBlocks = header.get<H::FinalFrameBlocks>();
   d->sampleFrames = (totalFrames - 1) * blocksPerFrame + finalFrameBlocks;
 }
 
 void APE::Properties::analyzeOld(File *file)
 {
-  const ByteVector header = file->readBlock(26);
-  if(header.size() < 26) {
+  typedef OldHeader H;
+  const ByteVector headerData = file->readBlock(H::size);
+  const Layout::View<H> header(headerData);
+  if(!header.isValid()) {
     debug("APE::Properties::analyzeOld() -- MAC header is too short.");
     return;
   }
 
-  const unsigned int totalFrames = header.toUInt(18, false);
+  const unsigned int totalFrames = header.get<H::TotalFrames>();
 
   // Fail on 0 length APE files (catches non-finalized APE files)
   if(totalFrames == 0)
     return;
 
-  const short compressionLevel = header.toShort(0, false);
+  const short compressionLevel = header.get<H::CompressionLevel>();
   unsigned int blocksPerFrame;
   if(d->version >= 3950)
     blocksPerFrame = 73728 * 4;
@@ -234,19 +281,20 @@ void APE::Properties::analyzeOld(File *file)
     blocksPerFrame = 9216;
 
   // Get the APE info
-  d->channels   = header.toShort(4, false);
-  d->sampleRate = header.toUInt(6, false);
+  d->channels   = header.get<H::Channels>();
+  d->sampleRate = header.get<H::SampleRate>();
 
-  const unsigned int finalFrameBlocks = header.toUInt(22, false);
+  const unsigned int finalFrameBlocks = header.get<H::FinalFrameBlocks>();
   d->sampleFrames = (totalFrames - 1) * blocksPerFrame + finalFrameBlocks;
 
   // Get the bit depth from the RIFF-fmt chunk.
   file->seek(16, File::Current);
-  const ByteVector fmt = file->readBlock(28);
-  if(fmt.size() < 28 || !fmt.startsWith("WAVEfmt ")) {
+  const ByteVector fmtData = file->readBlock(FormatChunk::size);
+  const Layout::View<FormatChunk> fmt(fmtData);
+  if(!fmt.isValid() || fmt.get<FormatChunk::ID>() != "WAVEfmt ") {
     debug("APE::Properties::analyzeOld() -- fmt header is too short.");
     return;
   }
 
-  d->bitsPerSample = fmt.toShort(26, false);
+  d->bitsPerSample = fmt.get<FormatChunk::BitsPerSample>();
 }
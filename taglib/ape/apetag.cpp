@@ -31,6 +31,8 @@
 #define WANT_CLASS_INSTANTIATION_OF_MAP (1)
 #endif
 
+#include <algorithm>
+
 #include <tfile.h>
 #include <tstring.h>
 #include <tmap.h>
@@ -41,6 +43,7 @@
 #include "apetag.h"
 #include "apefooter.h"
 #include "apeitem.h"
+#include "tagutils.h"
 
 using namespace TagLib;
 using namespace APE;
@@ -50,26 +53,59 @@ namespace
   const unsigned int MinKeyLength = 2;
   const unsigned int MaxKeyLength = 255;
 
-  bool isKeyValid(const ByteVector &key)
+  bool isKeyValid(const char *key, unsigned int length)
   {
     const char *invalidKeys[] = { "ID3", "TAG", "OGGS", "MP+", 0 };
 
     // only allow printable ASCII including space (32..126)
 
-    for(ByteVector::ConstIterator it = key.begin(); it != key.end(); ++it) {
-      const int c = static_cast<unsigned char>(*it);
+    for(unsigned int i = 0; i < length; ++i) {
+      const int c = static_cast<unsigned char>(key[i]);
       if(c < 32 || c > 126)
         return false;
     }
 
-    const String upperKey = String(key).upper();
+    // Compare case-insensitively without building an upper case copy of the key.
+
     for(size_t i = 0; invalidKeys[i] != 0; ++i) {
-      if(upperKey == invalidKeys[i])
+      unsigned int j = 0;
+      for(; j < length && invalidKeys[i][j] != '\0'; ++j) {
+        const char c = (key[j] >= 'a' && key[j] <= 'z') ? key[j] - 'a' + 'A' : key[j];
+        if(c != invalidKeys[i][j])
+          break;
+      }
+      if(j == length && invalidKeys[i][j] == '\0')
         return false;
     }
 
     return true;
   }
+
+  bool isKeyValid(const ByteVector &key)
+  {
+    return isKeyValid(key.data(), key.size());
+  }
+
+  // Copies the key folded to upper case into \a upper, which must hold
+  // length + 1 bytes, and returns whether any character was folded.
+
+  bool upperKey(const char *key, unsigned int length, char *upper)
+  {
+    bool folded = false;
+
+    for(unsigned int i = 0; i < length; ++i) {
+      if(key[i] >= 'a' && key[i] <= 'z') {
+        upper[i] = key[i] - 'a' + 'A';
+        folded = true;
+      }
+      else {
+        upper[i] = key[i];
+      }
+    }
+
+    upper[length] = '\0';
+    return folded;
+  }
 }
 
 class APE::Tag::TagPrivate
@@ -251,6 +287,8 @@ void APE::Tag::removeUnsupportedProperties(const StringList &properties)
 
 PropertyMap APE::Tag::setProperties(const PropertyMap &origProps)
 {
+  const Utils::PropertiesGuard<Tag> guard(this);
+
   PropertyMap properties(origProps); // make a local copy that can be modified
 
   // see comment in properties()
@@ -315,13 +353,23 @@ const APE::ItemListMap& APE::Tag::itemListMap() const
 
 void APE::Tag::removeItem(const String &key)
 {
-  d->itemListMap.erase(key.upper());
+  ItemListMap::Iterator it = d->itemListMap.find(key.upper());
+  if(it != d->itemListMap.end()) {
+    d->itemListMap.erase(it);
+    setModified();
+  }
 }
 
 void APE::Tag::addValue(const String &key, const String &value, bool replace)
 {
-  if(replace)
+  if(replace) {
+    ItemListMap::ConstIterator it = d->itemListMap.find(key.upper());
+    if(it != d->itemListMap.end() && it->second.type() == Item::Text &&
+       it->second.values() == StringList(value))
+      return;
+
     removeItem(key);
+  }
 
   if(value.isEmpty())
     return;
@@ -331,8 +379,10 @@ void APE::Tag::addValue(const String &key, const String &value, bool replace)
 
   ItemListMap::Iterator it = d->itemListMap.find(key.upper());
 
-  if(it != d->itemListMap.end() && it->second.type() == Item::Text)
+  if(it != d->itemListMap.end() && it->second.type() == Item::Text) {
     it->second.appendValue(value);
+    setModified();
+  }
   else
     setItem(key, Item(key, value));
 }
@@ -355,6 +405,7 @@ void APE::Tag::setItem(const String &key, const Item &item)
   }
 
   d->itemListMap[key.upper()] = item;
+  setModified();
 }
 
 bool APE::Tag::isEmpty() const
@@ -379,6 +430,7 @@ void APE::Tag::read()
 
     d->file->seek(d->footerLocation + Footer::size() - d->footer.tagSize());
     parse(d->file->readBlock(d->footer.tagSize() - Footer::size()));
+    setModified(false);
   }
 }
 
@@ -421,12 +473,22 @@ void APE::Tag::parse(const ByteVector &data)
 
     if(keyLength >= MinKeyLength
       && keyLength <= MaxKeyLength
-      && isKeyValid(data.mid(pos + 8, keyLength)))
+      && isKeyValid(data.data() + pos + 8, keyLength))
     {
+      // Hand the item a view bounded to its own bytes.  Binary values such as
+      // cover art stay shared with the tag data and are not copied here.
+
       APE::Item item;
-      item.parse(data.mid(pos));
+      item.parse(data.mid(pos, keyLength + 9 + std::min(valLegnth, data.size() - pos)));
+
+      // The map key is built from the key bytes folded on the stack.  Keys
+      // which are already upper case share the string of the item.
 
-      d->itemListMap.insert(item.key().upper(), item);
+      char key[MaxKeyLength + 1];
+      if(upperKey(data.data() + pos + 8, keyLength, key))
+        d->itemListMap[String(key, String::Latin1)].swap(item);
+      else
+        d->itemListMap[item.key()].swap(item);
     }
     else {
       debug("APE::Tag::parse() - Skipped an item due to an invalid key.");
@@ -23,8 +23,13 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tbytevectorlist.h>
+#include <tbytevectorbuilder.h>
 #include <tpropertymap.h>
 #include <tstring.h>
 #include <tagutils.h>
@@ -86,6 +91,7 @@ public:
 namespace
 {
   const ByteVector headerGuid("\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16);
+  const ByteVector dataGuid("\x36\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16);
   const ByteVector filePropertiesGuid("\xA1\xDC\xAB\x8C\x47\xA9\xCF\x11\x8E\xE4\x00\xC0\x0C\x20\x53\x65", 16);
   const ByteVector streamPropertiesGuid("\x91\x07\xDC\xB7\xB7\xA9\xCF\x11\x8E\xE6\x00\xC0\x0C\x20\x53\x65", 16);
   const ByteVector contentDescriptionGuid("\x33\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16);
@@ -106,7 +112,11 @@ public:
   virtual ~BaseObject() {}
   virtual ByteVector guid() const = 0;
   virtual void parse(ASF::File *file, unsigned int size);
-  virtual ByteVector render(ASF::File *file);
+  virtual void render(ASF::File *file, ByteVectorBuilder &out);
+
+protected:
+  unsigned int beginRender(ByteVectorBuilder &out) const;
+  void endRender(ByteVectorBuilder &out, unsigned int offset) const;
 };
 
 class ASF::File::FilePrivate::UnknownObject : public ASF::File::FilePrivate::BaseObject
@@ -136,7 +146,7 @@ class ASF::File::FilePrivate::ContentDescriptionObject : public ASF::File::FileP
 public:
   ByteVector guid() const;
   void parse(ASF::File *file, unsigned int size);
-  ByteVector render(ASF::File *file);
+  void render(ASF::File *file, ByteVectorBuilder &out);
 };
 
 class ASF::File::FilePrivate::ExtendedContentDescriptionObject : public ASF::File::FilePrivate::BaseObject
@@ -145,7 +155,7 @@ public:
   ByteVectorList attributeData;
   ByteVector guid() const;
   void parse(ASF::File *file, unsigned int size);
-  ByteVector render(ASF::File *file);
+  void render(ASF::File *file, ByteVectorBuilder &out);
 };
 
 class ASF::File::FilePrivate::MetadataObject : public ASF::File::FilePrivate::BaseObject
@@ -154,7 +164,7 @@ public:
   ByteVectorList attributeData;
   ByteVector guid() const;
   void parse(ASF::File *file, unsigned int size);
-  ByteVector render(ASF::File *file);
+  void render(ASF::File *file, ByteVectorBuilder &out);
 };
 
 class ASF::File::FilePrivate::MetadataLibraryObject : public ASF::File::FilePrivate::BaseObject
@@ -163,7 +173,7 @@ public:
   ByteVectorList attributeData;
   ByteVector guid() const;
   void parse(ASF::File *file, unsigned int size);
-  ByteVector render(ASF::File *file);
+  void render(ASF::File *file, ByteVectorBuilder &out);
 };
 
 class ASF::File::FilePrivate::HeaderExtensionObject : public ASF::File::FilePrivate::BaseObject
@@ -173,7 +183,7 @@ public:
   HeaderExtensionObject();
   ByteVector guid() const;
   void parse(ASF::File *file, unsigned int size);
-  ByteVector render(ASF::File *file);
+  void render(ASF::File *file, ByteVectorBuilder &out);
 };
 
 class ASF::File::FilePrivate::CodecListObject : public ASF::File::FilePrivate::BaseObject
@@ -200,9 +210,27 @@ void ASF::File::FilePrivate::BaseObject::parse(ASF::File *file, unsigned int siz
     data = ByteVector();
 }
 
-ByteVector ASF::File::FilePrivate::BaseObject::render(ASF::File * /*file*/)
+void ASF::File::FilePrivate::BaseObject::render(ASF::File * /*file*/, ByteVectorBuilder &out)
+{
+  const unsigned int object = beginRender(out);
+  out.append(data);
+  endRender(out, object);
+}
+
+unsigned int ASF::File::FilePrivate::BaseObject::beginRender(ByteVectorBuilder &out) const
 {
-  return guid() + ByteVector::fromLongLong(data.size() + 24, false) + data;
+  // The size of the object is patched by endRender() once its contents have
+  // been appended.
+
+  const unsigned int offset = out.size();
+  out.append(guid());
+  out.appendPlaceholder(8);
+  return offset;
+}
+
+void ASF::File::FilePrivate::BaseObject::endRender(ByteVectorBuilder &out, unsigned int offset) const
+{
+  out.setLongLong(offset + 16, out.size() - offset, false);
 }
 
 ASF::File::FilePrivate::UnknownObject::UnknownObject(const ByteVector &guid) : myGuid(guid)
@@ -271,7 +299,7 @@ void ASF::File::FilePrivate::ContentDescriptionObject::parse(ASF::File *file, un
   file->d->tag->setRating(readString(file,ratingLength));
 }
 
-ByteVector ASF::File::FilePrivate::ContentDescriptionObject::render(ASF::File *file)
+void ASF::File::FilePrivate::ContentDescriptionObject::render(ASF::File *file, ByteVectorBuilder &out)
 {
   const ByteVector v1 = renderString(file->d->tag->title());
   const ByteVector v2 = renderString(file->d->tag->artist());
@@ -289,7 +317,7 @@ ByteVector ASF::File::FilePrivate::ContentDescriptionObject::render(ASF::File *f
   data.append(v3);
   data.append(v4);
   data.append(v5);
-  return BaseObject::render(file);
+  BaseObject::render(file, out);
 }
 
 ByteVector ASF::File::FilePrivate::ExtendedContentDescriptionObject::guid() const
@@ -307,12 +335,13 @@ void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *
   }
 }
 
-ByteVector ASF::File::FilePrivate::ExtendedContentDescriptionObject::render(ASF::File *file)
+void ASF::File::FilePrivate::ExtendedContentDescriptionObject::render(ASF::File * /*file*/, ByteVectorBuilder &out)
 {
-  data.clear();
-  data.append(ByteVector::fromShort(attributeData.size(), false));
-  data.append(attributeData.toByteVector(""));
-  return BaseObject::render(file);
+  const unsigned int object = beginRender(out);
+  out.append(ByteVector::fromShort(attributeData.size(), false));
+  for(ByteVectorList::ConstIterator it = attributeData.begin(); it != attributeData.end(); ++it)
+    out.append(*it);
+  endRender(out, object);
 }
 
 ByteVector ASF::File::FilePrivate::MetadataObject::guid() const
@@ -330,12 +359,13 @@ void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, unsigned int
   }
 }
 
-ByteVector ASF::File::FilePrivate::MetadataObject::render(ASF::File *file)
+void ASF::File::FilePrivate::MetadataObject::render(ASF::File * /*file*/, ByteVectorBuilder &out)
 {
-  data.clear();
-  data.append(ByteVector::fromShort(attributeData.size(), false));
-  data.append(attributeData.toByteVector(""));
-  return BaseObject::render(file);
+  const unsigned int object = beginRender(out);
+  out.append(ByteVector::fromShort(attributeData.size(), false));
+  for(ByteVectorList::ConstIterator it = attributeData.begin(); it != attributeData.end(); ++it)
+    out.append(*it);
+  endRender(out, object);
 }
 
 ByteVector ASF::File::FilePrivate::MetadataLibraryObject::guid() const
@@ -353,12 +383,13 @@ void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, unsig
   }
 }
 
-ByteVector ASF::File::FilePrivate::MetadataLibraryObject::render(ASF::File *file)
+void ASF::File::FilePrivate::MetadataLibraryObject::render(ASF::File * /*file*/, ByteVectorBuilder &out)
 {
-  data.clear();
-  data.append(ByteVector::fromShort(attributeData.size(), false));
-  data.append(attributeData.toByteVector(""));
-  return BaseObject::render(file);
+  const unsigned int object = beginRender(out);
+  out.append(ByteVector::fromShort(attributeData.size(), false));
+  for(ByteVectorList::ConstIterator it = attributeData.begin(); it != attributeData.end(); ++it)
+    out.append(*it);
+  endRender(out, object);
 }
 
 ASF::File::FilePrivate::HeaderExtensionObject::HeaderExtensionObject()
@@ -406,14 +437,16 @@ void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, unsig
   }
 }
 
-ByteVector ASF::File::FilePrivate::HeaderExtensionObject::render(ASF::File *file)
+void ASF::File::FilePrivate::HeaderExtensionObject::render(ASF::File *file, ByteVectorBuilder &out)
 {
-  data.clear();
+  const unsigned int object = beginRender(out);
+  out.append(ByteVector("\x11\xD2\xD3\xAB\xBA\xA9\xcf\x11\x8E\xE6\x00\xC0\x0C\x20\x53\x65\x06\x00", 18));
+  const unsigned int dataSize = out.appendPlaceholder(4);
   for(List<BaseObject *>::ConstIterator it = objects.begin(); it != objects.end(); ++it) {
-    data.append((*it)->render(file));
+    (*it)->render(file, out);
   }
-  data = ByteVector("\x11\xD2\xD3\xAB\xBA\xA9\xcf\x11\x8E\xE6\x00\xC0\x0C\x20\x53\x65\x06\x00", 18) + ByteVector::fromUInt(data.size(), false) + data;
-  return BaseObject::render(file);
+  out.setUInt(dataSize, out.size() - dataSize - 4, false);
+  endRender(out, object);
 }
 
 ByteVector ASF::File::FilePrivate::CodecListObject::guid() const
@@ -535,6 +568,9 @@ ASF::Properties *ASF::File::audioProperties() const
 
 bool ASF::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("ASF::File::save() -- File is read only.");
     return false;
@@ -600,11 +636,13 @@ bool ASF::File::save()
     }
   }
 
-  ByteVector data;
+  ByteVectorBuilder out;
   for(List<FilePrivate::BaseObject *>::ConstIterator it = d->objects.begin(); it != d->objects.end(); ++it) {
-    data.append((*it)->render(this));
+    (*it)->render(this, out);
   }
 
+  const ByteVector data = out.toByteVector();
+
   seek(16);
   writeBlock(ByteVector::fromLongLong(data.size() + 30, false));
   writeBlock(ByteVector::fromUInt(d->objects.size(), false));
@@ -617,12 +655,42 @@ bool ASF::File::save()
   return true;
 }
 
+File::RangeList ASF::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  // The data object follows the header object.  Its own header (GUID, size,
+  // file ID, packet count and reserved bytes) is 50 bytes long.
+
+  seek(static_cast<long>(d->headerSize));
+  if(readBlock(16) != dataGuid) {
+    debug("ASF::File::audioDataRanges() -- Data object not found.");
+    return RangeList();
+  }
+
+  bool ok;
+  const long long size = readQWORD(this, &ok);
+  if(!ok || size <= 50)
+    return RangeList();
+
+  const long long start = d->headerSize + 50;
+  const long long end = std::min<long long>(d->headerSize + size, length());
+
+  RangeList ranges;
+  if(end > start)
+    ranges.append(Range(static_cast<long>(start), static_cast<long>(end - start)));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void ASF::File::read()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   if(!isValid())
     return;
 
@@ -697,6 +765,8 @@ void ASF::File::read()
     d->objects.append(obj);
   }
 
+  d->tag->setModified(false);
+
   if(!filePropertiesObject || !streamPropertiesObject) {
     debug("ASF::File::read(): Missing mandatory header objects.");
     setValid(false);
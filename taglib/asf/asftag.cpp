@@ -25,6 +25,7 @@
 
 #include <tpropertymap.h>
 #include "asftag.h"
+#include "tagutils.h"
 
 using namespace TagLib;
 
@@ -113,26 +114,31 @@ String ASF::Tag::genre() const
 void ASF::Tag::setTitle(const String &value)
 {
   d->title = value;
+  setModified();
 }
 
 void ASF::Tag::setArtist(const String &value)
 {
   d->artist = value;
+  setModified();
 }
 
 void ASF::Tag::setCopyright(const String &value)
 {
   d->copyright = value;
+  setModified();
 }
 
 void ASF::Tag::setComment(const String &value)
 {
   d->comment = value;
+  setModified();
 }
 
 void ASF::Tag::setRating(const String &value)
 {
   d->rating = value;
+  setModified();
 }
 
 void ASF::Tag::setAlbum(const String &value)
@@ -157,6 +163,8 @@ void ASF::Tag::setTrack(unsigned int value)
 
 ASF::AttributeListMap& ASF::Tag::attributeListMap()
 {
+  // The attributes may be changed through the returned map.
+  setModified();
   return d->attributeListMap;
 }
 
@@ -172,7 +180,10 @@ bool ASF::Tag::contains(const String &key) const
 
 void ASF::Tag::removeItem(const String &key)
 {
-  d->attributeListMap.erase(key);
+  if(d->attributeListMap.contains(key)) {
+    d->attributeListMap.erase(key);
+    setModified();
+  }
 }
 
 ASF::AttributeList ASF::Tag::attribute(const String &name) const
@@ -185,17 +196,20 @@ void ASF::Tag::setAttribute(const String &name, const Attribute &attribute)
   AttributeList value;
   value.append(attribute);
   d->attributeListMap.insert(name, value);
+  setModified();
 }
 
 void ASF::Tag::setAttribute(const String &name, const AttributeList &values)
 {
   d->attributeListMap.insert(name, values);
+  setModified();
 }
 
 void ASF::Tag::addAttribute(const String &name, const Attribute &attribute)
 {
   if(d->attributeListMap.contains(name)) {
     d->attributeListMap[name].append(attribute);
+    setModified();
   }
   else {
     setAttribute(name, attribute);
@@ -311,11 +325,13 @@ void ASF::Tag::removeUnsupportedProperties(const StringList &props)
 {
   StringList::ConstIterator it = props.begin();
   for(; it != props.end(); ++it)
-    d->attributeListMap.erase(*it);
+    removeItem(*it);
 }
 
 PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
 {
+  const Utils::PropertiesGuard<Tag> guard(this);
+
   static Map<String, String> reverseKeyMap;
   if(reverseKeyMap.isEmpty()) {
     int numKeys = sizeof(keyTranslation) / sizeof(keyTranslation[0]);
@@ -374,5 +390,6 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
     }
   }
 
+  setModified();
   return ignoredProps;
 }
@@ -88,18 +88,20 @@ unsigned int DSDIFF::DIIN::Tag::track() const
 
 void DSDIFF::DIIN::Tag::setTitle(const String &title)
 {
-  if(title.isNull() || title.isEmpty())
-    d->title = String();
-  else
-    d->title = title;
+  const String value = title.isEmpty() ? String() : title;
+  if(d->title != value) {
+    d->title = value;
+    setModified();
+  }
 }
 
 void DSDIFF::DIIN::Tag::setArtist(const String &artist)
 {
-  if(artist.isNull() || artist.isEmpty())
-    d->artist = String();
-  else
-    d->artist = artist;
+  const String value = artist.isEmpty() ? String() : artist;
+  if(d->artist != value) {
+    d->artist = value;
+    setModified();
+  }
 }
 
 void DSDIFF::DIIN::Tag::setAlbum(const String &)
@@ -137,16 +139,16 @@ PropertyMap DSDIFF::DIIN::Tag::setProperties(const PropertyMap &origProps)
   StringList oneValueSet;
 
   if(properties.contains("TITLE")) {
-    d->title = properties["TITLE"].front();
+    setTitle(properties["TITLE"].front());
     oneValueSet.append("TITLE");
   } else
-    d->title = String();
+    setTitle(String());
 
   if(properties.contains("ARTIST")) {
-    d->artist = properties["ARTIST"].front();
+    setArtist(properties["ARTIST"].front());
     oneValueSet.append("ARTIST");
   } else
-    d->artist = String();
+    setArtist(String());
 
   // for each tag that has been set above, remove the first entry in the corresponding
   // value list. The others will be returned as unsupported by this format.
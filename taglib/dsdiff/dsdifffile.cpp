@@ -25,6 +25,8 @@
 
 #include <tbytevector.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <id3v2tag.h>
 #include <tstringlist.h>
 #include <tpropertymap.h>
@@ -119,8 +121,10 @@ DSDIFF::File::File(FileName file, bool readProperties,
 {
   d = new FilePrivate;
   d->endianness = BigEndian;
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties, propertiesStyle);
+    d->tag.setModified(false);
+  }
 }
 
 DSDIFF::File::File(IOStream *stream, bool readProperties,
@@ -128,8 +132,10 @@ DSDIFF::File::File(IOStream *stream, bool readProperties,
 {
   d = new FilePrivate;
   d->endianness = BigEndian;
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties, propertiesStyle);
+    d->tag.setModified(false);
+  }
 }
 
 DSDIFF::File::~File()
@@ -162,6 +168,21 @@ bool DSDIFF::File::hasDIINTag() const
   return d->hasDiin;
 }
 
+File::RangeList DSDIFF::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  RangeList ranges;
+
+  for(unsigned int i = 0; i < d->chunks.size(); i++) {
+    if(d->chunks[i].name == "DSD " || d->chunks[i].name == "DST ")
+      ranges.append(Range(static_cast<long>(d->chunks[i].offset), static_cast<long>(d->chunks[i].size)));
+  }
+
+  return ranges;
+}
+
 PropertyMap DSDIFF::File::properties() const
 {
   if(d->hasID3v2)
@@ -191,6 +212,9 @@ DSDIFF::Properties *DSDIFF::File::audioProperties() const
 
 bool DSDIFF::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("DSDIFF::File::save() -- File is read only.");
     return false;
@@ -506,6 +530,8 @@ void DSDIFF::File::updateRootChunksStructure(unsigned int startingChunk)
 
 void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   bool bigEndian = (d->endianness == BigEndian);
 
   d->type = readBlock(4);
@@ -762,6 +788,8 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
   }
 
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
+
     if(lengthDSDSamplesTimeChannels == 0) {
       // DST compressed signal : need to compute length of DSD uncompressed frames
       if(dstFrameRate > 0)
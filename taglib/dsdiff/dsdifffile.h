@@ -194,6 +194,13 @@ namespace TagLib {
        */
        static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns the ranges of the file which hold the audio data.
+       *
+       * \see TagLib::File::audioDataRanges()
+       */
+      RangeList audioDataRanges();
+
     protected:
       enum Endianness { BigEndian, LittleEndian };
 
@@ -25,6 +25,8 @@
 
 #include <tbytevector.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <id3v2tag.h>
 #include <tstringlist.h>
 #include <tpropertymap.h>
@@ -117,6 +119,9 @@ DSF::Properties *DSF::File::audioProperties() const
 
 bool DSF::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("DSF::File::save() -- File is read only.");
     return false;
@@ -173,6 +178,31 @@ bool DSF::File::save()
   return true;
 }
 
+File::RangeList DSF::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  // The data chunk follows the 28 byte DSD chunk and the format chunk.
+
+  seek(28 + 4);
+  const long long dataOffset = 28 + readBlock(8).toLongLong(false);
+
+  seek(dataOffset);
+  if(readBlock(4) != "data") {
+    debug("DSF::File::audioDataRanges() -- Missing 'data' chunk.");
+    return RangeList();
+  }
+
+  const long long dataSize = readBlock(8).toLongLong(false) - 12;
+  const long long end = d->metadataOffset ? d->metadataOffset : d->fileSize;
+
+  RangeList ranges;
+  if(dataSize > 0 && dataOffset + 12 + dataSize <= end)
+    ranges.append(Range(static_cast<long>(dataOffset + 12), static_cast<long>(dataSize)));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,6 +210,8 @@ bool DSF::File::save()
 
 void DSF::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // A DSF file consists of four chunks: DSD chunk, format chunk, data chunk, and metadata chunk
   // The file format is not chunked in the sense of a RIFF File, though
 
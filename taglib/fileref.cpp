@@ -29,8 +29,10 @@
 
 #include <tfile.h>
 #include <tfilestream.h>
+#include <tinstrumentedstream.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <ttrace.h>
 #include <trefcounter.h>
 
 #include "fileref.h"
@@ -145,44 +147,54 @@ namespace
     return 0;
   }
 
+  // Checks if the stream is supported by a file type, counting the I/O as detection.
+
+  bool probe(bool (*isSupported)(IOStream *), IOStream *stream)
+  {
+    InstrumentedStream::PhaseScope scope(stream, IOStatistics::Detection);
+    return isSupported(stream);
+  }
+
   // Detect the file type based on the actual content of the stream.
 
   File *detectByContent(IOStream *stream, bool readAudioProperties,
                         AudioProperties::ReadStyle audioPropertiesStyle)
   {
+    TAGLIB_TRACE("FileRef::detectByContent");
+
     File *file = 0;
 
-    if(MPEG::File::isSupported(stream))
+    if(probe(MPEG::File::isSupported, stream))
       file = new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Vorbis::File::isSupported(stream))
+    else if(probe(Ogg::Vorbis::File::isSupported, stream))
       file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::FLAC::File::isSupported(stream))
+    else if(probe(Ogg::FLAC::File::isSupported, stream))
       file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(FLAC::File::isSupported(stream))
+    else if(probe(FLAC::File::isSupported, stream))
       file = new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(MPC::File::isSupported(stream))
+    else if(probe(MPC::File::isSupported, stream))
       file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(WavPack::File::isSupported(stream))
+    else if(probe(WavPack::File::isSupported, stream))
       file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Speex::File::isSupported(stream))
+    else if(probe(Ogg::Speex::File::isSupported, stream))
       file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Opus::File::isSupported(stream))
+    else if(probe(Ogg::Opus::File::isSupported, stream))
       file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(TrueAudio::File::isSupported(stream))
+    else if(probe(TrueAudio::File::isSupported, stream))
       file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(MP4::File::isSupported(stream))
+    else if(probe(MP4::File::isSupported, stream))
       file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ASF::File::isSupported(stream))
+    else if(probe(ASF::File::isSupported, stream))
       file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::AIFF::File::isSupported(stream))
+    else if(probe(RIFF::AIFF::File::isSupported, stream))
       file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::WAV::File::isSupported(stream))
+    else if(probe(RIFF::WAV::File::isSupported, stream))
       file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(APE::File::isSupported(stream))
+    else if(probe(APE::File::isSupported, stream))
       file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(DSDIFF::File::isSupported(stream))
+    else if(probe(DSDIFF::File::isSupported, stream))
       file = new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(DSF::File::isSupported(stream))
+    else if(probe(DSF::File::isSupported, stream))
       file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
 
     // isSupported() only does a quick check, so double check the file here.
@@ -354,6 +366,14 @@ File *FileRef::file() const
   return d->file;
 }
 
+IOStatistics FileRef::ioStatistics() const
+{
+  if(!d->file)
+    return IOStatistics();
+
+  return d->file->ioStatistics();
+}
+
 bool FileRef::save()
 {
   if(isNull()) {
@@ -449,6 +469,8 @@ File *FileRef::create(FileName fileName, bool readAudioProperties,
 void FileRef::parse(FileName fileName, bool readAudioProperties,
                     AudioProperties::ReadStyle audioPropertiesStyle)
 {
+  TAGLIB_TRACE("FileRef::parse");
+
   // Try user-defined resolvers.
 
   d->file = detectByResolvers(fileName, readAudioProperties, audioPropertiesStyle);
@@ -477,6 +499,12 @@ void FileRef::parse(FileName fileName, bool readAudioProperties,
 void FileRef::parse(IOStream *stream, bool readAudioProperties,
                     AudioProperties::ReadStyle audioPropertiesStyle)
 {
+  TAGLIB_TRACE("FileRef::parse");
+
+  // Opening a file reads its tags, unless the file type is being probed.
+
+  InstrumentedStream::PhaseScope scope(stream, IOStatistics::TagParsing);
+
   // User-defined resolvers won't work with a stream.
 
   // Try to resolve file types based on the file extension.
@@ -196,6 +196,15 @@ namespace TagLib {
      */
     File *file() const;
 
+    /*!
+     * Returns the I/O counters of the file if it was opened from an
+     * InstrumentedStream, otherwise all the counters are zero.  I/O issued
+     * while detecting the file type is counted as IOStatistics::Detection.
+     *
+     * \see File::ioStatistics()
+     */
+    IOStatistics ioStatistics() const;
+
     /*!
      * Saves the file.  Returns true on success.
      */
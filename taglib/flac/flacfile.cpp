@@ -27,6 +27,9 @@
 #include <tstring.h>
 #include <tlist.h>
 #include <tdebug.h>
+#include <ttrace.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tagunion.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
@@ -55,6 +58,204 @@ namespace
   const long MaxPaddingLegnth = 1024 * 1024;
 
   const char LastBlockFlag = '\x80';
+
+  // The fields of the stream info needed to validate frame headers.
+
+  struct StreamInfo
+  {
+    unsigned int maxBlockSize;
+    unsigned int sampleRate;
+    unsigned int channels;
+    unsigned int bitsPerSample;
+  };
+
+  bool parseStreamInfo(const ByteVector &data, StreamInfo &info)
+  {
+    if(data.size() < 18)
+      return false;
+
+    const unsigned int flags = data.toUInt(10U, true);
+
+    info.maxBlockSize  = data.toUShort(2U, true);
+    info.sampleRate    = flags >> 12;
+    info.channels      = ((flags >> 9) &  7) + 1;
+    info.bitsPerSample = ((flags >> 4) & 31) + 1;
+
+    return info.maxBlockSize > 0 && info.sampleRate > 0;
+  }
+
+  // The fields of a frame header needed to count the samples before its end.
+
+  struct FrameHeader
+  {
+    bool variableBlockSize;
+    unsigned long long number;
+    unsigned int blockSize;
+  };
+
+  // The sync code, 7 bytes of coded number, 2 of block size, 2 of sample
+  // rate and the CRC.
+
+  const unsigned int MaxFrameHeaderLength = 4 + 7 + 2 + 2 + 1;
+
+  // CRC-8 with the polynomial x^8 + x^2 + x + 1, which protects frame headers.
+
+  unsigned char crc8(const ByteVector &data, unsigned int offset, unsigned int length)
+  {
+    unsigned char crc = 0;
+    for(unsigned int i = offset; i < offset + length; ++i) {
+      crc ^= static_cast<unsigned char>(data[i]);
+      for(int bit = 0; bit < 8; ++bit)
+        crc = static_cast<unsigned char>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+    return crc;
+  }
+
+  // Parses the frame header at offset of data, which starts with the sync
+  // code.  Returns false if it is not a valid header of the stream described
+  // by info, so that false syncs in the audio data are skipped.
+
+  bool parseFrameHeader(const ByteVector &data, unsigned int offset, const StreamInfo &info,
+                        FrameHeader &header)
+  {
+    static const unsigned int sampleRates[] = {
+      0, 88200, 176400, 192000, 8000, 16000, 22050, 24000, 32000, 44100, 48000, 96000
+    };
+    static const unsigned int sampleSizes[] = { 0, 8, 12, 0, 16, 20, 24, 32 };
+
+    if(offset + 5 > data.size())
+      return false;
+
+    const unsigned char blockSizeCode  = static_cast<unsigned char>(data[offset + 2]) >> 4;
+    const unsigned char sampleRateCode = static_cast<unsigned char>(data[offset + 2]) & 0x0F;
+    const unsigned char channelCode    = static_cast<unsigned char>(data[offset + 3]) >> 4;
+    const unsigned char sampleSizeCode = (static_cast<unsigned char>(data[offset + 3]) >> 1) & 0x07;
+
+    if(blockSizeCode == 0 || sampleRateCode == 15 || channelCode > 10 || sampleSizeCode == 3 ||
+       (data[offset + 3] & 0x01) != 0)
+      return false;
+
+    // The frame or sample number, coded like UTF-8 up to 36 bits.
+
+    header.variableBlockSize = (data[offset + 1] & 0x01) != 0;
+
+    unsigned int pos = offset + 4;
+    const unsigned char first = static_cast<unsigned char>(data[pos++]);
+
+    unsigned int extraBytes;
+    if(first < 0x80) {
+      extraBytes = 0;
+      header.number = first;
+    }
+    else if(first >= 0xC0 && first < 0xFF) {
+      extraBytes = 1;
+      while(extraBytes < 6 && (first & (0x40 >> extraBytes)))
+        ++extraBytes;
+      header.number = first & (0x3F >> extraBytes);
+    }
+    else {
+      return false;
+    }
+
+    if(pos + extraBytes > data.size())
+      return false;
+
+    for(unsigned int i = 0; i < extraBytes; ++i) {
+      const unsigned char c = static_cast<unsigned char>(data[pos++]);
+      if((c & 0xC0) != 0x80)
+        return false;
+      header.number = (header.number << 6) | (c & 0x3F);
+    }
+
+    if(blockSizeCode == 1)
+      header.blockSize = 192;
+    else if(blockSizeCode <= 5)
+      header.blockSize = 576 << (blockSizeCode - 2);
+    else if(blockSizeCode == 6 && pos + 1 <= data.size())
+      header.blockSize = static_cast<unsigned char>(data[pos++]) + 1;
+    else if(blockSizeCode == 7 && pos + 2 <= data.size()) {
+      header.blockSize = data.toUShort(pos, true) + 1;
+      pos += 2;
+    }
+    else if(blockSizeCode >= 8)
+      header.blockSize = 256 << (blockSizeCode - 8);
+    else
+      return false;
+
+    unsigned int sampleRate;
+    if(sampleRateCode == 0)
+      sampleRate = info.sampleRate;
+    else if(sampleRateCode < 12)
+      sampleRate = sampleRates[sampleRateCode];
+    else if(sampleRateCode == 12 && pos + 1 <= data.size())
+      sampleRate = static_cast<unsigned char>(data[pos++]) * 1000;
+    else if(sampleRateCode >= 13 && pos + 2 <= data.size()) {
+      sampleRate = data.toUShort(pos, true) * (sampleRateCode == 14 ? 10 : 1);
+      pos += 2;
+    }
+    else
+      return false;
+
+    if(pos + 1 > data.size() || crc8(data, offset, pos - offset) != static_cast<unsigned char>(data[pos]))
+      return false;
+
+    const unsigned int channels = channelCode < 8 ? channelCode + 1 : 2;
+    const unsigned int bitsPerSample = sampleSizeCode == 0 ? info.bitsPerSample : sampleSizes[sampleSizeCode];
+
+    return header.blockSize <= info.maxBlockSize && sampleRate == info.sampleRate &&
+           channels == info.channels && bitsPerSample == info.bitsPerSample;
+  }
+
+  // A metadata block which is not parsed, such as a seek table or application
+  // data.  It is read only when it has to be written back by save().  Its
+  // offset is relative to the start of the metadata, which moves when save()
+  // resizes the ID3v2 tag in front of it.
+
+  class DeferredMetadataBlock : public FLAC::MetadataBlock
+  {
+  public:
+    DeferredMetadataBlock(File *file, const long &start, int code, long offset,
+                          unsigned int length) :
+      m_file(file),
+      m_start(start),
+      m_code(code),
+      m_offset(offset),
+      m_length(length),
+      m_loaded(false) {}
+
+    int code() const
+    {
+      return m_code;
+    }
+
+    ByteVector render() const
+    {
+      load();
+      return m_data;
+    }
+
+    // Reads the block if it has not been read yet.  Returns false if it could
+    // not be read completely, e.g. because the file has been truncated.
+
+    bool load() const
+    {
+      if(!m_loaded) {
+        m_file->seek(m_start + m_offset);
+        m_data = m_file->readBlock(m_length);
+        m_loaded = true;
+      }
+      return m_data.size() == m_length;
+    }
+
+  private:
+    File *const m_file;
+    const long &m_start;
+    const int m_code;
+    const long m_offset;
+    const unsigned int m_length;
+    mutable ByteVector m_data;
+    mutable bool m_loaded;
+  };
 }
 
 class FLAC::File::FilePrivate
@@ -68,7 +269,8 @@ public:
     properties(0),
     flacStart(0),
     streamStart(0),
-    scanned(false)
+    scanned(false),
+    blocksModified(false)
   {
     blocks.setAutoDelete(true);
   }
@@ -93,6 +295,7 @@ public:
   long flacStart;
   long streamStart;
   bool scanned;
+  bool blocksModified;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,7 +306,7 @@ bool FLAC::File::isSupported(IOStream *stream)
 {
   // A FLAC file has an ID "fLaC" somewhere. An ID3v2 tag may precede.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), true);
   return (buffer.find("fLaC") >= 0);
 }
 
@@ -111,30 +314,30 @@ bool FLAC::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-FLAC::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+FLAC::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 FLAC::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(stream),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 FLAC::File::~File()
@@ -169,6 +372,9 @@ FLAC::Properties *FLAC::File::audioProperties() const
 
 bool FLAC::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("FLAC::File::save() - Cannot save to a read only file.");
     return false;
@@ -179,128 +385,174 @@ bool FLAC::File::save()
     return false;
   }
 
+  // The metadata blocks are not written again if the comment and the
+  // pictures are unchanged since they were read or saved.
+
+  bool blocksModified = !hasXiphComment() || d->blocksModified;
+
   // Create new vorbis comments
   if(!hasXiphComment())
     Tag::duplicate(&d->tag, xiphComment(true), false);
 
-  d->xiphCommentData = xiphComment()->render(false);
+  if(xiphComment()->isModified())
+    blocksModified = true;
 
-  // Replace metadata blocks
+  for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+    const Picture *picture = dynamic_cast<const Picture *>(*it);
+    if(picture && picture->isModified())
+      blocksModified = true;
+  }
 
-  for(BlockIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
-    if((*it)->code() == MetadataBlock::VorbisComment) {
-      // Set the new Vorbis Comment block
-      delete *it;
-      d->blocks.erase(it);
-      break;
+  if(blocksModified) {
+
+    // The blocks which were not read by scan() are written back, so they have
+    // to be read completely before anything is changed.
+
+    for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+      const DeferredMetadataBlock *block = dynamic_cast<const DeferredMetadataBlock *>(*it);
+      if(block && !block->load()) {
+        debug("FLAC::File::save() -- Failed to read a metadata block.");
+        return false;
+      }
     }
-  }
 
-  d->blocks.append(new UnknownMetadataBlock(MetadataBlock::VorbisComment, d->xiphCommentData));
+    d->xiphCommentData = xiphComment()->render(false);
 
-  // Render data for the metadata blocks
+    // Replace metadata blocks
 
-  ByteVector data;
-  for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
-    ByteVector blockData = (*it)->render();
-    ByteVector blockHeader = ByteVector::fromUInt(blockData.size());
-    blockHeader[0] = (*it)->code();
-    data.append(blockHeader);
-    data.append(blockData);
-  }
+    for(BlockIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+      if((*it)->code() == MetadataBlock::VorbisComment) {
+        // Set the new Vorbis Comment block
+        delete *it;
+        d->blocks.erase(it);
+        break;
+      }
+    }
 
-  // Compute the amount of padding, and append that to data.
+    d->blocks.append(new UnknownMetadataBlock(MetadataBlock::VorbisComment, d->xiphCommentData));
 
-  long originalLength = d->streamStart - d->flacStart;
-  long paddingLength = originalLength - data.size() - 4;
+    // Render data for the metadata blocks
 
-  if(paddingLength <= 0) {
-    paddingLength = MinPaddingLength;
-  }
-  else {
-    // Padding won't increase beyond 1% of the file size or 1MB.
+    ByteVector data;
+    for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+      ByteVector blockData = (*it)->render();
+      ByteVector blockHeader = ByteVector::fromUInt(blockData.size());
+      blockHeader[0] = (*it)->code();
+      data.append(blockHeader);
+      data.append(blockData);
+    }
+
+    // Compute the amount of padding, and append that to data.
 
-    long threshold = length() / 100;
-    threshold = std::max(threshold, MinPaddingLength);
-    threshold = std::min(threshold, MaxPaddingLegnth);
+    long originalLength = d->streamStart - d->flacStart;
+    long paddingLength = originalLength - data.size() - 4;
 
-    if(paddingLength > threshold)
+    if(paddingLength <= 0) {
       paddingLength = MinPaddingLength;
-  }
+    }
+    else {
+      // Padding won't increase beyond 1% of the file size or 1MB.
 
-  ByteVector paddingHeader = ByteVector::fromUInt(paddingLength);
-  paddingHeader[0] = static_cast<char>(MetadataBlock::Padding | LastBlockFlag);
-  data.append(paddingHeader);
-  data.resize(static_cast<unsigned int>(data.size() + paddingLength));
+      long threshold = length() / 100;
+      threshold = std::max(threshold, MinPaddingLength);
+      threshold = std::min(threshold, MaxPaddingLegnth);
 
-  // Write the data to the file
+      if(paddingLength > threshold)
+        paddingLength = MinPaddingLength;
+    }
 
-  insert(data, d->flacStart, originalLength);
+    ByteVector paddingHeader = ByteVector::fromUInt(paddingLength);
+    paddingHeader[0] = static_cast<char>(MetadataBlock::Padding | LastBlockFlag);
+    data.append(paddingHeader);
+    data.resize(static_cast<unsigned int>(data.size() + paddingLength));
 
-  d->streamStart += (static_cast<long>(data.size()) - originalLength);
+    // Write the data to the file
 
-  if(d->ID3v1Location >= 0)
-    d->ID3v1Location += (static_cast<long>(data.size()) - originalLength);
+    insert(data, d->flacStart, originalLength);
 
-  // Update ID3 tags
+    d->streamStart += (static_cast<long>(data.size()) - originalLength);
 
-  if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
+    if(d->ID3v1Location >= 0)
+      d->ID3v1Location += (static_cast<long>(data.size()) - originalLength);
 
-    // ID3v2 tag is not empty. Update the old one or create a new one.
+    xiphComment()->setModified(false);
 
-    if(d->ID3v2Location < 0)
-      d->ID3v2Location = 0;
+    for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+      if(Picture *picture = dynamic_cast<Picture *>(*it))
+        picture->setModified(false);
+    }
 
-    data = ID3v2Tag()->render();
-    insert(data, d->ID3v2Location, d->ID3v2OriginalSize);
+    d->blocksModified = false;
+  }
 
-    d->flacStart   += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
-    d->streamStart += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
+  // Update ID3 tags, unless they are unchanged since they were read or saved
 
-    if(d->ID3v1Location >= 0)
-      d->ID3v1Location += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
+  const bool ID3v2Unchanged = d->ID3v2Location >= 0 && ID3v2Tag() && !ID3v2Tag()->isModified();
+  const bool ID3v1Unchanged = d->ID3v1Location >= 0 && ID3v1Tag() && !ID3v1Tag()->isModified();
 
-    d->ID3v2OriginalSize = data.size();
-  }
-  else {
+  if(!ID3v2Unchanged) {
+    if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
+
+      // ID3v2 tag is not empty. Update the old one or create a new one.
 
-    // ID3v2 tag is empty. Remove the old one.
+      if(d->ID3v2Location < 0)
+        d->ID3v2Location = 0;
 
-    if(d->ID3v2Location >= 0) {
-      removeBlock(d->ID3v2Location, d->ID3v2OriginalSize);
+      const ByteVector data = ID3v2Tag()->render();
+      insert(data, d->ID3v2Location, d->ID3v2OriginalSize);
+      ID3v2Tag()->setModified(false);
 
-      d->flacStart   -= d->ID3v2OriginalSize;
-      d->streamStart -= d->ID3v2OriginalSize;
+      d->flacStart   += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
+      d->streamStart += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
 
       if(d->ID3v1Location >= 0)
-        d->ID3v1Location -= d->ID3v2OriginalSize;
+        d->ID3v1Location += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
+
+      d->ID3v2OriginalSize = data.size();
+    }
+    else {
+
+      // ID3v2 tag is empty. Remove the old one.
+
+      if(d->ID3v2Location >= 0) {
+        removeBlock(d->ID3v2Location, d->ID3v2OriginalSize);
+
+        d->flacStart   -= d->ID3v2OriginalSize;
+        d->streamStart -= d->ID3v2OriginalSize;
 
-      d->ID3v2Location = -1;
-      d->ID3v2OriginalSize = 0;
+        if(d->ID3v1Location >= 0)
+          d->ID3v1Location -= d->ID3v2OriginalSize;
+
+        d->ID3v2Location = -1;
+        d->ID3v2OriginalSize = 0;
+      }
     }
   }
 
-  if(ID3v1Tag() && !ID3v1Tag()->isEmpty()) {
+  if(!ID3v1Unchanged) {
+    if(ID3v1Tag() && !ID3v1Tag()->isEmpty()) {
+
+      // ID3v1 tag is not empty. Update the old one or create a new one.
 
-    // ID3v1 tag is not empty. Update the old one or create a new one.
+      if(d->ID3v1Location >= 0) {
+        seek(d->ID3v1Location);
+      }
+      else {
+        seek(0, End);
+        d->ID3v1Location = tell();
+      }
 
-    if(d->ID3v1Location >= 0) {
-      seek(d->ID3v1Location);
+      writeBlock(ID3v1Tag()->render());
+      ID3v1Tag()->setModified(false);
     }
     else {
-      seek(0, End);
-      d->ID3v1Location = tell();
-    }
 
-    writeBlock(ID3v1Tag()->render());
-  }
-  else {
+      // ID3v1 tag is empty. Remove the old one.
 
-    // ID3v1 tag is empty. Remove the old one.
-
-    if(d->ID3v1Location >= 0) {
-      truncate(d->ID3v1Location);
-      d->ID3v1Location = -1;
+      if(d->ID3v1Location >= 0) {
+        truncate(d->ID3v1Location);
+        d->ID3v1Location = -1;
+      }
     }
   }
 
@@ -354,13 +606,16 @@ List<FLAC::Picture *> FLAC::File::pictureList()
 void FLAC::File::addPicture(Picture *picture)
 {
   d->blocks.append(picture);
+  d->blocksModified = true;
 }
 
 void FLAC::File::removePicture(Picture *picture, bool del)
 {
   BlockIterator it = d->blocks.find(picture);
-  if(it != d->blocks.end())
+  if(it != d->blocks.end()) {
     d->blocks.erase(it);
+    d->blocksModified = true;
+  }
 
   if(del)
     delete picture;
@@ -372,6 +627,7 @@ void FLAC::File::removePictures()
     if(dynamic_cast<Picture *>(*it)) {
       delete *it;
       it = d->blocks.erase(it);
+      d->blocksModified = true;
     }
     else {
       ++it;
@@ -408,12 +664,27 @@ bool FLAC::File::hasID3v2Tag() const
   return (d->ID3v2Location >= 0);
 }
 
+File::RangeList FLAC::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  const long end = (d->ID3v1Location >= 0) ? d->ID3v1Location : length();
+
+  RangeList ranges;
+  if(end > d->streamStart)
+    ranges.append(Range(d->streamStart, end - d->streamStart));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void FLAC::File::read(bool readProperties)
+void FLAC::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // Look for an ID3v2 tag
 
   d->ID3v2Location = Utils::findID3v2(this);
@@ -423,9 +694,13 @@ void FLAC::File::read(bool readProperties)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
+  // Look for the tags at the end of the file
+
+  const Utils::TrailingTags trailingTags = Utils::findTrailingTags(this);
+
   // Look for an ID3v1 tag
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->ID3v1Location = trailingTags.ID3v1Location;
 
   if(d->ID3v1Location >= 0)
     d->tag.set(FlacID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
@@ -443,24 +718,97 @@ void FLAC::File::read(bool readProperties)
     d->tag.set(FlacXiphIndex, new Ogg::XiphComment());
 
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
 
     // First block should be the stream_info metadata
 
     const ByteVector infoData = d->blocks.front()->render();
 
-    long streamLength;
+    const long streamLength = trailingTags.audioEnd - d->streamStart;
 
-    if(d->ID3v1Location >= 0)
-      streamLength = d->ID3v1Location - d->streamStart;
-    else
-      streamLength = length() - d->streamStart;
+    d->properties = new Properties(infoData, streamLength, readStyle);
 
-    d->properties = new Properties(infoData, streamLength);
+    // Streams written on the fly, e.g. by recorders, may not tell their
+    // number of samples.
+
+    if(readStyle == Properties::Accurate && d->properties->sampleFrames() == 0)
+      d->properties->setSampleFrames(countSampleFrames(infoData, trailingTags.audioEnd), streamLength);
   }
 }
 
+unsigned long long FLAC::File::countSampleFrames(const ByteVector &streamInfo, long streamEnd)
+{
+  TAGLIB_TRACE("FLAC::File::countSampleFrames");
+
+  StreamInfo info;
+  if(!parseStreamInfo(streamInfo, info))
+    return 0;
+
+  // The last seek point tells where the last frame is at the earliest.
+
+  long lowerBound = d->streamStart;
+  unsigned long long lowerSample = 0;
+
+  for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+    if((*it)->code() != MetadataBlock::SeekTable)
+      continue;
+
+    const ByteVector seekTable = (*it)->render();
+    for(unsigned int i = 0; i + 18 <= seekTable.size(); i += 18) {
+      const unsigned long long sample = seekTable.toLongLong(i, true);
+      const long long offset = seekTable.toLongLong(i + 8, true);
+      if(sample != 0xFFFFFFFFFFFFFFFFULL && offset >= 0 && offset < streamEnd - d->streamStart) {
+        lowerBound = std::max(lowerBound, d->streamStart + static_cast<long>(offset));
+        lowerSample = std::max(lowerSample, sample);
+      }
+    }
+  }
+
+  // Look for the last frame header from the end of the stream.
+
+  Budget *budget = this->budget();
+  unsigned int scanLength = scanBufferSize();
+  long position = streamEnd;
+
+  while(position > lowerBound) {
+    const long bufferLength = std::min<long>(position - lowerBound, scanLength);
+    position -= bufferLength;
+    scanLength = nextScanBufferSize(scanLength);
+
+    // Read the longest frame header past the block as well.
+
+    seek(position);
+    const ByteVector buffer = readBlock(bufferLength + MaxFrameHeaderLength);
+    if(buffer.isEmpty())
+      return 0;
+
+    for(int i = std::min<int>(bufferLength, buffer.size()) - 1; i >= 0; --i) {
+      if(static_cast<unsigned char>(buffer[i]) != 0xFF || i + 1 >= static_cast<int>(buffer.size()) ||
+         (static_cast<unsigned char>(buffer[i + 1]) & 0xFE) != 0xF8)
+        continue;
+
+      if(budget && !budget->addObject())
+        return 0;
+
+      FrameHeader header;
+      if(!parseFrameHeader(buffer, i, info, header))
+        continue;
+
+      const unsigned long long firstSample = header.variableBlockSize
+        ? header.number : header.number * info.maxBlockSize;
+
+      if(firstSample >= lowerSample)
+        return firstSample + header.blockSize;
+    }
+  }
+
+  return 0;
+}
+
 void FLAC::File::scan()
 {
+  TAGLIB_TRACE("FLAC::File::scan");
+
   // Scan the metadata pages
 
   if(d->scanned)
@@ -485,6 +833,8 @@ void FLAC::File::scan()
   nextBlockOffset += 4;
   d->flacStart = nextBlockOffset;
 
+  const long fileLength = length();
+
   while(true) {
 
     seek(nextBlockOffset);
@@ -522,8 +872,18 @@ void FLAC::File::scan()
       return;
     }
 
-    const ByteVector data = readBlock(blockLength);
-    if(data.size() != blockLength) {
+    // Only the blocks which are parsed are read.  The padding is skipped and
+    // the other blocks are read by save() if they have to be written back.
+
+    const bool isParsed = blockType == MetadataBlock::StreamInfo ||
+                          blockType == MetadataBlock::VorbisComment ||
+                          blockType == MetadataBlock::Picture;
+
+    ByteVector data;
+    if(isParsed)
+      data = readBlock(blockLength);
+
+    if(isParsed ? data.size() != blockLength : nextBlockOffset + 4 + blockLength > fileLength) {
       debug("FLAC::File::scan() -- Failed to read a metadata block");
       setValid(false);
       return;
@@ -554,9 +914,13 @@ void FLAC::File::scan()
     else if(blockType == MetadataBlock::Padding) {
       // Skip all padding blocks.
     }
-    else {
+    else if(blockType == MetadataBlock::StreamInfo) {
       block = new UnknownMetadataBlock(blockType, data);
     }
+    else {
+      block = new DeferredMetadataBlock(this, d->flacStart, blockType,
+                                        nextBlockOffset + 4 - d->flacStart, blockLength);
+    }
 
     if(block)
       d->blocks.append(block);
@@ -327,12 +327,20 @@ namespace TagLib {
        */
       static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns the ranges of the file which hold the audio data.
+       *
+       * \see TagLib::File::audioDataRanges()
+       */
+      RangeList audioDataRanges();
+
     private:
       File(const File &);
       File &operator=(const File &);
 
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle readStyle);
       void scan();
+      unsigned long long countSampleFrames(const ByteVector &streamInfo, long streamEnd);
 
       class FilePrivate;
       FilePrivate *d;
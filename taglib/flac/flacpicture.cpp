@@ -37,7 +37,8 @@ public:
     width(0),
     height(0),
     colorDepth(0),
-    numColors(0)
+    numColors(0),
+    modified(false)
     {}
 
   Type type;
@@ -48,6 +49,7 @@ public:
   int colorDepth;
   int numColors;
   ByteVector data;
+  bool modified;
 };
 
 FLAC::Picture::Picture() :
@@ -116,6 +118,16 @@ bool FLAC::Picture::parse(const ByteVector &data)
   return true;
 }
 
+bool FLAC::Picture::isModified() const
+{
+  return d->modified;
+}
+
+void FLAC::Picture::setModified(bool modified)
+{
+  d->modified = modified;
+}
+
 ByteVector FLAC::Picture::render() const
 {
   ByteVector result;
@@ -143,6 +155,7 @@ FLAC::Picture::Type FLAC::Picture::type() const
 void FLAC::Picture::setType(FLAC::Picture::Type type)
 {
   d->type = type;
+  d->modified = true;
 }
 
 String FLAC::Picture::mimeType() const
@@ -153,6 +166,7 @@ String FLAC::Picture::mimeType() const
 void FLAC::Picture::setMimeType(const String &mimeType)
 {
   d->mimeType = mimeType;
+  d->modified = true;
 }
 
 String FLAC::Picture::description() const
@@ -163,6 +177,7 @@ String FLAC::Picture::description() const
 void FLAC::Picture::setDescription(const String &description)
 {
   d->description = description;
+  d->modified = true;
 }
 
 int FLAC::Picture::width() const
@@ -173,6 +188,7 @@ int FLAC::Picture::width() const
 void FLAC::Picture::setWidth(int width)
 {
   d->width = width;
+  d->modified = true;
 }
 
 int FLAC::Picture::height() const
@@ -183,6 +199,7 @@ int FLAC::Picture::height() const
 void FLAC::Picture::setHeight(int height)
 {
   d->height = height;
+  d->modified = true;
 }
 
 int FLAC::Picture::colorDepth() const
@@ -193,6 +210,7 @@ int FLAC::Picture::colorDepth() const
 void FLAC::Picture::setColorDepth(int colorDepth)
 {
   d->colorDepth = colorDepth;
+  d->modified = true;
 }
 
 int FLAC::Picture::numColors() const
@@ -203,6 +221,7 @@ int FLAC::Picture::numColors() const
 void FLAC::Picture::setNumColors(int numColors)
 {
   d->numColors = numColors;
+  d->modified = true;
 }
 
 ByteVector FLAC::Picture::data() const
@@ -213,5 +232,6 @@ ByteVector FLAC::Picture::data() const
 void FLAC::Picture::setData(const ByteVector &data)
 {
   d->data = data;
+  d->modified = true;
 }
 
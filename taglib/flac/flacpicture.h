@@ -186,6 +186,18 @@ namespace TagLib {
        */
       ByteVector render() const;
 
+      /*!
+       * Returns true if the picture has been changed by one of its setters
+       * since it was read from the file, or since setModified(false) was last
+       * called.
+       */
+      bool isModified() const;
+
+      /*!
+       * Marks the picture as changed, or as unchanged if \a modified is false.
+       */
+      void setModified(bool modified = true);
+
       /*!
        * Parse the picture data in the FLAC picture block format.
        */
@@ -163,14 +163,19 @@ void FLAC::Properties::read(const ByteVector &data, long streamLength)
   const unsigned long long lo = data.toUInt(pos, true);
   pos += 4;
 
-  d->sampleFrames = (hi << 32) | lo;
+  setSampleFrames((hi << 32) | lo, streamLength);
+
+  if(data.size() >= pos + 16)
+    d->signature = data.mid(pos, 16);
+}
+
+void FLAC::Properties::setSampleFrames(unsigned long long sampleFrames, long streamLength)
+{
+  d->sampleFrames = sampleFrames;
 
   if(d->sampleFrames > 0 && d->sampleRate > 0) {
     const double length = d->sampleFrames * 1000.0 / d->sampleRate;
     d->length  = static_cast<int>(length + 0.5);
     d->bitrate = static_cast<int>(streamLength * 8.0 / length + 0.5);
   }
-
-  if(data.size() >= pos + 16)
-    d->signature = data.mid(pos, 16);
 }
@@ -123,7 +123,9 @@ namespace TagLib {
       int sampleWidth() const;
 
       /*!
-       * Return the number of sample frames.
+       * Return the number of sample frames.  If the stream info does not tell
+       * it, as in streams written on the fly, this is 0 unless the file was
+       * read with the Accurate read style, which finds the last frame.
        */
       unsigned long long sampleFrames() const;
 
@@ -134,10 +136,13 @@ namespace TagLib {
       ByteVector signature() const;
 
     private:
+      friend class File;
+
       Properties(const Properties &);
       Properties &operator=(const Properties &);
 
       void read(const ByteVector &data, long streamLength);
+      void setSampleFrames(unsigned long long sampleFrames, long streamLength);
 
       class PropertiesPrivate;
       PropertiesPrivate *d;
@@ -0,0 +1,277 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_FORMATUTILS_H
+#define TAGLIB_FORMATUTILS_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+// The helpers below are shared by the C binding and the tools.  They are
+// defined inline because the library does not export them.
+
+#include <vector>
+
+#include <tfile.h>
+#include <tstring.h>
+#include <tbytevector.h>
+#include <mpegfile.h>
+#include <vorbisfile.h>
+#include <oggflacfile.h>
+#include <speexfile.h>
+#include <opusfile.h>
+#include <flacfile.h>
+#include <flacpicture.h>
+#include <mpcfile.h>
+#include <wavpackfile.h>
+#include <trueaudiofile.h>
+#include <mp4file.h>
+#include <mp4tag.h>
+#include <asffile.h>
+#include <asftag.h>
+#include <asfpicture.h>
+#include <aifffile.h>
+#include <wavfile.h>
+#include <apefile.h>
+#include <apetag.h>
+#include <modfile.h>
+#include <s3mfile.h>
+#include <itfile.h>
+#include <xmfile.h>
+#include <dsffile.h>
+#include <dsdifffile.h>
+#include <id3v2tag.h>
+#include <attachedpictureframe.h>
+#include <xiphcomment.h>
+
+namespace TagLib {
+
+  namespace Utils {
+
+    /*!
+     * Returns the name of the format of \a file, e.g. "MPEG", or a null
+     * pointer if it is not one of the formats of TagLib.
+     */
+    inline const char *formatName(const File *file)
+    {
+      if(dynamic_cast<const MPEG::File *>(file))
+        return "MPEG";
+      if(dynamic_cast<const Ogg::Vorbis::File *>(file))
+        return "OggVorbis";
+      if(dynamic_cast<const Ogg::FLAC::File *>(file))
+        return "OggFlac";
+      if(dynamic_cast<const Ogg::Speex::File *>(file))
+        return "Speex";
+      if(dynamic_cast<const Ogg::Opus::File *>(file))
+        return "Opus";
+      if(dynamic_cast<const FLAC::File *>(file))
+        return "FLAC";
+      if(dynamic_cast<const MPC::File *>(file))
+        return "MPC";
+      if(dynamic_cast<const WavPack::File *>(file))
+        return "WavPack";
+      if(dynamic_cast<const TrueAudio::File *>(file))
+        return "TrueAudio";
+      if(dynamic_cast<const MP4::File *>(file))
+        return "MP4";
+      if(dynamic_cast<const ASF::File *>(file))
+        return "ASF";
+      if(dynamic_cast<const RIFF::AIFF::File *>(file))
+        return "AIFF";
+      if(dynamic_cast<const RIFF::WAV::File *>(file))
+        return "WAV";
+      if(dynamic_cast<const APE::File *>(file))
+        return "APE";
+      if(dynamic_cast<const Mod::File *>(file))
+        return "Mod";
+      if(dynamic_cast<const S3M::File *>(file))
+        return "S3M";
+      if(dynamic_cast<const IT::File *>(file))
+        return "IT";
+      if(dynamic_cast<const XM::File *>(file))
+        return "XM";
+      if(dynamic_cast<const DSF::File *>(file))
+        return "DSF";
+      if(dynamic_cast<const DSDIFF::File *>(file))
+        return "DSDIFF";
+      return 0;
+    }
+
+    //! A picture embedded in a file, see embeddedPictures().
+
+    struct EmbeddedPicture
+    {
+      String mimeType;
+      String description;
+      //! The picture type as defined by ID3v2 APIC frames.
+      int type;
+      ByteVector data;
+    };
+
+    typedef std::vector<EmbeddedPicture> EmbeddedPictureList;
+
+    inline void addEmbeddedPicture(EmbeddedPictureList &pictures, const String &mimeType,
+                                   const String &description, int type, const ByteVector &data)
+    {
+      EmbeddedPicture picture;
+      picture.mimeType    = mimeType;
+      picture.description = description;
+      picture.type        = type;
+      picture.data        = data;
+      pictures.push_back(picture);
+    }
+
+    inline void addEmbeddedPictures(EmbeddedPictureList &pictures, ID3v2::Tag *tag)
+    {
+      if(!tag)
+        return;
+
+      const ID3v2::FrameList frames = tag->frameList("APIC");
+      for(ID3v2::FrameList::ConstIterator it = frames.begin(); it != frames.end(); ++it) {
+        const ID3v2::AttachedPictureFrame *frame = dynamic_cast<ID3v2::AttachedPictureFrame *>(*it);
+        if(frame)
+          addEmbeddedPicture(pictures, frame->mimeType(), frame->description(), frame->type(), frame->picture());
+      }
+    }
+
+    inline void addEmbeddedPictures(EmbeddedPictureList &pictures, const List<FLAC::Picture *> &list)
+    {
+      for(List<FLAC::Picture *>::ConstIterator it = list.begin(); it != list.end(); ++it)
+        addEmbeddedPicture(pictures, (*it)->mimeType(), (*it)->description(), (*it)->type(), (*it)->data());
+    }
+
+    inline void addEmbeddedPictures(EmbeddedPictureList &pictures, MP4::Tag *tag)
+    {
+      if(!tag || !tag->contains("covr"))
+        return;
+
+      const MP4::CoverArtList covers = tag->item("covr").toCoverArtList();
+      for(MP4::CoverArtList::ConstIterator it = covers.begin(); it != covers.end(); ++it) {
+        String mimeType;
+        switch(it->format()) {
+        case MP4::CoverArt::JPEG:
+          mimeType = "image/jpeg";
+          break;
+        case MP4::CoverArt::PNG:
+          mimeType = "image/png";
+          break;
+        case MP4::CoverArt::BMP:
+          mimeType = "image/bmp";
+          break;
+        case MP4::CoverArt::GIF:
+          mimeType = "image/gif";
+          break;
+        default:
+          break;
+        }
+        addEmbeddedPicture(pictures, mimeType, String(), ID3v2::AttachedPictureFrame::FrontCover, it->data());
+      }
+    }
+
+    inline void addEmbeddedPictures(EmbeddedPictureList &pictures, ASF::Tag *tag)
+    {
+      if(!tag || !tag->contains("WM/Picture"))
+        return;
+
+      const ASF::AttributeList attributes = tag->attribute("WM/Picture");
+      for(ASF::AttributeList::ConstIterator it = attributes.begin(); it != attributes.end(); ++it) {
+        const ASF::Picture picture = it->toPicture();
+        if(picture.isValid())
+          addEmbeddedPicture(pictures, picture.mimeType(), picture.description(), picture.type(), picture.picture());
+      }
+    }
+
+    inline void addEmbeddedPictures(EmbeddedPictureList &pictures, APE::Tag *tag)
+    {
+      if(!tag)
+        return;
+
+      static const struct {
+        const char *key;
+        int type;
+      } covers[] = {
+        { "COVER ART (FRONT)", ID3v2::AttachedPictureFrame::FrontCover },
+        { "COVER ART (BACK)",  ID3v2::AttachedPictureFrame::BackCover }
+      };
+
+      const APE::ItemListMap &items = tag->itemListMap();
+      for(size_t i = 0; i < sizeof(covers) / sizeof(covers[0]); ++i) {
+        const APE::ItemListMap::ConstIterator it = items.find(covers[i].key);
+        if(it == items.end() || it->second.type() != APE::Item::Binary)
+          continue;
+
+        // The binary value is the file name or description followed by a null
+        // byte and the image data.
+
+        const ByteVector value = it->second.binaryData();
+        const int separator = value.find('\0');
+        if(separator < 0)
+          continue;
+
+        addEmbeddedPicture(pictures, String(), String(value.mid(0, separator), String::UTF8),
+                           covers[i].type, value.mid(separator + 1));
+      }
+    }
+
+    /*!
+     * Returns the pictures in the ID3v2 APIC frames, FLAC picture blocks, Xiph
+     * comments, MP4 cover art, ASF WM/Picture attributes and APE cover art
+     * items of \a file.  The image data is shared with the tags.
+     */
+    inline EmbeddedPictureList embeddedPictures(File *file)
+    {
+      EmbeddedPictureList pictures;
+
+      if(MPEG::File *mpeg = dynamic_cast<MPEG::File *>(file))
+        addEmbeddedPictures(pictures, mpeg->ID3v2Tag());
+      else if(FLAC::File *flac = dynamic_cast<FLAC::File *>(file))
+        addEmbeddedPictures(pictures, flac->pictureList());
+      else if(TrueAudio::File *trueAudio = dynamic_cast<TrueAudio::File *>(file))
+        addEmbeddedPictures(pictures, trueAudio->ID3v2Tag());
+      else if(DSDIFF::File *dsdiff = dynamic_cast<DSDIFF::File *>(file))
+        addEmbeddedPictures(pictures, dsdiff->ID3v2Tag());
+      else if(APE::File *ape = dynamic_cast<APE::File *>(file))
+        addEmbeddedPictures(pictures, ape->APETag());
+      else if(WavPack::File *wavPack = dynamic_cast<WavPack::File *>(file))
+        addEmbeddedPictures(pictures, wavPack->APETag());
+      else if(MPC::File *mpc = dynamic_cast<MPC::File *>(file))
+        addEmbeddedPictures(pictures, mpc->APETag());
+      else if(Ogg::XiphComment *comment = dynamic_cast<Ogg::XiphComment *>(file->tag()))
+        addEmbeddedPictures(pictures, comment->pictureList());
+      else if(ID3v2::Tag *id3v2 = dynamic_cast<ID3v2::Tag *>(file->tag()))
+        addEmbeddedPictures(pictures, id3v2);
+      else if(MP4::Tag *mp4 = dynamic_cast<MP4::Tag *>(file->tag()))
+        addEmbeddedPictures(pictures, mp4);
+      else if(ASF::Tag *asf = dynamic_cast<ASF::Tag *>(file->tag()))
+        addEmbeddedPictures(pictures, asf);
+
+      return pictures;
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,243 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include "tstring.h"
+#include "tiostream.h"
+#include "tchunkmap.h"
+#include "incrementalparser.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // A read only stream over the parts of a file received so far.  The first
+  // read of a missing byte is recorded and every read after it returns no
+  // data, so that the parser gives up quickly.
+
+  class SparseStream : public IOStream
+  {
+  public:
+    SparseStream(FileName name, long length) :
+      m_name(name),
+      m_chunks(length),
+      m_position(0),
+      m_missed(false),
+      m_missOffset(0),
+      m_missLength(0) {}
+
+    FileName name() const { return m_name; }
+
+    ByteVector readBlock(unsigned long length)
+    {
+      if(m_missed || length == 0 || m_position < 0 || m_position >= m_chunks.length())
+        return ByteVector();
+
+      const long end = m_position + static_cast<long>(std::min<unsigned long>(length, m_chunks.length() - m_position));
+
+      const long covered = m_chunks.coveredUntil(m_position);
+      if(covered >= end) {
+        const ByteVector data = m_chunks.data(m_position, end - m_position);
+        m_position = end;
+        return data;
+      }
+
+      m_missed     = true;
+      m_missOffset = covered;
+      m_missLength = end - m_missOffset;
+      return ByteVector();
+    }
+
+    void writeBlock(const ByteVector &) {}
+    void insert(const ByteVector &, unsigned long, unsigned long) {}
+    void removeBlock(unsigned long, unsigned long) {}
+    bool readOnly() const { return true; }
+    bool isOpen() const { return true; }
+
+    void seek(long offset, Position p)
+    {
+      switch(p) {
+      case Beginning:
+        m_position = offset;
+        break;
+      case Current:
+        m_position += offset;
+        break;
+      case End:
+        m_position = m_chunks.length() + offset;
+        break;
+      }
+    }
+
+    void clear() {}
+    long tell() const { return m_position; }
+    long length() { return m_chunks.length(); }
+    void truncate(long) {}
+
+    ChunkMap &chunks() { return m_chunks; }
+
+    void rewind()
+    {
+      m_position = 0;
+      m_missed = false;
+    }
+
+    bool missed() const { return m_missed; }
+    long missOffset() const { return m_missOffset; }
+    long missLength() const { return m_missLength; }
+
+  private:
+    const FileNameHandle m_name;
+    ChunkMap m_chunks;
+    long m_position;
+
+    bool m_missed;
+    long m_missOffset;
+    long m_missLength;
+  };
+}
+
+class IncrementalParser::IncrementalParserPrivate
+{
+public:
+  IncrementalParserPrivate(FileName name, long length, bool readAudioProperties,
+                           AudioProperties::ReadStyle audioPropertiesStyle,
+                           unsigned long blockSize) :
+    stream(name, length),
+    readAudioProperties(readAudioProperties),
+    audioPropertiesStyle(audioPropertiesStyle),
+    blockSize(std::max<unsigned long>(blockSize, 1)),
+    complete(false),
+    rounds(0) {}
+
+  // The file refers to the stream, so it is declared after it to be
+  // destroyed first.
+
+  SparseStream stream;
+  FileRef file;
+
+  const bool readAudioProperties;
+  const AudioProperties::ReadStyle audioPropertiesStyle;
+  const unsigned long blockSize;
+
+  bool complete;
+  unsigned int rounds;
+  File::Range needed;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+IncrementalParser::IncrementalParser(long length, bool readAudioProperties,
+                                     AudioProperties::ReadStyle audioPropertiesStyle,
+                                     unsigned long blockSize) :
+  d(new IncrementalParserPrivate(FileName(""), length, readAudioProperties, audioPropertiesStyle, blockSize))
+{
+  parse();
+}
+
+IncrementalParser::IncrementalParser(long length, FileName name, bool readAudioProperties,
+                                     AudioProperties::ReadStyle audioPropertiesStyle,
+                                     unsigned long blockSize) :
+  d(new IncrementalParserPrivate(name, length, readAudioProperties, audioPropertiesStyle, blockSize))
+{
+  parse();
+}
+
+IncrementalParser::~IncrementalParser()
+{
+  delete d;
+}
+
+bool IncrementalParser::isComplete() const
+{
+  return d->complete;
+}
+
+File::Range IncrementalParser::neededRange() const
+{
+  return d->complete ? File::Range() : d->needed;
+}
+
+bool IncrementalParser::feed(long offset, const ByteVector &data)
+{
+  d->stream.chunks().add(offset, data);
+
+  if(!d->complete && d->stream.chunks().coveredUntil(d->needed.offset) > d->needed.offset)
+    parse();
+
+  return d->complete;
+}
+
+FileRef IncrementalParser::fileRef() const
+{
+  return d->complete ? d->file : FileRef();
+}
+
+unsigned int IncrementalParser::rounds() const
+{
+  return d->rounds;
+}
+
+long IncrementalParser::bytesFed() const
+{
+  return d->stream.chunks().size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void IncrementalParser::parse()
+{
+  d->file = FileRef();
+  d->stream.rewind();
+  d->rounds++;
+
+  FileRef file(&d->stream, d->readAudioProperties, d->audioPropertiesStyle);
+
+  if(!d->stream.missed()) {
+    d->complete = true;
+    d->file = file;
+    return;
+  }
+
+  // Request whole blocks around the missing bytes, without the parts which
+  // have been received already.
+
+  const long length    = d->stream.length();
+  const long missStart = d->stream.missOffset();
+  const long missEnd   = missStart + d->stream.missLength();
+
+  long start = missStart - missStart % static_cast<long>(d->blockSize);
+  long end   = std::min<long>(missEnd + (d->blockSize - missEnd % d->blockSize) % d->blockSize, length);
+
+  if(d->stream.chunks().coveredUntil(start) >= missStart)
+    start = missStart;
+  end = std::min(end, d->stream.chunks().nextStart(missStart));
+
+  d->needed = File::Range(start, end - start);
+}
@@ -0,0 +1,148 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_INCREMENTALPARSER_H
+#define TAGLIB_INCREMENTALPARSER_H
+
+#include "taglib_export.h"
+#include "tfile.h"
+#include "fileref.h"
+#include "audioproperties.h"
+
+namespace TagLib {
+
+  //! Parses a file from data pushed by the caller as it arrives
+
+  /*!
+   * The parsers of TagLib pull the data they need from an IOStream, which
+   * blocks while data is fetched from a remote source.  An IncrementalParser
+   * turns this around: it tells which range of the file it needs next, and the
+   * caller fetches it without blocking and feeds it back.  This allows many
+   * remote files to be scanned concurrently on a few threads:
+   *
+   * \code
+   * TagLib::IncrementalParser parser(objectSize);
+   * while(!parser.isComplete()) {
+   *   const TagLib::File::Range r = parser.neededRange();
+   *   parser.feed(r.offset, fetch(r.offset, r.length));  // e.g. a range request
+   * }
+   * TagLib::Tag *tag = parser.fileRef().tag();
+   * \endcode
+   *
+   * Only the length of the file has to be known in advance.  The file type is
+   * detected like FileRef does for an IOStream, by the extension of the name
+   * if one is given and otherwise from the content.  The data is requested in
+   * blocks of a minimum size, aligned to that size, so that the small reads of
+   * a parser, such as the probes of the tags at the end of a file, are served
+   * by few requests.
+   *
+   * Each time data is fed the parser runs again from the start over the data
+   * received so far and stops at the first byte it does not have yet.
+   * Parsing is cheap compared to fetching, and only a handful of rounds are
+   * needed for usual files, since the parsers read the tags and the headers of
+   * the audio data only.
+   *
+   * \note The data fed is kept in memory until the parser is destroyed.
+   */
+
+  class TAGLIB_EXPORT IncrementalParser
+  {
+  public:
+    /*!
+     * Constructs a parser for a file of \a length bytes.  The audio properties
+     * are read if \a readAudioProperties is true, using \a audioPropertiesStyle.
+     * The data is requested in blocks of at least \a blockSize bytes.
+     */
+    IncrementalParser(long length,
+                      bool readAudioProperties = true,
+                      AudioProperties::ReadStyle audioPropertiesStyle = AudioProperties::Average,
+                      unsigned long blockSize = 64 * 1024);
+
+    /*!
+     * Constructs a parser for a file of \a length bytes named \a name.  The
+     * name is only used to detect the file type by its extension, like the
+     * name of the stream passed to FileRef, which is needed for the formats
+     * which can not be detected from their content, such as tracker modules.
+     */
+    IncrementalParser(long length,
+                      FileName name,
+                      bool readAudioProperties = true,
+                      AudioProperties::ReadStyle audioPropertiesStyle = AudioProperties::Average,
+                      unsigned long blockSize = 64 * 1024);
+
+    /*!
+     * Destroys the parser and the file it parsed.
+     */
+    ~IncrementalParser();
+
+    /*!
+     * Returns true if the file has been parsed and no more data is needed.
+     */
+    bool isComplete() const;
+
+    /*!
+     * Returns the range of the file which has to be fed next.  Returns an empty
+     * range if the parser is complete.
+     */
+    File::Range neededRange() const;
+
+    /*!
+     * Feeds \a data, which starts at \a offset in the file, and parses the file
+     * again if it covers the beginning of the needed range.  Data beyond the
+     * needed range, or fed in advance, is kept for the following rounds.
+     *
+     * Returns true if the parser is complete.
+     */
+    bool feed(long offset, const ByteVector &data);
+
+    /*!
+     * Returns the parsed file, or a null FileRef if the parser is not complete
+     * or the file type is not supported.  The file stays valid while the parser
+     * exists and it is read only.
+     */
+    FileRef fileRef() const;
+
+    /*!
+     * Returns the number of times the file has been parsed so far.
+     */
+    unsigned int rounds() const;
+
+    /*!
+     * Returns the number of distinct bytes fed so far.
+     */
+    long bytesFed() const;
+
+  private:
+    IncrementalParser(const IncrementalParser &);
+    IncrementalParser &operator=(const IncrementalParser &);
+
+    void parse();
+
+    class IncrementalParserPrivate;
+    IncrementalParserPrivate *d;
+  };
+
+}
+
+#endif
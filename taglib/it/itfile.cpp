@@ -27,11 +27,15 @@
 #include "tstringlist.h"
 #include "itfile.h"
 #include "tdebug.h"
+#include "tinstrumentedstream.h"
+#include "tbudgetstream.h"
 #include "modfileprivate.h"
+#include "modreader.h"
 #include "tpropertymap.h"
 
 using namespace TagLib;
 using namespace IT;
+using Mod::StructReader;
 
 class IT::File::FilePrivate
 {
@@ -50,8 +54,10 @@ IT::File::File(FileName file, bool readProperties,
   Mod::FileBase(file),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 IT::File::File(IOStream *stream, bool readProperties,
@@ -59,8 +65,10 @@ IT::File::File(IOStream *stream, bool readProperties,
   Mod::FileBase(stream),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 IT::File::~File()
@@ -90,6 +98,9 @@ IT::Properties *IT::File::audioProperties() const
 
 bool IT::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly())
   {
     debug("IT::File::save() - Cannot save to a read only file.");
@@ -201,41 +212,80 @@ bool IT::File::save()
 
 void IT::File::read(bool)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   if(!isOpen())
     return;
 
-  seek(0);
-  READ_ASSERT(readBlock(4) == "IMPM");
-  READ_STRING(d->tag.setTitle, 26);
-
-  seek(2, Current);
+  ByteVector magic;
+  String title;
+  unsigned short length          = 0;
+  unsigned short instrumentCount = 0;
+  unsigned short sampleCount     = 0;
+  unsigned short patternCount    = 0;
+  unsigned short version         = 0;
+  unsigned short compatibleVersion = 0;
+  unsigned short flags           = 0;
+  unsigned short special         = 0;
+  unsigned char  globalVolume    = 0;
+  unsigned char  mixVolume       = 0;
+  unsigned char  bpmSpeed        = 0;
+  unsigned char  tempo           = 0;
+  unsigned char  panningSeparation = 0;
+  unsigned char  pitchWheelDepth = 0;
+  unsigned short messageLength   = 0;
+  unsigned long  messageOffset   = 0;
+  ByteVector pannings;
+  ByteVector volumes;
+
+  StructReader header;
+  header.bytes(magic, 4)
+        .string(title, 26)
+        .skip(2)
+        .u16L(length)
+        .u16L(instrumentCount)
+        .u16L(sampleCount)
+        .u16L(patternCount)
+        .u16L(version)
+        .u16L(compatibleVersion)
+        .u16L(flags)
+        .u16L(special)
+        .byte(globalVolume)
+        .byte(mixVolume)
+        .byte(bpmSpeed)
+        .byte(tempo)
+        .byte(panningSeparation)
+        .byte(pitchWheelDepth)
+        .u16L(messageLength)
+        .u32L(messageOffset)
+        .skip(4)
+        .bytes(pannings, 64)
+        .bytes(volumes, 64);
 
-  READ_U16L_AS(length);
-  READ_U16L_AS(instrumentCount);
-  READ_U16L_AS(sampleCount);
+  seek(0);
+  READ_ASSERT(header.read(*this, header.size()) == header.size());
+  READ_ASSERT(magic == "IMPM");
 
+  d->tag.setTitle(title);
   d->properties.setInstrumentCount(instrumentCount);
   d->properties.setSampleCount(sampleCount);
-  READ_U16L(d->properties.setPatternCount);
-  READ_U16L(d->properties.setVersion);
-  READ_U16L(d->properties.setCompatibleVersion);
-  READ_U16L(d->properties.setFlags);
-  READ_U16L_AS(special);
+  d->properties.setPatternCount(patternCount);
+  d->properties.setVersion(version);
+  d->properties.setCompatibleVersion(compatibleVersion);
+  d->properties.setFlags(flags);
   d->properties.setSpecial(special);
-  READ_BYTE(d->properties.setGlobalVolume);
-  READ_BYTE(d->properties.setMixVolume);
-  READ_BYTE(d->properties.setBpmSpeed);
-  READ_BYTE(d->properties.setTempo);
-  READ_BYTE(d->properties.setPanningSeparation);
-  READ_BYTE(d->properties.setPitchWheelDepth);
+  d->properties.setGlobalVolume(globalVolume);
+  d->properties.setMixVolume(mixVolume);
+  d->properties.setBpmSpeed(bpmSpeed);
+  d->properties.setTempo(tempo);
+  d->properties.setPanningSeparation(panningSeparation);
+  d->properties.setPitchWheelDepth(pitchWheelDepth);
 
   // IT supports some kind of comment tag. Still, the
   // sample/instrument names are abused as comments so
   // I just add all together.
   String message;
   if(special & Properties::MessageAttached) {
-    READ_U16L_AS(messageLength);
-    READ_U32L_AS(messageOffset);
     seek(messageOffset);
     ByteVector messageBytes = readBlock(messageLength);
     READ_ASSERT(messageBytes.size() == messageLength);
@@ -246,11 +296,6 @@ void IT::File::read(bool)
     message = messageBytes;
   }
 
-  seek(64);
-
-  ByteVector pannings = readBlock(64);
-  ByteVector volumes  = readBlock(64);
-  READ_ASSERT(pannings.size() == 64 && volumes.size() == 64);
   int channels = 0;
   for(int i = 0; i < 64; ++ i) {
     // Strictly speaking an IT file has always 64 channels, but
@@ -263,10 +308,16 @@ void IT::File::read(bool)
   }
   d->properties.setChannels(channels);
 
+  // The orders and the instrument and sample offsets follow the header
+  // and are read at once.
+  seek(192);
+  const ByteVector tables = readBlock(length + 4UL * (instrumentCount + sampleCount));
+
   // real length might be shorter because of skips and terminator
   unsigned short realLength = 0;
   for(unsigned short i = 0; i < length; ++ i) {
-    READ_BYTE_AS(order);
+    READ_ASSERT(i < tables.size());
+    const unsigned char order = tables[i];
     if(order == 255) break;
     if(order != 254) ++ realLength;
   }
@@ -280,51 +331,62 @@ void IT::File::read(bool)
   //       e.g. VLC seems to interprete a nil as a space. I
   //       don't know what is the proper behaviour.
   for(unsigned short i = 0; i < instrumentCount; ++ i) {
-    seek(192L + length + ((long)i << 2));
-    READ_U32L_AS(instrumentOffset);
-    seek(instrumentOffset);
-
-    ByteVector instrumentMagic = readBlock(4);
+    const unsigned int tableOffset = length + (i << 2);
+    READ_ASSERT(tableOffset + 4 <= tables.size());
+    seek(tables.toUInt(tableOffset, false));
+
+    ByteVector instrumentMagic;
+    String dosFileName;
+    String instrumentName;
+    StructReader instrument;
+    instrument.bytes(instrumentMagic, 4)
+              .string(dosFileName, 13)
+              .skip(15)
+              .string(instrumentName, 26);
+
+    READ_ASSERT(instrument.read(*this, instrument.size()) == instrument.size());
     READ_ASSERT(instrumentMagic == "IMPI");
 
-    READ_STRING_AS(dosFileName, 13);
-
-    seek(15, Current);
-
-    READ_STRING_AS(instrumentName, 26);
     comment.append(instrumentName);
   }
 
   for(unsigned short i = 0; i < sampleCount; ++ i) {
-    seek(192L + length + ((long)instrumentCount << 2) + ((long)i << 2));
-    READ_U32L_AS(sampleOffset);
-
-    seek(sampleOffset);
-
-    ByteVector sampleMagic = readBlock(4);
-    READ_ASSERT(sampleMagic == "IMPS");
-
-    READ_STRING_AS(dosFileName, 13);
-    READ_BYTE_AS(globalVolume);
-    READ_BYTE_AS(sampleFlags);
-    READ_BYTE_AS(sampleVolume);
-    READ_STRING_AS(sampleName, 26);
+    const unsigned int tableOffset = length + ((instrumentCount + i) << 2);
+    READ_ASSERT(tableOffset + 4 <= tables.size());
+    seek(tables.toUInt(tableOffset, false));
+
+    ByteVector sampleMagic;
+    String dosFileName;
+    unsigned char globalVolume = 0;
+    unsigned char sampleFlags  = 0;
+    unsigned char sampleVolume = 0;
+    String sampleName;
+    StructReader sample;
+    sample.bytes(sampleMagic, 4)
+          .string(dosFileName, 13)
+          .byte(globalVolume)
+          .byte(sampleFlags)
+          .byte(sampleVolume)
+          .string(sampleName, 26);
     /*
-    READ_BYTE_AS(sampleCvt);
-    READ_BYTE_AS(samplePanning);
-    READ_U32L_AS(sampleLength);
-    READ_U32L_AS(loopStart);
-    READ_U32L_AS(loopStop);
-    READ_U32L_AS(c5speed);
-    READ_U32L_AS(sustainLoopStart);
-    READ_U32L_AS(sustainLoopEnd);
-    READ_U32L_AS(sampleDataOffset);
-    READ_BYTE_AS(vibratoSpeed);
-    READ_BYTE_AS(vibratoDepth);
-    READ_BYTE_AS(vibratoRate);
-    READ_BYTE_AS(vibratoType);
+          .byte(sampleCvt)
+          .byte(samplePanning)
+          .u32L(sampleLength)
+          .u32L(loopStart)
+          .u32L(loopStop)
+          .u32L(c5speed)
+          .u32L(sustainLoopStart)
+          .u32L(sustainLoopEnd)
+          .u32L(sampleDataOffset)
+          .byte(vibratoSpeed)
+          .byte(vibratoDepth)
+          .byte(vibratoRate)
+          .byte(vibratoType);
     */
 
+    READ_ASSERT(sample.read(*this, sample.size()) == sample.size());
+    READ_ASSERT(sampleMagic == "IMPS");
+
     comment.append(sampleName);
   }
 
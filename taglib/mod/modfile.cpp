@@ -27,7 +27,10 @@
 #include "modfile.h"
 #include "tstringlist.h"
 #include "tdebug.h"
+#include "tinstrumentedstream.h"
+#include "tbudgetstream.h"
 #include "modfileprivate.h"
+#include "modreader.h"
 #include "tpropertymap.h"
 
 using namespace TagLib;
@@ -50,8 +53,10 @@ Mod::File::File(FileName file, bool readProperties,
   Mod::FileBase(file),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 Mod::File::File(IOStream *stream, bool readProperties,
@@ -59,8 +64,10 @@ Mod::File::File(IOStream *stream, bool readProperties,
   Mod::FileBase(stream),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 Mod::File::~File()
@@ -90,6 +97,9 @@ PropertyMap Mod::File::setProperties(const PropertyMap &properties)
 
 bool Mod::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("Mod::File::save() - Cannot save to a read only file.");
     return false;
@@ -112,12 +122,17 @@ bool Mod::File::save()
 
 void Mod::File::read(bool)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   if(!isOpen())
     return;
 
-  seek(1080);
-  ByteVector modId = readBlock(4);
-  READ_ASSERT(modId.size() == 4);
+  // The header with the instruments ends with the format tag and is read
+  // at once.
+  seek(0);
+  const ByteVector data = readBlock(1084);
+  READ_ASSERT(data.size() == 1084);
+  const ByteVector modId = data.mid(1080, 4);
 
   int          channels    =  4;
   unsigned int instruments = 31;
@@ -160,33 +175,42 @@ void Mod::File::read(bool)
   d->properties.setChannels(channels);
   d->properties.setInstrumentCount(instruments);
 
-  seek(0);
-  READ_STRING(d->tag.setTitle, 20);
+  String title;
+  StructReader header;
+  header.string(title, 20);
+  unsigned int pos = header.parse(data, 0, header.size());
+  d->tag.setTitle(title);
 
   StringList comment;
   for(unsigned int i = 0; i < instruments; ++ i) {
-    READ_STRING_AS(instrumentName, 22);
-    // value in words, * 2 (<< 1) for bytes:
-    READ_U16B_AS(sampleLength);
+    String instrumentName;
+    unsigned short sampleLength = 0;
+    unsigned char  fineTuneByte = 0;
+    unsigned char  volume       = 0;
+    unsigned short repeatStart  = 0;
+    unsigned short repatLength  = 0;
+
+    // the lengths are in words, * 2 (<< 1) for bytes:
+    StructReader instrument;
+    instrument.string(instrumentName, 22)
+              .u16B(sampleLength)
+              .byte(fineTuneByte)
+              .byte(volume)
+              .u16B(repeatStart)
+              .u16B(repatLength);
+    pos += instrument.parse(data, pos, instrument.size());
 
-    READ_BYTE_AS(fineTuneByte);
     int fineTune = fineTuneByte & 0xF;
     // > 7 means negative value
     if(fineTune > 7) fineTune -= 16;
 
-    READ_BYTE_AS(volume);
     if(volume > 64) volume = 64;
     // volume in decibels: 20 * log10(volume / 64)
 
-    // value in words, * 2 (<< 1) for bytes:
-    READ_U16B_AS(repeatStart);
-    // value in words, * 2 (<< 1) for bytes:
-    READ_U16B_AS(repatLength);
-
     comment.append(instrumentName);
   }
 
-  READ_BYTE(d->properties.setLengthInPatterns);
+  d->properties.setLengthInPatterns(static_cast<unsigned char>(data[pos]));
 
   d->tag.setComment(comment.toString("\n"));
 }
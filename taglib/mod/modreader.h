@@ -0,0 +1,416 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MODREADER_H
+#define TAGLIB_MODREADER_H
+
+// Not part of the public API, only used internally by (mod|s3m|it|xm)file.cpp
+
+#include "tfile.h"
+#include "tlist.h"
+#include "tstring.h"
+
+#include <algorithm>
+
+namespace TagLib {
+
+  namespace Mod {
+
+    /*!
+     * The Reader classes are helpers to make handling of the stripped XM
+     * format more easy. In the stripped XM format certain header sizes might
+     * be smaller than one would expect. The fields that are not included
+     * are then just some predefined valued (e.g. 0).
+     *
+     * Using these classes this code:
+     *
+     *   if(headerSize >= 4) {
+     *     if(!readU16L(value1)) ERROR();
+     *     if(headerSize >= 8) {
+     *       if(!readU16L(value2)) ERROR();
+     *       if(headerSize >= 12) {
+     *         if(!readString(value3, 22)) ERROR();
+     *         ...
+     *       }
+     *     }
+     *   }
+     *
+     * Becomes:
+     *
+     *   StructReader header;
+     *   header.u16L(value1).u16L(value2).string(value3, 22). ...;
+     *   if(header.read(*this, headerSize) < std::min(header.size(), headerSize))
+     *     ERROR();
+     *
+     * The values are decoded from memory, so a whole header costs a single
+     * readBlock() call instead of one per field.  Readers can also be applied
+     * to a block which has already been read with parse().
+     */
+    class Reader
+    {
+    public:
+      virtual ~Reader()
+      {
+      }
+
+      /*!
+       * Decodes the associated values from \a data starting at \a offset,
+       * but never uses more than \a limit bytes.  Returns the number of bytes
+       * used, which is less than size() if \a data ends early.
+       */
+      virtual unsigned int parse(const ByteVector &data, unsigned int offset,
+                                 unsigned int limit) = 0;
+
+      /*!
+       * Returns the number of bytes this reader would like to read.
+       */
+      virtual unsigned int size() const = 0;
+
+      /*!
+       * Reads associated values from \a file with a single read, but never
+       * reads more then \a limit bytes.  The file is left positioned after
+       * the bytes which were used.
+       */
+      unsigned int read(TagLib::File &file, unsigned int limit)
+      {
+        const long start = file.tell();
+        const ByteVector data = file.readBlock(std::min(size(), limit));
+        const unsigned int count = parse(data, 0, limit);
+        if(count != data.size())
+          file.seek(start + count);
+        return count;
+      }
+
+    protected:
+      /*!
+       * Returns the number of bytes of \a data after \a offset, up to
+       * \a size.
+       */
+      static unsigned int available(const ByteVector &data, unsigned int offset,
+                                    unsigned int size)
+      {
+        return offset < data.size() ? std::min(data.size() - offset, size) : 0;
+      }
+    };
+
+    class SkipReader : public Reader
+    {
+    public:
+      SkipReader(unsigned int size) : m_size(size)
+      {
+      }
+
+      unsigned int parse(const ByteVector &, unsigned int, unsigned int limit)
+      {
+        // Like seeking, skipping past the end of the data succeeds.
+        return std::min(m_size, limit);
+      }
+
+      unsigned int size() const
+      {
+        return m_size;
+      }
+
+    private:
+      unsigned int m_size;
+    };
+
+    template<typename T>
+    class ValueReader : public Reader
+    {
+    public:
+      ValueReader(T &value) : value(value)
+      {
+      }
+
+    protected:
+      T &value;
+    };
+
+    class StringReader : public ValueReader<String>
+    {
+    public:
+      StringReader(String &string, unsigned int size) :
+        ValueReader<String>(string), m_size(size)
+      {
+      }
+
+      unsigned int parse(const ByteVector &data, unsigned int offset, unsigned int limit)
+      {
+        const unsigned int count = available(data, offset, std::min(m_size, limit));
+        ByteVector s = data.mid(offset, count);
+        int index = s.find((char) 0);
+        if(index > -1) {
+          s.resize(index);
+        }
+        s.replace('\xff', ' ');
+        value = s;
+        return count;
+      }
+
+      unsigned int size() const
+      {
+        return m_size;
+      }
+
+    private:
+      unsigned int m_size;
+    };
+
+    class ByteVectorReader : public ValueReader<ByteVector>
+    {
+    public:
+      ByteVectorReader(ByteVector &data, unsigned int size) :
+        ValueReader<ByteVector>(data), m_size(size)
+      {
+      }
+
+      unsigned int parse(const ByteVector &data, unsigned int offset, unsigned int limit)
+      {
+        const unsigned int count = available(data, offset, std::min(m_size, limit));
+        value = data.mid(offset, count);
+        return count;
+      }
+
+      unsigned int size() const
+      {
+        return m_size;
+      }
+
+    private:
+      unsigned int m_size;
+    };
+
+    class ByteReader : public ValueReader<unsigned char>
+    {
+    public:
+      ByteReader(unsigned char &byte) : ValueReader<unsigned char>(byte) {}
+
+      unsigned int parse(const ByteVector &data, unsigned int offset, unsigned int limit)
+      {
+        const unsigned int count = available(data, offset, std::min(1U, limit));
+        if(count > 0) {
+          value = data[offset];
+        }
+        return count;
+      }
+
+      unsigned int size() const
+      {
+        return 1;
+      }
+    };
+
+    template<typename T>
+    class NumberReader : public ValueReader<T>
+    {
+    public:
+      NumberReader(T &value, bool bigEndian) :
+        ValueReader<T>(value), bigEndian(bigEndian)
+      {
+      }
+
+    protected:
+      bool bigEndian;
+    };
+
+    class U16Reader : public NumberReader<unsigned short>
+    {
+    public:
+      U16Reader(unsigned short &value, bool bigEndian)
+      : NumberReader<unsigned short>(value, bigEndian) {}
+
+      unsigned int parse(const ByteVector &data, unsigned int offset, unsigned int limit)
+      {
+        const unsigned int count = available(data, offset, std::min(2U, limit));
+        if(count == 2)
+          value = data.toUShort(offset, bigEndian);
+        else
+          value = data.mid(offset, count).toUShort(bigEndian);
+        return count;
+      }
+
+      unsigned int size() const
+      {
+        return 2;
+      }
+    };
+
+    class U32Reader : public NumberReader<unsigned long>
+    {
+    public:
+      U32Reader(unsigned long &value, bool bigEndian = true) :
+        NumberReader<unsigned long>(value, bigEndian)
+      {
+      }
+
+      unsigned int parse(const ByteVector &data, unsigned int offset, unsigned int limit)
+      {
+        const unsigned int count = available(data, offset, std::min(4U, limit));
+        value = data.toUInt(offset, count, bigEndian);
+        return count;
+      }
+
+      unsigned int size() const
+      {
+        return 4;
+      }
+    };
+
+    class StructReader : public Reader
+    {
+    public:
+      StructReader()
+      {
+        m_readers.setAutoDelete(true);
+      }
+
+      /*!
+       * Add a nested reader. This reader takes ownership.
+       */
+      StructReader &reader(Reader *reader)
+      {
+        m_readers.append(reader);
+        return *this;
+      }
+
+      /*!
+       * Don't read anything but skip \a size bytes.
+       */
+      StructReader &skip(unsigned int size)
+      {
+        m_readers.append(new SkipReader(size));
+        return *this;
+      }
+
+      /*!
+       * Read a string of \a size characters (bytes) into \a string.
+       */
+      StructReader &string(String &string, unsigned int size)
+      {
+        m_readers.append(new StringReader(string, size));
+        return *this;
+      }
+
+      /*!
+       * Read \a size raw bytes into \a data.
+       */
+      StructReader &bytes(ByteVector &data, unsigned int size)
+      {
+        m_readers.append(new ByteVectorReader(data, size));
+        return *this;
+      }
+
+      /*!
+       * Read a byte into \a byte.
+       */
+      StructReader &byte(unsigned char &byte)
+      {
+        m_readers.append(new ByteReader(byte));
+        return *this;
+      }
+
+      /*!
+       * Read a unsigned 16 Bit integer into \a number. The byte order
+       * is controlled by \a bigEndian.
+       */
+      StructReader &u16(unsigned short &number, bool bigEndian)
+      {
+        m_readers.append(new U16Reader(number, bigEndian));
+        return *this;
+      }
+
+      /*!
+       * Read a unsigned 16 Bit little endian integer into \a number.
+       */
+      StructReader &u16L(unsigned short &number)
+      {
+        return u16(number, false);
+      }
+
+      /*!
+       * Read a unsigned 16 Bit big endian integer into \a number.
+       */
+      StructReader &u16B(unsigned short &number)
+      {
+        return u16(number, true);
+      }
+
+      /*!
+       * Read a unsigned 32 Bit integer into \a number. The byte order
+       * is controlled by \a bigEndian.
+       */
+      StructReader &u32(unsigned long &number, bool bigEndian)
+      {
+        m_readers.append(new U32Reader(number, bigEndian));
+        return *this;
+      }
+
+      /*!
+       * Read a unsigned 32 Bit little endian integer into \a number.
+       */
+      StructReader &u32L(unsigned long &number)
+      {
+        return u32(number, false);
+      }
+
+      /*!
+       * Read a unsigned 32 Bit big endian integer into \a number.
+       */
+      StructReader &u32B(unsigned long &number)
+      {
+        return u32(number, true);
+      }
+
+      unsigned int size() const
+      {
+        unsigned int size = 0;
+        for(List<Reader*>::ConstIterator i = m_readers.begin();
+            i != m_readers.end(); ++ i) {
+          size += (*i)->size();
+        }
+        return size;
+      }
+
+      unsigned int parse(const ByteVector &data, unsigned int offset, unsigned int limit)
+      {
+        unsigned int sumcount = 0;
+        for(List<Reader*>::ConstIterator i = m_readers.begin();
+            limit > 0 && i != m_readers.end(); ++ i) {
+          unsigned int count = (*i)->parse(data, offset + sumcount, limit);
+          limit    -= count;
+          sumcount += count;
+        }
+        return sumcount;
+      }
+
+    private:
+      List<Reader*> m_readers;
+    };
+
+  }
+
+}
+
+#endif
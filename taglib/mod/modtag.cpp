@@ -96,7 +96,10 @@ String Mod::Tag::trackerName() const
 
 void Mod::Tag::setTitle(const String &title)
 {
-  d->title = title;
+  if(d->title != title) {
+    d->title = title;
+    setModified();
+  }
 }
 
 void Mod::Tag::setArtist(const String &)
@@ -109,7 +112,10 @@ void Mod::Tag::setAlbum(const String &)
 
 void Mod::Tag::setComment(const String &comment)
 {
-  d->comment = comment;
+  if(d->comment != comment) {
+    d->comment = comment;
+    setModified();
+  }
 }
 
 void Mod::Tag::setGenre(const String &)
@@ -126,7 +132,10 @@ void Mod::Tag::setTrack(unsigned int)
 
 void Mod::Tag::setTrackerName(const String &trackerName)
 {
-  d->trackerName = trackerName;
+  if(d->trackerName != trackerName) {
+    d->trackerName = trackerName;
+    setModified();
+  }
 }
 
 PropertyMap Mod::Tag::properties() const
@@ -145,22 +154,22 @@ PropertyMap Mod::Tag::setProperties(const PropertyMap &origProps)
   properties.removeEmpty();
   StringList oneValueSet;
   if(properties.contains("TITLE")) {
-    d->title = properties["TITLE"].front();
+    setTitle(properties["TITLE"].front());
     oneValueSet.append("TITLE");
   } else
-    d->title.clear();
+    setTitle(String());
 
   if(properties.contains("COMMENT")) {
-    d->comment = properties["COMMENT"].front();
+    setComment(properties["COMMENT"].front());
     oneValueSet.append("COMMENT");
   } else
-    d->comment.clear();
+    setComment(String());
 
   if(properties.contains("TRACKERNAME")) {
-    d->trackerName = properties["TRACKERNAME"].front();
+    setTrackerName(properties["TRACKERNAME"].front());
     oneValueSet.append("TRACKERNAME");
   } else
-    d->trackerName.clear();
+    setTrackerName(String());
 
   // for each tag that has been set above, remove the first entry in the corresponding
   // value list. The others will be returned as unsupported by this format.
@@ -26,7 +26,9 @@
 #include <climits>
 
 #include <tdebug.h>
+#include <ttrace.h>
 #include <tstring.h>
+#include <tbudgetstream.h>
 #include "mp4atom.h"
 
 using namespace TagLib;
@@ -90,7 +92,10 @@ MP4::Atom::Atom(File *file)
       else if(name == "stsd") {
         file->seek(8, File::Current);
       }
+      Budget *budget = file->budget();
       while(file->tell() < offset + length) {
+        if(budget && !budget->addObject())
+          return;
         MP4::Atom *child = new MP4::Atom(file);
         children.append(child);
         if(child->length == 0)
@@ -153,12 +158,17 @@ MP4::Atom::path(MP4::AtomList &path, const char *name1, const char *name2, const
 
 MP4::Atoms::Atoms(File *file)
 {
+  TAGLIB_TRACE("MP4::Atoms::Atoms");
+
   atoms.setAutoDelete(true);
 
   file->seek(0, File::End);
   long end = file->tell();
   file->seek(0);
+  Budget *budget = file->budget();
   while(file->tell() + 8 <= end) {
+    if(budget && !budget->addObject())
+      break;
     MP4::Atom *atom = new MP4::Atom(file);
     atoms.append(atom);
     if (atom->length == 0)
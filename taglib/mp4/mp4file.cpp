@@ -23,7 +23,12 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <climits>
+#include <algorithm>
+
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tstring.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
@@ -138,6 +143,8 @@ MP4::File::audioProperties() const
 void
 MP4::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   if(!isValid())
     return;
 
@@ -155,6 +162,7 @@ MP4::File::read(bool readProperties)
 
   d->tag = new Tag(this, d->atoms);
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(this, d->atoms);
   }
 }
@@ -162,6 +170,9 @@ MP4::File::read(bool readProperties)
 bool
 MP4::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("MP4::File::save() -- File is read only.");
     return false;
@@ -180,3 +191,50 @@ MP4::File::hasMP4Tag() const
 {
   return (d->atoms->find("moov", "udta", "meta", "ilst") != 0);
 }
+
+File::RangeList
+MP4::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  // The atom tree read by the constructor is not updated when the tag is
+  // saved, so the top level atoms are walked again.
+
+  RangeList ranges;
+
+  const long fileLength = length();
+  long offset = 0;
+
+  while(offset + 8 <= fileLength) {
+    seek(offset);
+    const ByteVector header = readBlock(8);
+    if(header.size() != 8)
+      break;
+
+    long atomLength = header.toUInt();
+    long headerLength = 8;
+
+    if(atomLength == 0) {
+      atomLength = fileLength - offset;
+    }
+    else if(atomLength == 1) {
+      const long long longLength = readBlock(8).toLongLong();
+      if(longLength > LONG_MAX)
+        break;
+
+      atomLength = static_cast<long>(longLength);
+      headerLength = 16;
+    }
+
+    if(atomLength < headerLength)
+      break;
+
+    if(header.containsAt("mdat", 4))
+      ranges.append(Range(offset + headerLength, std::min(atomLength, fileLength - offset) - headerLength));
+
+    offset += atomLength;
+  }
+
+  return ranges;
+}
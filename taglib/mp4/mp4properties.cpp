@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <tdebug.h>
+#include <tlayout.h>
 #include <tstring.h>
 #include "mp4file.h"
 #include "mp4atom.h"
@@ -31,6 +32,51 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // The media header atom, in version 0 with 32-bit and in version 1 with
+  // 64-bit times.
+
+  struct MediaHeader
+  {
+    static const unsigned int size = 9;
+    typedef Layout::U8<8> Version;
+  };
+
+  struct MediaHeader0
+  {
+    static const unsigned int size = 32;
+    typedef Layout::U32B<20> TimeScale;
+    typedef Layout::U32B<24> Duration;
+  };
+
+  struct MediaHeader1
+  {
+    static const unsigned int size = 44;
+    typedef Layout::U32B<28> TimeScale;
+    typedef Layout::U64B<32> Duration;
+  };
+
+  // The sample description atoms of AAC and ALAC.
+
+  struct AACSampleEntry
+  {
+    static const unsigned int size = 50;
+    typedef Layout::S16B<40> Channels;
+    typedef Layout::S16B<42> BitsPerSample;
+    typedef Layout::U32B<46> SampleRate;
+  };
+
+  struct ALACSampleEntry
+  {
+    static const unsigned int size = 88;
+    typedef Layout::U8<69>   BitsPerSample;
+    typedef Layout::U8<73>   Channels;
+    typedef Layout::U32B<80> Bitrate;
+    typedef Layout::U32B<84> SampleRate;
+  };
+}
+
 class MP4::Properties::PropertiesPrivate
 {
 public:
@@ -167,24 +213,31 @@ MP4::Properties::read(File *file, Atoms *atoms)
   file->seek(mdhd->offset);
   data = file->readBlock(mdhd->length);
 
-  const unsigned int version = data[8];
+  const Layout::View<MediaHeader> mediaHeader(data);
+  if(!mediaHeader.isValid()) {
+    debug("MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
+    return;
+  }
+
   long long unit;
   long long length;
-  if(version == 1) {
-    if(data.size() < 36 + 8) {
+  if(mediaHeader.get<MediaHeader::Version>() == 1) {
+    const Layout::View<MediaHeader1> header(data);
+    if(!header.isValid()) {
       debug("MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
       return;
     }
-    unit   = data.toUInt(28U);
-    length = data.toLongLong(32U);
+    unit   = header.get<MediaHeader1::TimeScale>();
+    length = header.get<MediaHeader1::Duration>();
   }
   else {
-    if(data.size() < 24 + 8) {
+    const Layout::View<MediaHeader0> header(data);
+    if(!header.isValid()) {
       debug("MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
       return;
     }
-    unit   = data.toUInt(20U);
-    length = data.toUInt(24U);
+    unit   = header.get<MediaHeader0::TimeScale>();
+    length = header.get<MediaHeader0::Duration>();
   }
   if(unit > 0 && length > 0)
     d->length = static_cast<int>(length * 1000.0 / unit + 0.5);
@@ -198,16 +251,19 @@ MP4::Properties::read(File *file, Atoms *atoms)
   data = file->readBlock(atom->length);
   if(data.containsAt("mp4a", 20)) {
     d->codec         = AAC;
-    d->channels      = data.toShort(40U);
-    d->bitsPerSample = data.toShort(42U);
-    d->sampleRate    = data.toUInt(46U);
-    if(data.containsAt("esds", 56) && data[64] == 0x03) {
+    const Layout::View<AACSampleEntry> entry(data);
+    if(entry.isValid()) {
+      d->channels      = entry.get<AACSampleEntry::Channels>();
+      d->bitsPerSample = entry.get<AACSampleEntry::BitsPerSample>();
+      d->sampleRate    = entry.get<AACSampleEntry::SampleRate>();
+    }
+    if(data.containsAt("esds", 56) && data.at(64) == 0x03) {
       unsigned int pos = 65;
       if(data.containsAt("\x80\x80\x80", pos)) {
         pos += 3;
       }
       pos += 4;
-      if(data[pos] == 0x04) {
+      if(data.at(pos) == 0x04) {
         pos += 1;
         if(data.containsAt("\x80\x80\x80", pos)) {
           pos += 3;
@@ -218,12 +274,13 @@ MP4::Properties::read(File *file, Atoms *atoms)
     }
   }
   else if(data.containsAt("alac", 20)) {
-    if(atom->length == 88 && data.containsAt("alac", 56)) {
+    const Layout::View<ALACSampleEntry> entry(data);
+    if(atom->length == 88 && entry.isValid() && data.containsAt("alac", 56)) {
       d->codec         = ALAC;
-      d->bitsPerSample = data.at(69);
-      d->channels      = data.at(73);
-      d->bitrate       = static_cast<int>(data.toUInt(80U) / 1000.0 + 0.5);
-      d->sampleRate    = data.toUInt(84U);
+      d->bitsPerSample = entry.get<ALACSampleEntry::BitsPerSample>();
+      d->channels      = entry.get<ALACSampleEntry::Channels>();
+      d->bitrate       = static_cast<int>(entry.get<ALACSampleEntry::Bitrate>() / 1000.0 + 0.5);
+      d->sampleRate    = entry.get<ALACSampleEntry::SampleRate>();
     }
   }
 
@@ -29,9 +29,28 @@
 #include "mp4atom.h"
 #include "mp4tag.h"
 #include "id3v1genres.h"
+#include "tagutils.h"
 
 using namespace TagLib;
 
+namespace
+{
+  // Appends the header of an atom whose size is patched by endAtom() once its
+  // contents have been appended.
+
+  unsigned int beginAtom(ByteVectorBuilder &out, const ByteVector &name)
+  {
+    const unsigned int offset = out.appendPlaceholder(4);
+    out.append(name);
+    return offset;
+  }
+
+  void endAtom(ByteVectorBuilder &out, unsigned int offset)
+  {
+    out.setUInt(offset, out.size() - offset);
+  }
+}
+
 class MP4::Tag::TagPrivate
 {
 public:
@@ -318,10 +337,10 @@ MP4::Tag::parseCovr(const MP4::Atom *atom)
 }
 
 ByteVector
-MP4::Tag::padIlst(const ByteVector &data, int length) const
+MP4::Tag::padIlst(unsigned int size, int length) const
 {
   if(length == -1) {
-    length = ((data.size() + 1023) & ~1023) - data.size();
+    length = ((size + 1023) & ~1023) - size;
   }
   return renderAtom("free", ByteVector(length, '\1'));
 }
@@ -414,16 +433,22 @@ MP4::Tag::renderText(const ByteVector &name, const MP4::Item &item, int flags) c
   return renderData(name, flags, data);
 }
 
-ByteVector
-MP4::Tag::renderCovr(const ByteVector &name, const MP4::Item &item) const
+void
+MP4::Tag::renderCovr(ByteVectorBuilder &out, const ByteVector &name, const MP4::Item &item) const
 {
-  ByteVector data;
+  // The pictures are shared with the items rather than copied into each
+  // enclosing atom.
+
+  const unsigned int covr = beginAtom(out, name);
   MP4::CoverArtList value = item.toCoverArtList();
   for(MP4::CoverArtList::ConstIterator it = value.begin(); it != value.end(); ++it) {
-    data.append(renderAtom("data", ByteVector::fromUInt(it->format()) +
-                                   ByteVector(4, '\0') + it->data()));
+    const unsigned int data = beginAtom(out, "data");
+    out.append(ByteVector::fromUInt(it->format()));
+    out.append(ByteVector(4, '\0'));
+    out.append(it->data());
+    endAtom(out, data);
   }
-  return renderAtom(name, data);
+  endAtom(out, covr);
 }
 
 ByteVector
@@ -461,62 +486,73 @@ MP4::Tag::renderFreeForm(const String &name, const MP4::Item &item) const
   return renderAtom("----", data);
 }
 
-bool
-MP4::Tag::save()
+void
+MP4::Tag::renderIlst(ByteVectorBuilder &out) const
 {
-  ByteVector data;
+  const unsigned int ilst = beginAtom(out, "ilst");
   for(MP4::ItemMap::ConstIterator it = d->items.begin(); it != d->items.end(); ++it) {
     const String name = it->first;
     if(name.startsWith("----")) {
-      data.append(renderFreeForm(name, it->second));
+      out.append(renderFreeForm(name, it->second));
     }
     else if(name == "trkn") {
-      data.append(renderIntPair(name.data(String::Latin1), it->second));
+      out.append(renderIntPair(name.data(String::Latin1), it->second));
     }
     else if(name == "disk") {
-      data.append(renderIntPairNoTrailing(name.data(String::Latin1), it->second));
+      out.append(renderIntPairNoTrailing(name.data(String::Latin1), it->second));
     }
     else if(name == "cpil" || name == "pgap" || name == "pcst" || name == "hdvd" ||
             name == "shwm") {
-      data.append(renderBool(name.data(String::Latin1), it->second));
+      out.append(renderBool(name.data(String::Latin1), it->second));
     }
     else if(name == "tmpo" || name == "rate" || name == "\251mvi" || name == "\251mvc") {
-      data.append(renderInt(name.data(String::Latin1), it->second));
+      out.append(renderInt(name.data(String::Latin1), it->second));
     }
     else if(name == "tvsn" || name == "tves" || name == "cnID" ||
             name == "sfID" || name == "atID" || name == "geID" ||
             name == "cmID") {
-      data.append(renderUInt(name.data(String::Latin1), it->second));
+      out.append(renderUInt(name.data(String::Latin1), it->second));
     }
     else if(name == "plID") {
-      data.append(renderLongLong(name.data(String::Latin1), it->second));
+      out.append(renderLongLong(name.data(String::Latin1), it->second));
     }
     else if(name == "stik" || name == "rtng" || name == "akID") {
-      data.append(renderByte(name.data(String::Latin1), it->second));
+      out.append(renderByte(name.data(String::Latin1), it->second));
     }
     else if(name == "covr") {
-      data.append(renderCovr(name.data(String::Latin1), it->second));
+      renderCovr(out, name.data(String::Latin1), it->second);
     }
     else if(name == "purl" || name == "egid") {
-      data.append(renderText(name.data(String::Latin1), it->second, TypeImplicit));
+      out.append(renderText(name.data(String::Latin1), it->second, TypeImplicit));
     }
     else if(name.size() == 4){
-      data.append(renderText(name.data(String::Latin1), it->second));
+      out.append(renderText(name.data(String::Latin1), it->second));
     }
     else {
       debug("MP4: Unknown item name \"" + name + "\"");
     }
   }
-  data = renderAtom("ilst", data);
+  endAtom(out, ilst);
+}
 
+bool
+MP4::Tag::save()
+{
   AtomList path = d->atoms->path("moov", "udta", "meta", "ilst");
   if(path.size() == 4) {
-    saveExisting(data, path);
+
+    // The items in the file are up to date.
+
+    if(!isModified())
+      return true;
+
+    saveExisting(path);
   }
   else {
-    saveNew(data);
+    saveNew();
   }
 
+  setModified(false);
   return true;
 }
 
@@ -620,19 +656,33 @@ MP4::Tag::updateOffsets(long delta, long offset)
 }
 
 void
-MP4::Tag::saveNew(ByteVector data)
+MP4::Tag::saveNew()
 {
-  data = renderAtom("meta", ByteVector(4, '\0') +
-                    renderAtom("hdlr", ByteVector(8, '\0') + ByteVector("mdirappl") +
-                               ByteVector(9, '\0')) +
-                    data + padIlst(data));
+  ByteVectorBuilder out;
 
   AtomList path = d->atoms->path("moov", "udta");
-  if(path.size() != 2) {
+  unsigned int udta = 0;
+  const bool hasUdta = (path.size() == 2);
+  if(!hasUdta) {
     path = d->atoms->path("moov");
-    data = renderAtom("udta", data);
+    udta = beginAtom(out, "udta");
   }
 
+  const unsigned int meta = beginAtom(out, "meta");
+  out.append(ByteVector(4, '\0'));
+  out.append(renderAtom("hdlr", ByteVector(8, '\0') + ByteVector("mdirappl") +
+                                ByteVector(9, '\0')));
+
+  const unsigned int ilst = out.size();
+  renderIlst(out);
+  out.append(padIlst(out.size() - ilst));
+  endAtom(out, meta);
+
+  if(!hasUdta)
+    endAtom(out, udta);
+
+  const ByteVector data = out.toByteVector();
+
   long offset = path.back()->offset + 8;
   d->file->insert(data, offset, 0);
 
@@ -646,8 +696,11 @@ MP4::Tag::saveNew(ByteVector data)
 }
 
 void
-MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
+MP4::Tag::saveExisting(const AtomList &path)
 {
+  ByteVectorBuilder out;
+  renderIlst(out);
+
   AtomList::ConstIterator it = path.end();
 
   MP4::Atom *ilst = *(--it);
@@ -677,19 +730,27 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
     }
   }
 
-  long delta = data.size() - length;
+  long delta = out.size() - length;
   if(delta > 0 || (delta < 0 && delta > -8)) {
-    data.append(padIlst(data));
-    delta = data.size() - length;
+    out.append(padIlst(out.size()));
+    delta = out.size() - length;
   }
   else if(delta < 0) {
-    data.append(padIlst(data, -delta - 8));
+    out.append(padIlst(out.size(), -delta - 8));
     delta = 0;
   }
 
-  d->file->insert(data, offset, length);
+  if(delta == 0) {
+    // The atoms fit in place, so the pieces are written one after the other
+    // rather than assembled first.
+    const ByteVectorList blocks = out.blocks();
+    d->file->seek(offset);
+    for(ByteVectorList::ConstIterator block = blocks.begin(); block != blocks.end(); ++block)
+      d->file->writeBlock(*block);
+  }
+  else {
+    d->file->insert(out.toByteVector(), offset, length);
 
-  if(delta) {
     updateParents(path, delta, 1);
     updateOffsets(delta, offset);
   }
@@ -755,42 +816,49 @@ void
 MP4::Tag::setTitle(const String &value)
 {
   d->items["\251nam"] = StringList(value);
+  setModified();
 }
 
 void
 MP4::Tag::setArtist(const String &value)
 {
   d->items["\251ART"] = StringList(value);
+  setModified();
 }
 
 void
 MP4::Tag::setAlbum(const String &value)
 {
   d->items["\251alb"] = StringList(value);
+  setModified();
 }
 
 void
 MP4::Tag::setComment(const String &value)
 {
   d->items["\251cmt"] = StringList(value);
+  setModified();
 }
 
 void
 MP4::Tag::setGenre(const String &value)
 {
   d->items["\251gen"] = StringList(value);
+  setModified();
 }
 
 void
 MP4::Tag::setYear(unsigned int value)
 {
   d->items["\251day"] = StringList(String::number(value));
+  setModified();
 }
 
 void
 MP4::Tag::setTrack(unsigned int value)
 {
   d->items["trkn"] = MP4::Item(value, 0);
+  setModified();
 }
 
 bool MP4::Tag::isEmpty() const
@@ -800,6 +868,8 @@ bool MP4::Tag::isEmpty() const
 
 MP4::ItemMap &MP4::Tag::itemListMap()
 {
+  // The items may be changed through the returned map.
+  setModified();
   return d->items;
 }
 
@@ -816,11 +886,15 @@ MP4::Item MP4::Tag::item(const String &key) const
 void MP4::Tag::setItem(const String &key, const Item &value)
 {
   d->items[key] = value;
+  setModified();
 }
 
 void MP4::Tag::removeItem(const String &key)
 {
-  d->items.erase(key);
+  if(d->items.contains(key)) {
+    d->items.erase(key);
+    setModified();
+  }
 }
 
 bool MP4::Tag::contains(const String &key) const
@@ -931,11 +1005,13 @@ PropertyMap MP4::Tag::properties() const
 void MP4::Tag::removeUnsupportedProperties(const StringList &props)
 {
   for(StringList::ConstIterator it = props.begin(); it != props.end(); ++it)
-    d->items.erase(*it);
+    removeItem(*it);
 }
 
 PropertyMap MP4::Tag::setProperties(const PropertyMap &props)
 {
+  const Utils::PropertiesGuard<Tag> guard(this);
+
   static Map<String, String> reverseKeyMap;
   if(reverseKeyMap.isEmpty()) {
     int numKeys = sizeof(keyTranslation) / sizeof(keyTranslation[0]);
@@ -983,6 +1059,7 @@ PropertyMap MP4::Tag::setProperties(const PropertyMap &props)
     }
   }
 
+  setModified();
   return ignoredProps;
 }
 
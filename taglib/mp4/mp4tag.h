@@ -28,6 +28,7 @@
 
 #include "tag.h"
 #include "tbytevectorlist.h"
+#include "tbytevectorbuilder.h"
 #include "tfile.h"
 #include "tmap.h"
 #include "tstringlist.h"
@@ -122,7 +123,7 @@ namespace TagLib {
         void parseBool(const Atom *atom);
         void parseCovr(const Atom *atom);
 
-        ByteVector padIlst(const ByteVector &data, int length = -1) const;
+        ByteVector padIlst(unsigned int size, int length = -1) const;
         ByteVector renderAtom(const ByteVector &name, const ByteVector &data) const;
         ByteVector renderData(const ByteVector &name, int flags,
                               const ByteVectorList &data) const;
@@ -136,13 +137,14 @@ namespace TagLib {
         ByteVector renderLongLong(const ByteVector &name, const Item &item) const;
         ByteVector renderIntPair(const ByteVector &name, const Item &item) const;
         ByteVector renderIntPairNoTrailing(const ByteVector &name, const Item &item) const;
-        ByteVector renderCovr(const ByteVector &name, const Item &item) const;
+        void renderCovr(ByteVectorBuilder &out, const ByteVector &name, const Item &item) const;
+        void renderIlst(ByteVectorBuilder &out) const;
 
         void updateParents(const AtomList &path, long delta, int ignore = 0);
         void updateOffsets(long delta, long offset);
 
-        void saveNew(ByteVector data);
-        void saveExisting(ByteVector data, const AtomList &path);
+        void saveNew();
+        void saveExisting(const AtomList &path);
 
         void addItem(const String &name, const Item &value);
 
@@ -27,6 +27,8 @@
 #include <tstring.h>
 #include <tagunion.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
 
@@ -143,6 +145,9 @@ MPC::Properties *MPC::File::audioProperties() const
 
 bool MPC::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("MPC::File::save() -- File is read only.");
     return false;
@@ -270,12 +275,35 @@ bool MPC::File::hasAPETag() const
   return (d->APELocation >= 0);
 }
 
+File::RangeList MPC::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  long start = 0;
+  if(d->ID3v2Location >= 0)
+    start = d->ID3v2Location + d->ID3v2Size;
+
+  long end = length();
+  if(d->APELocation >= 0)
+    end = d->APELocation;
+  else if(d->ID3v1Location >= 0)
+    end = d->ID3v1Location;
+
+  RangeList ranges;
+  if(end > start)
+    ranges.append(Range(start, end - start));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void MPC::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // Look for an ID3v2 tag
 
   d->ID3v2Location = Utils::findID3v2(this);
@@ -286,16 +314,20 @@ void MPC::File::read(bool readProperties)
     d->ID3v2Size = d->ID3v2Header->completeTagSize();
   }
 
+  // Look for the tags at the end of the file
+
+  const Utils::TrailingTags trailingTags = Utils::findTrailingTags(this);
+
   // Look for an ID3v1 tag
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->ID3v1Location = trailingTags.ID3v1Location;
 
   if(d->ID3v1Location >= 0)
     d->tag.set(MPCID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
 
   // Look for an APE tag
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = trailingTags.APEFooterLocation;
 
   if(d->APELocation >= 0) {
     d->tag.set(MPCAPEIndex, new APE::Tag(this, d->APELocation));
@@ -309,15 +341,9 @@ void MPC::File::read(bool readProperties)
   // Look for MPC metadata
 
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
 
-    long streamLength;
-
-    if(d->APELocation >= 0)
-      streamLength = d->APELocation;
-    else if(d->ID3v1Location >= 0)
-      streamLength = d->ID3v1Location;
-    else
-      streamLength = length();
+    long streamLength = trailingTags.audioEnd;
 
     if(d->ID3v2Location >= 0) {
       seek(d->ID3v2Location + d->ID3v2Size);
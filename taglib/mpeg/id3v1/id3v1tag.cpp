@@ -164,37 +164,57 @@ unsigned int ID3v1::Tag::track() const
 
 void ID3v1::Tag::setTitle(const String &s)
 {
-  d->title = s;
+  if(d->title != s) {
+    d->title = s;
+    setModified();
+  }
 }
 
 void ID3v1::Tag::setArtist(const String &s)
 {
-  d->artist = s;
+  if(d->artist != s) {
+    d->artist = s;
+    setModified();
+  }
 }
 
 void ID3v1::Tag::setAlbum(const String &s)
 {
-  d->album = s;
+  if(d->album != s) {
+    d->album = s;
+    setModified();
+  }
 }
 
 void ID3v1::Tag::setComment(const String &s)
 {
-  d->comment = s;
+  if(d->comment != s) {
+    d->comment = s;
+    setModified();
+  }
 }
 
 void ID3v1::Tag::setGenre(const String &s)
 {
-  d->genre = ID3v1::genreIndex(s);
+  setGenreNumber(ID3v1::genreIndex(s));
 }
 
 void ID3v1::Tag::setYear(unsigned int i)
 {
-  d->year = i > 0 ? String::number(i) : String();
+  const String year = i > 0 ? String::number(i) : String();
+  if(d->year != year) {
+    d->year = year;
+    setModified();
+  }
 }
 
 void ID3v1::Tag::setTrack(unsigned int i)
 {
-  d->track = i < 256 ? i : 0;
+  const unsigned int track = i < 256 ? i : 0;
+  if(d->track != track) {
+    d->track = track;
+    setModified();
+  }
 }
 
 unsigned int ID3v1::Tag::genreNumber() const
@@ -204,7 +224,11 @@ unsigned int ID3v1::Tag::genreNumber() const
 
 void ID3v1::Tag::setGenreNumber(unsigned int i)
 {
-  d->genre = i < 256 ? i : 255;
+  const unsigned int genre = i < 256 ? i : 255;
+  if(d->genre != genre) {
+    d->genre = genre;
+    setModified();
+  }
 }
 
 void ID3v1::Tag::setStringHandler(const StringHandler *handler)
@@ -231,6 +255,8 @@ void ID3v1::Tag::read()
       parse(data);
     else
       debug("ID3v1 tag is not valid or could not be read at the specified offset.");
+
+    setModified(false);
   }
 }
 
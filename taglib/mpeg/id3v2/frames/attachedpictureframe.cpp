@@ -80,6 +80,7 @@ String::Type AttachedPictureFrame::textEncoding() const
 void AttachedPictureFrame::setTextEncoding(String::Type t)
 {
   d->textEncoding = t;
+  setModified();
 }
 
 String AttachedPictureFrame::mimeType() const
@@ -90,6 +91,7 @@ String AttachedPictureFrame::mimeType() const
 void AttachedPictureFrame::setMimeType(const String &m)
 {
   d->mimeType = m;
+  setModified();
 }
 
 AttachedPictureFrame::Type AttachedPictureFrame::type() const
@@ -100,6 +102,7 @@ AttachedPictureFrame::Type AttachedPictureFrame::type() const
 void AttachedPictureFrame::setType(Type t)
 {
   d->type = t;
+  setModified();
 }
 
 String AttachedPictureFrame::description() const
@@ -110,6 +113,7 @@ String AttachedPictureFrame::description() const
 void AttachedPictureFrame::setDescription(const String &desc)
 {
   d->description = desc;
+  setModified();
 }
 
 ByteVector AttachedPictureFrame::picture() const
@@ -120,6 +124,7 @@ ByteVector AttachedPictureFrame::picture() const
 void AttachedPictureFrame::setPicture(const ByteVector &p)
 {
   d->data = p;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,26 +126,31 @@ void ChapterFrame::setElementID(const ByteVector &eID)
 
   if(d->elementID.endsWith(char(0)))
     d->elementID = d->elementID.mid(0, d->elementID.size() - 1);
+  setModified();
 }
 
 void ChapterFrame::setStartTime(const unsigned int &sT)
 {
   d->startTime = sT;
+  setModified();
 }
 
 void ChapterFrame::setEndTime(const unsigned int &eT)
 {
   d->endTime = eT;
+  setModified();
 }
 
 void ChapterFrame::setStartOffset(const unsigned int &sO)
 {
   d->startOffset = sO;
+  setModified();
 }
 
 void ChapterFrame::setEndOffset(const unsigned int &eO)
 {
   d->endOffset = eO;
+  setModified();
 }
 
 const FrameListMap &ChapterFrame::embeddedFrameListMap() const
@@ -167,6 +172,7 @@ void ChapterFrame::addEmbeddedFrame(Frame *frame)
 {
   d->embeddedFrameList.append(frame);
   d->embeddedFrameListMap[frame->frameID()].append(frame);
+  setModified();
 }
 
 void ChapterFrame::removeEmbeddedFrame(Frame *frame, bool del)
@@ -182,6 +188,7 @@ void ChapterFrame::removeEmbeddedFrame(Frame *frame, bool del)
   // ...and delete as desired
   if(del)
     delete frame;
+  setModified();
 }
 
 void ChapterFrame::removeEmbeddedFrames(const ByteVector &id)
@@ -90,16 +90,19 @@ String CommentsFrame::text() const
 void CommentsFrame::setLanguage(const ByteVector &languageEncoding)
 {
   d->language = languageEncoding.mid(0, 3);
+  setModified();
 }
 
 void CommentsFrame::setDescription(const String &s)
 {
   d->description = s;
+  setModified();
 }
 
 void CommentsFrame::setText(const String &s)
 {
   d->text = s;
+  setModified();
 }
 
 String::Type CommentsFrame::textEncoding() const
@@ -110,6 +113,7 @@ String::Type CommentsFrame::textEncoding() const
 void CommentsFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 PropertyMap CommentsFrame::asProperties() const
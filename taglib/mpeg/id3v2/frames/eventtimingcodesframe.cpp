@@ -84,12 +84,14 @@ void EventTimingCodesFrame::setTimestampFormat(
     EventTimingCodesFrame::TimestampFormat f)
 {
   d->timestampFormat = f;
+  setModified();
 }
 
 void EventTimingCodesFrame::setSynchedEvents(
     const EventTimingCodesFrame::SynchedEventList &e)
 {
   d->synchedEvents = e;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
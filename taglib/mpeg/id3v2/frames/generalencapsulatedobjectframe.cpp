@@ -89,6 +89,7 @@ String::Type GeneralEncapsulatedObjectFrame::textEncoding() const
 void GeneralEncapsulatedObjectFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 String GeneralEncapsulatedObjectFrame::mimeType() const
@@ -99,6 +100,7 @@ String GeneralEncapsulatedObjectFrame::mimeType() const
 void GeneralEncapsulatedObjectFrame::setMimeType(const String &type)
 {
   d->mimeType = type;
+  setModified();
 }
 
 String GeneralEncapsulatedObjectFrame::fileName() const
@@ -109,6 +111,7 @@ String GeneralEncapsulatedObjectFrame::fileName() const
 void GeneralEncapsulatedObjectFrame::setFileName(const String &name)
 {
   d->fileName = name;
+  setModified();
 }
 
 String GeneralEncapsulatedObjectFrame::description() const
@@ -119,6 +122,7 @@ String GeneralEncapsulatedObjectFrame::description() const
 void GeneralEncapsulatedObjectFrame::setDescription(const String &desc)
 {
   d->description = desc;
+  setModified();
 }
 
 ByteVector GeneralEncapsulatedObjectFrame::object() const
@@ -129,6 +133,7 @@ ByteVector GeneralEncapsulatedObjectFrame::object() const
 void GeneralEncapsulatedObjectFrame::setObject(const ByteVector &data)
 {
   d->data = data;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
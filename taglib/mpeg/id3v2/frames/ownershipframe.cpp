@@ -77,6 +77,7 @@ String OwnershipFrame::pricePaid() const
 void OwnershipFrame::setPricePaid(const String &s)
 {
   d->pricePaid = s;
+  setModified();
 }
 
 String OwnershipFrame::datePurchased() const
@@ -87,6 +88,7 @@ String OwnershipFrame::datePurchased() const
 void OwnershipFrame::setDatePurchased(const String &s)
 {
   d->datePurchased = s;
+  setModified();
 }
 
 String OwnershipFrame::seller() const
@@ -97,6 +99,7 @@ String OwnershipFrame::seller() const
 void OwnershipFrame::setSeller(const String &s)
 {
   d->seller = s;
+  setModified();
 }
 
 String::Type OwnershipFrame::textEncoding() const
@@ -107,6 +110,7 @@ String::Type OwnershipFrame::textEncoding() const
 void OwnershipFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
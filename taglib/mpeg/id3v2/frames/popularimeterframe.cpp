@@ -74,6 +74,7 @@ String PopularimeterFrame::email() const
 void PopularimeterFrame::setEmail(const String &s)
 {
   d->email = s;
+  setModified();
 }
 
 int PopularimeterFrame::rating() const
@@ -84,6 +85,7 @@ int PopularimeterFrame::rating() const
 void PopularimeterFrame::setRating(int s)
 {
   d->rating = s;
+  setModified();
 }
 
 unsigned int PopularimeterFrame::counter() const
@@ -94,6 +96,7 @@ unsigned int PopularimeterFrame::counter() const
 void PopularimeterFrame::setCounter(unsigned int s)
 {
   d->counter = s;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
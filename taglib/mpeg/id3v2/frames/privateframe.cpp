@@ -81,11 +81,13 @@ ByteVector PrivateFrame::data() const
 void PrivateFrame::setOwner(const String &s)
 {
   d->owner = s;
+  setModified();
 }
 
 void PrivateFrame::setData(const ByteVector & data)
 {
   d->data = data;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
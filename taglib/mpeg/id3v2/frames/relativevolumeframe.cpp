@@ -112,6 +112,7 @@ short RelativeVolumeFrame::volumeAdjustmentIndex() const
 void RelativeVolumeFrame::setVolumeAdjustmentIndex(short index, ChannelType type)
 {
   d->channels[type].volumeAdjustment = index;
+  setModified();
 }
 
 void RelativeVolumeFrame::setVolumeAdjustmentIndex(short index)
@@ -132,6 +133,7 @@ float RelativeVolumeFrame::volumeAdjustment() const
 void RelativeVolumeFrame::setVolumeAdjustment(float adjustment, ChannelType type)
 {
   d->channels[type].volumeAdjustment = short(adjustment * float(512));
+  setModified();
 }
 
 void RelativeVolumeFrame::setVolumeAdjustment(float adjustment)
@@ -152,6 +154,7 @@ RelativeVolumeFrame::PeakVolume RelativeVolumeFrame::peakVolume() const
 void RelativeVolumeFrame::setPeakVolume(const PeakVolume &peak, ChannelType type)
 {
   d->channels[type].peakVolume = peak;
+  setModified();
 }
 
 void RelativeVolumeFrame::setPeakVolume(const PeakVolume &peak)
@@ -167,6 +170,7 @@ String RelativeVolumeFrame::identification() const
 void RelativeVolumeFrame::setIdentification(const String &s)
 {
   d->identification = s;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
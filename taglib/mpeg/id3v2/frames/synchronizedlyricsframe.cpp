@@ -110,32 +110,38 @@ SynchronizedLyricsFrame::synchedText() const
 void SynchronizedLyricsFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 void SynchronizedLyricsFrame::setLanguage(const ByteVector &languageEncoding)
 {
   d->language = languageEncoding.mid(0, 3);
+  setModified();
 }
 
 void SynchronizedLyricsFrame::setTimestampFormat(SynchronizedLyricsFrame::TimestampFormat f)
 {
   d->timestampFormat = f;
+  setModified();
 }
 
 void SynchronizedLyricsFrame::setType(SynchronizedLyricsFrame::Type t)
 {
   d->type = t;
+  setModified();
 }
 
 void SynchronizedLyricsFrame::setDescription(const String &s)
 {
   d->description = s;
+  setModified();
 }
 
 void SynchronizedLyricsFrame::setSynchedText(
     const SynchronizedLyricsFrame::SynchedTextList &t)
 {
   d->synchedText = t;
+  setModified();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
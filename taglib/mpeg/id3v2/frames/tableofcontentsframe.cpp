@@ -137,28 +137,33 @@ void TableOfContentsFrame::setElementID(const ByteVector &eID)
 {
   d->elementID = eID;
   strip(d->elementID);
+  setModified();
 }
 
 void TableOfContentsFrame::setIsTopLevel(const bool &t)
 {
   d->isTopLevel = t;
+  setModified();
 }
 
 void TableOfContentsFrame::setIsOrdered(const bool &o)
 {
   d->isOrdered = o;
+  setModified();
 }
 
 void TableOfContentsFrame::setChildElements(const ByteVectorList &l)
 {
   d->childElements = l;
   strip(d->childElements);
+  setModified();
 }
 
 void TableOfContentsFrame::addChildElement(const ByteVector &cE)
 {
   d->childElements.append(cE);
   strip(d->childElements);
+  setModified();
 }
 
 void TableOfContentsFrame::removeChildElement(const ByteVector &cE)
@@ -169,6 +174,7 @@ void TableOfContentsFrame::removeChildElement(const ByteVector &cE)
     it = d->childElements.find(cE + ByteVector("\0"));
 
   d->childElements.erase(it);
+  setModified();
 }
 
 const FrameListMap &TableOfContentsFrame::embeddedFrameListMap() const
@@ -190,6 +196,7 @@ void TableOfContentsFrame::addEmbeddedFrame(Frame *frame)
 {
   d->embeddedFrameList.append(frame);
   d->embeddedFrameListMap[frame->frameID()].append(frame);
+  setModified();
 }
 
 void TableOfContentsFrame::removeEmbeddedFrame(Frame *frame, bool del)
@@ -205,6 +212,7 @@ void TableOfContentsFrame::removeEmbeddedFrame(Frame *frame, bool del)
   // ...and delete as desired
   if(del)
     delete frame;
+  setModified();
 }
 
 void TableOfContentsFrame::removeEmbeddedFrames(const ByteVector &id)
@@ -92,11 +92,13 @@ TextIdentificationFrame::~TextIdentificationFrame()
 void TextIdentificationFrame::setText(const StringList &l)
 {
   d->fieldList = l;
+  setModified();
 }
 
 void TextIdentificationFrame::setText(const String &s)
 {
   d->fieldList = s;
+  setModified();
 }
 
 String TextIdentificationFrame::toString() const
@@ -117,6 +119,7 @@ String::Type TextIdentificationFrame::textEncoding() const
 void TextIdentificationFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 namespace
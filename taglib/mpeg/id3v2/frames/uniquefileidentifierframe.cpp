@@ -77,11 +77,13 @@ ByteVector UniqueFileIdentifierFrame::identifier() const
 void UniqueFileIdentifierFrame::setOwner(const String &s)
 {
   d->owner = s;
+  setModified();
 }
 
 void UniqueFileIdentifierFrame::setIdentifier(const ByteVector &v)
 {
   d->identifier = v;
+  setModified();
 }
 
 String UniqueFileIdentifierFrame::toString() const
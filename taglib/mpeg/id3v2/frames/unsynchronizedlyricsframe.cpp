@@ -91,16 +91,19 @@ String UnsynchronizedLyricsFrame::text() const
 void UnsynchronizedLyricsFrame::setLanguage(const ByteVector &languageEncoding)
 {
   d->language = languageEncoding.mid(0, 3);
+  setModified();
 }
 
 void UnsynchronizedLyricsFrame::setDescription(const String &s)
 {
   d->description = s;
+  setModified();
 }
 
 void UnsynchronizedLyricsFrame::setText(const String &s)
 {
   d->text = s;
+  setModified();
 }
 
 
@@ -112,6 +115,7 @@ String::Type UnsynchronizedLyricsFrame::textEncoding() const
 void UnsynchronizedLyricsFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 PropertyMap UnsynchronizedLyricsFrame::asProperties() const
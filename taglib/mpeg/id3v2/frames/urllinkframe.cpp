@@ -68,6 +68,7 @@ UrlLinkFrame::~UrlLinkFrame()
 void UrlLinkFrame::setUrl(const String &s)
 {
   d->url = s;
+  setModified();
 }
 
 String UrlLinkFrame::url() const
@@ -154,6 +155,7 @@ String::Type UserUrlLinkFrame::textEncoding() const
 void UserUrlLinkFrame::setTextEncoding(String::Type encoding)
 {
   d->textEncoding = encoding;
+  setModified();
 }
 
 String UserUrlLinkFrame::description() const
@@ -164,6 +166,7 @@ String UserUrlLinkFrame::description() const
 void UserUrlLinkFrame::setDescription(const String &s)
 {
   d->description = s;
+  setModified();
 }
 
 PropertyMap UserUrlLinkFrame::asProperties() const
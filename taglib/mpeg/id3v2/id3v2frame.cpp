@@ -40,6 +40,8 @@
 #include "frames/commentsframe.h"
 #include "frames/uniquefileidentifierframe.h"
 #include "frames/unknownframe.h"
+#include "frames/chapterframe.h"
+#include "frames/tableofcontentsframe.h"
 
 using namespace TagLib;
 using namespace ID3v2;
@@ -48,7 +50,8 @@ class Frame::FramePrivate
 {
 public:
   FramePrivate() :
-    header(0)
+    header(0),
+    modified(false)
     {}
 
   ~FramePrivate()
@@ -57,10 +60,23 @@ public:
   }
 
   Frame::Header *header;
+  bool modified;
 };
 
 namespace
 {
+  const FrameList &embeddedFrames(const Frame *frame)
+  {
+    static const FrameList noFrames;
+
+    if(const ChapterFrame *chap = dynamic_cast<const ChapterFrame *>(frame))
+      return chap->embeddedFrameList();
+    if(const TableOfContentsFrame *toc = dynamic_cast<const TableOfContentsFrame *>(frame))
+      return toc->embeddedFrameList();
+
+    return noFrames;
+  }
+
   bool isValidFrameID(const ByteVector &frameID)
   {
     if(frameID.size() != 4)
@@ -178,6 +194,7 @@ unsigned int Frame::size() const
 void Frame::setData(const ByteVector &data)
 {
   parse(data);
+  setModified();
 }
 
 void Frame::setText(const String &)
@@ -185,6 +202,31 @@ void Frame::setText(const String &)
 
 }
 
+bool Frame::isModified() const
+{
+  if(d->modified)
+    return true;
+
+  const FrameList &embedded = embeddedFrames(this);
+  for(FrameList::ConstIterator it = embedded.begin(); it != embedded.end(); ++it) {
+    if((*it)->isModified())
+      return true;
+  }
+
+  return false;
+}
+
+void Frame::setModified(bool modified)
+{
+  d->modified = modified;
+
+  if(!modified) {
+    const FrameList &embedded = embeddedFrames(this);
+    for(FrameList::ConstIterator it = embedded.begin(); it != embedded.end(); ++it)
+      (*it)->setModified(false);
+  }
+}
+
 ByteVector Frame::render() const
 {
   ByteVector fieldData = renderFields();
@@ -129,6 +129,22 @@ namespace TagLib {
        */
       ByteVector render() const;
 
+      /*!
+       * Returns true if the frame has been changed since it was read from the
+       * file, or since setModified(false) was last called.  For chapter and
+       * table of contents frames this includes the embedded frames.
+       *
+       * \see setModified()
+       */
+      bool isModified() const;
+
+      /*!
+       * Marks the frame as changed, or as unchanged if \a modified is false.
+       * The setters of the frame types call this; clearing the flag also
+       * clears it for the embedded frames.
+       */
+      void setModified(bool modified = true);
+
       /*!
        * Returns the text delimiter that is used between fields for the string
        * type \a t.
@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <tdebug.h>
+#include <ttrace.h>
 #include <tzlib.h>
 
 #include "id3v2framefactory.h"
@@ -127,6 +128,8 @@ Frame *FrameFactory::createFrame(const ByteVector &data, unsigned int version) c
 
 Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader) const
 {
+  TAGLIB_TRACE("ID3v2::FrameFactory::createFrame");
+
   ByteVector data = origData;
   unsigned int version = tagHeader->majorVersion();
   Frame::Header *header = new Frame::Header(data, version);
@@ -27,8 +27,10 @@
 
 #include <tfile.h>
 #include <tbytevector.h>
+#include <tbytevectorbuilder.h>
 #include <tpropertymap.h>
 #include <tdebug.h>
+#include <ttrace.h>
 
 #include "id3v2tag.h"
 #include "id3v2header.h"
@@ -36,6 +38,7 @@
 #include "id3v2footer.h"
 #include "id3v2synchdata.h"
 #include "id3v1genres.h"
+#include "tagutils.h"
 
 #include "frames/textidentificationframe.h"
 #include "frames/commentsframe.h"
@@ -250,8 +253,11 @@ void ID3v2::Tag::setComment(const String &s)
     return;
   }
 
-  if(!d->frameListMap["COMM"].isEmpty())
-    d->frameListMap["COMM"].front()->setText(s);
+  if(!d->frameListMap["COMM"].isEmpty()) {
+    Frame *f = d->frameListMap["COMM"].front();
+    if(f->toString() != s)
+      f->setText(s);
+  }
   else {
     CommentsFrame *f = new CommentsFrame(d->factory->defaultTextEncoding());
     addFrame(f);
@@ -342,6 +348,7 @@ void ID3v2::Tag::addFrame(Frame *frame)
 {
   d->frameList.append(frame);
   d->frameListMap[frame->frameID()].append(frame);
+  setModified();
 }
 
 void ID3v2::Tag::removeFrame(Frame *frame, bool del)
@@ -357,6 +364,8 @@ void ID3v2::Tag::removeFrame(Frame *frame, bool del)
   // ...and delete as desired
   if(del)
     delete frame;
+
+  setModified();
 }
 
 void ID3v2::Tag::removeFrames(const ByteVector &id)
@@ -418,6 +427,8 @@ void ID3v2::Tag::removeUnsupportedProperties(const StringList &properties)
 
 PropertyMap ID3v2::Tag::setProperties(const PropertyMap &origProps)
 {
+  const Utils::PropertiesGuard<Tag> guard(this);
+
   FrameList framesToDelete;
   // we split up the PropertyMap into the "normal" keys and the "complicated" ones,
   // which are those according to TIPL or TMCL frames.
@@ -594,9 +605,11 @@ ByteVector ID3v2::Tag::render(int version) const
     downgradeFrames(&frameList, &newFrames);
   }
 
-  // Reserve a 10-byte blank space for an ID3v2 tag header.
+  // Reserve a 10-byte blank space for an ID3v2 tag header.  Large frames such
+  // as pictures are shared rather than copied until the tag is assembled.
 
-  ByteVector tagData(Header::size(), '\0');
+  ByteVectorBuilder tagData;
+  const unsigned int header = tagData.appendPlaceholder(Header::size());
 
   // Loop through the frames rendering them and adding them to the tagData.
 
@@ -608,13 +621,18 @@ ByteVector ID3v2::Tag::render(int version) const
       continue;
     }
     if(!(*it)->header()->tagAlterPreservation()) {
-      const ByteVector frameData = (*it)->render();
-      if(frameData.size() == Frame::headerSize((*it)->header()->version())) {
+      // Same as Frame::render(), but the fields are not copied behind the
+      // frame header.
+
+      const ByteVector fieldData = (*it)->renderFields();
+      if(fieldData.isEmpty()) {
         debug("An empty ID3v2 frame \'"
           + String((*it)->header()->frameID()) + "\' has been discarded");
         continue;
       }
-      tagData.append(frameData);
+      (*it)->header()->setFrameSize(fieldData.size());
+      tagData.append((*it)->header()->render());
+      tagData.append(fieldData);
     }
   }
 
@@ -637,17 +655,16 @@ ByteVector ID3v2::Tag::render(int version) const
       paddingSize = MinPaddingSize;
   }
 
-  tagData.resize(static_cast<unsigned int>(tagData.size() + paddingSize), '\0');
+  tagData.appendPlaceholder(static_cast<unsigned int>(paddingSize));
 
   // Set the version and data size.
   d->header.setMajorVersion(version);
   d->header.setTagSize(tagData.size() - Header::size());
 
   // TODO: This should eventually include d->footer->render().
-  const ByteVector headerData = d->header.render();
-  std::copy(headerData.begin(), headerData.end(), tagData.begin());
+  tagData.set(header, d->header.render());
 
-  return tagData;
+  return tagData.toByteVector();
 }
 
 Latin1StringHandler const *ID3v2::Tag::latin1StringHandler()
@@ -684,6 +701,8 @@ void ID3v2::Tag::read()
   if(d->header.tagSize() != 0)
     parse(d->file->readBlock(d->header.tagSize()));
 
+  setModified(false);
+
   // Look for duplicate ID3v2 tags and treat them as an extra blank of this one.
   // It leads to overwriting them with zero when saving the tag.
 
@@ -706,11 +725,17 @@ void ID3v2::Tag::read()
   if(extraSize != 0) {
     debug("ID3v2::Tag::read() - Duplicate ID3v2 tags found.");
     d->header.setTagSize(d->header.tagSize() + extraSize);
+
+    // Saving the tag blanks the duplicates.
+
+    setModified();
   }
 }
 
 void ID3v2::Tag::parse(const ByteVector &origData)
 {
+  TAGLIB_TRACE("ID3v2::Tag::parse");
+
   ByteVector data = origData;
 
   if(d->header.unsynchronisation() && d->header.majorVersion() <= 3)
@@ -783,8 +808,12 @@ void ID3v2::Tag::setTextFrame(const ByteVector &id, const String &value)
     return;
   }
 
-  if(!d->frameListMap[id].isEmpty())
-    d->frameListMap[id].front()->setText(value);
+  if(!d->frameListMap[id].isEmpty()) {
+    Frame *f = d->frameListMap[id].front();
+    TextIdentificationFrame *tf = dynamic_cast<TextIdentificationFrame *>(f);
+    if(tf ? tf->fieldList() != StringList(value) : f->toString() != value)
+      f->setText(value);
+  }
   else {
     const String::Type encoding = d->factory->defaultTextEncoding();
     TextIdentificationFrame *f = new TextIdentificationFrame(id, encoding);
@@ -31,6 +31,8 @@
 #include <apefooter.h>
 #include <apetag.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 
 #include "mpegfile.h"
 #include "mpegheader.h"
@@ -51,9 +53,12 @@ public:
     ID3v2FrameFactory(frameFactory),
     ID3v2Location(-1),
     ID3v2OriginalSize(0),
+    ID3v2Appended(false),
     APELocation(-1),
     APEOriginalSize(0),
     ID3v1Location(-1),
+    audioEnd(-1),
+    tailOffset(0),
     properties(0) {}
 
   ~FilePrivate()
@@ -65,12 +70,20 @@ public:
 
   long ID3v2Location;
   long ID3v2OriginalSize;
+  bool ID3v2Appended;
 
   long APELocation;
   long APEOriginalSize;
 
   long ID3v1Location;
 
+  // The end of the audio data and the end of the file as read to find the
+  // tags, which are only kept while reading the audio properties.
+
+  long audioEnd;
+  long tailOffset;
+  ByteVector tail;
+
   TagUnion tag;
 
   Properties *properties;
@@ -106,7 +119,7 @@ bool MPEG::File::isSupported(IOStream *stream)
   // So we check if a frame header is really valid.
 
   long headerOffset;
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true, &headerOffset);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), true, &headerOffset);
 
   if(buffer.isEmpty())
 	  return false;
@@ -215,6 +228,9 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version)
 
 bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplicateTags)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("MPEG::File::save() -- File is read only.");
     return false;
@@ -239,17 +255,33 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
   if(stripOthers)
     strip(~tags, false);
 
-  if(ID3v2 & tags) {
+  // The tags which are in the file and have not been changed since they were
+  // read or saved are not written again.
+
+  const bool ID3v2Unchanged = d->ID3v2Location >= 0 && !d->ID3v2Appended &&
+    ID3v2Tag() && !ID3v2Tag()->isModified() &&
+    ID3v2Tag()->header()->majorVersion() == static_cast<unsigned int>(id3v2Version);
+
+  const bool ID3v1Unchanged = d->ID3v1Location >= 0 && ID3v1Tag() && !ID3v1Tag()->isModified();
+  const bool APEUnchanged = d->APELocation >= 0 && APETag() && !APETag()->isModified();
+
+  if((ID3v2 & tags) && !ID3v2Unchanged) {
 
     if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
 
       // ID3v2 tag is not empty. Update the old one or create a new one.
+      // Footers are not written, so an appended tag is moved to the
+      // beginning of the file.
+
+      if(d->ID3v2Appended)
+        strip(ID3v2, false);
 
       if(d->ID3v2Location < 0)
         d->ID3v2Location = 0;
 
       const ByteVector data = ID3v2Tag()->render(id3v2Version);
       insert(data, d->ID3v2Location, d->ID3v2OriginalSize);
+      ID3v2Tag()->setModified(false);
 
       if(d->APELocation >= 0)
         d->APELocation += (static_cast<long>(data.size()) - d->ID3v2OriginalSize);
@@ -267,7 +299,7 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
     }
   }
 
-  if(ID3v1 & tags) {
+  if((ID3v1 & tags) && !ID3v1Unchanged) {
 
     if(ID3v1Tag() && !ID3v1Tag()->isEmpty()) {
 
@@ -282,6 +314,7 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
       }
 
       writeBlock(ID3v1Tag()->render());
+      ID3v1Tag()->setModified(false);
     }
     else {
 
@@ -291,7 +324,7 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
     }
   }
 
-  if(APE & tags) {
+  if((APE & tags) && !APEUnchanged) {
 
     if(APETag() && !APETag()->isEmpty()) {
 
@@ -306,6 +339,7 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
 
       const ByteVector data = APETag()->render();
       insert(data, d->APELocation, d->APEOriginalSize);
+      APETag()->setModified(false);
 
       if(d->ID3v1Location >= 0)
         d->ID3v1Location += (static_cast<long>(data.size()) - d->APEOriginalSize);
@@ -361,6 +395,7 @@ bool MPEG::File::strip(int tags, bool freeMemory)
 
     d->ID3v2Location = -1;
     d->ID3v2OriginalSize = 0;
+    d->ID3v2Appended = false;
 
     if(freeMemory)
       d->tag.set(ID3v2Index, 0);
@@ -399,10 +434,12 @@ void MPEG::File::setID3v2FrameFactory(const ID3v2::FrameFactory *factory)
 long MPEG::File::nextFrameOffset(long position)
 {
   ByteVector frameSyncBytes(2, '\0');
+  unsigned int bufferLength = scanBufferSize();
+  Budget *budget = this->budget();
 
   while(true) {
     seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
+    const ByteVector buffer = readBlock(bufferLength);
     if(buffer.isEmpty())
       return -1;
 
@@ -410,31 +447,49 @@ long MPEG::File::nextFrameOffset(long position)
       frameSyncBytes[0] = frameSyncBytes[1];
       frameSyncBytes[1] = buffer[i];
       if(isFrameSync(frameSyncBytes)) {
+        if(budget && !budget->addObject())
+          return -1;
         const Header header(this, position + i - 1, true);
         if(header.isValid())
           return position + i - 1;
       }
     }
 
-    position += bufferSize();
+    position += buffer.size();
+    bufferLength = nextScanBufferSize(bufferLength);
   }
 }
 
 long MPEG::File::previousFrameOffset(long position)
 {
   ByteVector frameSyncBytes(2, '\0');
+  unsigned int scanLength = scanBufferSize();
+  Budget *budget = this->budget();
 
   while(position > 0) {
-    const long bufferLength = std::min<long>(position, bufferSize());
+    if(budget && budget->isExhausted())
+      return -1;
+
+    const long bufferLength = std::min<long>(position, scanLength);
     position -= bufferLength;
+    scanLength = nextScanBufferSize(scanLength);
 
-    seek(position);
-    const ByteVector buffer = readBlock(bufferLength);
+    ByteVector buffer;
+    if(position >= d->tailOffset &&
+       position + bufferLength <= d->tailOffset + static_cast<long>(d->tail.size())) {
+      buffer = d->tail.mid(position - d->tailOffset, bufferLength);
+    }
+    else {
+      seek(position);
+      buffer = readBlock(bufferLength);
+    }
 
     for(int i = buffer.size() - 1; i >= 0; --i) {
       frameSyncBytes[1] = frameSyncBytes[0];
       frameSyncBytes[0] = buffer[i];
       if(isFrameSync(frameSyncBytes)) {
+        if(budget && !budget->addObject())
+          return -1;
         const Header header(this, position + i, true);
         if(header.isValid())
           return position + i + header.frameLength();
@@ -449,7 +504,7 @@ long MPEG::File::firstFrameOffset()
 {
   long position = 0;
 
-  if(hasID3v2Tag())
+  if(hasID3v2Tag() && !d->ID3v2Appended)
     position = d->ID3v2Location + ID3v2Tag()->header()->completeTagSize();
 
   return nextFrameOffset(position);
@@ -459,7 +514,11 @@ long MPEG::File::lastFrameOffset()
 {
   long position;
 
-  if(hasAPETag())
+  if(d->audioEnd >= 0)
+    position = d->audioEnd;
+  else if(d->ID3v2Appended)
+    position = d->ID3v2Location;
+  else if(hasAPETag())
     position = d->APELocation - 1;
   else if(hasID3v1Tag())
     position = d->ID3v1Location - 1;
@@ -484,12 +543,38 @@ bool MPEG::File::hasAPETag() const
   return (d->APELocation >= 0);
 }
 
+File::RangeList MPEG::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  long start = 0;
+  if(d->ID3v2Location >= 0 && !d->ID3v2Appended)
+    start = d->ID3v2Location + d->ID3v2OriginalSize;
+
+  start = nextFrameOffset(start);
+  if(start < 0)
+    return RangeList();
+
+  // The tags at the end of the file are looked for again, since they may
+  // include a Lyrics3v2 tag which is not read by this class.
+
+  const long end = Utils::findTrailingTags(this).audioEnd;
+
+  RangeList ranges;
+  if(end > start)
+    ranges.append(Range(start, end - start));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void MPEG::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // Look for an ID3v2 tag
 
   d->ID3v2Location = findID3v2();
@@ -499,16 +584,20 @@ void MPEG::File::read(bool readProperties)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
+  // Look for the tags at the end of the file
+
+  const Utils::TrailingTags trailingTags = Utils::findTrailingTags(this);
+
   // Look for an ID3v1 tag
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->ID3v1Location = trailingTags.ID3v1Location;
 
   if(d->ID3v1Location >= 0)
     d->tag.set(ID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
 
   // Look for an APE tag
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = trailingTags.APEFooterLocation;
 
   if(d->APELocation >= 0) {
     d->tag.set(APEIndex, new APE::Tag(this, d->APELocation));
@@ -516,9 +605,28 @@ void MPEG::File::read(bool readProperties)
     d->APELocation = d->APELocation + APE::Footer::size() - d->APEOriginalSize;
   }
 
-  if(readProperties)
+  // Use an ID3v2 tag appended to the audio data if there is none in front
+
+  if(d->ID3v2Location < 0 && trailingTags.ID3v2Location >= 0) {
+    d->ID3v2Location = trailingTags.ID3v2Location;
+    d->ID3v2Appended = true;
+    d->tag.set(ID3v2Index, new ID3v2::Tag(this, d->ID3v2Location, d->ID3v2FrameFactory));
+    d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
+  }
+
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
+
+    d->audioEnd   = trailingTags.audioEnd;
+    d->tailOffset = trailingTags.windowOffset;
+    d->tail       = trailingTags.window;
+
     d->properties = new Properties(this);
 
+    d->audioEnd = -1;
+    d->tail.clear();
+  }
+
   // Make sure that we have our default tag types available.
 
   ID3v2Tag(true);
@@ -547,10 +655,11 @@ long MPEG::File::findID3v2()
   ByteVector frameSyncBytes(2, '\0');
   ByteVector tagHeaderBytes(3, '\0');
   long position = 0;
+  unsigned int bufferLength = scanBufferSize();
 
   while(true) {
     seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
+    const ByteVector buffer = readBlock(bufferLength);
     if(buffer.isEmpty())
       return -1;
 
@@ -570,6 +679,7 @@ long MPEG::File::findID3v2()
         return position + i - 2;
     }
 
-    position += bufferSize();
+    position += buffer.size();
+    bufferLength = nextScanBufferSize(bufferLength);
   }
 }
@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <tdebug.h>
+#include <ttrace.h>
 #include <tstring.h>
 
 #include "mpegproperties.h"
@@ -155,6 +156,8 @@ bool MPEG::Properties::isOriginal() const
 
 void MPEG::Properties::read(File *file)
 {
+  TAGLIB_TRACE("MPEG::Properties::read");
+
   // Only the first valid frame is required if we have a VBR header.
 
   const long firstFrameOffset = file->firstFrameOffset();
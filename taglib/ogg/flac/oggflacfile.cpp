@@ -26,6 +26,7 @@
 #include <tbytevector.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
 
@@ -74,7 +75,7 @@ bool Ogg::FLAC::File::isSupported(IOStream *stream)
 {
   // An Ogg FLAC file has IDs "OggS" and "fLaC" somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), false);
   return (buffer.find("OggS") >= 0 && buffer.find("fLaC") >= 0);
 }
 
@@ -128,26 +129,31 @@ Properties *Ogg::FLAC::File::audioProperties() const
 
 bool Ogg::FLAC::File::save()
 {
-  d->xiphCommentData = d->comment->render(false);
+  // The comment packet is only rewritten if the comment has changed.
 
-  // Create FLAC metadata-block:
+  if(!d->hasXiphComment || d->comment->isModified()) {
+    d->xiphCommentData = d->comment->render(false);
 
-  // Put the size in the first 32 bit (I assume no more than 24 bit are used)
+    // Create FLAC metadata-block:
 
-  ByteVector v = ByteVector::fromUInt(d->xiphCommentData.size());
+    // Put the size in the first 32 bit (I assume no more than 24 bit are used)
 
-  // Set the type of the metadata-block to be a Xiph / Vorbis comment
+    ByteVector v = ByteVector::fromUInt(d->xiphCommentData.size());
 
-  v[0] = 4;
+    // Set the type of the metadata-block to be a Xiph / Vorbis comment
 
-  // Append the comment-data after the 32 bit header
+    v[0] = 4;
 
-  v.append(d->xiphCommentData);
+    // Append the comment-data after the 32 bit header
 
-  // Save the packet at the old spot
-  // FIXME: Use padding if size is increasing
+    v.append(d->xiphCommentData);
 
-  setPacket(d->commentPacket, v);
+    // Save the packet at the old spot
+    // FIXME: Use padding if size is increasing
+
+    setPacket(d->commentPacket, v);
+    d->comment->setModified(false);
+  }
 
   return Ogg::File::save();
 }
@@ -163,6 +169,8 @@ bool Ogg::FLAC::File::hasXiphComment() const
 
 void Ogg::FLAC::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // Sanity: Check if we really have an Ogg/FLAC file
 
 /*
@@ -190,8 +198,10 @@ void Ogg::FLAC::File::read(bool readProperties, Properties::ReadStyle properties
     d->comment = new Ogg::XiphComment();
 
 
-  if(readProperties)
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(streamInfoData(), streamLength(), propertiesStyle);
+  }
 }
 
 ByteVector Ogg::FLAC::File::streamInfoData()
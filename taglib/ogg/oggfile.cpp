@@ -23,10 +23,15 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tbytevectorlist.h>
 #include <tmap.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <ttrace.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 
 #include "oggfile.h"
 #include "oggpage.h"
@@ -155,6 +160,9 @@ const Ogg::PageHeader *Ogg::File::lastPageHeader()
 
 bool Ogg::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("Ogg::File::save() - Cannot save to a read only file.");
     return false;
@@ -169,6 +177,44 @@ bool Ogg::File::save()
   return true;
 }
 
+File::RangeList Ogg::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  // The header packets end with a page of their own, so the audio starts with
+  // the page following the one where the last header packet ends.
+
+  const unsigned int headerPackets = headerPacketCount();
+  if(headerPackets == 0) {
+    debug("Ogg::File::audioDataRanges() -- Unknown codec.");
+    return RangeList();
+  }
+
+  readPages(headerPackets - 1);
+
+  if(d->pages.isEmpty() || nextPacketIndex(d->pages.back()) < headerPackets)
+    return RangeList();
+
+  RangeList ranges;
+
+  long offset = d->pages.back()->fileOffset() + d->pages.back()->size();
+  const long fileLength = length();
+
+  while(offset < fileLength) {
+    const PageHeader header(this, offset);
+    if(!header.isValid())
+      break;
+
+    if(header.dataSize() > 0)
+      ranges.append(Range(offset + header.size(), header.dataSize()));
+
+    offset += header.size() + header.dataSize();
+  }
+
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected members
 ////////////////////////////////////////////////////////////////////////////////
@@ -191,6 +237,10 @@ Ogg::File::File(IOStream *stream) :
 
 bool Ogg::File::readPages(unsigned int i)
 {
+  TAGLIB_TRACE("Ogg::File::readPages");
+
+  Budget *budget = this->budget();
+
   while(true) {
     unsigned int packetIndex;
     long offset;
@@ -214,6 +264,9 @@ bool Ogg::File::readPages(unsigned int i)
 
     // Read the next page and add it to the page list.
 
+    if(budget && !budget->addObject())
+      return false;
+
     Page *nextPage = new Page(this, offset);
     if(!nextPage->header()->isValid()) {
       delete nextPage;
@@ -228,6 +281,46 @@ bool Ogg::File::readPages(unsigned int i)
   }
 }
 
+unsigned int Ogg::File::headerPacketCount()
+{
+  const ByteVector first = packet(0);
+
+  if(first.startsWith("\x01vorbis"))
+    return 3;
+
+  if(first.startsWith("OpusHead"))
+    return 2;
+
+  // Speex has a header and a comment packet, followed by the number of extra
+  // headers given in the header.
+
+  if(first.startsWith("Speex   ") && first.size() >= 80)
+    return 2 + first.toUInt(68, false);
+
+  // The FLAC mapping has a packet for each metadata block, the last of which
+  // has the last-metadata-block flag set.  Since FLAC 1.1.2 the first packet
+  // holds the STREAMINFO block, before that it only holds "fLaC".
+
+  if(first.startsWith("\x7f""FLAC") || first.startsWith("fLaC")) {
+    if(first.size() > 13 && (first[13] & 0x80))
+      return 1;
+
+    unsigned int i = 1;
+    while(true) {
+      const ByteVector block = packet(i);
+      if(block.isEmpty())
+        return 0;
+
+      ++i;
+
+      if(block[0] & 0x80)
+        return i;
+    }
+  }
+
+  return 0;
+}
+
 void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
 {
   if(!readPages(i)) {
@@ -282,6 +375,9 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
   insert(data, originalOffset, originalLength);
 
   // Renumber the following pages if the pages have been split or merged.
+  // The page checksum has no initial value and no final XOR, so the new
+  // checksum is the old one XOR the checksum of the changed bits.  Only the
+  // page headers are read; the page bodies are left alone.
 
   const int numberOfNewPages
     = pages.back()->pageSequenceNumber() - lastPage->pageSequenceNumber();
@@ -294,11 +390,27 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
       if(!page.header()->isValid())
         break;
 
-      page.setPageSequenceNumber(page.pageSequenceNumber() + numberOfNewPages);
-      const ByteVector data = page.render();
+      seek(pageOffset + 18);
+      const ByteVector fields = readBlock(8);
+      if(fields.size() != 8)
+        break;
+
+      const unsigned int sequenceNumber = fields.toUInt(0U, false);
+      const unsigned int checksum       = fields.toUInt(4U, false);
+      const unsigned int newSequenceNumber = sequenceNumber + numberOfNewPages;
+
+      // The changed bits start at byte 18, and the checksum of the leading
+      // zeros is zero, so the page from byte 18 on is all that counts.
+
+      ByteVector change(page.size() - 18, '\0');
+      const ByteVector bits = ByteVector::fromUInt(sequenceNumber ^ newSequenceNumber, false);
+      std::copy(bits.begin(), bits.end(), change.begin());
+
+      ByteVector patch = ByteVector::fromUInt(newSequenceNumber, false);
+      patch.append(ByteVector::fromUInt(checksum ^ change.checksum(), false));
 
       seek(pageOffset + 18);
-      writeBlock(data.mid(18, 8));
+      writeBlock(patch);
 
       if(page.header()->lastPageOfStream())
         break;
@@ -80,6 +80,14 @@ namespace TagLib {
 
       virtual bool save();
 
+      /*!
+       * Returns the bodies of the audio pages, that is all the pages after the
+       * ones which hold the header packets.
+       *
+       * \see TagLib::File::audioDataRanges()
+       */
+      RangeList audioDataRanges();
+
     protected:
       /*!
        * Constructs an Ogg file from \a file.
@@ -112,6 +120,12 @@ namespace TagLib {
        */
       bool readPages(unsigned int i);
 
+      /*!
+       * Returns the number of header packets at the beginning of the stream,
+       * or 0 if the codec is unknown.
+       */
+      unsigned int headerPacketCount();
+
       /*!
        * Writes the requested packet to the file.
        */
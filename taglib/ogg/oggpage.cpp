@@ -27,6 +27,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tbytevectorbuilder.h>
 
 #include "oggpage.h"
 #include "oggpageheader.h"
@@ -167,14 +168,14 @@ int Ogg::Page::size() const
 
 ByteVector Ogg::Page::render() const
 {
-  ByteVector data;
+  ByteVectorBuilder builder;
 
-  data.append(d->header.render());
+  builder.append(d->header.render());
 
   if(d->packets.isEmpty()) {
     if(d->file) {
       d->file->seek(d->fileOffset + d->header.size());
-      data.append(d->file->readBlock(d->header.dataSize()));
+      builder.append(d->file->readBlock(d->header.dataSize()));
     }
     else
       debug("Ogg::Page::render() -- this page is empty!");
@@ -182,9 +183,11 @@ ByteVector Ogg::Page::render() const
   else {
     ByteVectorList::ConstIterator it = d->packets.begin();
     for(; it != d->packets.end(); ++it)
-      data.append(*it);
+      builder.append(*it);
   }
 
+  ByteVector data = builder.toByteVector();
+
   // Compute and set the checksum for the Ogg page.  The checksum is taken over
   // the entire page with the 4 bytes reserved for the checksum zeroed and then
   // inserted in bytes 22-25 of the page header.
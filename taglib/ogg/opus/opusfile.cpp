@@ -29,6 +29,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
 
@@ -62,7 +63,7 @@ bool Ogg::Opus::File::isSupported(IOStream *stream)
 {
   // An Opus file has IDs "OggS" and "OpusHead" somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), false);
   return (buffer.find("OggS") >= 0 && buffer.find("OpusHead") >= 0);
 }
 
@@ -113,10 +114,15 @@ Opus::Properties *Opus::File::audioProperties() const
 
 bool Opus::File::save()
 {
-  if(!d->comment)
-    d->comment = new Ogg::XiphComment();
+  // The comment packet is only rewritten if the comment has changed.
 
-  setPacket(1, ByteVector("OpusTags", 8) + d->comment->render(false));
+  if(!d->comment || d->comment->isModified()) {
+    if(!d->comment)
+      d->comment = new Ogg::XiphComment();
+
+    setPacket(1, ByteVector("OpusTags", 8) + d->comment->render(false));
+    d->comment->setModified(false);
+  }
 
   return Ogg::File::save();
 }
@@ -127,6 +133,8 @@ bool Opus::File::save()
 
 void Opus::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   ByteVector opusHeaderData = packet(0);
 
   if(!opusHeaderData.startsWith("OpusHead")) {
@@ -145,6 +153,8 @@ void Opus::File::read(bool readProperties)
 
   d->comment = new Ogg::XiphComment(commentHeaderData.mid(8));
 
-  if(readProperties)
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(this);
+  }
 }
@@ -29,6 +29,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
 
@@ -62,7 +63,7 @@ bool Ogg::Speex::File::isSupported(IOStream *stream)
 {
   // A Speex file has IDs "OggS" and "Speex   " somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), false);
   return (buffer.find("OggS") >= 0 && buffer.find("Speex   ") >= 0);
 }
 
@@ -113,10 +114,15 @@ Speex::Properties *Speex::File::audioProperties() const
 
 bool Speex::File::save()
 {
-  if(!d->comment)
-    d->comment = new Ogg::XiphComment();
+  // The comment packet is only rewritten if the comment has changed.
 
-  setPacket(1, d->comment->render());
+  if(!d->comment || d->comment->isModified()) {
+    if(!d->comment)
+      d->comment = new Ogg::XiphComment();
+
+    setPacket(1, d->comment->render());
+    d->comment->setModified(false);
+  }
 
   return Ogg::File::save();
 }
@@ -127,6 +133,8 @@ bool Speex::File::save()
 
 void Speex::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   ByteVector speexHeaderData = packet(0);
 
   if(!speexHeaderData.startsWith("Speex   ")) {
@@ -138,6 +146,8 @@ void Speex::File::read(bool readProperties)
 
   d->comment = new Ogg::XiphComment(commentHeaderData);
 
-  if(readProperties)
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(this);
+  }
 }
@@ -27,6 +27,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
 
@@ -67,7 +68,7 @@ bool Vorbis::File::isSupported(IOStream *stream)
 {
   // An Ogg Vorbis file has IDs "OggS" and "\x01vorbis" somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
+  const ByteVector buffer = Utils::readHeader(stream, defaultScanBufferSize(), false);
   return (buffer.find("OggS") >= 0 && buffer.find("\x01vorbis") >= 0);
 }
 
@@ -118,13 +119,18 @@ Vorbis::Properties *Vorbis::File::audioProperties() const
 
 bool Vorbis::File::save()
 {
-  ByteVector v(vorbisCommentHeaderID);
+  // The comment packet is only rewritten if the comment has changed.
 
-  if(!d->comment)
-    d->comment = new Ogg::XiphComment();
-  v.append(d->comment->render());
+  if(!d->comment || d->comment->isModified()) {
+    ByteVector v(vorbisCommentHeaderID);
 
-  setPacket(1, v);
+    if(!d->comment)
+      d->comment = new Ogg::XiphComment();
+    v.append(d->comment->render());
+
+    setPacket(1, v);
+    d->comment->setModified(false);
+  }
 
   return Ogg::File::save();
 }
@@ -135,6 +141,8 @@ bool Vorbis::File::save()
 
 void Vorbis::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   ByteVector commentHeaderData = packet(1);
 
   if(commentHeaderData.mid(0, 7) != vorbisCommentHeaderID) {
@@ -145,6 +153,8 @@ void Vorbis::File::read(bool readProperties)
 
   d->comment = new Ogg::XiphComment(commentHeaderData.mid(7));
 
-  if(readProperties)
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(this);
+  }
 }
@@ -25,6 +25,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tlayout.h>
 
 #include <oggpageheader.h>
 
@@ -64,6 +65,23 @@ namespace TagLib {
   static const char vorbisSetupHeaderID[] = { 0x01, 'v', 'o', 'r', 'b', 'i', 's', 0 };
 }
 
+namespace
+{
+  // The identification header, see the Vorbis I specification, section 4.2.2.
+
+  struct IdentificationHeader
+  {
+    static const unsigned int size = 28;
+    typedef Layout::Bytes<0, 7> PacketType;
+    typedef Layout::U32L<7>     VorbisVersion;
+    typedef Layout::U8<11>      Channels;
+    typedef Layout::U32L<12>    SampleRate;
+    typedef Layout::U32L<16>    BitrateMaximum;
+    typedef Layout::U32L<20>    BitrateNominal;
+    typedef Layout::U32L<24>    BitrateMinimum;
+  };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
@@ -138,38 +156,25 @@ void Vorbis::Properties::read(File *file)
 {
   // Get the identification header from the Ogg implementation.
 
+  typedef IdentificationHeader H;
   const ByteVector data = file->packet(0);
-  if(data.size() < 28) {
+  const Layout::View<H> header(data);
+  if(!header.isValid()) {
     debug("Vorbis::Properties::read() -- data is too short.");
     return;
   }
 
-  unsigned int pos = 0;
-
-  if(data.mid(pos, 7) != vorbisSetupHeaderID) {
+  if(header.get<H::PacketType>() != vorbisSetupHeaderID) {
     debug("Vorbis::Properties::read() -- invalid Vorbis identification header");
     return;
   }
 
-  pos += 7;
-
-  d->vorbisVersion = data.toUInt(pos, false);
-  pos += 4;
-
-  d->channels = static_cast<unsigned char>(data[pos]);
-  pos += 1;
-
-  d->sampleRate = data.toUInt(pos, false);
-  pos += 4;
-
-  d->bitrateMaximum = data.toUInt(pos, false);
-  pos += 4;
-
-  d->bitrateNominal = data.toUInt(pos, false);
-  pos += 4;
-
-  d->bitrateMinimum = data.toUInt(pos, false);
-  pos += 4;
+  d->vorbisVersion  = header.get<H::VorbisVersion>();
+  d->channels       = header.get<H::Channels>();
+  d->sampleRate     = header.get<H::SampleRate>();
+  d->bitrateMaximum = header.get<H::BitrateMaximum>();
+  d->bitrateNominal = header.get<H::BitrateNominal>();
+  d->bitrateMinimum = header.get<H::BitrateMinimum>();
 
   // Find the length of the file.  See http://wiki.xiph.org/VorbisStreamLength/
   // for my notes on the topic.
@@ -29,6 +29,7 @@
 #include <flacpicture.h>
 #include <xiphcomment.h>
 #include <tpropertymap.h>
+#include <tagutils.h>
 
 using namespace TagLib;
 
@@ -223,6 +224,8 @@ PropertyMap Ogg::XiphComment::properties() const
 
 PropertyMap Ogg::XiphComment::setProperties(const PropertyMap &properties)
 {
+  const Utils::PropertiesGuard<XiphComment> guard(this);
+
   // check which keys are to be deleted
   StringList toRemove;
   for(FieldConstIterator it = d->fieldListMap.begin(); it != d->fieldListMap.end(); ++it)
@@ -286,11 +289,19 @@ void Ogg::XiphComment::addField(const String &key, const String &value, bool rep
 
   const String upperKey = key.upper();
 
-  if(replace)
+  if(replace) {
+    FieldConstIterator it = d->fieldListMap.find(upperKey);
+    if(value.isEmpty() ? it == d->fieldListMap.end() || it->second.isEmpty()
+                       : it != d->fieldListMap.end() && it->second == StringList(value))
+      return;
+
     removeFields(upperKey);
+  }
 
-  if(!key.isEmpty() && !value.isEmpty())
+  if(!key.isEmpty() && !value.isEmpty()) {
     d->fieldListMap[upperKey].append(value);
+    setModified();
+  }
 }
 
 void Ogg::XiphComment::removeField(const String &key, const String &value)
@@ -303,15 +314,22 @@ void Ogg::XiphComment::removeField(const String &key, const String &value)
 
 void Ogg::XiphComment::removeFields(const String &key)
 {
-  d->fieldListMap.erase(key.upper());
+  FieldListMap::Iterator it = d->fieldListMap.find(key.upper());
+  if(it != d->fieldListMap.end()) {
+    if(!it->second.isEmpty())
+      setModified();
+    d->fieldListMap.erase(it);
+  }
 }
 
 void Ogg::XiphComment::removeFields(const String &key, const String &value)
 {
   StringList &fields = d->fieldListMap[key.upper()];
   for(StringList::Iterator it = fields.begin(); it != fields.end(); ) {
-    if(*it == value)
+    if(*it == value) {
       it = fields.erase(it);
+      setModified();
+    }
     else
       ++it;
   }
@@ -319,6 +337,9 @@ void Ogg::XiphComment::removeFields(const String &key, const String &value)
 
 void Ogg::XiphComment::removeAllFields()
 {
+  if(!isEmpty())
+    setModified();
+
   d->fieldListMap.clear();
 }
 
@@ -330,8 +351,10 @@ bool Ogg::XiphComment::contains(const String &key) const
 void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 {
   PictureIterator it = d->pictureList.find(picture);
-  if(it != d->pictureList.end())
+  if(it != d->pictureList.end()) {
     d->pictureList.erase(it);
+    setModified();
+  }
 
   if(del)
     delete picture;
@@ -339,12 +362,16 @@ void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 
 void Ogg::XiphComment::removeAllPictures()
 {
+  if(!d->pictureList.isEmpty())
+    setModified();
+
   d->pictureList.clear();
 }
 
 void Ogg::XiphComment::addPicture(FLAC::Picture * picture)
 {
   d->pictureList.append(picture);
+  setModified();
 }
 
 List<FLAC::Picture *> Ogg::XiphComment::pictureList()
@@ -439,6 +466,12 @@ void Ogg::XiphComment::parse(const ByteVector &data)
     return;
   }
 
+  // Fields which are dropped or normalised here are written in their
+  // canonical form when the comment is saved, so the comment counts as
+  // modified.
+
+  bool normalized = false;
+
   for(unsigned int i = 0; i < commentFields; i++) {
 
     // Each comment field is in the format "KEY=value" in a UTF8 string and has
@@ -460,14 +493,20 @@ void Ogg::XiphComment::parse(const ByteVector &data)
     const int sep = entry.find('=');
     if(sep < 1) {
       debug("Ogg::XiphComment::parse() - Discarding a field. Separator not found.");
+      normalized = true;
       continue;
     }
 
     // Parse the key
 
-    const String key = String(entry.mid(0, sep), String::UTF8).upper();
+    const String fieldName(entry.mid(0, sep), String::UTF8);
+    const String key = fieldName.upper();
+    if(key != fieldName)
+      normalized = true;
+
     if(!checkKey(key)) {
       debug("Ogg::XiphComment::parse() - Discarding a field. Invalid key.");
+      normalized = true;
       continue;
     }
 
@@ -478,6 +517,7 @@ void Ogg::XiphComment::parse(const ByteVector &data)
       const ByteVector picturedata = ByteVector::fromBase64(entry.mid(sep + 1));
       if(picturedata.isEmpty()) {
         debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
+        normalized = true;
         continue;
       }
 
@@ -492,12 +532,15 @@ void Ogg::XiphComment::parse(const ByteVector &data)
         else {
           delete picture;
           debug("Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
+          normalized = true;
         }
       }
       else {
 
         // Assume it's some type of image file
 
+        normalized = true;
+
         FLAC::Picture * picture = new FLAC::Picture();
         picture->setData(picturedata);
         picture->setMimeType("image/");
@@ -512,4 +555,6 @@ void Ogg::XiphComment::parse(const ByteVector &data)
       addField(key, String(entry.mid(sep + 1), String::UTF8), false);
     }
   }
+
+  setModified(normalized);
 }
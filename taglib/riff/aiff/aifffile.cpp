@@ -23,8 +23,12 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tbytevector.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <id3v2tag.h>
 #include <tstringlist.h>
 #include <tpropertymap.h>
@@ -118,6 +122,9 @@ RIFF::AIFF::Properties *RIFF::AIFF::File::audioProperties() const
 
 bool RIFF::AIFF::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("RIFF::AIFF::File::save() -- File is read only.");
     return false;
@@ -128,6 +135,11 @@ bool RIFF::AIFF::File::save()
     return false;
   }
 
+  // The tag in the file is up to date.
+
+  if(d->hasID3v2 && !d->tag->isModified())
+    return true;
+
   if(d->hasID3v2) {
     removeChunk("ID3 ");
     removeChunk("id3 ");
@@ -136,6 +148,7 @@ bool RIFF::AIFF::File::save()
 
   if(tag() && !tag()->isEmpty()) {
     setChunkData("ID3 ", d->tag->render());
+    d->tag->setModified(false);
     d->hasID3v2 = true;
   }
 
@@ -147,12 +160,35 @@ bool RIFF::AIFF::File::hasID3v2Tag() const
   return d->hasID3v2;
 }
 
+File::RangeList RIFF::AIFF::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  RangeList ranges;
+
+  const long fileLength = length();
+
+  for(unsigned int i = 0; i < chunkCount(); ++i) {
+    if(chunkName(i) == "SSND") {
+      const long offset = chunkOffset(i);
+      const long size = std::min<long>(chunkDataSize(i), fileLength - offset);
+      if(size > 0)
+        ranges.append(Range(offset, size));
+    }
+  }
+
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void RIFF::AIFF::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   for(unsigned int i = 0; i < chunkCount(); ++i) {
     const ByteVector name = chunkName(i);
     if(name == "ID3 " || name == "id3 ") {
@@ -162,6 +198,10 @@ void RIFF::AIFF::File::read(bool readProperties)
       }
       else {
         debug("RIFF::AIFF::File::read() - Duplicate ID3v2 tag found.");
+
+        // Saving the tag removes the duplicates.
+
+        d->tag->setModified();
       }
     }
   }
@@ -169,6 +209,8 @@ void RIFF::AIFF::File::read(bool readProperties)
   if(!d->tag)
     d->tag = new ID3v2::Tag();
 
-  if(readProperties)
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(this, Properties::Average);
+  }
 }
@@ -134,6 +134,13 @@ namespace TagLib {
          */
         static bool isSupported(IOStream *stream);
 
+        /*!
+         * Returns the ranges of the file which hold the audio data.
+         *
+         * \see TagLib::File::audioDataRanges()
+         */
+        RangeList audioDataRanges();
+
       private:
         File(const File &);
         File &operator=(const File &);
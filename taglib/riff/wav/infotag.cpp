@@ -75,6 +75,7 @@ RIFF::Info::Tag::Tag(const ByteVector &data) :
   d(new TagPrivate())
 {
   parse(data);
+  setModified(false);
 }
 
 RIFF::Info::Tag::Tag() :
@@ -153,7 +154,7 @@ void RIFF::Info::Tag::setYear(unsigned int i)
   if(i != 0)
     setFieldText("ICRD", String::number(i));
   else
-    d->fieldListMap.erase("ICRD");
+    removeField("ICRD");
 }
 
 void RIFF::Info::Tag::setTrack(unsigned int i)
@@ -161,7 +162,7 @@ void RIFF::Info::Tag::setTrack(unsigned int i)
   if(i != 0)
     setFieldText("IPRT", String::number(i));
   else
-    d->fieldListMap.erase("IPRT");
+    removeField("IPRT");
 }
 
 bool RIFF::Info::Tag::isEmpty() const
@@ -188,16 +189,20 @@ void RIFF::Info::Tag::setFieldText(const ByteVector &id, const String &s)
   if(!isValidChunkName(id))
     return;
 
-  if(!s.isEmpty())
-    d->fieldListMap[id] = s;
-  else
+  if(s.isEmpty())
     removeField(id);
+  else if(!d->fieldListMap.contains(id) || d->fieldListMap[id] != s) {
+    d->fieldListMap[id] = s;
+    setModified();
+  }
 }
 
 void RIFF::Info::Tag::removeField(const ByteVector &id)
 {
-  if(d->fieldListMap.contains(id))
+  if(d->fieldListMap.contains(id)) {
     d->fieldListMap.erase(id);
+    setModified();
+  }
 }
 
 ByteVector RIFF::Info::Tag::render() const
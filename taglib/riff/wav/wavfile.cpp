@@ -23,8 +23,12 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tbytevector.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tstringlist.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
@@ -152,6 +156,9 @@ bool RIFF::WAV::File::save()
 
 bool RIFF::WAV::File::save(TagTypes tags, bool stripOthers, int id3v2Version)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("RIFF::WAV::File::save() -- File is read only.");
     return false;
@@ -165,20 +172,30 @@ bool RIFF::WAV::File::save(TagTypes tags, bool stripOthers, int id3v2Version)
   if(stripOthers)
     strip(static_cast<TagTypes>(AllTags & ~tags));
 
-  if(tags & ID3v2) {
+  // The tags which are in the file and have not been changed since they were
+  // read or saved are not written again.
+
+  const bool ID3v2Unchanged = d->hasID3v2 && ID3v2Tag() && !ID3v2Tag()->isModified() &&
+    ID3v2Tag()->header()->majorVersion() == static_cast<unsigned int>(id3v2Version);
+
+  const bool infoUnchanged = d->hasInfo && InfoTag() && !InfoTag()->isModified();
+
+  if((tags & ID3v2) && !ID3v2Unchanged) {
     removeTagChunks(ID3v2);
 
     if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
       setChunkData("ID3 ", ID3v2Tag()->render(id3v2Version));
+      ID3v2Tag()->setModified(false);
       d->hasID3v2 = true;
     }
   }
 
-  if(tags & Info) {
+  if((tags & Info) && !infoUnchanged) {
     removeTagChunks(Info);
 
     if(InfoTag() && !InfoTag()->isEmpty()) {
       setChunkData("LIST", InfoTag()->render(), true);
+      InfoTag()->setModified(false);
       d->hasInfo = true;
     }
   }
@@ -196,12 +213,35 @@ bool RIFF::WAV::File::hasInfoTag() const
   return d->hasInfo;
 }
 
+File::RangeList RIFF::WAV::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  RangeList ranges;
+
+  const long fileLength = length();
+
+  for(unsigned int i = 0; i < chunkCount(); ++i) {
+    if(chunkName(i) == "data") {
+      const long offset = chunkOffset(i);
+      const long size = std::min<long>(chunkDataSize(i), fileLength - offset);
+      if(size > 0)
+        ranges.append(Range(offset, size));
+    }
+  }
+
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void RIFF::WAV::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   for(unsigned int i = 0; i < chunkCount(); ++i) {
     const ByteVector name = chunkName(i);
     if(name == "ID3 " || name == "id3 ") {
@@ -211,6 +251,10 @@ void RIFF::WAV::File::read(bool readProperties)
       }
       else {
         debug("RIFF::WAV::File::read() - Duplicate ID3v2 tag found.");
+
+        // Saving the tag removes the duplicates.
+
+        d->tag[ID3v2Index]->setModified();
       }
     }
     else if(name == "LIST") {
@@ -222,6 +266,7 @@ void RIFF::WAV::File::read(bool readProperties)
         }
         else {
           debug("RIFF::WAV::File::read() - Duplicate INFO tag found.");
+          d->tag[InfoIndex]->setModified();
         }
       }
     }
@@ -233,8 +278,10 @@ void RIFF::WAV::File::read(bool readProperties)
   if(!d->tag[InfoIndex])
     d->tag.set(InfoIndex, new RIFF::Info::Tag());
 
-  if(readProperties)
+  if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
     d->properties = new Properties(this, Properties::Average);
+  }
 }
 
 void RIFF::WAV::File::removeTagChunks(TagTypes tags)
@@ -27,13 +27,17 @@
 #include "s3mfile.h"
 #include "tstringlist.h"
 #include "tdebug.h"
+#include "tinstrumentedstream.h"
+#include "tbudgetstream.h"
 #include "modfileprivate.h"
+#include "modreader.h"
 #include "tpropertymap.h"
 
 #include <iostream>
 
 using namespace TagLib;
 using namespace S3M;
+using Mod::StructReader;
 
 class S3M::File::FilePrivate
 {
@@ -52,8 +56,10 @@ S3M::File::File(FileName file, bool readProperties,
   Mod::FileBase(file),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 S3M::File::File(IOStream *stream, bool readProperties,
@@ -61,8 +67,10 @@ S3M::File::File(IOStream *stream, bool readProperties,
   Mod::FileBase(stream),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 S3M::File::~File()
@@ -92,6 +100,9 @@ S3M::Properties *S3M::File::audioProperties() const
 
 bool S3M::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("S3M::File::save() - Cannot save to a read only file.");
     return false;
@@ -148,48 +159,72 @@ bool S3M::File::save()
 
 void S3M::File::read(bool)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   if(!isOpen())
     return;
 
-  READ_STRING(d->tag.setTitle, 28);
-  READ_BYTE_AS(mark);
-  READ_BYTE_AS(type);
-
-  READ_ASSERT(mark == 0x1A && type == 0x10);
+  String title;
+  unsigned char  mark              = 0;
+  unsigned char  type              = 0;
+  unsigned short length            = 0;
+  unsigned short sampleCount       = 0;
+  unsigned short patternCount      = 0;
+  unsigned short flags             = 0;
+  unsigned short trackerVersion    = 0;
+  unsigned short fileFormatVersion = 0;
+  ByteVector magic;
+  unsigned char  globalVolume      = 0;
+  unsigned char  bpmSpeed          = 0;
+  unsigned char  tempo             = 0;
+  unsigned char  masterVolume      = 0;
+  ByteVector settings;
+
+  // I've seen players who call the two bytes after the master volume
+  // "ultra click" and "use panning values" (if == 0xFC).
+  // I don't see them in any spec, though.
+  // Hm, but there is "UltraClick-removal" and some other
+  // variables in ScreamTracker IIIs GUI.
 
-  seek(32);
+  StructReader header;
+  header.string(title, 28)
+        .byte(mark)
+        .byte(type)
+        .skip(2)
+        .u16L(length)
+        .u16L(sampleCount)
+        .u16L(patternCount)
+        .u16L(flags)
+        .u16L(trackerVersion)
+        .u16L(fileFormatVersion)
+        .bytes(magic, 4)
+        .byte(globalVolume)
+        .byte(bpmSpeed)
+        .byte(tempo)
+        .byte(masterVolume)
+        .skip(12)
+        .bytes(settings, 32);
 
-  READ_U16L_AS(length);
-  READ_U16L_AS(sampleCount);
+  seek(0);
+  READ_ASSERT(header.read(*this, header.size()) == header.size());
+  READ_ASSERT(mark == 0x1A && type == 0x10);
+  READ_ASSERT(magic == "SCRM");
 
+  d->tag.setTitle(title);
   d->properties.setSampleCount(sampleCount);
-
-  READ_U16L(d->properties.setPatternCount);
-  READ_U16L(d->properties.setFlags);
-  READ_U16L(d->properties.setTrackerVersion);
-  READ_U16L(d->properties.setFileFormatVersion);
-
-  READ_ASSERT(readBlock(4) == "SCRM");
-
-  READ_BYTE(d->properties.setGlobalVolume);
-  READ_BYTE(d->properties.setBpmSpeed);
-  READ_BYTE(d->properties.setTempo);
-
-  READ_BYTE_AS(masterVolume);
+  d->properties.setPatternCount(patternCount);
+  d->properties.setFlags(flags);
+  d->properties.setTrackerVersion(trackerVersion);
+  d->properties.setFileFormatVersion(fileFormatVersion);
+  d->properties.setGlobalVolume(globalVolume);
+  d->properties.setBpmSpeed(bpmSpeed);
+  d->properties.setTempo(tempo);
   d->properties.setMasterVolume(masterVolume & 0x7f);
   d->properties.setStereo((masterVolume & 0x80) != 0);
 
-  // I've seen players who call the next two bytes
-  // "ultra click" and "use panning values" (if == 0xFC).
-  // I don't see them in any spec, though.
-  // Hm, but there is "UltraClick-removal" and some other
-  // variables in ScreamTracker IIIs GUI.
-
-  seek(12, Current);
-
   int channels = 0;
   for(int i = 0; i < 32; ++ i) {
-    READ_BYTE_AS(setting);
+    const unsigned char setting = settings[i];
     // or if(setting >= 128)?
     // or channels = i + 1;?
     // need a better spec!
@@ -197,48 +232,60 @@ void S3M::File::read(bool)
   }
   d->properties.setChannels(channels);
 
+  // The orders and the sample pointers follow the header and are read at
+  // once.
   seek(96);
+  const ByteVector tables = readBlock(length + 2UL * sampleCount);
+
   unsigned short realLength = 0;
   for(unsigned short i = 0; i < length; ++ i) {
-    READ_BYTE_AS(order);
+    READ_ASSERT(i < tables.size());
+    const unsigned char order = tables[i];
     if(order == 255) break;
     if(order != 254) ++ realLength;
   }
   d->properties.setLengthInPatterns(realLength);
 
-  seek(channels, Current);
-
   // Note: The S3M spec mentions samples and instruments, but in
   //       the header there are only pointers to instruments.
   //       However, there I never found instruments (SCRI) but
   //       instead samples (SCRS).
   StringList comment;
   for(unsigned short i = 0; i < sampleCount; ++ i) {
-    seek(96L + length + ((long)i << 1));
-
-    READ_U16L_AS(sampleHeaderOffset);
-    seek((long)sampleHeaderOffset << 4);
-
-    READ_BYTE_AS(sampleType);
-    READ_STRING_AS(dosFileName, 13);
-    READ_U16L_AS(sampleDataOffset);
-    READ_U32L_AS(sampleLength);
-    READ_U32L_AS(repeatStart);
-    READ_U32L_AS(repeatStop);
-    READ_BYTE_AS(sampleVolume);
-
-    seek(1, Current);
-
-    READ_BYTE_AS(packing);
-    READ_BYTE_AS(sampleFlags);
-    READ_U32L_AS(baseFrequency);
-
-    seek(12, Current);
-
-    READ_STRING_AS(sampleName, 28);
+    const unsigned int tableOffset = length + (i << 1);
+    READ_ASSERT(tableOffset + 2 <= tables.size());
+    seek((long)tables.toUShort(tableOffset, false) << 4);
+
+    unsigned char  sampleType       = 0;
+    String dosFileName;
+    unsigned short sampleDataOffset = 0;
+    unsigned long  sampleLength     = 0;
+    unsigned long  repeatStart      = 0;
+    unsigned long  repeatStop       = 0;
+    unsigned char  sampleVolume     = 0;
+    unsigned char  packing          = 0;
+    unsigned char  sampleFlags      = 0;
+    unsigned long  baseFrequency    = 0;
+    String sampleName;
+
+    StructReader sample;
+    sample.byte(sampleType)
+          .string(dosFileName, 13)
+          .u16L(sampleDataOffset)
+          .u32L(sampleLength)
+          .u32L(repeatStart)
+          .u32L(repeatStop)
+          .byte(sampleVolume)
+          .skip(1)
+          .byte(packing)
+          .byte(sampleFlags)
+          .u32L(baseFrequency)
+          .skip(12)
+          .string(sampleName, 28);
     // The next 4 bytes should be "SCRS", but I've found
     // files that are otherwise ok with 4 nils instead.
-    // READ_ASSERT(readBlock(4) == "SCRS");
+
+    READ_ASSERT(sample.read(*this, sample.size()) == sample.size());
 
     comment.append(sampleName);
   }
@@ -26,22 +26,31 @@
 #include "tag.h"
 #include "tstringlist.h"
 #include "tpropertymap.h"
+#include "tagunion.h"
+#include "id3v2tag.h"
+#include "xiphcomment.h"
+#include "flacpicture.h"
 
 using namespace TagLib;
 
 class Tag::TagPrivate
 {
+public:
+  TagPrivate() :
+    modified(false) {}
 
+  bool modified;
 };
 
-Tag::Tag()
+Tag::Tag() :
+  d(new TagPrivate())
 {
 
 }
 
 Tag::~Tag()
 {
-
+  delete d;
 }
 
 bool Tag::isEmpty() const
@@ -178,3 +187,59 @@ void Tag::duplicate(const Tag *source, Tag *target, bool overwrite) // static
       target->setTrack(source->track());
   }
 }
+
+bool Tag::isModified() const
+{
+  if(d->modified)
+    return true;
+
+  // The items which are changed through pointers are asked as well.
+
+  if(const ID3v2::Tag *t = dynamic_cast<const ID3v2::Tag *>(this)) {
+    const ID3v2::FrameList &frames = t->frameList();
+    for(ID3v2::FrameList::ConstIterator it = frames.begin(); it != frames.end(); ++it) {
+      if((*it)->isModified())
+        return true;
+    }
+  }
+  else if(const Ogg::XiphComment *t = dynamic_cast<const Ogg::XiphComment *>(this)) {
+    const List<FLAC::Picture *> pictures = const_cast<Ogg::XiphComment *>(t)->pictureList();
+    for(List<FLAC::Picture *>::ConstIterator it = pictures.begin(); it != pictures.end(); ++it) {
+      if((*it)->isModified())
+        return true;
+    }
+  }
+  else if(const TagUnion *t = dynamic_cast<const TagUnion *>(this)) {
+    for(int i = 0; i < 3; ++i) {
+      if(t->tag(i) && t->tag(i)->isModified())
+        return true;
+    }
+  }
+
+  return false;
+}
+
+void Tag::setModified(bool modified)
+{
+  d->modified = modified;
+
+  if(modified)
+    return;
+
+  if(ID3v2::Tag *t = dynamic_cast<ID3v2::Tag *>(this)) {
+    const ID3v2::FrameList &frames = t->frameList();
+    for(ID3v2::FrameList::ConstIterator it = frames.begin(); it != frames.end(); ++it)
+      (*it)->setModified(false);
+  }
+  else if(Ogg::XiphComment *t = dynamic_cast<Ogg::XiphComment *>(this)) {
+    const List<FLAC::Picture *> pictures = t->pictureList();
+    for(List<FLAC::Picture *>::ConstIterator it = pictures.begin(); it != pictures.end(); ++it)
+      (*it)->setModified(false);
+  }
+  else if(TagUnion *t = dynamic_cast<TagUnion *>(this)) {
+    for(int i = 0; i < 3; ++i) {
+      if(t->tag(i))
+        t->tag(i)->setModified(false);
+    }
+  }
+}
@@ -182,6 +182,31 @@ namespace TagLib {
      */
     static void duplicate(const Tag *source, Tag *target, bool overwrite = true);
 
+    /*!
+     * Returns true if the tag has been changed since it was read from or last
+     * saved to its file.  The files use this to skip saving tags which have
+     * not changed.
+     *
+     * Calling setProperties() with the properties which the tag already has
+     * does not count as a change.  The items which are changed through
+     * pointers, such as ID3v2 frames and FLAC pictures, keep their own flag
+     * which is taken into account.
+     *
+     * \see setModified()
+     */
+    bool isModified() const;
+
+    /*!
+     * Marks the tag as changed if \a modified is true.  Otherwise the tag and
+     * all of its items are marked as unchanged, which the files do when they
+     * have read or saved the tag.
+     *
+     * The setters of the tags call this, so this only has to be called after
+     * changing the tag in a way which is not tracked, e.g. through the header
+     * of an ID3v2 frame.
+     */
+    void setModified(bool modified = true);
+
   protected:
     /*!
      * Construct a Tag.  This is protected since tags should only be instantiated
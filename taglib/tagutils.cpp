@@ -23,57 +23,142 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include <tfile.h>
 
 #include "id3v1tag.h"
 #include "id3v2header.h"
 #include "apetag.h"
+#include "apefooter.h"
 
 #include "tagutils.h"
 
 using namespace TagLib;
 
-long Utils::findID3v1(File *file)
+namespace
 {
-  if(!file->isValid())
-    return -1;
+  // The size of the end of the file read at once to find the trailing tags.
+  // It covers ID3v1, a Lyrics3v2 footer, an APE footer and an ID3v2 footer,
+  // and leaves room for the last frames of the audio data.
 
-  file->seek(-128, File::End);
-  const long p = file->tell();
+  const long TrailingTagsWindowSize = 4096;
 
-  if(file->readBlock(3) == ID3v1::Tag::fileIdentifier())
-    return p;
+  const char Lyrics3v2BeginIdentifier[] = "LYRICSBEGIN";
+  const char Lyrics3v2EndIdentifier[]   = "LYRICS200";
+  const char ID3v2FooterIdentifier[]    = "3DI";
 
-  return -1;
+  // Returns length bytes at offset, from the window if it holds them.
+
+  ByteVector readAt(File *file, const Utils::TrailingTags &tags, long offset, unsigned int length)
+  {
+    if(offset >= tags.windowOffset &&
+       offset + length <= tags.windowOffset + static_cast<long>(tags.window.size()))
+      return tags.window.mid(offset - tags.windowOffset, length);
+
+    file->seek(offset);
+    return file->readBlock(length);
+  }
+
+  // Returns the size field of a Lyrics3v2 footer, which is 6 decimal digits,
+  // or -1 if it is invalid.
+
+  long lyrics3Size(const ByteVector &footer)
+  {
+    long size = 0;
+    for(int i = 0; i < 6; ++i) {
+      if(footer[i] < '0' || footer[i] > '9')
+        return -1;
+      size = size * 10 + (footer[i] - '0');
+    }
+    return size;
+  }
 }
 
-long Utils::findID3v2(File *file)
+Utils::TrailingTags::TrailingTags() :
+  ID3v1Location(-1),
+  APEFooterLocation(-1),
+  lyrics3Location(-1),
+  ID3v2Location(-1),
+  audioEnd(0),
+  windowOffset(0)
 {
+}
+
+Utils::TrailingTags Utils::findTrailingTags(File *file)
+{
+  TrailingTags tags;
+
   if(!file->isValid())
-    return -1;
+    return tags;
 
-  file->seek(0);
+  tags.windowOffset = std::max<long>(file->length() - TrailingTagsWindowSize, 0);
+  file->seek(tags.windowOffset);
+  tags.window = file->readBlock(TrailingTagsWindowSize);
 
-  if(file->readBlock(3) == ID3v2::Header::fileIdentifier())
-    return 0;
+  long end = tags.windowOffset + tags.window.size();
 
-  return -1;
+  // Look for an ID3v1 tag
+
+  if(end >= 128 && readAt(file, tags, end - 128, 3) == ID3v1::Tag::fileIdentifier()) {
+    end -= 128;
+    tags.ID3v1Location = end;
+  }
+
+  // Look for a Lyrics3v2 tag, whose size does not include its footer
+
+  if(end >= 15) {
+    const ByteVector footer = readAt(file, tags, end - 15, 15);
+    if(footer.containsAt(Lyrics3v2EndIdentifier, 6)) {
+      const long start = end - 15 - lyrics3Size(footer);
+      if(start >= 0 && start < end - 15 &&
+         readAt(file, tags, start, 11) == Lyrics3v2BeginIdentifier) {
+        end = start;
+        tags.lyrics3Location = end;
+      }
+    }
+  }
+
+  // Look for an APE tag
+
+  if(end >= 32 && readAt(file, tags, end - 32, 8) == APE::Tag::fileIdentifier()) {
+    tags.APEFooterLocation = end - 32;
+
+    const APE::Footer footer(readAt(file, tags, end - 32, APE::Footer::size()));
+    if(footer.completeTagSize() <= static_cast<unsigned long>(end))
+      end -= footer.completeTagSize();
+    else
+      end -= 32;
+  }
+
+  // Look for an ID3v2 tag appended to the audio data, which has a footer
+
+  if(end >= 20) {
+    const ByteVector footer = readAt(file, tags, end - 10, 10);
+    if(footer.startsWith(ID3v2FooterIdentifier)) {
+      const ID3v2::Header header(footer);
+      const long start = end - static_cast<long>(header.completeTagSize());
+      if(header.footerPresent() && start > 0 && start < end - 20 &&
+         readAt(file, tags, start, 3) == ID3v2::Header::fileIdentifier()) {
+        end = start;
+        tags.ID3v2Location = start;
+      }
+    }
+  }
+
+  tags.audioEnd = end;
+  return tags;
 }
 
-long Utils::findAPE(File *file, long id3v1Location)
+long Utils::findID3v2(File *file)
 {
   if(!file->isValid())
     return -1;
 
-  if(id3v1Location >= 0)
-    file->seek(id3v1Location - 32, File::Beginning);
-  else
-    file->seek(-32, File::End);
-
-  const long p = file->tell();
+  file->seek(0);
 
-  if(file->readBlock(8) == APE::Tag::fileIdentifier())
-    return p;
+  if(file->readBlock(3) == ID3v2::Header::fileIdentifier())
+    return 0;
 
   return -1;
 }
@@ -31,6 +31,7 @@
 #ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
 
 #include <tbytevector.h>
+#include <tpropertymap.h>
 
 namespace TagLib {
 
@@ -39,14 +40,72 @@ namespace TagLib {
 
   namespace Utils {
 
-    long findID3v1(File *file);
+    // The locations of the tags at the end of a file, in the order they are
+    // usually written:
+    //
+    //   [audio] [ID3v2 with a footer] [APE] [Lyrics3v2] [ID3v1]
+    //
+    // Each location is -1 if the tag is not present.
 
-    long findID3v2(File *file);
+    struct TrailingTags
+    {
+      TrailingTags();
+
+      long ID3v1Location;
+      long APEFooterLocation;
+      long lyrics3Location;
+      long ID3v2Location;
+
+      // The start of the first of the tags above, or the length of the file.
+      long audioEnd;
 
-    long findAPE(File *file, long id3v1Location);
+      // The end of the file as read to find the tags, which also holds the
+      // end of the audio data for short tags.
+      long windowOffset;
+      ByteVector window;
+    };
+
+    TrailingTags findTrailingTags(File *file);
+
+    long findID3v2(File *file);
 
     ByteVector readHeader(IOStream *stream, unsigned int length, bool skipID3v2,
                           long *headerOffset = 0);
+
+    // Clears the modified flag of a tag again at the end of setProperties() if
+    // the properties have not actually changed, so that writing back the
+    // properties of a file does not make it save its tags.
+
+    template <class T>
+    class PropertiesGuard
+    {
+    public:
+      explicit PropertiesGuard(T *tag) :
+        m_tag(tag),
+        m_modified(tag->isModified()),
+        m_properties(nonEmptyProperties(tag)) {}
+
+      ~PropertiesGuard()
+      {
+        if(!m_modified && nonEmptyProperties(m_tag) == m_properties)
+          m_tag->setModified(false);
+      }
+
+    private:
+      static PropertyMap nonEmptyProperties(const T *tag)
+      {
+        PropertyMap properties = tag->properties();
+        properties.removeEmpty();
+        return properties;
+      }
+
+      PropertiesGuard(const PropertiesGuard &);
+      PropertiesGuard &operator=(const PropertiesGuard &);
+
+      T *m_tag;
+      const bool m_modified;
+      const PropertyMap m_properties;
+    };
   }
 }
 
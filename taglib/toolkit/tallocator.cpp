@@ -0,0 +1,237 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstdlib>
+#include <new>
+
+#include "tallocator.h"
+
+using namespace TagLib;
+
+// The scopes of each thread count only the allocations of that thread.
+
+#if __cplusplus >= 201103L
+# define TAGLIB_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+# define TAGLIB_THREAD_LOCAL __declspec(thread)
+#else
+# define TAGLIB_THREAD_LOCAL __thread
+#endif
+
+namespace TagLib
+{
+  // Does the bookkeeping for the replaced operator new and operator delete.
+
+  class AllocationTracker
+  {
+  public:
+    static void *allocate(size_t size);
+    static void deallocate(void *p);
+
+    static Allocator *allocator;
+    static TAGLIB_THREAD_LOCAL AllocationScope *scope;
+
+  private:
+    // Each block is prefixed with the allocator which returned it, so that it
+    // is released by the same one even if the allocator has been replaced.
+
+    union Header
+    {
+      Allocator *allocator;
+      long double alignment1;
+      void *alignment2;
+      long long alignment3;
+    };
+  };
+
+  Allocator *AllocationTracker::allocator = 0;
+  TAGLIB_THREAD_LOCAL AllocationScope *AllocationTracker::scope = 0;
+}
+
+void *AllocationTracker::allocate(size_t size)
+{
+  if(size == 0)
+    size = 1;
+
+  Allocator *const a = allocator;
+  void *const block = a ? a->allocate(sizeof(Header) + size) : std::malloc(sizeof(Header) + size);
+  if(!block)
+    return 0;
+
+  for(AllocationScope *s = scope; s; s = s->m_previous) {
+    s->m_allocations++;
+    s->m_bytesAllocated += size;
+  }
+
+  Header *const header = static_cast<Header *>(block);
+  header->allocator = a;
+  return header + 1;
+}
+
+void AllocationTracker::deallocate(void *p)
+{
+  if(!p)
+    return;
+
+  for(AllocationScope *s = scope; s; s = s->m_previous)
+    s->m_deallocations++;
+
+  Header *const header = static_cast<Header *>(p) - 1;
+  if(header->allocator)
+    header->allocator->deallocate(header);
+  else
+    std::free(header);
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+#if __cplusplus >= 201103L
+# define TAGLIB_THROW_BAD_ALLOC
+# define TAGLIB_NOTHROW noexcept
+#else
+# define TAGLIB_THROW_BAD_ALLOC throw(std::bad_alloc)
+# define TAGLIB_NOTHROW throw()
+#endif
+
+void *operator new(size_t size) TAGLIB_THROW_BAD_ALLOC
+{
+  void *p = AllocationTracker::allocate(size);
+  if(!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) TAGLIB_THROW_BAD_ALLOC
+{
+  return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) TAGLIB_NOTHROW
+{
+  return AllocationTracker::allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) TAGLIB_NOTHROW
+{
+  return AllocationTracker::allocate(size);
+}
+
+void operator delete(void *p) TAGLIB_NOTHROW
+{
+  AllocationTracker::deallocate(p);
+}
+
+void operator delete[](void *p) TAGLIB_NOTHROW
+{
+  AllocationTracker::deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) TAGLIB_NOTHROW
+{
+  AllocationTracker::deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) TAGLIB_NOTHROW
+{
+  AllocationTracker::deallocate(p);
+}
+
+#ifdef __cpp_sized_deallocation
+
+void operator delete(void *p, size_t) TAGLIB_NOTHROW
+{
+  AllocationTracker::deallocate(p);
+}
+
+void operator delete[](void *p, size_t) TAGLIB_NOTHROW
+{
+  AllocationTracker::deallocate(p);
+}
+
+#endif
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocator
+////////////////////////////////////////////////////////////////////////////////
+
+Allocator::Allocator()
+{
+}
+
+Allocator::~Allocator()
+{
+}
+
+void TagLib::setAllocator(Allocator *allocator)
+{
+  AllocationTracker::allocator = allocator;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AllocationScope
+////////////////////////////////////////////////////////////////////////////////
+
+AllocationScope::AllocationScope() :
+  m_previous(AllocationTracker::scope),
+  m_allocations(0),
+  m_deallocations(0),
+  m_bytesAllocated(0)
+{
+  AllocationTracker::scope = this;
+}
+
+AllocationScope::~AllocationScope()
+{
+  AllocationTracker::scope = m_previous;
+}
+
+unsigned long long AllocationScope::allocations() const
+{
+  return m_allocations;
+}
+
+unsigned long long AllocationScope::deallocations() const
+{
+  return m_deallocations;
+}
+
+unsigned long long AllocationScope::bytesAllocated() const
+{
+  return m_bytesAllocated;
+}
+
+bool AllocationScope::isTrackingEnabled()
+{
+#ifdef TRACK_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,157 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_ALLOCATOR_H
+#define TAGLIB_ALLOCATOR_H
+
+#include <cstddef>
+
+#include "taglib_export.h"
+
+namespace TagLib
+{
+  //! An abstraction for the memory allocator used in allocation tracking builds.
+
+  /*!
+   * If TagLib is built with the TRACK_ALLOCATIONS option, it replaces the
+   * global operator new and operator delete of the process, counts the
+   * allocations in the active AllocationScope objects and passes them on to
+   * the current allocator, which is malloc() and free() by default.  A custom
+   * allocator can be installed with setAllocator() to inject failures or to
+   * collect further statistics.
+   *
+   * \note This is a debugging facility and adds a small overhead to every
+   * allocation.  It is not meant to be enabled in production builds.
+   *
+   * \see setAllocator()
+   * \see AllocationScope
+   */
+  class TAGLIB_EXPORT Allocator
+  {
+  public:
+    Allocator();
+    virtual ~Allocator();
+
+    /*!
+     * When overridden in a derived class, returns a block of at least \a size
+     * bytes aligned for any type, or a null pointer if it is out of memory.
+     * This must not use operator new.
+     */
+    virtual void *allocate(size_t size) = 0;
+
+    /*!
+     * When overridden in a derived class, releases the block \a p which was
+     * returned by allocate().
+     */
+    virtual void deallocate(void *p) = 0;
+
+  private:
+    // Noncopyable
+    Allocator(const Allocator &);
+    Allocator &operator=(const Allocator &);
+  };
+
+  /*!
+   * Sets the allocator used for new allocations.  If the parameter
+   * \a allocator is null, malloc() and free() are restored.
+   *
+   * Blocks are always released by the allocator which returned them, so
+   * \a allocator must not be deleted while any of its blocks is still in use.
+   *
+   * The allocator is shared by all threads, so it should be set while no
+   * other thread allocates.
+   *
+   * \note This has no effect unless TagLib was built with TRACK_ALLOCATIONS.
+   *
+   * \see Allocator
+   */
+  TAGLIB_EXPORT void setAllocator(Allocator *allocator);
+
+  //! Counts the allocations made during its lifetime.
+
+  /*!
+   * Every allocation made by the current thread while an AllocationScope
+   * exists is counted in it, including the ones made in nested scopes.
+   * Allocations of other threads are not counted.  For example:
+   *
+   * \code
+   * TagLib::AllocationScope scope;
+   * TagLib::FileRef f("song.mp3");
+   * std::cout << scope.allocations() << std::endl;
+   * \endcode
+   *
+   * \note The counters are only maintained if TagLib was built with
+   * TRACK_ALLOCATIONS, see isTrackingEnabled().  Scopes must be created and
+   * destroyed in a nested order by the same thread.
+   */
+  class TAGLIB_EXPORT AllocationScope
+  {
+  public:
+    /*!
+     * Starts counting the allocations.
+     */
+    AllocationScope();
+
+    /*!
+     * Stops counting the allocations.
+     */
+    ~AllocationScope();
+
+    /*!
+     * Returns the number of blocks allocated so far in this scope.
+     */
+    unsigned long long allocations() const;
+
+    /*!
+     * Returns the number of blocks released so far in this scope, including
+     * blocks which were allocated before it was created.
+     */
+    unsigned long long deallocations() const;
+
+    /*!
+     * Returns the total size of the blocks allocated so far in this scope.
+     */
+    unsigned long long bytesAllocated() const;
+
+    /*!
+     * Returns true if TagLib was built with TRACK_ALLOCATIONS and the counters
+     * are maintained.
+     */
+    static bool isTrackingEnabled();
+
+  private:
+    // Noncopyable
+    AllocationScope(const AllocationScope &);
+    AllocationScope &operator=(const AllocationScope &);
+
+    friend class AllocationTracker;
+
+    AllocationScope *m_previous;
+    unsigned long long m_allocations;
+    unsigned long long m_deallocations;
+    unsigned long long m_bytesAllocated;
+  };
+}
+
+#endif
@@ -0,0 +1,361 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if defined(HAVE_STD_ATOMIC)
+# include <atomic>
+#endif
+
+#include "tbudgetstream.h"
+#include "tstreamchain.h"
+#include "tclock.h"
+
+using namespace TagLib;
+
+namespace
+{
+  unsigned long long milliseconds()
+  {
+    return Utils::monotonicNanoseconds() / 1000000;
+  }
+
+  bool exceeds(unsigned long long value, unsigned long long limit)
+  {
+    return limit > 0 && value > limit;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Budget
+////////////////////////////////////////////////////////////////////////////////
+
+class Budget::BudgetPrivate
+{
+public:
+  BudgetPrivate() :
+    maxBytesRead(0),
+    maxSeeks(0),
+    maxObjects(0),
+    maxMilliseconds(0),
+    cancelled(false),
+    bytesRead(0),
+    seeks(0),
+    objects(0),
+    start(milliseconds()),
+    reason(NotExhausted) {}
+
+  // Records the first reason for the budget to be exhausted.
+
+  bool exhaust(Reason r)
+  {
+    if(reason == NotExhausted)
+      reason = r;
+    return false;
+  }
+
+  unsigned long long maxBytesRead;
+  unsigned long long maxSeeks;
+  unsigned long long maxObjects;
+  unsigned long long maxMilliseconds;
+
+#if defined(HAVE_STD_ATOMIC)
+  std::atomic<bool> cancelled;
+#else
+  volatile bool cancelled;
+#endif
+
+  unsigned long long bytesRead;
+  unsigned long long seeks;
+  unsigned long long objects;
+  unsigned long long start;
+  Reason reason;
+};
+
+Budget::Budget() :
+  d(new BudgetPrivate())
+{
+}
+
+Budget::~Budget()
+{
+  delete d;
+}
+
+unsigned long long Budget::maxBytesRead() const
+{
+  return d->maxBytesRead;
+}
+
+void Budget::setMaxBytesRead(unsigned long long bytes)
+{
+  d->maxBytesRead = bytes;
+}
+
+unsigned long long Budget::maxSeeks() const
+{
+  return d->maxSeeks;
+}
+
+void Budget::setMaxSeeks(unsigned long long seeks)
+{
+  d->maxSeeks = seeks;
+}
+
+unsigned long long Budget::maxObjects() const
+{
+  return d->maxObjects;
+}
+
+void Budget::setMaxObjects(unsigned long long objects)
+{
+  d->maxObjects = objects;
+}
+
+unsigned long long Budget::maxMilliseconds() const
+{
+  return d->maxMilliseconds;
+}
+
+void Budget::setMaxMilliseconds(unsigned long long milliseconds)
+{
+  d->maxMilliseconds = milliseconds;
+}
+
+void Budget::cancel()
+{
+  d->cancelled = true;
+}
+
+unsigned long long Budget::bytesRead() const
+{
+  return d->bytesRead;
+}
+
+unsigned long long Budget::seeks() const
+{
+  return d->seeks;
+}
+
+unsigned long long Budget::objects() const
+{
+  return d->objects;
+}
+
+Budget::Reason Budget::reason() const
+{
+  return d->reason;
+}
+
+bool Budget::isExhausted()
+{
+  if(d->reason != NotExhausted)
+    return true;
+
+  if(d->cancelled)
+    d->exhaust(Cancelled);
+  else if(d->maxMilliseconds > 0 && exceeds(milliseconds() - d->start, d->maxMilliseconds))
+    d->exhaust(Time);
+
+  return d->reason != NotExhausted;
+}
+
+bool Budget::addBytesRead(unsigned long long bytes)
+{
+  d->bytesRead += bytes;
+  if(exceeds(d->bytesRead, d->maxBytesRead))
+    return d->exhaust(BytesRead);
+
+  return !isExhausted();
+}
+
+bool Budget::addSeek()
+{
+  d->seeks++;
+  if(exceeds(d->seeks, d->maxSeeks))
+    return d->exhaust(Seeks);
+
+  return !isExhausted();
+}
+
+bool Budget::addObject()
+{
+  if(isExhausted())
+    return false;
+
+  if(d->maxObjects > 0 && d->objects >= d->maxObjects)
+    return d->exhaust(Objects);
+
+  d->objects++;
+  return true;
+}
+
+void Budget::reset()
+{
+  d->cancelled = false;
+  d->bytesRead = 0;
+  d->seeks = 0;
+  d->objects = 0;
+  d->start = milliseconds();
+  d->reason = NotExhausted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// BudgetStream
+////////////////////////////////////////////////////////////////////////////////
+
+class BudgetStream::BudgetStreamPrivate
+{
+public:
+  BudgetStreamPrivate(IOStream *stream, Budget *budget) :
+    stream(stream),
+    budget(budget),
+    saving(false),
+    exhaustedWhenSaving(false) {}
+
+  bool isExhausted() const
+  {
+    return saving ? exhaustedWhenSaving : budget->reason() != Budget::NotExhausted;
+  }
+
+  IOStream *stream;
+  Budget *budget;
+  bool saving;
+  bool exhaustedWhenSaving;
+};
+
+BudgetStream::BudgetStream(IOStream *stream, Budget *budget) :
+  d(new BudgetStreamPrivate(stream, budget))
+{
+}
+
+BudgetStream::~BudgetStream()
+{
+  delete d;
+}
+
+FileName BudgetStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector BudgetStream::readBlock(unsigned long length)
+{
+  if(d->saving)
+    return d->stream->readBlock(length);
+
+  if(d->budget->isExhausted())
+    return ByteVector();
+
+  const ByteVector data = d->stream->readBlock(length);
+  d->budget->addBytesRead(data.size());
+  return data;
+}
+
+void BudgetStream::writeBlock(const ByteVector &data)
+{
+  d->stream->writeBlock(data);
+}
+
+void BudgetStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
+{
+  d->stream->insert(data, start, replace);
+}
+
+void BudgetStream::removeBlock(unsigned long start, unsigned long length)
+{
+  d->stream->removeBlock(start, length);
+}
+
+bool BudgetStream::readOnly() const
+{
+  return d->stream->readOnly() || d->isExhausted();
+}
+
+bool BudgetStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void BudgetStream::seek(long offset, Position p)
+{
+  d->stream->seek(offset, p);
+
+  if(!d->saving)
+    d->budget->addSeek();
+}
+
+void BudgetStream::clear()
+{
+  d->stream->clear();
+}
+
+long BudgetStream::tell() const
+{
+  return d->stream->tell();
+}
+
+long BudgetStream::length()
+{
+  return d->stream->length();
+}
+
+void BudgetStream::truncate(long length)
+{
+  d->stream->truncate(length);
+}
+
+IOStream *BudgetStream::stream() const
+{
+  return d->stream;
+}
+
+Budget *BudgetStream::budget() const
+{
+  return d->saving ? 0 : d->budget;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// BudgetStream::SaveScope
+////////////////////////////////////////////////////////////////////////////////
+
+BudgetStream::SaveScope::SaveScope(IOStream *stream) :
+  m_stream(Utils::findStream<BudgetStream>(stream)),
+  m_previous(false)
+{
+  if(m_stream) {
+    m_previous = m_stream->d->saving;
+    if(!m_previous)
+      m_stream->d->exhaustedWhenSaving = m_stream->d->isExhausted();
+    m_stream->d->saving = true;
+  }
+}
+
+BudgetStream::SaveScope::~SaveScope()
+{
+  if(m_stream)
+    m_stream->d->saving = m_previous;
+}
@@ -0,0 +1,346 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BUDGETSTREAM_H
+#define TAGLIB_BUDGETSTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! Limits on the resources spent opening a file
+
+  /*!
+   * A malformed file, such as a large MPEG file full of false frame syncs or
+   * an MP4 file with millions of atoms, may take a long time to parse.  A
+   * Budget caps the bytes read, the seeks, the objects parsed (atoms, pages,
+   * frame headers) and the wall time, and can be cancelled from another
+   * thread.  Once any of these is exhausted, parsing stops and the file keeps
+   * what was parsed so far; reason() tells why.
+   *
+   * The limits are zero, i.e. unlimited, by default.
+   *
+   * \see BudgetStream
+   */
+
+  class TAGLIB_EXPORT Budget
+  {
+  public:
+    /*!
+     * The reason why a budget is exhausted.
+     */
+    enum Reason {
+      //! The budget is not exhausted.
+      NotExhausted = 0,
+      //! More than maxBytesRead() bytes were read.
+      BytesRead = 1,
+      //! More than maxSeeks() seeks were issued.
+      Seeks = 2,
+      //! More than maxObjects() objects were parsed.
+      Objects = 3,
+      //! More than maxMilliseconds() passed.
+      Time = 4,
+      //! cancel() was called.
+      Cancelled = 5
+    };
+
+    /*!
+     * Constructs an unlimited budget.  The wall time is counted from now on.
+     */
+    Budget();
+
+    /*!
+     * Destroys this Budget instance.
+     */
+    ~Budget();
+
+    /*!
+     * Returns the maximum number of bytes to read, or 0 if it is unlimited.
+     */
+    unsigned long long maxBytesRead() const;
+
+    /*!
+     * Sets the maximum number of bytes to read to \a bytes, 0 meaning
+     * unlimited.  The read which crosses the limit is still completed.
+     */
+    void setMaxBytesRead(unsigned long long bytes);
+
+    /*!
+     * Returns the maximum number of seeks, or 0 if it is unlimited.
+     */
+    unsigned long long maxSeeks() const;
+
+    /*!
+     * Sets the maximum number of seeks to \a seeks, 0 meaning unlimited.
+     */
+    void setMaxSeeks(unsigned long long seeks);
+
+    /*!
+     * Returns the maximum number of objects to parse, or 0 if it is unlimited.
+     */
+    unsigned long long maxObjects() const;
+
+    /*!
+     * Sets the maximum number of objects to parse to \a objects, 0 meaning
+     * unlimited.
+     */
+    void setMaxObjects(unsigned long long objects);
+
+    /*!
+     * Returns the maximum wall time in milliseconds, or 0 if it is unlimited.
+     */
+    unsigned long long maxMilliseconds() const;
+
+    /*!
+     * Sets the maximum wall time to \a milliseconds, counted from the
+     * construction of the budget or the last reset(), 0 meaning unlimited.
+     */
+    void setMaxMilliseconds(unsigned long long milliseconds);
+
+    /*!
+     * Requests parsing to stop as soon as possible.  Unlike the other methods,
+     * this may be called from another thread.
+     */
+    void cancel();
+
+    /*!
+     * Returns the number of bytes read so far.
+     */
+    unsigned long long bytesRead() const;
+
+    /*!
+     * Returns the number of seeks issued so far.
+     */
+    unsigned long long seeks() const;
+
+    /*!
+     * Returns the number of objects parsed so far.
+     */
+    unsigned long long objects() const;
+
+    /*!
+     * Returns why the budget is exhausted, or NotExhausted.  Once exhausted, a
+     * budget stays exhausted until reset() is called.
+     */
+    Reason reason() const;
+
+    /*!
+     * Returns true if the budget is exhausted, checking the wall time and the
+     * cancellation first.
+     */
+    bool isExhausted();
+
+    /*!
+     * Adds \a bytes to the bytes read.  Returns false if the budget is
+     * exhausted.
+     */
+    bool addBytesRead(unsigned long long bytes);
+
+    /*!
+     * Counts a seek.  Returns false if the budget is exhausted.
+     */
+    bool addSeek();
+
+    /*!
+     * Counts a parsed object and returns true, or returns false without
+     * counting it if the budget is exhausted.  This is called by the parsers
+     * before each atom, page or frame header, so that parsing stops once it
+     * returns false.
+     */
+    bool addObject();
+
+    /*!
+     * Sets the counters to zero, clears the cancellation and restarts the
+     * wall time, keeping the limits, so that the budget can be used for
+     * another file.
+     */
+    void reset();
+
+  private:
+    Budget(const Budget &);
+    Budget &operator=(const Budget &);
+
+    class BudgetPrivate;
+    BudgetPrivate *d;
+  };
+
+  //! An IOStream decorator which enforces a Budget
+
+  /*!
+   * This forwards all the calls to another IOStream and charges them to a
+   * Budget.  Once the budget is exhausted, readBlock() returns no data, so
+   * that the parsers stop as if the file ended, and the stream becomes read
+   * only, so that a file which was not parsed completely can not be saved:
+   *
+   * \code
+   * TagLib::Budget budget;
+   * budget.setMaxBytesRead(16 * 1024 * 1024);
+   * budget.setMaxMilliseconds(2000);
+   *
+   * TagLib::FileStream fileStream("song.mp3", true);
+   * TagLib::BudgetStream stream(&fileStream, &budget);
+   * TagLib::FileRef f(&stream);
+   * if(budget.reason() != TagLib::Budget::NotExhausted)
+   *   std::cout << "partially parsed" << std::endl;
+   * \endcode
+   *
+   * Saving is not charged to the budget.  save() fails if the budget is
+   * exhausted when it starts, and otherwise runs to the end, since a save cut
+   * short would leave a corrupt file.  Writes are always forwarded.
+   *
+   * \see File::budget()
+   */
+
+  class TAGLIB_EXPORT BudgetStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a BudgetStream which forwards to \a stream and charges
+     * \a budget.  Neither is owned by the BudgetStream and both must outlive
+     * it.
+     */
+    BudgetStream(IOStream *stream, Budget *budget);
+
+    /*!
+     * Destroys this BudgetStream instance.
+     */
+    virtual ~BudgetStream();
+
+    /*!
+     * Returns the name of the underlying stream.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer, or returns
+     * an empty ByteVector if the budget is exhausted.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Attempts to write the block \a data at the current get pointer.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Insert \a data at position \a start in the file overwriting \a replace
+     * bytes of the original content.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Removes a block of the file starting a \a start and continuing for
+     * \a length bytes.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true if the underlying stream is read only or the budget has
+     * been exhausted, i.e. a reason() has been recorded while parsing.  This
+     * does not check the wall time or the cancellation itself, so a file which
+     * was parsed completely can still be saved after the deadline.  While a
+     * SaveScope exists, this reports the state from when it was created.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the underlying stream is open.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Reset the end-of-stream and error flags on the stream.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the stream.
+     */
+    long length();
+
+    /*!
+     * Truncates the stream to a \a length.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns the stream which the calls are forwarded to.
+     */
+    IOStream *stream() const;
+
+    /*!
+     * Returns the budget which the calls are charged to, or a null pointer
+     * while a SaveScope exists, so that the parsers do not count the objects
+     * they read again while saving.
+     */
+    Budget *budget() const;
+
+    /*!
+     * If \a stream is or decorates a BudgetStream, this stops charging its
+     * budget for the lifetime of the SaveScope object, and restores it
+     * afterwards.  Otherwise this does nothing.  The save() functions create
+     * one, after which reads are not cut short by the budget, and readOnly()
+     * does not change until it is destroyed.
+     */
+
+    class TAGLIB_EXPORT SaveScope
+    {
+    public:
+      SaveScope(IOStream *stream);
+      ~SaveScope();
+
+    private:
+      SaveScope(const SaveScope &);
+      SaveScope &operator=(const SaveScope &);
+
+      BudgetStream *m_stream;
+      bool m_previous;
+    };
+
+  private:
+    BudgetStream(const BudgetStream &);
+    BudgetStream &operator=(const BudgetStream &);
+
+    friend class SaveScope;
+
+    class BudgetStreamPrivate;
+    BudgetStreamPrivate *d;
+  };
+
+}
+
+#endif
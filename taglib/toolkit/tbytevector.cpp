@@ -258,18 +258,31 @@ public:
   ByteVectorPrivate(unsigned int l, char c) :
     counter(new RefCounter()),
     data(new std::vector<char>(l, c)),
+    borrowed(0),
     offset(0),
     length(l) {}
 
   ByteVectorPrivate(const char *s, unsigned int l) :
     counter(new RefCounter()),
     data(new std::vector<char>(s, s + l)),
+    borrowed(0),
+    offset(0),
+    length(l) {}
+
+  // Refers to the memory of the caller instead of a copy of it, see
+  // fromRawData().
+
+  ByteVectorPrivate(const char *s, unsigned int l, bool) :
+    counter(new RefCounter()),
+    data(0),
+    borrowed(s),
     offset(0),
     length(l) {}
 
   ByteVectorPrivate(const ByteVectorPrivate &d, unsigned int o, unsigned int l) :
     counter(d.counter),
     data(d.data),
+    borrowed(d.borrowed),
     offset(d.offset + o),
     length(l)
   {
@@ -284,8 +297,31 @@ public:
     }
   }
 
+  const char *begin() const
+  {
+    return borrowed ? borrowed + offset : &(*data)[offset];
+  }
+
+  // Copies borrowed memory into a vector of its own, which the iterators need.
+
+  void own()
+  {
+    if(!borrowed)
+      return;
+
+    std::vector<char> *copy = new std::vector<char>(borrowed + offset, borrowed + offset + length);
+    if(counter->deref())
+      delete counter;
+
+    counter  = new RefCounter();
+    data     = copy;
+    borrowed = 0;
+    offset   = 0;
+  }
+
   RefCounter        *counter;
   std::vector<char> *data;
+  const char        *borrowed;
   unsigned int       offset;
   unsigned int       length;
 };
@@ -296,6 +332,16 @@ public:
 
 ByteVector ByteVector::null;
 
+ByteVector ByteVector::fromRawData(const char *data, unsigned int length)
+{
+  ByteVector v;
+  if(data && length > 0) {
+    delete v.d;
+    v.d = new ByteVectorPrivate(data, length, true);
+  }
+  return v;
+}
+
 ByteVector ByteVector::fromCString(const char *s, unsigned int length)
 {
   if(length == 0xffffffff)
@@ -403,7 +449,7 @@ char *ByteVector::data()
 
 const char *ByteVector::data() const
 {
-  return (size() > 0) ? (&(*d->data)[d->offset]) : 0;
+  return (size() > 0) ? d->begin() : 0;
 }
 
 ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
@@ -416,18 +462,20 @@ ByteVector ByteVector::mid(unsigned int index, unsigned int length) const
 
 char ByteVector::at(unsigned int index) const
 {
-  return (index < size()) ? (*d->data)[d->offset + index] : 0;
+  return (index < size()) ? d->begin()[index] : 0;
 }
 
 int ByteVector::find(const ByteVector &pattern, unsigned int offset, int byteAlign) const
 {
-  return findVector<ConstIterator>(
-    begin(), end(), pattern.begin(), pattern.end(), offset, byteAlign);
+  // Pointers rather than iterators, which would copy borrowed memory.
+
+  return findVector<const char *>(
+    data(), data() + size(), pattern.data(), pattern.data() + pattern.size(), offset, byteAlign);
 }
 
 int ByteVector::find(char c, unsigned int offset, int byteAlign) const
 {
-  return findChar<ConstIterator>(begin(), end(), c, offset, byteAlign);
+  return findChar<const char *>(data(), data() + size(), c, offset, byteAlign);
 }
 
 int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAlign) const
@@ -438,8 +486,11 @@ int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAl
       offset = 0;
   }
 
-  const int pos = findVector<ConstReverseIterator>(
-    rbegin(), rend(), pattern.rbegin(), pattern.rend(), offset, byteAlign);
+  typedef std::reverse_iterator<const char *> Reverse;
+
+  const int pos = findVector<Reverse>(
+    Reverse(data() + size()), Reverse(data()),
+    Reverse(pattern.data() + pattern.size()), Reverse(pattern.data()), offset, byteAlign);
 
   if(pos == -1)
     return -1;
@@ -620,6 +671,7 @@ ByteVector::Iterator ByteVector::begin()
 
 ByteVector::ConstIterator ByteVector::begin() const
 {
+  d->own();
   return d->data->begin() + d->offset;
 }
 
@@ -631,6 +683,7 @@ ByteVector::Iterator ByteVector::end()
 
 ByteVector::ConstIterator ByteVector::end() const
 {
+  d->own();
   return d->data->begin() + d->offset + d->length;
 }
 
@@ -642,6 +695,8 @@ ByteVector::ReverseIterator ByteVector::rbegin()
 
 ByteVector::ConstReverseIterator ByteVector::rbegin() const
 {
+  d->own();
+
   // Workaround for the Solaris Studio 12.4 compiler.
   // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
   const std::vector<char> &v = *d->data;
@@ -656,6 +711,8 @@ ByteVector::ReverseIterator ByteVector::rend()
 
 ByteVector::ConstReverseIterator ByteVector::rend() const
 {
+  d->own();
+
   // Workaround for the Solaris Studio 12.4 compiler.
   // We need a const reference to the data vector so we can ensure the const version of rbegin() is called.
   const std::vector<char> &v = *d->data;
@@ -803,7 +860,7 @@ long double ByteVector::toFloat80BE(size_t offset) const
 
 const char &ByteVector::operator[](int index) const
 {
-  return (*d->data)[d->offset + index];
+  return d->begin()[index];
 }
 
 char &ByteVector::operator[](int index)
@@ -1023,9 +1080,11 @@ ByteVector ByteVector::toBase64() const
 
 void ByteVector::detach()
 {
-  if(d->counter->count() > 1) {
+  // Borrowed memory is never written to.
+
+  if(d->borrowed || d->counter->count() > 1) {
     if(!isEmpty())
-      ByteVector(&d->data->front() + d->offset, d->length).swap(*this);
+      ByteVector(d->begin(), d->length).swap(*this);
     else
       ByteVector().swap(*this);
   }
@@ -514,6 +514,17 @@ namespace TagLib {
      */
     static ByteVector fromCString(const char *s, unsigned int length = 0xffffffff);
 
+    /*!
+     * Returns a ByteVector which refers to the \a length bytes at \a data
+     * instead of copying them.  Copies and mid() of it refer to the same
+     * memory.  Modifying the vector, or iterating over it, copies the bytes
+     * first; find(), data() const and operator[] const do not.
+     *
+     * \warning The memory must not be changed or freed as long as the
+     * returned vector or any vector referring to it exists.
+     */
+    static ByteVector fromRawData(const char *data, unsigned int length);
+
     /*!
      * Returns a const reference to the byte at \a index.
      */
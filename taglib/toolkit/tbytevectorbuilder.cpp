@@ -0,0 +1,235 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "tbytevectorbuilder.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Pieces of at least this size are shared instead of copied.  Sharing costs
+  // an allocation for the ByteVector, which copying small pieces avoids.
+
+  const unsigned int MinSharedSize = 1024;
+
+  // Either a buffer which small pieces are copied into or a shared piece.
+
+  struct Segment
+  {
+    Segment() : isShared(false) {}
+
+    unsigned int size() const
+    {
+      return isShared ? shared.size() : static_cast<unsigned int>(buffer.size());
+    }
+
+    bool isShared;
+    ByteVector shared;
+    std::vector<char> buffer;
+  };
+
+  // The segments keyed by their offset, so that set() finds the one to write
+  // to without walking the others.
+
+  typedef std::map<unsigned int, Segment> SegmentMap;
+}
+
+class ByteVectorBuilder::ByteVectorBuilderPrivate
+{
+public:
+  ByteVectorBuilderPrivate(unsigned int capacity) :
+    size(0),
+    capacity(capacity) {}
+
+  // Returns the buffer to copy small pieces into.
+
+  std::vector<char> &buffer()
+  {
+    if(segments.empty() || segments.rbegin()->second.isShared) {
+      std::vector<char> &buffer = segments[size].buffer;
+      if(capacity > size)
+        buffer.reserve(capacity - size);
+      return buffer;
+    }
+    return segments.rbegin()->second.buffer;
+  }
+
+  SegmentMap segments;
+  unsigned int size;
+  unsigned int capacity;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+ByteVectorBuilder::ByteVectorBuilder(unsigned int capacity) :
+  d(new ByteVectorBuilderPrivate(capacity))
+{
+}
+
+ByteVectorBuilder::~ByteVectorBuilder()
+{
+  delete d;
+}
+
+void ByteVectorBuilder::reserve(unsigned int capacity)
+{
+  d->capacity = capacity;
+  if(capacity > d->size) {
+    std::vector<char> &buffer = d->buffer();
+    buffer.reserve(buffer.size() + capacity - d->size);
+  }
+}
+
+ByteVectorBuilder &ByteVectorBuilder::append(const ByteVector &data)
+{
+  if(data.isEmpty())
+    return *this;
+
+  if(data.size() >= MinSharedSize) {
+    // This replaces an empty buffer left at the same offset, if any.
+    Segment &segment = d->segments[d->size];
+    segment.isShared = true;
+    segment.shared   = data;
+    segment.buffer.clear();
+  }
+  else {
+    std::vector<char> &buffer = d->buffer();
+    buffer.insert(buffer.end(), data.begin(), data.end());
+  }
+
+  d->size += data.size();
+  return *this;
+}
+
+ByteVectorBuilder &ByteVectorBuilder::append(char c)
+{
+  d->buffer().push_back(c);
+  d->size++;
+  return *this;
+}
+
+unsigned int ByteVectorBuilder::appendPlaceholder(unsigned int width)
+{
+  const unsigned int offset = d->size;
+  std::vector<char> &buffer = d->buffer();
+  buffer.resize(buffer.size() + width, '\0');
+  d->size += width;
+  return offset;
+}
+
+void ByteVectorBuilder::set(unsigned int offset, const ByteVector &data)
+{
+  if(data.isEmpty() || d->segments.empty())
+    return;
+
+  // The last segment which starts at or before the offset.
+  SegmentMap::iterator it = d->segments.upper_bound(offset);
+  if(it != d->segments.begin())
+    --it;
+
+  unsigned int written = 0;
+
+  for(; it != d->segments.end() && written < data.size(); ++it) {
+    Segment &segment = it->second;
+    const unsigned int end = it->first + segment.size();
+    if(offset + written >= end)
+      continue;
+
+    const unsigned int position = offset + written - it->first;
+    const unsigned int length   = std::min(data.size() - written, end - (offset + written));
+
+    // Writing to a shared piece detaches it from the original ByteVector.
+    char *target = segment.isShared ? segment.shared.data() : &segment.buffer[0];
+    ::memcpy(target + position, data.data() + written, length);
+    written += length;
+  }
+}
+
+void ByteVectorBuilder::setUInt(unsigned int offset, unsigned int value,
+                                bool mostSignificantByteFirst)
+{
+  set(offset, ByteVector::fromUInt(value, mostSignificantByteFirst));
+}
+
+void ByteVectorBuilder::setLongLong(unsigned int offset, long long value,
+                                    bool mostSignificantByteFirst)
+{
+  set(offset, ByteVector::fromLongLong(value, mostSignificantByteFirst));
+}
+
+unsigned int ByteVectorBuilder::size() const
+{
+  return d->size;
+}
+
+bool ByteVectorBuilder::isEmpty() const
+{
+  return d->size == 0;
+}
+
+ByteVectorList ByteVectorBuilder::blocks() const
+{
+  ByteVectorList blocks;
+
+  for(SegmentMap::const_iterator it = d->segments.begin(); it != d->segments.end(); ++it) {
+    const Segment &segment = it->second;
+    if(segment.isShared)
+      blocks.append(segment.shared);
+    else if(!segment.buffer.empty())
+      blocks.append(ByteVector(&segment.buffer[0], static_cast<unsigned int>(segment.buffer.size())));
+  }
+
+  return blocks;
+}
+
+ByteVector ByteVectorBuilder::toByteVector() const
+{
+  if(d->segments.size() == 1 && d->segments.begin()->second.isShared)
+    return d->segments.begin()->second.shared;
+
+  ByteVector data(d->size, '\0');
+  char *p = data.data();
+
+  for(SegmentMap::const_iterator it = d->segments.begin(); it != d->segments.end(); ++it) {
+    const Segment &segment = it->second;
+    const unsigned int size = segment.size();
+    if(size > 0)
+      ::memcpy(p + it->first, segment.isShared ? segment.shared.data() : &segment.buffer[0], size);
+  }
+
+  return data;
+}
+
+void ByteVectorBuilder::clear()
+{
+  d->segments.clear();
+  d->size = 0;
+}
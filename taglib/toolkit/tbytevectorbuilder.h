@@ -0,0 +1,153 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BYTEVECTORBUILDER_H
+#define TAGLIB_BYTEVECTORBUILDER_H
+
+#include "taglib_export.h"
+#include "tbytevector.h"
+#include "tbytevectorlist.h"
+
+namespace TagLib {
+
+  //! Assembles a ByteVector from many pieces
+
+  /*!
+   * Rendering nested structures by concatenating ByteVectors copies the
+   * payload once per level of nesting.  A ByteVectorBuilder instead keeps the
+   * pieces which are appended: small ones are copied into a buffer, large ones
+   * are shared with the ByteVector they were appended from.  They are copied
+   * only once, when the result is assembled by toByteVector().
+   *
+   * Sizes which are only known after their contents have been appended are
+   * written to placeholders, e.g. for an MP4 atom:
+   *
+   * \code
+   * const unsigned int atom = builder.appendPlaceholder(4);
+   * builder.append("covr");
+   * builder.append(picture);
+   * builder.setUInt(atom, builder.size() - atom);
+   * \endcode
+   */
+
+  class TAGLIB_EXPORT ByteVectorBuilder
+  {
+  public:
+    /*!
+     * Constructs an empty builder with room for \a capacity bytes of small
+     * pieces.
+     */
+    explicit ByteVectorBuilder(unsigned int capacity = 0);
+
+    /*!
+     * Destroys this ByteVectorBuilder instance.
+     */
+    ~ByteVectorBuilder();
+
+    /*!
+     * Makes room for \a capacity bytes of small pieces in total, so that
+     * appending them does not reallocate the buffer.
+     */
+    void reserve(unsigned int capacity);
+
+    /*!
+     * Appends \a data.  Unless it is small, the data is shared rather than
+     * copied.
+     */
+    ByteVectorBuilder &append(const ByteVector &data);
+
+    /*!
+     * Appends the character \a c.
+     */
+    ByteVectorBuilder &append(char c);
+
+    /*!
+     * Appends \a width zero bytes to be overwritten later and returns their
+     * offset.
+     *
+     * \see setUInt()
+     * \see set()
+     */
+    unsigned int appendPlaceholder(unsigned int width);
+
+    /*!
+     * Overwrites the bytes at \a offset with \a data.  The range must have been
+     * appended before.
+     */
+    void set(unsigned int offset, const ByteVector &data);
+
+    /*!
+     * Overwrites the 4 bytes at \a offset with \a value.
+     *
+     * \see ByteVector::fromUInt()
+     */
+    void setUInt(unsigned int offset, unsigned int value,
+                 bool mostSignificantByteFirst = true);
+
+    /*!
+     * Overwrites the 8 bytes at \a offset with \a value.
+     *
+     * \see ByteVector::fromLongLong()
+     */
+    void setLongLong(unsigned int offset, long long value,
+                     bool mostSignificantByteFirst = true);
+
+    /*!
+     * Returns the number of bytes appended so far.
+     */
+    unsigned int size() const;
+
+    /*!
+     * Returns true if nothing has been appended.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * Returns the pieces in order, without assembling them.  The large pieces
+     * are shared with the ByteVectors they were appended from, so this is
+     * suited to writing them one after the other.
+     */
+    ByteVectorList blocks() const;
+
+    /*!
+     * Assembles the pieces into a single ByteVector.
+     */
+    ByteVector toByteVector() const;
+
+    /*!
+     * Removes all the pieces.
+     */
+    void clear();
+
+  private:
+    ByteVectorBuilder(const ByteVectorBuilder &);
+    ByteVectorBuilder &operator=(const ByteVectorBuilder &);
+
+    class ByteVectorBuilderPrivate;
+    ByteVectorBuilderPrivate *d;
+  };
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include "tchunkmap.h"
+
+using namespace TagLib;
+
+ChunkMap::ChunkMap(long length) :
+  m_length(std::max<long>(length, 0)),
+  m_size(0)
+{
+}
+
+void ChunkMap::add(long offset, const ByteVector &data)
+{
+  const long start = std::max<long>(offset, 0);
+  const long end   = std::min<long>(offset + static_cast<long>(data.size()), m_length);
+  if(end <= start)
+    return;
+
+  // Keep the gaps between the ranges received before, sharing the data.
+
+  long position = start;
+  while(position < end) {
+    const long covered = coveredUntil(position);
+    if(covered > position) {
+      position = covered;
+      continue;
+    }
+
+    const long gapEnd = std::min(nextStart(position), end);
+    m_blocks[position] = data.mid(static_cast<unsigned int>(position - offset),
+                                  static_cast<unsigned int>(gapEnd - position));
+    m_size += gapEnd - position;
+    position = gapEnd;
+  }
+
+  // Merge the ranges which overlap or touch the new one.
+
+  RangeMap::iterator first = m_ranges.upper_bound(start);
+  if(first != m_ranges.begin()) {
+    RangeMap::iterator previous = first;
+    --previous;
+    if(previous->second >= start)
+      first = previous;
+  }
+
+  RangeMap::iterator last = first;
+  while(last != m_ranges.end() && last->first <= end)
+    ++last;
+
+  long rangeStart = start;
+  long rangeEnd   = end;
+  if(first != last) {
+    RangeMap::iterator back = last;
+    --back;
+    rangeStart = std::min(start, first->first);
+    rangeEnd   = std::max(end, back->second);
+  }
+
+  m_ranges.erase(first, last);
+  m_ranges[rangeStart] = rangeEnd;
+}
+
+long ChunkMap::coveredUntil(long offset) const
+{
+  RangeMap::const_iterator it = m_ranges.upper_bound(offset);
+  if(it == m_ranges.begin())
+    return offset;
+
+  --it;
+  return std::max(it->second, offset);
+}
+
+long ChunkMap::previousEnd(long offset) const
+{
+  RangeMap::const_iterator it = m_ranges.lower_bound(offset);
+  if(it == m_ranges.begin())
+    return -1;
+
+  --it;
+  return std::min(it->second, offset);
+}
+
+long ChunkMap::nextStart(long offset) const
+{
+  const RangeMap::const_iterator it = m_ranges.upper_bound(offset);
+  return (it != m_ranges.end()) ? it->first : m_length;
+}
+
+ByteVector ChunkMap::data(long offset, long length) const
+{
+  if(length <= 0)
+    return ByteVector();
+
+  BlockMap::const_iterator it = m_blocks.upper_bound(offset);
+  if(it == m_blocks.begin())
+    return ByteVector();
+
+  --it;
+
+  const long end = offset + length;
+  if(it->first + static_cast<long>(it->second.size()) >= end)
+    return it->second.mid(static_cast<unsigned int>(offset - it->first),
+                          static_cast<unsigned int>(length));
+
+  ByteVector data(static_cast<unsigned int>(length), '\0');
+  for(; it != m_blocks.end() && it->first < end; ++it) {
+    const long blockStart = std::max(it->first, offset);
+    const long blockEnd   = std::min(it->first + static_cast<long>(it->second.size()), end);
+    if(blockEnd > blockStart)
+      std::copy(it->second.begin() + (blockStart - it->first),
+                it->second.begin() + (blockEnd - it->first),
+                data.begin() + (blockStart - offset));
+  }
+
+  return data;
+}
+
+long ChunkMap::size() const
+{
+  return m_size;
+}
+
+long ChunkMap::length() const
+{
+  return m_length;
+}
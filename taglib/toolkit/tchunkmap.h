@@ -0,0 +1,128 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_CHUNKMAP_H
+#define TAGLIB_CHUNKMAP_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include <map>
+#include <string>
+
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib
+{
+  /*!
+   * A copy of a file name which outlives the name it is constructed with.
+   *
+   * \internal
+   */
+#ifdef _WIN32
+
+  typedef FileName FileNameHandle;
+
+#else
+
+  struct FileNameHandle : public std::string
+  {
+    FileNameHandle(FileName name) : std::string(name) {}
+    operator FileName () const { return c_str(); }
+  };
+
+#endif
+
+  /*!
+   * The parts of a file of a known length which have been received so far,
+   * such as the ranges fetched from a remote file.
+   *
+   * The data added is kept in the blocks it was added with, and only the
+   * bytes which have not been received before are kept.  Adding data never
+   * copies the data received before, and only the index of the received
+   * ranges is merged.
+   *
+   * \internal
+   */
+  class ChunkMap
+  {
+  public:
+    explicit ChunkMap(long length);
+
+    /*!
+     * Adds \a data at \a offset.  The parts outside of the file and the parts
+     * which have been received before are ignored.
+     */
+    void add(long offset, const ByteVector &data);
+
+    /*!
+     * Returns the end of the data received starting at \a offset, or
+     * \a offset if the byte at \a offset has not been received.
+     */
+    long coveredUntil(long offset) const;
+
+    /*!
+     * Returns the end of the last range received before \a offset, at most
+     * \a offset, or -1 if there is none.
+     */
+    long previousEnd(long offset) const;
+
+    /*!
+     * Returns the start of the first range received after \a offset, or the
+     * length of the file if there is none.
+     */
+    long nextStart(long offset) const;
+
+    /*!
+     * Returns the \a length bytes at \a offset, which must have been
+     * received.  The data is only copied if it spans several blocks.
+     */
+    ByteVector data(long offset, long length) const;
+
+    /*!
+     * Returns the number of bytes received.
+     */
+    long size() const;
+
+    /*!
+     * Returns the length of the file.
+     */
+    long length() const;
+
+  private:
+    typedef std::map<long, ByteVector> BlockMap;
+    typedef std::map<long, long> RangeMap;
+
+    const long m_length;
+    long m_size;
+    BlockMap m_blocks;
+    RangeMap m_ranges;
+  };
+}
+
+#endif
+
+#endif
@@ -23,11 +23,17 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include "tfile.h"
 #include "tfilestream.h"
 #include "tstring.h"
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tinstrumentedstream.h"
+#include "tbudgetstream.h"
+#include "tstreamchain.h"
+#include "thash.h"
 
 #ifdef _WIN32
 # include <windows.h>
@@ -68,13 +74,23 @@
 
 using namespace TagLib;
 
+namespace
+{
+  unsigned int defaultScanSize = 1024;
+
+  // Scans which go on grow their blocks up to this size.
+
+  const unsigned int MaxScanBufferSize = 64 * 1024;
+}
+
 class File::FilePrivate
 {
 public:
   FilePrivate(IOStream *stream, bool owner) :
     stream(stream),
     streamOwner(owner),
-    valid(true) {}
+    valid(true),
+    scanBufferSize(defaultScanSize) {}
 
   ~FilePrivate()
   {
@@ -85,6 +101,7 @@ public:
   IOStream *stream;
   bool streamOwner;
   bool valid;
+  unsigned int scanBufferSize;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -249,7 +266,7 @@ void File::writeBlock(const ByteVector &data)
 
 long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.size() > scanBufferSize())
       return -1;
 
   // The position in the file that the current buffer starts at.
@@ -263,6 +280,12 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
   int previousPartialMatch = -1;
   int beforePreviousPartialMatch = -1;
 
+  // The buffers grow as long as nothing is found, so the partial matches are
+  // relative to the size of the previous buffer.
+
+  unsigned int bufferLength = scanBufferSize();
+  int previousLength = 0;
+
   // Save the location of the current read pointer.  We will restore the
   // position using seek() before all returns.
 
@@ -290,20 +313,20 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
   // then check for "before".  The order is important because it gives priority
   // to "real" matches.
 
-  for(buffer = readBlock(bufferSize()); buffer.size() > 0; buffer = readBlock(bufferSize())) {
+  for(buffer = readBlock(bufferLength); buffer.size() > 0; buffer = readBlock(bufferLength)) {
 
     // (1) previous partial match
 
-    if(previousPartialMatch >= 0 && int(bufferSize()) > previousPartialMatch) {
-      const int patternOffset = (bufferSize() - previousPartialMatch);
+    if(previousPartialMatch >= 0 && previousLength > previousPartialMatch) {
+      const int patternOffset = (previousLength - previousPartialMatch);
       if(buffer.containsAt(pattern, 0, patternOffset)) {
         seek(originalPosition);
-        return bufferOffset - bufferSize() + previousPartialMatch;
+        return bufferOffset - previousLength + previousPartialMatch;
       }
     }
 
-    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && int(bufferSize()) > beforePreviousPartialMatch) {
-      const int beforeOffset = (bufferSize() - beforePreviousPartialMatch);
+    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && previousLength > beforePreviousPartialMatch) {
+      const int beforeOffset = (previousLength - beforePreviousPartialMatch);
       if(buffer.containsAt(before, 0, beforeOffset)) {
         seek(originalPosition);
         return -1;
@@ -330,7 +353,9 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
     if(!before.isEmpty())
       beforePreviousPartialMatch = buffer.endsWithPartialMatch(before);
 
-    bufferOffset += bufferSize();
+    previousLength = buffer.size();
+    bufferOffset += buffer.size();
+    bufferLength = nextScanBufferSize(bufferLength);
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -345,7 +370,7 @@ long File::find(const ByteVector &pattern, long fromOffset, const ByteVector &be
 
 long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.size() > scanBufferSize())
       return -1;
 
   // The position in the file that the current buffer starts at.
@@ -370,7 +395,7 @@ long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &b
   if(fromOffset == 0)
     fromOffset = length();
 
-  long bufferLength = bufferSize();
+  long bufferLength = scanBufferSize();
   long bufferOffset = fromOffset + pattern.size();
 
   // See the notes in find() for an explanation of this algorithm.
@@ -406,6 +431,8 @@ long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &b
     }
 
     // TODO: (3) partial match
+
+    bufferLength = nextScanBufferSize(bufferLength);
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -467,6 +494,123 @@ long File::length()
   return d->stream->length();
 }
 
+IOStatistics File::ioStatistics() const
+{
+  const InstrumentedStream *stream = Utils::findStream<InstrumentedStream>(d->stream);
+  if(stream)
+    return stream->statistics();
+  else
+    return IOStatistics();
+}
+
+Budget *File::budget() const
+{
+  const BudgetStream *stream = Utils::findStream<BudgetStream>(d->stream);
+  if(stream)
+    return stream->budget();
+  else
+    return 0;
+}
+
+File::RangeList File::audioDataRanges()
+{
+  // ugly workaround until this method is virtual
+  if(dynamic_cast<APE::File *>(this))
+    return dynamic_cast<APE::File *>(this)->audioDataRanges();
+  if(dynamic_cast<FLAC::File *>(this))
+    return dynamic_cast<FLAC::File *>(this)->audioDataRanges();
+  if(dynamic_cast<MPC::File *>(this))
+    return dynamic_cast<MPC::File *>(this)->audioDataRanges();
+  if(dynamic_cast<MPEG::File *>(this))
+    return dynamic_cast<MPEG::File *>(this)->audioDataRanges();
+  if(dynamic_cast<Ogg::File *>(this))
+    return dynamic_cast<Ogg::File *>(this)->audioDataRanges();
+  if(dynamic_cast<RIFF::AIFF::File *>(this))
+    return dynamic_cast<RIFF::AIFF::File *>(this)->audioDataRanges();
+  if(dynamic_cast<RIFF::WAV::File *>(this))
+    return dynamic_cast<RIFF::WAV::File *>(this)->audioDataRanges();
+  if(dynamic_cast<TrueAudio::File *>(this))
+    return dynamic_cast<TrueAudio::File *>(this)->audioDataRanges();
+  if(dynamic_cast<WavPack::File *>(this))
+    return dynamic_cast<WavPack::File *>(this)->audioDataRanges();
+  if(dynamic_cast<MP4::File *>(this))
+    return dynamic_cast<MP4::File *>(this)->audioDataRanges();
+  if(dynamic_cast<ASF::File *>(this))
+    return dynamic_cast<ASF::File *>(this)->audioDataRanges();
+  if(dynamic_cast<DSF::File *>(this))
+    return dynamic_cast<DSF::File *>(this)->audioDataRanges();
+  if(dynamic_cast<DSDIFF::File *>(this))
+    return dynamic_cast<DSDIFF::File *>(this)->audioDataRanges();
+  return RangeList();
+}
+
+unsigned long long File::audioDataHash(unsigned long blockSize)
+{
+  const RangeList ranges = audioDataRanges();
+
+  // Without audio data all such files would have the hash of empty input,
+  // and look like copies of each other.
+
+  if(ranges.isEmpty())
+    return 0;
+
+  XXHash64 hash;
+
+  // The ranges are read in large blocks, which also cover small gaps between
+  // them, such as the headers of Ogg pages.
+
+  ByteVector block;
+  long blockOffset = 0;
+
+  for(RangeList::ConstIterator it = ranges.begin(); it != ranges.end(); ++it) {
+    long offset = it->offset;
+    long remaining = it->length;
+
+    while(remaining > 0) {
+      if(offset < blockOffset || offset >= blockOffset + static_cast<long>(block.size())) {
+        seek(offset);
+        block = readBlock(std::max(blockSize, 1UL));
+        blockOffset = offset;
+
+        // The ranges run past the end of the data which can be read, so the
+        // hash would not cover the whole recording.
+
+        if(block.isEmpty())
+          return 0;
+      }
+
+      const long position = offset - blockOffset;
+      const long count = std::min<long>(remaining, block.size() - position);
+      hash.update(block.data() + position, count);
+
+      offset    += count;
+      remaining -= count;
+    }
+  }
+
+  return hash.digest();
+}
+
+unsigned int File::scanBufferSize() const
+{
+  return d->scanBufferSize;
+}
+
+void File::setScanBufferSize(unsigned int size)
+{
+  d->scanBufferSize = (size > 0) ? size : defaultScanSize;
+}
+
+unsigned int File::defaultScanBufferSize()
+{
+  return defaultScanSize;
+}
+
+void File::setDefaultScanBufferSize(unsigned int size)
+{
+  defaultScanSize = (size > 0) ? size : bufferSize();
+}
+
 bool File::isReadable(const char *file)
 {
 
@@ -506,8 +650,19 @@ unsigned int File::bufferSize()
   return 1024;
 }
 
+unsigned int File::nextScanBufferSize(unsigned int size) const
+{
+  const unsigned int maxSize = std::max(MaxScanBufferSize, d->scanBufferSize);
+  return (size < maxSize / 2) ? size * 2 : maxSize;
+}
+
 void File::setValid(bool valid)
 {
   d->valid = valid;
 }
 
+IOStream *File::stream() const
+{
+  return d->stream;
+}
+
@@ -30,6 +30,7 @@
 #include "taglib.h"
 #include "tag.h"
 #include "tbytevector.h"
+#include "tlist.h"
 #include "tiostream.h"
 
 namespace TagLib {
@@ -38,6 +39,8 @@ namespace TagLib {
   class Tag;
   class AudioProperties;
   class PropertyMap;
+  class IOStatistics;
+  class Budget;
 
   //! A file class with some useful methods for tag manipulation
 
@@ -62,6 +65,22 @@ namespace TagLib {
       End
     };
 
+    //! A range of bytes in a file.
+
+    struct Range
+    {
+      Range(long offset = 0, long length = 0) :
+        offset(offset),
+        length(length) {}
+
+      //! The position of the first byte.
+      long offset;
+      //! The number of bytes.
+      long length;
+    };
+
+    typedef List<Range> RangeList;
+
     /*!
      * Destroys this File instance.
      */
@@ -161,7 +180,7 @@ namespace TagLib {
      * file.
      *
      * \note This has the practical limitation that \a pattern can not be longer
-     * than the buffer size used by readBlock().  Currently this is 1024 bytes.
+     * than scanBufferSize().
      */
     long find(const ByteVector &pattern,
               long fromOffset = 0,
@@ -177,7 +196,7 @@ namespace TagLib {
      * beginning of the file and defaults to the end of the file.
      *
      * \note This has the practical limitation that \a pattern can not be longer
-     * than the buffer size used by readBlock().  Currently this is 1024 bytes.
+     * than scanBufferSize().
      */
     long rfind(const ByteVector &pattern,
                long fromOffset = 0,
@@ -240,6 +259,88 @@ namespace TagLib {
      */
     long length();
 
+    /*!
+     * Returns the I/O counters of the file if it is read through an
+     * InstrumentedStream, otherwise all the counters are zero.
+     *
+     * \note This returns a copy of the counters at the time of the call.  Keep
+     * the result in a variable rather than binding a reference to a member of
+     * it, which would refer to the destroyed temporary.
+     *
+     * \see InstrumentedStream
+     */
+    IOStatistics ioStatistics() const;
+
+    /*!
+     * Returns the budget of the file if it is read through a BudgetStream,
+     * directly or through an InstrumentedStream, otherwise a null pointer.
+     * The parsers count the objects they parse, such as atoms and pages, with
+     * Budget::addObject() and stop once it returns false.  Saving the file is
+     * not charged to the budget, so this is a null pointer during save().
+     *
+     * \see BudgetStream
+     */
+    Budget *budget() const;
+
+    /*!
+     * Returns the ranges of the file which hold the audio data, that is the
+     * file without its tags and metadata.  Retagging a file does not change
+     * the data in these ranges, although it may move them.  Returns an empty
+     * list if the file is invalid or has no separate audio data, as tracker
+     * modules.
+     *
+     * \note In Ogg files this is the body of each audio page, since the page
+     * headers are renumbered when the header packets are resized.
+     *
+     * \note This is a hack until TagLib 2.0 and will be made virtual then.
+     */
+    RangeList audioDataRanges();
+
+    /*!
+     * Returns a 64 bit hash (XXH64) of the data in audioDataRanges(), read in
+     * blocks of \a blockSize bytes.  Two files holding the same recording have
+     * the same hash, whatever their tags.  The hash is not cryptographic and
+     * can not be used to protect against deliberate collisions.
+     *
+     * Returns 0 if audioDataRanges() is empty, e.g. for invalid files and
+     * tracker modules, or if its data can not be read completely, for example
+     * because the file has been truncated.
+     */
+    unsigned long long audioDataHash(unsigned long blockSize = 1024 * 1024);
+
+    /*!
+     * Returns the size of the first block read by the scans of the file, such
+     * as find(), rfind() and the search for MPEG frames.  As long as a scan
+     * does not find what it looks for, each block is twice as large as the
+     * previous one, up to 64 KiB or this size if it is larger.  This keeps
+     * scans which end quickly cheap and long ones down to a few large reads.
+     *
+     * \see setScanBufferSize()
+     */
+    unsigned int scanBufferSize() const;
+
+    /*!
+     * Sets the size of the first block read by the scans of the file to
+     * \a size.  A small size suits streams in memory, a larger one storage
+     * with a high latency.  If \a size is 0, defaultScanBufferSize() is used.
+     */
+    void setScanBufferSize(unsigned int size);
+
+    /*!
+     * Returns the scan buffer size of the files constructed from now on,
+     * which is 1024 bytes unless set by setDefaultScanBufferSize().
+     */
+    static unsigned int defaultScanBufferSize();
+
+    /*!
+     * Sets the scan buffer size of the files constructed from now on to
+     * \a size, or back to 1024 bytes if \a size is 0.  This also applies to
+     * the scans done while constructing a file, unlike setScanBufferSize().
+     *
+     * \note This is not thread safe, and should be set before opening files.
+     */
+    static void setDefaultScanBufferSize(unsigned int size);
+
     /*!
      * Returns true if \a file can be opened for reading.  If the file does not
      * exist, this will return false.
@@ -293,6 +394,19 @@ namespace TagLib {
      */
     static unsigned int bufferSize();
 
+    /*!
+     * Returns the size of the block to read after a block of \a size bytes
+     * in a scan which has not found what it looks for.
+     *
+     * \see scanBufferSize()
+     */
+    unsigned int nextScanBufferSize(unsigned int size) const;
+
+    /*!
+     * Returns the stream which this file reads from and writes to.
+     */
+    IOStream *stream() const;
+
   private:
     File(const File &);
     File &operator=(const File &);
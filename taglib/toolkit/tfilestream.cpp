@@ -26,6 +26,7 @@
 #include "tfilestream.h"
 #include "tstring.h"
 #include "tdebug.h"
+#include "ttrace.h"
 
 #ifdef _WIN32
 # include <windows.h>
@@ -124,6 +125,11 @@ namespace
   }
 
 #endif  // _WIN32
+
+  // The size of the blocks which the rest of the file is moved in when data
+  // is inserted or removed.
+
+  const unsigned int DefaultCopyBufferSize = 64 * 1024;
 }
 
 class FileStream::FileStreamPrivate
@@ -133,12 +139,14 @@ public:
     : file(InvalidFileHandle)
     , name(fileName)
     , readOnly(true)
+    , copyBufferSize(DefaultCopyBufferSize)
   {
   }
 
   FileHandle file;
   FileNameHandle name;
   bool readOnly;
+  unsigned int copyBufferSize;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -235,6 +243,8 @@ void FileStream::writeBlock(const ByteVector &data)
 
 void FileStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
 {
+  TAGLIB_TRACE("FileStream::insert");
+
   if(!isOpen()) {
     debug("FileStream::insert() -- invalid file.");
     return;
@@ -267,10 +277,10 @@ void FileStream::insert(const ByteVector &data, unsigned long start, unsigned lo
   // the *differnce* in the tag sizes.  We want to avoid overwriting parts
   // that aren't yet in memory, so this is necessary.
 
-  unsigned long bufferLength = bufferSize();
+  unsigned long bufferLength = d->copyBufferSize;
 
   while(data.size() - replace > bufferLength)
-    bufferLength += bufferSize();
+    bufferLength += d->copyBufferSize;
 
   // Set where to start the reading and writing.
 
@@ -316,12 +326,14 @@ void FileStream::insert(const ByteVector &data, unsigned long start, unsigned lo
 
 void FileStream::removeBlock(unsigned long start, unsigned long length)
 {
+  TAGLIB_TRACE("FileStream::removeBlock");
+
   if(!isOpen()) {
     debug("FileStream::removeBlock() -- invalid file.");
     return;
   }
 
-  unsigned long bufferLength = bufferSize();
+  unsigned long bufferLength = d->copyBufferSize;
 
   long readPosition = start + length;
   long writePosition = start;
@@ -500,6 +512,16 @@ void FileStream::truncate(long length)
 #endif
 }
 
+unsigned int FileStream::copyBufferSize() const
+{
+  return d->copyBufferSize;
+}
+
+void FileStream::setCopyBufferSize(unsigned int size)
+{
+  d->copyBufferSize = (size > 0) ? size : DefaultCopyBufferSize;
+}
+
 unsigned int FileStream::bufferSize()
 {
   return 1024;
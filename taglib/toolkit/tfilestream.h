@@ -142,6 +142,21 @@ namespace TagLib {
      */
     void truncate(long length);
 
+    /*!
+     * Returns the size of the blocks which insert() and removeBlock() copy
+     * the rest of the file in.  This is 64 KiB unless set by
+     * setCopyBufferSize().
+     */
+    unsigned int copyBufferSize() const;
+
+    /*!
+     * Sets the size of the blocks which insert() and removeBlock() copy the
+     * rest of the file in to \a size, or back to 64 KiB if \a size is 0.
+     * Larger blocks need fewer system calls, which matters most on storage
+     * with a high latency.
+     */
+    void setCopyBufferSize(unsigned int size);
+
   protected:
 
     /*!
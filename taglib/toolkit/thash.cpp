@@ -0,0 +1,169 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include "thash.h"
+
+using namespace TagLib;
+
+namespace
+{
+  const unsigned long long Prime1 = 0x9E3779B185EBCA87ULL;
+  const unsigned long long Prime2 = 0xC2B2AE3D27D4EB4FULL;
+  const unsigned long long Prime3 = 0x165667B19E3779F9ULL;
+  const unsigned long long Prime4 = 0x85EBCA77C2B2AE63ULL;
+  const unsigned long long Prime5 = 0x27D4EB2F165667C5ULL;
+
+  inline unsigned long long rotateLeft(unsigned long long x, int r)
+  {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  // The input is little endian regardless of the platform.
+
+  inline unsigned long long read64(const unsigned char *p)
+  {
+    unsigned long long value = 0;
+    for(int i = 7; i >= 0; --i)
+      value = (value << 8) | p[i];
+    return value;
+  }
+
+  inline unsigned long long read32(const unsigned char *p)
+  {
+    return static_cast<unsigned long long>(p[0]) | (static_cast<unsigned long long>(p[1]) << 8) |
+      (static_cast<unsigned long long>(p[2]) << 16) | (static_cast<unsigned long long>(p[3]) << 24);
+  }
+
+  inline unsigned long long round(unsigned long long accumulator, unsigned long long input)
+  {
+    accumulator += input * Prime2;
+    accumulator  = rotateLeft(accumulator, 31);
+    return accumulator * Prime1;
+  }
+
+  inline unsigned long long mergeRound(unsigned long long accumulator, unsigned long long value)
+  {
+    accumulator ^= round(0, value);
+    return accumulator * Prime1 + Prime4;
+  }
+}
+
+XXHash64::XXHash64(unsigned long long seed) :
+  m_seed(seed),
+  m_totalLength(0),
+  m_bufferSize(0)
+{
+  m_accumulators[0] = seed + Prime1 + Prime2;
+  m_accumulators[1] = seed + Prime2;
+  m_accumulators[2] = seed;
+  m_accumulators[3] = seed - Prime1;
+}
+
+void XXHash64::update(const char *data, unsigned long length)
+{
+  const unsigned char *p   = reinterpret_cast<const unsigned char *>(data);
+  const unsigned char *end = p + length;
+
+  m_totalLength += length;
+
+  // Complete a stripe left over from the previous call.
+
+  if(m_bufferSize > 0) {
+    const unsigned long count = std::min<unsigned long>(32 - m_bufferSize, length);
+    ::memcpy(m_buffer + m_bufferSize, p, count);
+    m_bufferSize += count;
+    p += count;
+
+    if(m_bufferSize < 32)
+      return;
+
+    consume(m_buffer);
+    m_bufferSize = 0;
+  }
+
+  while(end - p >= 32) {
+    consume(p);
+    p += 32;
+  }
+
+  if(p < end) {
+    ::memcpy(m_buffer, p, end - p);
+    m_bufferSize = static_cast<unsigned int>(end - p);
+  }
+}
+
+unsigned long long XXHash64::digest() const
+{
+  unsigned long long hash;
+
+  if(m_totalLength >= 32) {
+    hash = rotateLeft(m_accumulators[0], 1) + rotateLeft(m_accumulators[1], 7) +
+      rotateLeft(m_accumulators[2], 12) + rotateLeft(m_accumulators[3], 18);
+    for(int i = 0; i < 4; ++i)
+      hash = mergeRound(hash, m_accumulators[i]);
+  }
+  else {
+    hash = m_seed + Prime5;
+  }
+
+  hash += m_totalLength;
+
+  const unsigned char *p   = m_buffer;
+  const unsigned char *end = m_buffer + m_bufferSize;
+
+  while(end - p >= 8) {
+    hash ^= round(0, read64(p));
+    hash  = rotateLeft(hash, 27) * Prime1 + Prime4;
+    p += 8;
+  }
+
+  if(end - p >= 4) {
+    hash ^= read32(p) * Prime1;
+    hash  = rotateLeft(hash, 23) * Prime2 + Prime3;
+    p += 4;
+  }
+
+  while(p < end) {
+    hash ^= *p * Prime5;
+    hash  = rotateLeft(hash, 11) * Prime1;
+    ++p;
+  }
+
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+
+  return hash;
+}
+
+void XXHash64::consume(const unsigned char *stripe)
+{
+  for(int i = 0; i < 4; ++i)
+    m_accumulators[i] = round(m_accumulators[i], read64(stripe + i * 8));
+}
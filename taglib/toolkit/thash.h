@@ -0,0 +1,62 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_HASH_H
+#define TAGLIB_HASH_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib
+{
+  /*!
+   * A streaming implementation of the 64 bit xxHash (XXH64), a fast
+   * non-cryptographic hash function.  Feeding the data in pieces gives the
+   * same result as hashing it at once.
+   *
+   * \internal
+   */
+  class XXHash64
+  {
+  public:
+    explicit XXHash64(unsigned long long seed = 0);
+
+    void update(const char *data, unsigned long length);
+    unsigned long long digest() const;
+
+  private:
+    void consume(const unsigned char *stripe);
+
+    unsigned long long m_seed;
+    unsigned long long m_accumulators[4];
+    unsigned long long m_totalLength;
+    unsigned char m_buffer[32];
+    unsigned int m_bufferSize;
+  };
+}
+
+#endif
+
+#endif
@@ -0,0 +1,306 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tinstrumentedstream.h"
+#include "tstreamchain.h"
+#include "tclock.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Adds the time elapsed since its construction to the given counters.
+
+  class Timer
+  {
+  public:
+    explicit Timer(IOStatistics::Counters &counters) :
+      counters(counters),
+      start(Utils::monotonicNanoseconds()) {}
+
+    ~Timer()
+    {
+      counters.wallTimeInNanoseconds += Utils::monotonicNanoseconds() - start;
+    }
+
+  private:
+    IOStatistics::Counters &counters;
+    const unsigned long long start;
+  };
+
+  // The number of bytes after the modified range, which have to be moved.
+
+  unsigned long long tailLength(long length, unsigned long end)
+  {
+    return (length > 0 && static_cast<unsigned long>(length) > end) ? length - end : 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// IOStatistics
+////////////////////////////////////////////////////////////////////////////////
+
+IOStatistics::Counters::Counters() :
+  readCalls(0),
+  bytesRead(0),
+  seekCalls(0),
+  writeCalls(0),
+  bytesWritten(0),
+  bytesShifted(0),
+  wallTimeInNanoseconds(0)
+{
+}
+
+IOStatistics::Counters &IOStatistics::Counters::operator+=(const Counters &c)
+{
+  readCalls             += c.readCalls;
+  bytesRead             += c.bytesRead;
+  seekCalls             += c.seekCalls;
+  writeCalls            += c.writeCalls;
+  bytesWritten          += c.bytesWritten;
+  bytesShifted          += c.bytesShifted;
+  wallTimeInNanoseconds += c.wallTimeInNanoseconds;
+  return *this;
+}
+
+class IOStatistics::IOStatisticsPrivate
+{
+public:
+  Counters counters[PhaseCount];
+};
+
+IOStatistics::IOStatistics() :
+  d(new IOStatisticsPrivate())
+{
+}
+
+IOStatistics::IOStatistics(const IOStatistics &s) :
+  d(new IOStatisticsPrivate(*s.d))
+{
+}
+
+IOStatistics::~IOStatistics()
+{
+  delete d;
+}
+
+IOStatistics &IOStatistics::operator=(const IOStatistics &s)
+{
+  *d = *s.d;
+  return *this;
+}
+
+const IOStatistics::Counters &IOStatistics::counters(Phase phase) const
+{
+  return d->counters[phase];
+}
+
+IOStatistics::Counters &IOStatistics::counters(Phase phase)
+{
+  return d->counters[phase];
+}
+
+IOStatistics::Counters IOStatistics::total() const
+{
+  Counters sum;
+  for(int i = 0; i < PhaseCount; ++i)
+    sum += d->counters[i];
+  return sum;
+}
+
+void IOStatistics::reset()
+{
+  for(int i = 0; i < PhaseCount; ++i)
+    d->counters[i] = Counters();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// InstrumentedStream
+////////////////////////////////////////////////////////////////////////////////
+
+class InstrumentedStream::InstrumentedStreamPrivate
+{
+public:
+  InstrumentedStreamPrivate(IOStream *stream) :
+    stream(stream),
+    phase(IOStatistics::Other) {}
+
+  IOStatistics::Counters &counters()
+  {
+    return statistics.counters(phase);
+  }
+
+  IOStream *stream;
+  IOStatistics::Phase phase;
+  IOStatistics statistics;
+};
+
+InstrumentedStream::InstrumentedStream(IOStream *stream) :
+  d(new InstrumentedStreamPrivate(stream))
+{
+}
+
+InstrumentedStream::~InstrumentedStream()
+{
+  delete d;
+}
+
+FileName InstrumentedStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector InstrumentedStream::readBlock(unsigned long length)
+{
+  IOStatistics::Counters &c = d->counters();
+  Timer timer(c);
+
+  const ByteVector data = d->stream->readBlock(length);
+  c.readCalls++;
+  c.bytesRead += data.size();
+  return data;
+}
+
+void InstrumentedStream::writeBlock(const ByteVector &data)
+{
+  IOStatistics::Counters &c = d->counters();
+  Timer timer(c);
+
+  d->stream->writeBlock(data);
+  c.writeCalls++;
+  c.bytesWritten += data.size();
+}
+
+void InstrumentedStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
+{
+  IOStatistics::Counters &c = d->counters();
+  Timer timer(c);
+
+  if(data.size() != replace)
+    c.bytesShifted += tailLength(d->stream->length(), start + replace);
+
+  d->stream->insert(data, start, replace);
+  c.writeCalls++;
+  c.bytesWritten += data.size();
+}
+
+void InstrumentedStream::removeBlock(unsigned long start, unsigned long length)
+{
+  IOStatistics::Counters &c = d->counters();
+  Timer timer(c);
+
+  if(length > 0)
+    c.bytesShifted += tailLength(d->stream->length(), start + length);
+
+  d->stream->removeBlock(start, length);
+  c.writeCalls++;
+}
+
+bool InstrumentedStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool InstrumentedStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void InstrumentedStream::seek(long offset, Position p)
+{
+  IOStatistics::Counters &c = d->counters();
+  Timer timer(c);
+
+  d->stream->seek(offset, p);
+  c.seekCalls++;
+}
+
+void InstrumentedStream::clear()
+{
+  d->stream->clear();
+}
+
+long InstrumentedStream::tell() const
+{
+  return d->stream->tell();
+}
+
+long InstrumentedStream::length()
+{
+  return d->stream->length();
+}
+
+void InstrumentedStream::truncate(long length)
+{
+  IOStatistics::Counters &c = d->counters();
+  Timer timer(c);
+
+  d->stream->truncate(length);
+  c.writeCalls++;
+}
+
+IOStream *InstrumentedStream::stream() const
+{
+  return d->stream;
+}
+
+IOStatistics::Phase InstrumentedStream::phase() const
+{
+  return d->phase;
+}
+
+void InstrumentedStream::setPhase(IOStatistics::Phase phase)
+{
+  d->phase = phase;
+}
+
+const IOStatistics &InstrumentedStream::statistics() const
+{
+  return d->statistics;
+}
+
+void InstrumentedStream::resetStatistics()
+{
+  d->statistics.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// InstrumentedStream::PhaseScope
+////////////////////////////////////////////////////////////////////////////////
+
+InstrumentedStream::PhaseScope::PhaseScope(IOStream *stream, IOStatistics::Phase phase) :
+  m_stream(Utils::findStream<InstrumentedStream>(stream)),
+  m_previous(IOStatistics::Other)
+{
+  if(m_stream) {
+    m_previous = m_stream->phase();
+    m_stream->setPhase(phase);
+  }
+}
+
+InstrumentedStream::PhaseScope::~PhaseScope()
+{
+  if(m_stream)
+    m_stream->setPhase(m_previous);
+}
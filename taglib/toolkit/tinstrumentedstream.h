@@ -0,0 +1,289 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_INSTRUMENTEDSTREAM_H
+#define TAGLIB_INSTRUMENTEDSTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! I/O counters collected by an InstrumentedStream
+
+  /*!
+   * The counters are broken down by the phase the I/O was issued in, so that
+   * the cost of detecting the file type, parsing the tags, reading the audio
+   * properties and saving can be told apart.
+   *
+   * \see InstrumentedStream
+   */
+
+  class TAGLIB_EXPORT IOStatistics
+  {
+  public:
+    /*!
+     * The phase of processing a file which I/O is attributed to.
+     */
+    enum Phase {
+      //! Probing the stream to detect the file type.
+      Detection = 0,
+      //! Reading the tags.
+      TagParsing = 1,
+      //! Reading the audio properties.
+      PropertiesParsing = 2,
+      //! Writing the tags back to the stream.
+      Saving = 3,
+      //! Any I/O outside of the phases above.
+      Other = 4
+    };
+
+    /*!
+     * The number of phases.
+     */
+    static const int PhaseCount = 5;
+
+    //! The counters of a single phase.
+
+    struct TAGLIB_EXPORT Counters
+    {
+      Counters();
+
+      /*!
+       * Adds the counters of \a c to these counters.
+       */
+      Counters &operator+=(const Counters &c);
+
+      //! The number of readBlock() calls.
+      unsigned long long readCalls;
+      //! The number of bytes returned by readBlock().
+      unsigned long long bytesRead;
+      //! The number of seek() calls.
+      unsigned long long seekCalls;
+      //! The number of writeBlock(), insert(), removeBlock() and truncate() calls.
+      unsigned long long writeCalls;
+      //! The number of bytes passed to writeBlock() and insert().
+      unsigned long long bytesWritten;
+      //! The number of bytes moved by insert() and removeBlock().
+      unsigned long long bytesShifted;
+      //! The wall time spent in the calls above.
+      unsigned long long wallTimeInNanoseconds;
+    };
+
+    /*!
+     * Constructs an IOStatistics object with all the counters set to zero.
+     */
+    IOStatistics();
+
+    /*!
+     * Makes a copy of \a s.
+     */
+    IOStatistics(const IOStatistics &s);
+
+    /*!
+     * Destroys this IOStatistics instance.
+     */
+    ~IOStatistics();
+
+    /*!
+     * Copies the counters of \a s into this object.
+     */
+    IOStatistics &operator=(const IOStatistics &s);
+
+    /*!
+     * Returns the counters of \a phase.
+     */
+    const Counters &counters(Phase phase) const;
+
+    /*!
+     * Returns a reference to the counters of \a phase which can be modified.
+     */
+    Counters &counters(Phase phase);
+
+    /*!
+     * Returns the sum of the counters of all phases.
+     */
+    Counters total() const;
+
+    /*!
+     * Sets all the counters to zero.
+     */
+    void reset();
+
+  private:
+    class IOStatisticsPrivate;
+    IOStatisticsPrivate *d;
+  };
+
+  //! An IOStream decorator which counts the I/O issued through it
+
+  /*!
+   * This forwards all the calls to another IOStream and counts the calls, the
+   * bytes transferred and the time spent, attributed to the current phase.
+   * TagLib sets the phase while detecting, parsing and saving a file, so that
+   * for example:
+   *
+   * \code
+   * TagLib::FileStream fileStream("song.mp3", true);
+   * TagLib::InstrumentedStream stream(&fileStream);
+   * TagLib::FileRef f(&stream);
+   * TagLib::IOStatistics::Counters c = f.ioStatistics().counters(TagLib::IOStatistics::TagParsing);
+   * \endcode
+   *
+   * tells how many bytes were read to parse the tags of the file.
+   */
+
+  class TAGLIB_EXPORT InstrumentedStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs an InstrumentedStream which forwards to \a stream.  The
+     * stream is not owned by the InstrumentedStream and must outlive it.
+     */
+    InstrumentedStream(IOStream *stream);
+
+    /*!
+     * Destroys this InstrumentedStream instance.
+     */
+    virtual ~InstrumentedStream();
+
+    /*!
+     * Returns the name of the underlying stream.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Attempts to write the block \a data at the current get pointer.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Insert \a data at position \a start in the file overwriting \a replace
+     * bytes of the original content.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Removes a block of the file starting a \a start and continuing for
+     * \a length bytes.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true if the underlying stream is read only.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the underlying stream is open.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Reset the end-of-stream and error flags on the stream.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the stream.
+     */
+    long length();
+
+    /*!
+     * Truncates the stream to a \a length.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns the stream which the calls are forwarded to.
+     */
+    IOStream *stream() const;
+
+    /*!
+     * Returns the phase which I/O is currently attributed to.
+     */
+    IOStatistics::Phase phase() const;
+
+    /*!
+     * Attributes the I/O from now on to \a phase.
+     */
+    void setPhase(IOStatistics::Phase phase);
+
+    /*!
+     * Returns the counters collected so far.
+     */
+    const IOStatistics &statistics() const;
+
+    /*!
+     * Sets all the counters to zero.
+     */
+    void resetStatistics();
+
+    //! Attributes the I/O in a scope to a phase
+
+    /*!
+     * If \a stream is an InstrumentedStream, or a BudgetStream reading from
+     * one, this sets its phase for the lifetime of the PhaseScope object and
+     * restores the previous phase afterwards.  Otherwise this does nothing.
+     */
+
+    class TAGLIB_EXPORT PhaseScope
+    {
+    public:
+      PhaseScope(IOStream *stream, IOStatistics::Phase phase);
+      ~PhaseScope();
+
+    private:
+      PhaseScope(const PhaseScope &);
+      PhaseScope &operator=(const PhaseScope &);
+
+      InstrumentedStream *m_stream;
+      IOStatistics::Phase m_previous;
+    };
+
+  private:
+    class InstrumentedStreamPrivate;
+    InstrumentedStreamPrivate *d;
+  };
+
+}
+
+#endif
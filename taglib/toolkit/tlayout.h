@@ -0,0 +1,190 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_LAYOUT_H
+#define TAGLIB_LAYOUT_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "tbytevector.h"
+#include "tutils.h"
+
+#include <cstring>
+
+namespace TagLib
+{
+  /*!
+   * Descriptions of fixed size binary headers.  A header is described once by
+   * a struct with its size and a typedef for each field:
+   *
+   * \code
+   * struct BlockHeader
+   * {
+   *   static const unsigned int size = 32;
+   *   typedef Layout::U32L<4>  BlockSize;
+   *   typedef Layout::S16L<8>  Version;
+   *   typedef Layout::U32L<24> Flags;
+   * };
+   * \endcode
+   *
+   * and a View checks the length of the data once, after which the fields
+   * are decoded without any further checks:
+   *
+   * \code
+   * const ByteVector data = file->readBlock(BlockHeader::size);
+   * const Layout::View<BlockHeader> header(data);
+   * if(!header.isValid())
+   *   return;
+   * const unsigned int flags = header.get<BlockHeader::Flags>();
+   * \endcode
+   *
+   * Getting a field which does not fit into the size of its header fails to
+   * compile.
+   */
+
+  namespace Layout
+  {
+    template <unsigned int Width> struct Storage;
+
+    template <> struct Storage<1>
+    {
+      typedef unsigned char Type;
+      static Type swap(Type x) { return x; }
+    };
+
+    template <> struct Storage<2>
+    {
+      typedef unsigned short Type;
+      static Type swap(Type x) { return Utils::byteSwap(x); }
+    };
+
+    template <> struct Storage<4>
+    {
+      typedef unsigned int Type;
+      static Type swap(Type x) { return Utils::byteSwap(x); }
+    };
+
+    template <> struct Storage<8>
+    {
+      typedef unsigned long long Type;
+      static Type swap(Type x) { return Utils::byteSwap(x); }
+    };
+
+    /*!
+     * A number of type \a T at \a Offset, stored in the byte order given by
+     * \a BigEndian.
+     */
+    template <unsigned int Offset, typename T, bool BigEndian>
+    struct Number
+    {
+      typedef T Type;
+      static const unsigned int end = Offset + sizeof(T);
+
+      static T decode(const char *header)
+      {
+        typedef Storage<sizeof(T)> S;
+
+        // Uses memcpy instead of reinterpret_cast to avoid an alignment exception.
+        typename S::Type value;
+        ::memcpy(&value, header + Offset, sizeof(T));
+
+        if(BigEndian != (Utils::systemByteOrder() == Utils::BigEndian))
+          value = S::swap(value);
+
+        return static_cast<T>(value);
+      }
+    };
+
+    template <unsigned int Offset> struct U8   : Number<Offset, unsigned char, false> {};
+    template <unsigned int Offset> struct U16L : Number<Offset, unsigned short, false> {};
+    template <unsigned int Offset> struct U16B : Number<Offset, unsigned short, true> {};
+    template <unsigned int Offset> struct S16L : Number<Offset, short, false> {};
+    template <unsigned int Offset> struct S16B : Number<Offset, short, true> {};
+    template <unsigned int Offset> struct U32L : Number<Offset, unsigned int, false> {};
+    template <unsigned int Offset> struct U32B : Number<Offset, unsigned int, true> {};
+    template <unsigned int Offset> struct U64L : Number<Offset, unsigned long long, false> {};
+    template <unsigned int Offset> struct U64B : Number<Offset, unsigned long long, true> {};
+
+    /*!
+     * \a Length raw bytes at \a Offset, e.g. an identifier.
+     */
+    template <unsigned int Offset, unsigned int Length>
+    struct Bytes
+    {
+      typedef ByteVector Type;
+      static const unsigned int end = Offset + Length;
+
+      static ByteVector decode(const char *header)
+      {
+        return ByteVector(header + Offset, Length);
+      }
+    };
+
+    template <bool FieldFitsIntoHeader> struct Check;
+    template <> struct Check<true> { enum { value = 1 }; };
+
+    /*!
+     * A header described by \a H at \a offset of \a data.  The data is not
+     * copied and must outlive the view.
+     */
+    template <class H>
+    class View
+    {
+    public:
+      explicit View(const ByteVector &data, unsigned int offset = 0) :
+        m_header(offset <= data.size() && data.size() - offset >= H::size
+                 ? data.data() + offset : 0)
+      {
+      }
+
+      /*!
+       * Returns true if the data is long enough to hold the whole header.
+       */
+      bool isValid() const
+      {
+        return m_header != 0;
+      }
+
+      /*!
+       * Returns the value of the field \a F.  Must only be called if
+       * isValid() is true.
+       */
+      template <class F>
+      typename F::Type get() const
+      {
+        (void)sizeof(Check<(F::end <= H::size)>);
+        return F::decode(m_header);
+      }
+
+    private:
+      const char *const m_header;
+    };
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tmemorystream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+class MemoryStream::MemoryStreamPrivate
+{
+public:
+  MemoryStreamPrivate(const char *data, unsigned long length) :
+    data(ByteVector::fromRawData(data, static_cast<unsigned int>(length))),
+    position(0) {}
+
+  const ByteVector data;
+  long position;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MemoryStream::MemoryStream(const char *data, unsigned long length) :
+  d(new MemoryStreamPrivate(data, length))
+{
+}
+
+MemoryStream::~MemoryStream()
+{
+  delete d;
+}
+
+FileName MemoryStream::name() const
+{
+  return FileName("");
+}
+
+ByteVector MemoryStream::readBlock(unsigned long length)
+{
+  if(length == 0 || d->position < 0 || static_cast<unsigned long>(d->position) >= d->data.size())
+    return ByteVector();
+
+  // The block refers to the memory of the caller instead of copying it.
+
+  const ByteVector v = d->data.mid(d->position, static_cast<unsigned int>(length));
+  d->position += v.size();
+  return v;
+}
+
+void MemoryStream::writeBlock(const ByteVector &)
+{
+  debug("MemoryStream::writeBlock() -- read only stream.");
+}
+
+void MemoryStream::insert(const ByteVector &, unsigned long, unsigned long)
+{
+  debug("MemoryStream::insert() -- read only stream.");
+}
+
+void MemoryStream::removeBlock(unsigned long, unsigned long)
+{
+  debug("MemoryStream::removeBlock() -- read only stream.");
+}
+
+bool MemoryStream::readOnly() const
+{
+  return true;
+}
+
+bool MemoryStream::isOpen() const
+{
+  return true;
+}
+
+void MemoryStream::seek(long offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = static_cast<long>(d->data.size()) + offset;
+    break;
+  }
+}
+
+void MemoryStream::clear()
+{
+}
+
+long MemoryStream::tell() const
+{
+  return d->position;
+}
+
+long MemoryStream::length()
+{
+  return static_cast<long>(d->data.size());
+}
+
+void MemoryStream::truncate(long)
+{
+  debug("MemoryStream::truncate() -- read only stream.");
+}
+
+const char *MemoryStream::data() const
+{
+  return d->data.data();
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MEMORYSTREAM_H
+#define TAGLIB_MEMORYSTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! A read only stream over memory owned by the caller
+
+  /*!
+   * Unlike ByteVectorStream, this does not copy the data it is constructed
+   * with, which makes it suitable for files already held in memory, such as
+   * a buffer received over the network or a memory mapped file.  The blocks
+   * returned by readBlock() refer to the memory as well, see
+   * ByteVector::fromRawData(), so parsing a file only allocates for the
+   * parsed output.
+   *
+   * \warning The memory must stay valid and unchanged for the lifetime of the
+   * stream, of any File constructed from it and of any ByteVector read from
+   * either of them, e.g. the data of a picture.  Copy such a ByteVector with
+   * ByteVector(v.data(), v.size()) to keep it longer.
+   */
+
+  class TAGLIB_EXPORT MemoryStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a MemoryStream over the \a length bytes at \a data, which are
+     * not copied.
+     */
+    MemoryStream(const char *data, unsigned long length);
+
+    /*!
+     * Destroys this MemoryStream instance.  The memory is not freed.
+     */
+    virtual ~MemoryStream();
+
+    /*!
+     * Returns an empty name.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Does nothing.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the data.
+     */
+    long length();
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns the data of the stream.
+     */
+    const char *data() const;
+
+  private:
+    MemoryStream(const MemoryStream &);
+    MemoryStream &operator=(const MemoryStream &);
+
+    class MemoryStreamPrivate;
+    MemoryStreamPrivate *d;
+  };
+
+}
+
+#endif
@@ -0,0 +1,328 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <map>
+
+#include "toverlaystream.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Either a range of the underlying stream or a block of new data.
+
+  struct Piece
+  {
+    long offset;
+    long length;
+    ByteVector data;
+    bool isNew;
+  };
+
+  // The pieces keyed by their position in the stream, so that the piece at a
+  // position is found without walking all the pieces before it.  Rewriting
+  // many small fields, such as the Ogg page sequence numbers, stays cheap.
+
+  typedef std::map<long, Piece> PieceMap;
+}
+
+class OverlayStream::OverlayStreamPrivate
+{
+public:
+  OverlayStreamPrivate(IOStream *stream) :
+    stream(stream),
+    originalLength(std::max<long>(stream->length(), 0)),
+    length(originalLength),
+    position(0)
+  {
+    if(length > 0) {
+      Piece piece;
+      piece.offset = 0;
+      piece.length = length;
+      piece.isNew  = false;
+      pieces[0] = piece;
+    }
+  }
+
+  // Replaces count bytes at start with data.
+  void replace(long start, long count, const ByteVector &data);
+
+  // Splits the pieces so that one starts at position, and returns it.
+  PieceMap::iterator split(long position);
+
+  // Returns the piece which contains position.
+  PieceMap::const_iterator find(long position) const;
+
+  IOStream *stream;
+  PieceMap pieces;
+  const long originalLength;
+  long length;
+  long position;
+};
+
+void OverlayStream::OverlayStreamPrivate::replace(long start, long count, const ByteVector &data)
+{
+  // Writing past the end fills the gap with zeros like a file does.
+
+  if(start > length)
+    replace(length, 0, ByteVector(static_cast<unsigned int>(start - length), '\0'));
+
+  if(count > length - start)
+    count = length - start;
+
+  const PieceMap::iterator first = split(start);
+  const PieceMap::iterator last  = split(start + count);
+  pieces.erase(first, last);
+
+  // Only the pieces after the replaced range move, and only if its size
+  // changes.
+
+  const long delta = static_cast<long>(data.size()) - count;
+  if(delta != 0) {
+    PieceMap tail(last, pieces.end());
+    pieces.erase(last, pieces.end());
+    for(PieceMap::const_iterator it = tail.begin(); it != tail.end(); ++it)
+      pieces.insert(pieces.end(), std::make_pair(it->first + delta, it->second));
+  }
+
+  // Sequential writes, like rewriting a table entry by entry, are merged into
+  // the previous piece to keep the number of pieces low.
+
+  if(!data.isEmpty()) {
+    PieceMap::iterator previous = pieces.lower_bound(start);
+    if(previous != pieces.begin() && (--previous)->second.isNew) {
+      previous->second.data.append(data);
+      previous->second.length += data.size();
+    }
+    else {
+      Piece piece;
+      piece.offset = 0;
+      piece.length = data.size();
+      piece.data   = data;
+      piece.isNew  = true;
+      pieces[start] = piece;
+    }
+  }
+
+  length += delta;
+}
+
+PieceMap::iterator OverlayStream::OverlayStreamPrivate::split(long position)
+{
+  PieceMap::iterator it = pieces.upper_bound(position);
+  if(it == pieces.begin())
+    return it;
+
+  --it;
+  if(it->first == position)
+    return it;
+
+  Piece &piece = it->second;
+  const long offset = position - it->first;
+  if(offset >= piece.length)
+    return ++it;
+
+  Piece tail = piece;
+  tail.length = piece.length - offset;
+  if(piece.isNew)
+    tail.data = piece.data.mid(offset);
+  else
+    tail.offset = piece.offset + offset;
+
+  piece.length = offset;
+  if(piece.isNew)
+    piece.data = piece.data.mid(0, offset);
+
+  return pieces.insert(++it, std::make_pair(position, tail));
+}
+
+PieceMap::const_iterator OverlayStream::OverlayStreamPrivate::find(long position) const
+{
+  PieceMap::const_iterator it = pieces.upper_bound(position);
+  if(it != pieces.begin())
+    --it;
+
+  return it;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+OverlayStream::OverlayStream(IOStream *stream) :
+  d(new OverlayStreamPrivate(stream))
+{
+}
+
+OverlayStream::~OverlayStream()
+{
+  delete d;
+}
+
+FileName OverlayStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector OverlayStream::readBlock(unsigned long length)
+{
+  if(length == 0 || d->position >= d->length)
+    return ByteVector();
+
+  if(length > static_cast<unsigned long>(d->length - d->position))
+    length = d->length - d->position;
+
+  ByteVector data;
+
+  for(PieceMap::const_iterator it = d->find(d->position);
+      it != d->pieces.end() && data.size() < length; ++it) {
+    const Piece &piece = it->second;
+    const long offset = d->position + data.size() - it->first;
+    const long count  = std::min<long>(piece.length - offset, length - data.size());
+
+    if(piece.isNew) {
+      data.append(piece.data.mid(offset, count));
+    }
+    else {
+      d->stream->seek(piece.offset + offset);
+      const ByteVector block = d->stream->readBlock(count);
+      data.append(block);
+      if(block.size() != static_cast<unsigned int>(count))
+        break;
+    }
+  }
+
+  d->position += data.size();
+  return data;
+}
+
+void OverlayStream::writeBlock(const ByteVector &data)
+{
+  const long count = std::min<long>(data.size(), std::max<long>(d->length - d->position, 0));
+  d->replace(d->position, count, data);
+  d->position += data.size();
+}
+
+void OverlayStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
+{
+  d->replace(start, replace, data);
+}
+
+void OverlayStream::removeBlock(unsigned long start, unsigned long length)
+{
+  d->replace(start, length, ByteVector());
+}
+
+bool OverlayStream::readOnly() const
+{
+  return false;
+}
+
+bool OverlayStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void OverlayStream::seek(long offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = d->length + offset;
+    break;
+  }
+
+  if(d->position < 0)
+    d->position = 0;
+}
+
+void OverlayStream::clear()
+{
+  d->stream->clear();
+}
+
+long OverlayStream::tell() const
+{
+  return d->position;
+}
+
+long OverlayStream::length()
+{
+  return d->length;
+}
+
+void OverlayStream::truncate(long length)
+{
+  if(length < d->length)
+    d->replace(length, d->length - length, ByteVector());
+  else if(length > d->length)
+    d->replace(d->length, 0, ByteVector(static_cast<unsigned int>(length - d->length), '\0'));
+}
+
+bool OverlayStream::isModified() const
+{
+  if(d->length != d->originalLength)
+    return true;
+
+  for(PieceMap::const_iterator it = d->pieces.begin(); it != d->pieces.end(); ++it) {
+    if(it->second.isNew || it->second.offset != it->first)
+      return true;
+  }
+
+  return false;
+}
+
+bool OverlayStream::writeTo(IOStream *sink, unsigned long bufferSize)
+{
+  bufferSize = std::max<unsigned long>(bufferSize, 1);
+
+  for(PieceMap::const_iterator it = d->pieces.begin(); it != d->pieces.end(); ++it) {
+    const Piece &piece = it->second;
+    if(piece.isNew) {
+      sink->writeBlock(piece.data);
+      continue;
+    }
+
+    d->stream->seek(piece.offset);
+
+    long remaining = piece.length;
+    while(remaining > 0) {
+      const unsigned long count = std::min<unsigned long>(remaining, bufferSize);
+      const ByteVector block = d->stream->readBlock(count);
+      if(block.isEmpty())
+        return false;
+
+      sink->writeBlock(block);
+      remaining -= block.size();
+    }
+  }
+
+  return true;
+}
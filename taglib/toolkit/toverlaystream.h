@@ -0,0 +1,169 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_OVERLAYSTREAM_H
+#define TAGLIB_OVERLAYSTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! An IOStream which keeps all the changes to another stream in memory
+
+  /*!
+   * Reads are served from the underlying stream, which is never written to,
+   * merged with the changes made so far.  The changes are kept as a list of
+   * pieces, so that inserting or removing a block does not move any data.
+   *
+   * Saving a file through an OverlayStream shows what would be written without
+   * touching the file, and writeTo() then emits the modified file to a
+   * sequential sink, such as a pipe or an upload, in a single pass:
+   *
+   * \code
+   * TagLib::FileStream source("song.m4a", true);
+   * TagLib::OverlayStream overlay(&source);
+   * {
+   *   TagLib::FileRef f(&overlay);
+   *   f.tag()->setTitle("title");
+   *   f.save();
+   * }
+   * overlay.writeTo(&sink);
+   * \endcode
+   *
+   * The offsets which depend on the size of the tags, such as the MP4 chunk
+   * offset tables or the Ogg page sequence numbers, are fixed up by the
+   * format's own save() and only the fixed up parts are kept in memory.  The
+   * audio data is copied from the underlying stream by writeTo(), which is
+   * the only time it is read.  save() may still read the headers inside of
+   * it; renumbering the Ogg pages, for instance, reads every page header
+   * following the tags.
+   */
+
+  class TAGLIB_EXPORT OverlayStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs an OverlayStream on top of \a stream.  The stream is not
+     * owned by the OverlayStream and must outlive it.
+     */
+    OverlayStream(IOStream *stream);
+
+    /*!
+     * Destroys this OverlayStream instance.
+     */
+    virtual ~OverlayStream();
+
+    /*!
+     * Returns the name of the underlying stream.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Writes the block \a data at the current get pointer.  The underlying
+     * stream is not modified.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Insert \a data at position \a start in the stream overwriting \a replace
+     * bytes of the original content.  No data is moved.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Removes a block of the stream starting a \a start and continuing for
+     * \a length bytes.  No data is moved.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns false, since the changes are kept in memory.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the underlying stream is open.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Reset the end-of-stream and error flags on the underlying stream.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the stream including the changes.
+     */
+    long length();
+
+    /*!
+     * Truncates the stream to a \a length.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns true if the stream differs from the underlying stream.
+     */
+    bool isModified() const;
+
+    /*!
+     * Writes the whole content of the stream, including the changes, to
+     * \a sink.  Only writeBlock() is called on \a sink, in order from the
+     * beginning of the stream to its end.  The unchanged parts are read from
+     * the underlying stream in blocks of up to \a bufferSize bytes.
+     *
+     * Returns false if the underlying stream is shorter than expected, in
+     * which case the output is incomplete.
+     */
+    bool writeTo(IOStream *sink, unsigned long bufferSize = 1024 * 1024);
+
+  private:
+    OverlayStream(const OverlayStream &);
+    OverlayStream &operator=(const OverlayStream &);
+
+    class OverlayStreamPrivate;
+    OverlayStreamPrivate *d;
+  };
+
+}
+
+#endif
@@ -0,0 +1,274 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+
+#include "trangefetchstream.h"
+#include "tchunkmap.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // The size of the end of the file which is prefetched along with the head.
+
+  const long TailSize = 128 * 1024;
+
+  // Gaps up to this size between a request and the data fetched before are
+  // fetched too, which saves a round trip when the gap is read later.
+
+  const long MergeDistance = 16 * 1024;
+}
+
+class RangeFetchStream::RangeFetchStreamPrivate
+{
+public:
+  RangeFetchStreamPrivate(Fetcher *fetcher, long length, FileName name, unsigned long blockSize) :
+    fetcher(fetcher),
+    name(name),
+    length(std::max<long>(length, 0)),
+    blockSize(static_cast<long>(std::max<unsigned long>(blockSize, 1))),
+    position(0),
+    chunks(length),
+    prefetched(false),
+    roundTrips(0),
+    bytesFetched(0) {}
+
+  // Adds the data fetched at offset.
+  void add(long offset, const ByteVector &data)
+  {
+    bytesFetched += data.size();
+    chunks.add(offset, data);
+  }
+
+  // Fetches the head and the tail of the file in one round trip.
+  void prefetch()
+  {
+    prefetched = true;
+    if(length == 0)
+      return;
+
+    const long headEnd   = std::min(blockSize, length);
+    const long tailStart = std::max<long>(length - TailSize, 0);
+
+    File::RangeList ranges;
+    if(tailStart - headEnd <= MergeDistance) {
+      ranges.append(File::Range(0, length));
+    }
+    else {
+      ranges.append(File::Range(0, headEnd));
+      ranges.append(File::Range(tailStart, length - tailStart));
+    }
+
+    const ByteVectorList data = fetcher->fetchRanges(ranges);
+    roundTrips++;
+
+    File::RangeList::ConstIterator range = ranges.begin();
+    for(ByteVectorList::ConstIterator it = data.begin();
+        it != data.end() && range != ranges.end(); ++it, ++range) {
+      add(range->offset, *it);
+    }
+  }
+
+  // Fetches the parts of [offset, end) which are missing in one round trip,
+  // along with the blocks around them.
+  void fetch(long offset, long end)
+  {
+    long start = chunks.coveredUntil(offset);
+
+    const long previous = chunks.previousEnd(start);
+    if(previous >= 0 && start - previous <= MergeDistance)
+      start = previous;
+
+    long stop = std::min(std::max(end, start + blockSize), length);
+
+    const long next = chunks.nextStart(start);
+    if(next < end) {
+
+      // The range to read has been partly fetched.  Fetching the middle
+      // again is cheaper than another round trip.
+
+      stop = end;
+    }
+    else if(next <= stop || next - stop <= MergeDistance) {
+      stop = next;
+
+      // The read ends where data has been fetched, as in a backward scan, so
+      // fetch a block before it rather than after it.
+
+      if(stop - start < blockSize)
+        start = std::max(std::max(stop - blockSize, previous), 0L);
+    }
+
+    const ByteVector data = fetcher->fetch(start, static_cast<unsigned long>(stop - start));
+    roundTrips++;
+
+    if(data.size() < static_cast<unsigned long>(stop - start))
+      debug("RangeFetchStream::readBlock() -- The fetcher returned less data than requested.");
+
+    add(start, data);
+  }
+
+  Fetcher *const fetcher;
+  const FileNameHandle name;
+  const long length;
+  const long blockSize;
+
+  long position;
+  ChunkMap chunks;
+
+  bool prefetched;
+  unsigned int roundTrips;
+  long bytesFetched;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// RangeFetchStream::Fetcher
+////////////////////////////////////////////////////////////////////////////////
+
+RangeFetchStream::Fetcher::~Fetcher()
+{
+}
+
+ByteVectorList RangeFetchStream::Fetcher::fetchRanges(const File::RangeList &ranges)
+{
+  ByteVectorList data;
+  for(File::RangeList::ConstIterator it = ranges.begin(); it != ranges.end(); ++it)
+    data.append(fetch(it->offset, static_cast<unsigned long>(it->length)));
+
+  return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+RangeFetchStream::RangeFetchStream(Fetcher *fetcher, long length, FileName name,
+                                   unsigned long blockSize) :
+  d(new RangeFetchStreamPrivate(fetcher, length, name, blockSize))
+{
+}
+
+RangeFetchStream::~RangeFetchStream()
+{
+  delete d;
+}
+
+FileName RangeFetchStream::name() const
+{
+  return d->name;
+}
+
+ByteVector RangeFetchStream::readBlock(unsigned long length)
+{
+  if(!d->prefetched)
+    d->prefetch();
+
+  if(length == 0 || d->position < 0 || d->position >= d->length)
+    return ByteVector();
+
+  const long end = d->position + static_cast<long>(std::min<unsigned long>(length, d->length - d->position));
+
+  if(d->chunks.coveredUntil(d->position) < end)
+    d->fetch(d->position, end);
+
+  const long available = std::min(d->chunks.coveredUntil(d->position), end);
+  if(available <= d->position)
+    return ByteVector();
+
+  const ByteVector data = d->chunks.data(d->position, available - d->position);
+  d->position = available;
+  return data;
+}
+
+void RangeFetchStream::writeBlock(const ByteVector &)
+{
+  debug("RangeFetchStream::writeBlock() -- read only stream.");
+}
+
+void RangeFetchStream::insert(const ByteVector &, unsigned long, unsigned long)
+{
+  debug("RangeFetchStream::insert() -- read only stream.");
+}
+
+void RangeFetchStream::removeBlock(unsigned long, unsigned long)
+{
+  debug("RangeFetchStream::removeBlock() -- read only stream.");
+}
+
+bool RangeFetchStream::readOnly() const
+{
+  return true;
+}
+
+bool RangeFetchStream::isOpen() const
+{
+  return true;
+}
+
+void RangeFetchStream::seek(long offset, Position p)
+{
+  switch(p) {
+  case Beginning:
+    d->position = offset;
+    break;
+  case Current:
+    d->position += offset;
+    break;
+  case End:
+    d->position = d->length + offset;
+    break;
+  }
+}
+
+void RangeFetchStream::clear()
+{
+}
+
+long RangeFetchStream::tell() const
+{
+  return d->position;
+}
+
+long RangeFetchStream::length()
+{
+  return d->length;
+}
+
+void RangeFetchStream::truncate(long)
+{
+  debug("RangeFetchStream::truncate() -- read only stream.");
+}
+
+unsigned int RangeFetchStream::roundTrips() const
+{
+  return d->roundTrips;
+}
+
+long RangeFetchStream::bytesFetched() const
+{
+  return d->bytesFetched;
+}
@@ -0,0 +1,188 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_RANGEFETCHSTREAM_H
+#define TAGLIB_RANGEFETCHSTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tbytevectorlist.h"
+#include "tiostream.h"
+#include "tfile.h"
+
+namespace TagLib {
+
+  //! A read only stream over a remote file fetched in ranges
+
+  /*!
+   * This reads a file through a Fetcher, which typically issues HTTP range
+   * requests to an object store.  Each request is a round trip, so rather than
+   * passing each readBlock() through, the stream:
+   *
+   * - fetches the head of the file and its last 128 KiB together on the first
+   *   read, since most formats probe the tags and headers at the end of the
+   *   file (ID3v1, APE, the last Ogg page, the last MPEG frame) besides the
+   *   ones at the start,
+   * - fetches at least \a blockSize bytes on a miss, and extends the request to
+   *   the data fetched before if the gap is small, so that the small reads of
+   *   a parser are served by few requests,
+   * - keeps all the data fetched, so that no range is fetched twice.
+   *
+   * \code
+   * MyHttpFetcher fetcher(url);
+   * TagLib::RangeFetchStream stream(&fetcher, contentLength, "song.mp3");
+   * TagLib::FileRef f(&stream);
+   * std::cout << stream.roundTrips() << " requests" << std::endl;
+   * \endcode
+   *
+   * \note The data fetched is kept in memory until the stream is destroyed.
+   */
+
+  class TAGLIB_EXPORT RangeFetchStream : public IOStream
+  {
+  public:
+    //! Fetches ranges of a remote file
+
+    class TAGLIB_EXPORT Fetcher
+    {
+    public:
+      /*!
+       * Destroys this Fetcher instance.
+       */
+      virtual ~Fetcher();
+
+      /*!
+       * This method must be overridden to return the \a length bytes at
+       * \a offset of the file.  Fewer bytes may be returned on error.
+       */
+      virtual ByteVector fetch(long offset, unsigned long length) = 0;
+
+      /*!
+       * Returns the data of each range in \a ranges, in the same order.  This
+       * is used to prefetch the head and the tail of the file in one round
+       * trip.  The default implementation calls fetch() for each range; it may
+       * be overridden to issue a single multi-range request.
+       */
+      virtual ByteVectorList fetchRanges(const File::RangeList &ranges);
+    };
+
+    /*!
+     * Constructs a RangeFetchStream which reads a file of \a length bytes
+     * through \a fetcher, which is not owned by the stream and must outlive
+     * it.  \a name is returned by name(), so that FileRef can detect the file
+     * type by its extension.  At least \a blockSize bytes are fetched at a
+     * time.
+     */
+    RangeFetchStream(Fetcher *fetcher, long length, FileName name = "",
+                     unsigned long blockSize = 64 * 1024);
+
+    /*!
+     * Destroys this RangeFetchStream instance.
+     */
+    virtual ~RangeFetchStream();
+
+    /*!
+     * Returns the name given to the constructor.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer, fetching the
+     * parts which have not been fetched yet.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Does nothing.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length given to the constructor.
+     */
+    long length();
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void truncate(long length);
+
+    /*!
+     * Returns the number of requests issued to the fetcher, counting the
+     * prefetch of the head and the tail as one.
+     */
+    unsigned int roundTrips() const;
+
+    /*!
+     * Returns the number of bytes returned by the fetcher.
+     */
+    long bytesFetched() const;
+
+  private:
+    RangeFetchStream(const RangeFetchStream &);
+    RangeFetchStream &operator=(const RangeFetchStream &);
+
+    class RangeFetchStreamPrivate;
+    RangeFetchStreamPrivate *d;
+  };
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_STREAMCHAIN_H
+#define TAGLIB_STREAMCHAIN_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "tinstrumentedstream.h"
+#include "tbudgetstream.h"
+
+namespace TagLib
+{
+  namespace Utils
+  {
+    /*!
+     * Returns the first stream of type T in the chain of decorating streams
+     * which starts at \a stream, e.g. the InstrumentedStream below a
+     * BudgetStream, or a null pointer if there is none.
+     */
+    template <class T>
+    T *findStream(IOStream *stream)
+    {
+      while(stream) {
+        T *found = dynamic_cast<T *>(stream);
+        if(found)
+          return found;
+
+        InstrumentedStream *instrumented = dynamic_cast<InstrumentedStream *>(stream);
+        BudgetStream *budget = dynamic_cast<BudgetStream *>(stream);
+        if(instrumented)
+          stream = instrumented->stream();
+        else if(budget)
+          stream = budget->stream();
+        else
+          stream = 0;
+      }
+      return 0;
+    }
+  }
+}
+
+#endif
+
+#endif
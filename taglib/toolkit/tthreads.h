@@ -0,0 +1,241 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_THREADS_H
+#define TAGLIB_THREADS_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include <vector>
+
+#ifdef _WIN32
+# if !defined(NOMINMAX)
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <pthread.h>
+# include <unistd.h>
+# if defined(__linux__)
+#   include <sys/syscall.h>
+# endif
+#endif
+
+namespace TagLib
+{
+  namespace Utils
+  {
+    //! A mutex on top of the native threads API.
+
+    class Mutex
+    {
+    public:
+#ifdef _WIN32
+      Mutex() { InitializeCriticalSection(&m_mutex); }
+      ~Mutex() { DeleteCriticalSection(&m_mutex); }
+      void lock() { EnterCriticalSection(&m_mutex); }
+      void unlock() { LeaveCriticalSection(&m_mutex); }
+#else
+      Mutex() { pthread_mutex_init(&m_mutex, 0); }
+      ~Mutex() { pthread_mutex_destroy(&m_mutex); }
+      void lock() { pthread_mutex_lock(&m_mutex); }
+      void unlock() { pthread_mutex_unlock(&m_mutex); }
+#endif
+
+    private:
+      Mutex(const Mutex &);
+      Mutex &operator=(const Mutex &);
+
+      friend class Condition;
+
+#ifdef _WIN32
+      CRITICAL_SECTION m_mutex;
+#else
+      pthread_mutex_t m_mutex;
+#endif
+    };
+
+    //! Locks a mutex for the lifetime of the object.
+
+    class MutexLocker
+    {
+    public:
+      explicit MutexLocker(Mutex &mutex) : m_mutex(mutex) { m_mutex.lock(); }
+      ~MutexLocker() { m_mutex.unlock(); }
+
+    private:
+      MutexLocker(const MutexLocker &);
+      MutexLocker &operator=(const MutexLocker &);
+
+      Mutex &m_mutex;
+    };
+
+    //! A condition variable on top of the native threads API.
+
+    class Condition
+    {
+    public:
+#ifdef _WIN32
+      Condition() { InitializeConditionVariable(&m_condition); }
+      ~Condition() {}
+      void wait(Mutex &mutex) { SleepConditionVariableCS(&m_condition, &mutex.m_mutex, INFINITE); }
+      void wakeAll() { WakeAllConditionVariable(&m_condition); }
+#else
+      Condition() { pthread_cond_init(&m_condition, 0); }
+      ~Condition() { pthread_cond_destroy(&m_condition); }
+      void wait(Mutex &mutex) { pthread_cond_wait(&m_condition, &mutex.m_mutex); }
+      void wakeAll() { pthread_cond_broadcast(&m_condition); }
+#endif
+
+    private:
+      Condition(const Condition &);
+      Condition &operator=(const Condition &);
+
+#ifdef _WIN32
+      CONDITION_VARIABLE m_condition;
+#else
+      pthread_cond_t m_condition;
+#endif
+    };
+
+    //! A thread which runs a worker next to the calling thread.
+
+    class Thread
+    {
+    public:
+      /*!
+       * Starts calling \a worker with \a context on a new thread.  If the
+       * thread can not be created, \a worker is not called at all.
+       */
+      Thread(void (*worker)(void *), void *context) :
+        m_worker(worker),
+        m_context(context)
+      {
+#ifdef _WIN32
+        m_handle = CreateThread(NULL, 0, run, this, 0, NULL);
+        m_started = (m_handle != NULL);
+#else
+        m_started = (pthread_create(&m_handle, 0, run, this) == 0);
+#endif
+      }
+
+      /*!
+       * Waits for the worker to return.
+       */
+      ~Thread()
+      {
+        if(!m_started)
+          return;
+
+#ifdef _WIN32
+        WaitForSingleObject(m_handle, INFINITE);
+        CloseHandle(m_handle);
+#else
+        pthread_join(m_handle, 0);
+#endif
+      }
+
+    private:
+      Thread(const Thread &);
+      Thread &operator=(const Thread &);
+
+#ifdef _WIN32
+      static DWORD WINAPI run(LPVOID thread)
+      {
+        static_cast<Thread *>(thread)->m_worker(static_cast<Thread *>(thread)->m_context);
+        return 0;
+      }
+#else
+      static void *run(void *thread)
+      {
+        static_cast<Thread *>(thread)->m_worker(static_cast<Thread *>(thread)->m_context);
+        return 0;
+      }
+#endif
+
+      void (*const m_worker)(void *);
+      void *const m_context;
+      bool m_started;
+#ifdef _WIN32
+      HANDLE m_handle;
+#else
+      pthread_t m_handle;
+#endif
+    };
+
+    /*!
+     * Calls \a worker with \a context on \a threads threads, one of which is
+     * the calling thread, and returns when all of them have returned.  The
+     * workers are expected to pull their work from \a context until there is
+     * none left.
+     */
+    inline void runParallel(unsigned int threads, void (*worker)(void *), void *context)
+    {
+      std::vector<Thread *> started;
+      for(unsigned int i = 1; i < threads; ++i)
+        started.push_back(new Thread(worker, context));
+
+      worker(context);
+
+      for(std::vector<Thread *>::const_iterator it = started.begin(); it != started.end(); ++it)
+        delete *it;
+    }
+
+    /*!
+     * Returns the identifier of the current process.
+     */
+    inline unsigned long long currentProcessId()
+    {
+#ifdef _WIN32
+      return GetCurrentProcessId();
+#else
+      return static_cast<unsigned long long>(getpid());
+#endif
+    }
+
+    /*!
+     * Returns the identifier the operating system uses for the current thread.
+     */
+    inline unsigned long long currentThreadId()
+    {
+#if defined(_WIN32)
+      return GetCurrentThreadId();
+#elif defined(__APPLE__)
+      unsigned long long id = 0;
+      pthread_threadid_np(0, &id);
+      return id;
+#elif defined(__linux__)
+      return static_cast<unsigned long long>(syscall(SYS_gettid));
+#else
+      return reinterpret_cast<unsigned long long>(pthread_self());
+#endif
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef ENABLE_TRACE_EVENTS
+
+#include "ttrace.h"
+#include "ttracelistener.h"
+#include "tclock.h"
+
+using namespace TagLib;
+
+namespace TagLib
+{
+  // Defined in ttracelistener.cpp.
+  TraceListener *currentTraceListener();
+}
+
+TraceScope::TraceScope(const char *name) :
+  m_name(name),
+  m_listener(currentTraceListener()),
+  m_start(m_listener ? Utils::monotonicNanoseconds() : 0)
+{
+}
+
+TraceScope::~TraceScope()
+{
+  if(m_listener && m_listener == currentTraceListener())
+    m_listener->traceEvent(m_name, m_start, Utils::monotonicNanoseconds() - m_start);
+}
+
+#endif
@@ -0,0 +1,78 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_TRACE_H
+#define TAGLIB_TRACE_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#ifdef ENABLE_TRACE_EVENTS
+
+namespace TagLib
+{
+  class TraceListener;
+
+  /*!
+   * Reports the time between its construction and destruction to the trace
+   * listener, if one is set.
+   *
+   * \internal
+   */
+  class TraceScope
+  {
+  public:
+    explicit TraceScope(const char *name);
+    ~TraceScope();
+
+  private:
+    TraceScope(const TraceScope &);
+    TraceScope &operator=(const TraceScope &);
+
+    const char *const m_name;
+    TraceListener *const m_listener;
+    unsigned long long m_start;
+  };
+}
+
+/*!
+ * Traces the rest of the enclosing scope as the phase \a name, which must be
+ * a string literal.
+ */
+# define TAGLIB_TRACE(name) TagLib::TraceScope taglibTraceScope(name)
+
+#else
+
+# define TAGLIB_TRACE(name) ((void)0)
+
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <ostream>
+
+#if defined(HAVE_STD_ATOMIC)
+# include <atomic>
+#endif
+
+#include "ttracelistener.h"
+#include "tthreads.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Writes a nanosecond value in microseconds, the unit of the trace format.
+
+  void writeMicroseconds(std::ostream &stream, unsigned long long nanoseconds)
+  {
+    const char fill = stream.fill('0');
+    stream << nanoseconds / 1000 << '.';
+    stream.width(3);
+    stream << nanoseconds % 1000;
+    stream.fill(fill);
+  }
+
+  void writeString(std::ostream &stream, const char *s)
+  {
+    stream << '"';
+    for(; *s; ++s) {
+      if(*s == '"' || *s == '\\')
+        stream << '\\';
+      stream << *s;
+    }
+    stream << '"';
+  }
+}
+
+namespace
+{
+#if defined(HAVE_STD_ATOMIC)
+  std::atomic<TraceListener *> listener(0);
+#else
+  TraceListener *volatile listener = 0;
+#endif
+}
+
+namespace TagLib
+{
+  // Used by TraceScope in ttrace.cpp.
+
+  TraceListener *currentTraceListener()
+  {
+    return listener;
+  }
+
+  TraceListener::TraceListener()
+  {
+  }
+
+  TraceListener::~TraceListener()
+  {
+  }
+
+  void setTraceListener(TraceListener *l)
+  {
+    listener = l;
+  }
+
+  bool isTracingEnabled()
+  {
+#ifdef ENABLE_TRACE_EVENTS
+    return true;
+#else
+    return false;
+#endif
+  }
+}
+
+class ChromeTraceWriter::ChromeTraceWriterPrivate
+{
+public:
+  ChromeTraceWriterPrivate(std::ostream &stream) :
+    stream(stream),
+    first(true),
+    processId(Utils::currentProcessId()) {}
+
+  std::ostream &stream;
+  bool first;
+  const unsigned long long processId;
+
+  // Events of several threads must not interleave in the output.
+  Utils::Mutex mutex;
+};
+
+ChromeTraceWriter::ChromeTraceWriter(std::ostream &stream) :
+  d(new ChromeTraceWriterPrivate(stream))
+{
+  d->stream << "{\"traceEvents\": [";
+}
+
+ChromeTraceWriter::~ChromeTraceWriter()
+{
+  d->stream << "\n], \"displayTimeUnit\": \"ns\"}\n";
+  d->stream.flush();
+  delete d;
+}
+
+void ChromeTraceWriter::traceEvent(const char *name,
+                                   unsigned long long startInNanoseconds,
+                                   unsigned long long durationInNanoseconds)
+{
+  const unsigned long long threadId = Utils::currentThreadId();
+
+  Utils::MutexLocker locker(d->mutex);
+
+  std::ostream &s = d->stream;
+
+  s << (d->first ? "\n" : ",\n");
+  d->first = false;
+
+  s << "{\"name\": ";
+  writeString(s, name);
+  s << ", \"cat\": \"taglib\", \"ph\": \"X\", \"ts\": ";
+  writeMicroseconds(s, startInNanoseconds);
+  s << ", \"dur\": ";
+  writeMicroseconds(s, durationInNanoseconds);
+  s << ", \"pid\": " << d->processId << ", \"tid\": " << threadId << "}";
+}
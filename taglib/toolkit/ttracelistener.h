@@ -0,0 +1,129 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_TRACELISTENER_H
+#define TAGLIB_TRACELISTENER_H
+
+#include <iosfwd>
+
+#include "taglib_export.h"
+
+namespace TagLib
+{
+  //! An abstraction for the listener to the trace events.
+
+  /*!
+   * If TagLib is built with the ENABLE_TRACE_EVENTS option, the expensive
+   * phases of reading and writing files, such as detecting the file type,
+   * parsing an ID3v2 tag or scanning the Ogg pages, report their duration to
+   * the listener set with setTraceListener().  Otherwise no events are
+   * reported and the trace points compile to nothing.
+   *
+   * \see setTraceListener()
+   * \see ChromeTraceWriter
+   */
+  class TAGLIB_EXPORT TraceListener
+  {
+  public:
+    TraceListener();
+    virtual ~TraceListener();
+
+    /*!
+     * When overridden in a derived class, records that the phase \a name,
+     * which started at \a startInNanoseconds of a monotonic clock, took
+     * \a durationInNanoseconds.  Phases which are nested in another phase are
+     * reported before the enclosing one.
+     */
+    virtual void traceEvent(const char *name,
+                            unsigned long long startInNanoseconds,
+                            unsigned long long durationInNanoseconds) = 0;
+
+  private:
+    // Noncopyable
+    TraceListener(const TraceListener &);
+    TraceListener &operator=(const TraceListener &);
+  };
+
+  /*!
+   * Sets the listener which receives the trace events.  If the parameter
+   * \a listener is null, no events are reported, which is the default.
+   *
+   * \note The listener is called from the thread doing the work and is not
+   * synchronized, so it has to be thread safe if TagLib is used from several
+   * threads.  ChromeTraceWriter is.  The listener may be replaced while other
+   * threads are working, but it must outlive the phases which started while it
+   * was set.
+   *
+   * \see TraceListener
+   */
+  TAGLIB_EXPORT void setTraceListener(TraceListener *listener);
+
+  /*!
+   * Returns true if TagLib was built with ENABLE_TRACE_EVENTS.
+   */
+  TAGLIB_EXPORT bool isTracingEnabled();
+
+  //! Writes the trace events in the Chrome trace event format.
+
+  /*!
+   * The output is a JSON object which can be loaded in chrome://tracing or
+   * the Perfetto UI, for example:
+   *
+   * \code
+   * std::ofstream out("taglib.json");
+   * TagLib::ChromeTraceWriter writer(out);
+   * TagLib::setTraceListener(&writer);
+   * TagLib::FileRef f("slow.mp3");
+   * TagLib::setTraceListener(0);
+   * \endcode
+   *
+   * The JSON object is completed when the writer is destroyed.  Events may be
+   * reported from several threads; each is recorded with the identifiers of
+   * the process and the thread which reported it.
+   */
+  class TAGLIB_EXPORT ChromeTraceWriter : public TraceListener
+  {
+  public:
+    /*!
+     * Constructs a writer which writes to \a stream.  The stream must outlive
+     * the writer.
+     */
+    explicit ChromeTraceWriter(std::ostream &stream);
+
+    /*!
+     * Completes the JSON object and destroys this ChromeTraceWriter instance.
+     */
+    virtual ~ChromeTraceWriter();
+
+    virtual void traceEvent(const char *name,
+                            unsigned long long startInNanoseconds,
+                            unsigned long long durationInNanoseconds);
+
+  private:
+    class ChromeTraceWriterPrivate;
+    ChromeTraceWriterPrivate *d;
+  };
+}
+
+#endif
@@ -30,6 +30,8 @@
 #include <tbytevector.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tagunion.h>
 #include <tstringlist.h>
 #include <tpropertymap.h>
@@ -163,6 +165,9 @@ void TrueAudio::File::setID3v2FrameFactory(const ID3v2::FrameFactory *factory)
 
 bool TrueAudio::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("TrueAudio::File::save() -- File is read only.");
     return false;
@@ -261,12 +266,31 @@ bool TrueAudio::File::hasID3v2Tag() const
   return (d->ID3v2Location >= 0);
 }
 
+File::RangeList TrueAudio::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  long start = 0;
+  if(d->ID3v2Location >= 0)
+    start = d->ID3v2Location + d->ID3v2OriginalSize;
+
+  const long end = (d->ID3v1Location >= 0) ? d->ID3v1Location : length();
+
+  RangeList ranges;
+  if(end > start)
+    ranges.append(Range(start, end - start));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void TrueAudio::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   // Look for an ID3v2 tag
 
   d->ID3v2Location = Utils::findID3v2(this);
@@ -276,9 +300,13 @@ void TrueAudio::File::read(bool readProperties)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
+  // Look for the tags at the end of the file
+
+  const Utils::TrailingTags trailingTags = Utils::findTrailingTags(this);
+
   // Look for an ID3v1 tag
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->ID3v1Location = trailingTags.ID3v1Location;
 
   if(d->ID3v1Location >= 0)
     d->tag.set(TrueAudioID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
@@ -289,13 +317,9 @@ void TrueAudio::File::read(bool readProperties)
   // Look for TrueAudio metadata
 
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
 
-    long streamLength;
-
-    if(d->ID3v1Location >= 0)
-      streamLength = d->ID3v1Location;
-    else
-      streamLength = length();
+    long streamLength = trailingTags.audioEnd;
 
     if(d->ID3v2Location >= 0) {
       seek(d->ID3v2Location + d->ID3v2OriginalSize);
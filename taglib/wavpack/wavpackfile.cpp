@@ -30,6 +30,8 @@
 #include <tbytevector.h>
 #include <tstring.h>
 #include <tdebug.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
 #include <tagunion.h>
 #include <tpropertymap.h>
 #include <tagutils.h>
@@ -138,6 +140,9 @@ WavPack::Properties *WavPack::File::audioProperties() const
 
 bool WavPack::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("WavPack::File::save() -- File is read only.");
     return false;
@@ -240,22 +245,45 @@ bool WavPack::File::hasAPETag() const
   return (d->APELocation >= 0);
 }
 
+File::RangeList WavPack::File::audioDataRanges()
+{
+  if(!isValid())
+    return RangeList();
+
+  long end = length();
+  if(d->APELocation >= 0)
+    end = d->APELocation;
+  else if(d->ID3v1Location >= 0)
+    end = d->ID3v1Location;
+
+  RangeList ranges;
+  if(end > 0)
+    ranges.append(Range(0, end));
+  return ranges;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
 void WavPack::File::read(bool readProperties)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
+  // Look for the tags at the end of the file
+
+  const Utils::TrailingTags trailingTags = Utils::findTrailingTags(this);
+
   // Look for an ID3v1 tag
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->ID3v1Location = trailingTags.ID3v1Location;
 
   if(d->ID3v1Location >= 0)
     d->tag.set(WavID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
 
   // Look for an APE tag
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = trailingTags.APEFooterLocation;
 
   if(d->APELocation >= 0) {
     d->tag.set(WavAPEIndex, new APE::Tag(this, d->APELocation));
@@ -269,15 +297,9 @@ void WavPack::File::read(bool readProperties)
   // Look for WavPack audio properties
 
   if(readProperties) {
+    InstrumentedStream::PhaseScope scope(stream(), IOStatistics::PropertiesParsing);
 
-    long streamLength;
-
-    if(d->APELocation >= 0)
-      streamLength = d->APELocation;
-    else if(d->ID3v1Location >= 0)
-      streamLength = d->ID3v1Location;
-    else
-      streamLength = length();
+    const long streamLength = trailingTags.audioEnd;
 
     d->properties = new Properties(this, streamLength);
   }
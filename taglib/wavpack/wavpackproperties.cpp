@@ -29,6 +29,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <tlayout.h>
 
 #include "wavpackproperties.h"
 #include "wavpackfile.h"
@@ -160,35 +161,52 @@ namespace
 
 #define FINAL_BLOCK     0x1000
 
+namespace
+{
+  struct BlockHeader
+  {
+    static const unsigned int size = 32;
+    typedef Layout::Bytes<0, 4> ID;
+    typedef Layout::U32L<4>     BlockSize;
+    typedef Layout::S16L<8>     Version;
+    typedef Layout::U32L<12>    TotalSamples;
+    typedef Layout::U32L<16>    BlockIndex;
+    typedef Layout::U32L<20>    BlockSamples;
+    typedef Layout::U32L<24>    Flags;
+  };
+}
+
 void WavPack::Properties::read(File *file, long streamLength)
 {
+  typedef BlockHeader H;
   long offset = 0;
 
   while(true) {
     file->seek(offset);
-    const ByteVector data = file->readBlock(32);
+    const ByteVector data = file->readBlock(H::size);
+    const Layout::View<H> header(data);
 
-    if(data.size() < 32) {
+    if(!header.isValid()) {
       debug("WavPack::Properties::read() -- data is too short.");
       break;
     }
 
-    if(!data.startsWith("wvpk")) {
+    if(header.get<H::ID>() != "wvpk") {
       debug("WavPack::Properties::read() -- Block header not found.");
       break;
     }
 
-    const unsigned int flags = data.toUInt(24, false);
+    const unsigned int flags = header.get<H::Flags>();
 
     if(offset == 0) {
-      d->version = data.toShort(8, false);
+      d->version = header.get<H::Version>();
       if(d->version < MIN_STREAM_VERS || d->version > MAX_STREAM_VERS)
         break;
 
       d->bitsPerSample = ((flags & BYTES_STORED) + 1) * 8 - ((flags & SHIFT_MASK) >> SHIFT_LSB);
       d->sampleRate    = sample_rates[(flags & SRATE_MASK) >> SRATE_LSB];
       d->lossless      = !(flags & LOSSLESS_FLAG);
-      d->sampleFrames  = data.toUInt(12, false);
+      d->sampleFrames  = header.get<H::TotalSamples>();
     }
 
     d->channels += (flags & MONO_FLAG) ? 1 : 2;
@@ -196,7 +214,7 @@ void WavPack::Properties::read(File *file, long streamLength)
     if(flags & FINAL_BLOCK)
       break;
 
-    const unsigned int blockSize = data.toUInt(4, false);
+    const unsigned int blockSize = header.get<H::BlockSize>();
     offset += blockSize + 8;
   }
 
@@ -216,21 +234,24 @@ unsigned int WavPack::Properties::seekFinalIndex(File *file, long streamLength)
   if(offset == -1)
     return 0;
 
+  typedef BlockHeader H;
+
   file->seek(offset);
-  const ByteVector data = file->readBlock(32);
-  if(data.size() < 32)
+  const ByteVector data = file->readBlock(H::size);
+  const Layout::View<H> header(data);
+  if(!header.isValid())
     return 0;
 
-  const int version = data.toShort(8, false);
+  const int version = header.get<H::Version>();
   if(version < MIN_STREAM_VERS || version > MAX_STREAM_VERS)
     return 0;
 
-  const unsigned int flags = data.toUInt(24, false);
+  const unsigned int flags = header.get<H::Flags>();
   if(!(flags & FINAL_BLOCK))
     return 0;
 
-  const unsigned int blockIndex   = data.toUInt(16, false);
-  const unsigned int blockSamples = data.toUInt(20, false);
+  const unsigned int blockIndex   = header.get<H::BlockIndex>();
+  const unsigned int blockSamples = header.get<H::BlockSamples>();
 
   return blockIndex + blockSamples;
 }
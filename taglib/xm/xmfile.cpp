@@ -25,8 +25,11 @@
 
 #include "tstringlist.h"
 #include "tdebug.h"
+#include "tinstrumentedstream.h"
+#include "tbudgetstream.h"
 #include "xmfile.h"
 #include "modfileprivate.h"
+#include "modreader.h"
 #include "tpropertymap.h"
 
 #include <string.h>
@@ -34,314 +37,7 @@
 
 using namespace TagLib;
 using namespace XM;
-
-/*!
- * The Reader classes are helpers to make handling of the stripped XM
- * format more easy. In the stripped XM format certain header sizes might
- * be smaller than one would expect. The fields that are not included
- * are then just some predefined valued (e.g. 0).
- *
- * Using these classes this code:
- *
- *   if(headerSize >= 4) {
- *     if(!readU16L(value1)) ERROR();
- *     if(headerSize >= 8) {
- *       if(!readU16L(value2)) ERROR();
- *       if(headerSize >= 12) {
- *         if(!readString(value3, 22)) ERROR();
- *         ...
- *       }
- *     }
- *   }
- *
- * Becomes:
- *
- *   StructReader header;
- *   header.u16L(value1).u16L(value2).string(value3, 22). ...;
- *   if(header.read(*this, headerSize) < std::min(header.size(), headerSize))
- *     ERROR();
- *
- * Maybe if this is useful to other formats these classes can be moved to
- * their own public files.
- */
-class Reader
-{
-public:
-  virtual ~Reader()
-  {
-  }
-
-  /*!
-   * Reads associated values from \a file, but never reads more
-   * then \a limit bytes.
-   */
-  virtual unsigned int read(TagLib::File &file, unsigned int limit) = 0;
-
-  /*!
-   * Returns the number of bytes this reader would like to read.
-   */
-  virtual unsigned int size() const = 0;
-};
-
-class SkipReader : public Reader
-{
-public:
-  SkipReader(unsigned int size) : m_size(size)
-  {
-  }
-
-  unsigned int read(TagLib::File &file, unsigned int limit)
-  {
-    unsigned int count = std::min(m_size, limit);
-    file.seek(count, TagLib::File::Current);
-    return count;
-  }
-
-  unsigned int size() const
-  {
-    return m_size;
-  }
-
-private:
-  unsigned int m_size;
-};
-
-template<typename T>
-class ValueReader : public Reader
-{
-public:
-  ValueReader(T &value) : value(value)
-  {
-  }
-
-protected:
-  T &value;
-};
-
-class StringReader : public ValueReader<String>
-{
-public:
-  StringReader(String &string, unsigned int size) :
-    ValueReader<String>(string), m_size(size)
-  {
-  }
-
-  unsigned int read(TagLib::File &file, unsigned int limit)
-  {
-    ByteVector data = file.readBlock(std::min(m_size, limit));
-    unsigned int count = data.size();
-    int index = data.find((char) 0);
-    if(index > -1) {
-      data.resize(index);
-    }
-    data.replace('\xff', ' ');
-    value = data;
-    return count;
-  }
-
-  unsigned int size() const
-  {
-    return m_size;
-  }
-
-private:
-  unsigned int m_size;
-};
-
-class ByteReader : public ValueReader<unsigned char>
-{
-public:
-  ByteReader(unsigned char &byte) : ValueReader<unsigned char>(byte) {}
-
-  unsigned int read(TagLib::File &file, unsigned int limit)
-  {
-    ByteVector data = file.readBlock(std::min(1U,limit));
-    if(data.size() > 0) {
-      value = data[0];
-    }
-    return data.size();
-  }
-
-  unsigned int size() const
-  {
-    return 1;
-  }
-};
-
-template<typename T>
-class NumberReader : public ValueReader<T>
-{
-public:
-  NumberReader(T &value, bool bigEndian) :
-    ValueReader<T>(value), bigEndian(bigEndian)
-  {
-  }
-
-protected:
-  bool bigEndian;
-};
-
-class U16Reader : public NumberReader<unsigned short>
-{
-public:
-  U16Reader(unsigned short &value, bool bigEndian)
-  : NumberReader<unsigned short>(value, bigEndian) {}
-
-  unsigned int read(TagLib::File &file, unsigned int limit)
-  {
-    ByteVector data = file.readBlock(std::min(2U,limit));
-    value = data.toUShort(bigEndian);
-    return data.size();
-  }
-
-  unsigned int size() const
-  {
-    return 2;
-  }
-};
-
-class U32Reader : public NumberReader<unsigned long>
-{
-public:
-  U32Reader(unsigned long &value, bool bigEndian = true) :
-    NumberReader<unsigned long>(value, bigEndian)
-  {
-  }
-
-  unsigned int read(TagLib::File &file, unsigned int limit)
-  {
-    ByteVector data = file.readBlock(std::min(4U,limit));
-    value = data.toUInt(bigEndian);
-    return data.size();
-  }
-
-  unsigned int size() const
-  {
-    return 4;
-  }
-};
-
-class StructReader : public Reader
-{
-public:
-  StructReader()
-  {
-    m_readers.setAutoDelete(true);
-  }
-
-  /*!
-   * Add a nested reader. This reader takes ownership.
-   */
-  StructReader &reader(Reader *reader)
-  {
-    m_readers.append(reader);
-    return *this;
-  }
-
-  /*!
-   * Don't read anything but skip \a size bytes.
-   */
-  StructReader &skip(unsigned int size)
-  {
-    m_readers.append(new SkipReader(size));
-    return *this;
-  }
-
-  /*!
-   * Read a string of \a size characters (bytes) into \a string.
-   */
-  StructReader &string(String &string, unsigned int size)
-  {
-    m_readers.append(new StringReader(string, size));
-    return *this;
-  }
-
-  /*!
-   * Read a byte into \a byte.
-   */
-  StructReader &byte(unsigned char &byte)
-  {
-    m_readers.append(new ByteReader(byte));
-    return *this;
-  }
-
-  /*!
-   * Read a unsigned 16 Bit integer into \a number. The byte order
-   * is controlled by \a bigEndian.
-   */
-  StructReader &u16(unsigned short &number, bool bigEndian)
-  {
-    m_readers.append(new U16Reader(number, bigEndian));
-    return *this;
-  }
-
-  /*!
-   * Read a unsigned 16 Bit little endian integer into \a number.
-   */
-  StructReader &u16L(unsigned short &number)
-  {
-    return u16(number, false);
-  }
-
-  /*!
-   * Read a unsigned 16 Bit big endian integer into \a number.
-   */
-  StructReader &u16B(unsigned short &number)
-  {
-    return u16(number, true);
-  }
-
-  /*!
-   * Read a unsigned 32 Bit integer into \a number. The byte order
-   * is controlled by \a bigEndian.
-   */
-  StructReader &u32(unsigned long &number, bool bigEndian)
-  {
-    m_readers.append(new U32Reader(number, bigEndian));
-    return *this;
-  }
-
-  /*!
-   * Read a unsigned 32 Bit little endian integer into \a number.
-   */
-  StructReader &u32L(unsigned long &number)
-  {
-    return u32(number, false);
-  }
-
-  /*!
-   * Read a unsigned 32 Bit big endian integer into \a number.
-   */
-  StructReader &u32B(unsigned long &number)
-  {
-    return u32(number, true);
-  }
-
-  unsigned int size() const
-  {
-    unsigned int size = 0;
-    for(List<Reader*>::ConstIterator i = m_readers.begin();
-        i != m_readers.end(); ++ i) {
-      size += (*i)->size();
-    }
-    return size;
-  }
-
-  unsigned int read(TagLib::File &file, unsigned int limit)
-  {
-    unsigned int sumcount = 0;
-    for(List<Reader*>::ConstIterator i = m_readers.begin();
-        limit > 0 && i != m_readers.end(); ++ i) {
-      unsigned int count = (*i)->read(file, limit);
-      limit    -= count;
-      sumcount += count;
-    }
-    return sumcount;
-  }
-
-private:
-  List<Reader*> m_readers;
-};
+using Mod::StructReader;
 
 class XM::File::FilePrivate
 {
@@ -360,8 +56,10 @@ XM::File::File(FileName file, bool readProperties,
   Mod::FileBase(file),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 XM::File::File(IOStream *stream, bool readProperties,
@@ -369,8 +67,10 @@ XM::File::File(IOStream *stream, bool readProperties,
   Mod::FileBase(stream),
   d(new FilePrivate(propertiesStyle))
 {
-  if(isOpen())
+  if(isOpen()) {
     read(readProperties);
+    d->tag.setModified(false);
+  }
 }
 
 XM::File::~File()
@@ -400,6 +100,9 @@ XM::Properties *XM::File::audioProperties() const
 
 bool XM::File::save()
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::Saving);
+  BudgetStream::SaveScope budgetScope(stream());
+
   if(readOnly()) {
     debug("XM::File::save() - Cannot save to a read only file.");
     return false;
@@ -495,24 +198,25 @@ bool XM::File::save()
 
 void XM::File::read(bool)
 {
+  InstrumentedStream::PhaseScope scope(stream(), IOStatistics::TagParsing);
+
   if(!isOpen())
     return;
 
-  seek(0);
-  ByteVector magic = readBlock(17);
-  // it's all 0x00 for stripped XM files:
-  READ_ASSERT(magic == "Extended Module: " || magic == ByteVector(17, 0));
-
-  READ_STRING(d->tag.setTitle, 20);
-  READ_BYTE_AS(escape);
-  // in stripped XM files this is 0x00:
-  READ_ASSERT(escape == 0x1A || escape == 0x00);
-
-  READ_STRING(d->tag.setTrackerName, 20);
-  READ_U16L(d->properties.setVersion);
+  ByteVector magic;
+  String title;
+  unsigned char escape = 0;
+  String trackerName;
+  unsigned short version = 0;
+  unsigned long headerSize = 0;
 
-  READ_U32L_AS(headerSize);
-  READ_ASSERT(headerSize >= 4);
+  StructReader module;
+  module.bytes(magic, 17)
+        .string(title, 20)
+        .byte(escape)
+        .string(trackerName, 20)
+        .u16L(version)
+        .u32L(headerSize);
 
   unsigned short length          = 0;
   unsigned short restartPosition = 0;
@@ -533,7 +237,22 @@ void XM::File::read(bool)
         .u16L(tempo)
         .u16L(bpmSpeed);
 
-  unsigned int count = header.read(*this, headerSize - 4U);
+  // the module header and the song header are read at once:
+  seek(0);
+  const ByteVector data = readBlock(module.size() + header.size());
+  READ_ASSERT(module.parse(data, 0, module.size()) == module.size());
+
+  // it's all 0x00 for stripped XM files:
+  READ_ASSERT(magic == "Extended Module: " || magic == ByteVector(17, 0));
+  // in stripped XM files this is 0x00:
+  READ_ASSERT(escape == 0x1A || escape == 0x00);
+  READ_ASSERT(headerSize >= 4);
+
+  d->tag.setTitle(title);
+  d->tag.setTrackerName(trackerName);
+  d->properties.setVersion(version);
+
+  unsigned int count = header.parse(data, module.size(), headerSize - 4U);
   unsigned int size = std::min(headerSize - 4U, (unsigned long)header.size());
 
   READ_ASSERT(count == size);
@@ -547,34 +266,36 @@ void XM::File::read(bool)
   d->properties.setTempo(tempo);
   d->properties.setBpmSpeed(bpmSpeed);
 
-  seek(60 + headerSize);
+  long pos = 60 + headerSize; // should be long long in taglib2.
 
-  // read patterns:
+  // read patterns, each header together with its length:
   for(unsigned short i = 0; i < patternCount; ++ i) {
-    READ_U32L_AS(patternHeaderLength);
-    READ_ASSERT(patternHeaderLength >= 4);
-
     unsigned char  packingType = 0;
     unsigned short rowCount = 0;
     unsigned short dataSize = 0;
     StructReader pattern;
     pattern.byte(packingType).u16L(rowCount).u16L(dataSize);
 
-    unsigned int count = pattern.read(*this, patternHeaderLength - 4U);
+    seek(pos);
+    const ByteVector data = readBlock(4 + pattern.size());
+    READ_ASSERT(data.size() >= 4);
+
+    const unsigned long patternHeaderLength = data.toUInt(0U, false);
+    READ_ASSERT(patternHeaderLength >= 4);
+
+    unsigned int count = pattern.parse(data, 4, patternHeaderLength - 4U);
     READ_ASSERT(count == std::min(patternHeaderLength - 4U, (unsigned long)pattern.size()));
 
-    seek(patternHeaderLength - (4 + count) + dataSize, Current);
+    pos += patternHeaderLength + dataSize;
   }
 
   StringList intrumentNames;
   StringList sampleNames;
   unsigned int sumSampleCount = 0;
 
-  // read instruments:
+  // read instruments, each header together with its length and the size of
+  // the sample headers:
   for(unsigned short i = 0; i < instrumentCount; ++ i) {
-    READ_U32L_AS(instrumentHeaderSize);
-    READ_ASSERT(instrumentHeaderSize >= 4);
-
     String instrumentName;
     unsigned char  instrumentType = 0;
     unsigned short sampleCount = 0;
@@ -582,18 +303,27 @@ void XM::File::read(bool)
     StructReader instrument;
     instrument.string(instrumentName, 22).byte(instrumentType).u16L(sampleCount);
 
+    seek(pos);
+    const ByteVector data = readBlock(4 + instrument.size() + 4);
+    READ_ASSERT(data.size() >= 4);
+
+    const unsigned long instrumentHeaderSize = data.toUInt(0U, false);
+    READ_ASSERT(instrumentHeaderSize >= 4);
+
     // 4 for instrumentHeaderSize
-    unsigned int count = 4 + instrument.read(*this, instrumentHeaderSize - 4U);
+    unsigned int count = 4 + instrument.parse(data, 4, instrumentHeaderSize - 4U);
     READ_ASSERT(count == std::min(instrumentHeaderSize, (unsigned long)instrument.size() + 4));
 
-    long offset = 0;
+    pos += instrumentHeaderSize;
+
     if(sampleCount > 0) {
-      unsigned long sampleHeaderSize = 0;
       sumSampleCount += sampleCount;
       // wouldn't know which header size to assume otherwise:
-      READ_ASSERT(instrumentHeaderSize >= count + 4 && readU32L(sampleHeaderSize));
+      READ_ASSERT(instrumentHeaderSize >= count + 4 && data.size() >= count + 4);
+      const unsigned long sampleHeaderSize = data.toUInt(count, false);
+
       // skip unhandeled header proportion:
-      seek(instrumentHeaderSize - count - 4, Current);
+      seek(pos);
 
       for(unsigned short j = 0; j < sampleCount; ++ j) {
         unsigned long sampleLength = 0;
@@ -621,17 +351,14 @@ void XM::File::read(bool)
         unsigned int count = sample.read(*this, sampleHeaderSize);
         READ_ASSERT(count == std::min(sampleHeaderSize, (unsigned long)sample.size()));
         // skip unhandeled header proportion:
-        seek(sampleHeaderSize - count, Current);
+        if(count < sampleHeaderSize)
+          seek(sampleHeaderSize - count, Current);
 
-        offset += sampleLength;
+        pos += sampleHeaderSize + sampleLength;
         sampleNames.append(sampleName);
       }
     }
-    else {
-      offset = instrumentHeaderSize - count;
-    }
     intrumentNames.append(instrumentName);
-    seek(offset, Current);
   }
 
   d->properties.setSampleCount(sumSampleCount);
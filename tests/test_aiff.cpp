@@ -28,6 +28,8 @@
 #include <tag.h>
 #include <tbytevectorlist.h>
 #include <aifffile.h>
+#include <fileref.h>
+#include <tinstrumentedstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -43,6 +45,7 @@ class TestAIFF : public CppUnit::TestFixture
   CPPUNIT_TEST(testDuplicateID3v2);
   CPPUNIT_TEST(testFuzzedFile1);
   CPPUNIT_TEST(testFuzzedFile2);
+  CPPUNIT_TEST(testSaveUnchanged);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -137,6 +140,11 @@ public:
     CPPUNIT_ASSERT(!f.isValid());
   }
 
+  void testSaveUnchanged()
+  {
+    checkSaveUnchanged("empty", ".aiff");
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestAIFF);
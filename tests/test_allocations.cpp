@@ -0,0 +1,161 @@
+/***************************************************************************
+    copyright           : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <string>
+#include <tallocator.h>
+#include <tpropertymap.h>
+#include <tag.h>
+#include <fileref.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  class CountingAllocator : public Allocator
+  {
+  public:
+    CountingAllocator() : allocations(0), deallocations(0) {}
+
+    void *allocate(size_t size)
+    {
+      ++allocations;
+      return malloc(size);
+    }
+
+    void deallocate(void *p)
+    {
+      ++deallocations;
+      free(p);
+    }
+
+    int allocations;
+    int deallocations;
+  };
+}
+
+class TestAllocations : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestAllocations);
+  CPPUNIT_TEST(testScope);
+  CPPUNIT_TEST(testAllocator);
+  CPPUNIT_TEST(testMPEGBudget);
+  CPPUNIT_TEST(testFLACBudget);
+  CPPUNIT_TEST(testOggBudget);
+  CPPUNIT_TEST(testMP4Budget);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void setUp()
+  {
+    // This suite is only built with TRACK_ALLOCATIONS.
+    CPPUNIT_ASSERT(AllocationScope::isTrackingEnabled());
+  }
+
+  void testScope()
+  {
+    AllocationScope outer;
+    {
+      AllocationScope inner;
+      int *p = new int[4];
+      delete[] p;
+
+      CPPUNIT_ASSERT_EQUAL(1ULL, inner.allocations());
+      CPPUNIT_ASSERT_EQUAL(1ULL, inner.deallocations());
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long long>(sizeof(int) * 4), inner.bytesAllocated());
+    }
+    CPPUNIT_ASSERT_EQUAL(1ULL, outer.allocations());
+  }
+
+  void testAllocator()
+  {
+    CountingAllocator allocator;
+    setAllocator(&allocator);
+    int *p = new int;
+    setAllocator(0);
+
+    // Released by the allocator which returned it, even after it was replaced.
+    delete p;
+
+    CPPUNIT_ASSERT_EQUAL(1, allocator.allocations);
+    CPPUNIT_ASSERT_EQUAL(1, allocator.deallocations);
+  }
+
+  // The budgets are the allocations counted by checkBudget() in a
+  // TRACK_ALLOCATIONS build, 825, 444, 474 and 715 respectively, rounded up
+  // by 5 to 12%.  That leaves room for small changes, but a regression such
+  // as a copy per frame or per item exceeds them.  Lower them when the counts
+  // drop.
+
+  void testMPEGBudget()
+  {
+    checkBudget("rare_frames.mp3", 900);
+  }
+
+  void testFLACBudget()
+  {
+    checkBudget("silence-44-s.flac", 470);
+  }
+
+  void testOggBudget()
+  {
+    checkBudget("test.ogg", 530);
+  }
+
+  void testMP4Budget()
+  {
+    checkBudget("has-tags.m4a", 800);
+  }
+
+private:
+
+  // Opens a file, reads its tags and audio properties, and checks that it
+  // takes at most maxAllocations and that all of them are released again.
+
+  void checkBudget(const string &filename, unsigned long long maxAllocations)
+  {
+    AllocationScope scope;
+    {
+      FileRef f(TEST_FILE_PATH_C(filename));
+      CPPUNIT_ASSERT(!f.isNull());
+      f.tag()->title();
+      f.file()->properties();
+      f.audioProperties()->lengthInMilliseconds();
+    }
+
+    if(scope.allocations() > maxAllocations) {
+      CPPUNIT_FAIL(filename + ": " + String::number(static_cast<int>(scope.allocations())).to8Bit()
+                   + " allocations exceed the budget of "
+                   + String::number(static_cast<int>(maxAllocations)).to8Bit());
+    }
+    CPPUNIT_ASSERT_EQUAL(scope.allocations(), scope.deallocations());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestAllocations);
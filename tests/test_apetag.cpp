@@ -30,6 +30,7 @@
 #include <tbytevectorlist.h>
 #include <tpropertymap.h>
 #include <apetag.h>
+#include <apefile.h>
 #include <tdebug.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -46,6 +47,7 @@ class TestAPETag : public CppUnit::TestFixture
   CPPUNIT_TEST(testPropertyInterface2);
   CPPUNIT_TEST(testInvalidKeys);
   CPPUNIT_TEST(testTextBinary);
+  CPPUNIT_TEST(testParseManyItems);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -149,6 +151,33 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector(), item.binaryData());
   }
 
+  void testParseManyItems()
+  {
+    const ByteVector picture(100000, 'x');
+
+    ScopedFileCopy copy("mac-399", ".ape");
+    {
+      APE::File f(copy.fileName().c_str());
+      APE::Tag *tag = f.APETag(true);
+      for(int i = 0; i < 198; ++i)
+        tag->addValue(String("Field ") + String::number(i), String::number(i * 3));
+      tag->addValue("ID3 Field", "ID3 as a prefix is a valid key");
+      tag->setData("Cover Art (Front)", picture);
+      f.save();
+    }
+    {
+      APE::File f(copy.fileName().c_str());
+      const APE::ItemListMap &items = f.APETag()->itemListMap();
+      CPPUNIT_ASSERT_EQUAL(200u, items.size());
+      CPPUNIT_ASSERT_EQUAL(String("Field 17"), items["FIELD 17"].key());
+      CPPUNIT_ASSERT_EQUAL(String("51"), items["FIELD 17"].toString());
+      CPPUNIT_ASSERT_EQUAL(String("591"), items["FIELD 197"].toString());
+      CPPUNIT_ASSERT(items.contains("ID3 FIELD"));
+      CPPUNIT_ASSERT_EQUAL(APE::Item::Binary, items["COVER ART (FRONT)"].type());
+      CPPUNIT_ASSERT_EQUAL(picture, items["COVER ART (FRONT)"].binaryData());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestAPETag);
@@ -0,0 +1,334 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+#include <tbudgetstream.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
+#include <tag.h>
+#include <mp4file.h>
+#include <mpegfile.h>
+#include <id3v1tag.h>
+#include <id3v2tag.h>
+#include <id3v2framefactory.h>
+#include <vorbisfile.h>
+#include <fileref.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  // Cancels a budget when the stream is truncated, as if the deadline passed
+  // in the middle of a save.
+
+  class CancellingStream : public FileStream
+  {
+  public:
+    CancellingStream(const char *fileName, Budget *budget) :
+      FileStream(fileName),
+      budget(budget) {}
+
+    void truncate(long length)
+    {
+      budget->cancel();
+      FileStream::truncate(length);
+    }
+
+  private:
+    Budget *budget;
+  };
+}
+
+class TestBudgetStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestBudgetStream);
+  CPPUNIT_TEST(testUnlimited);
+  CPPUNIT_TEST(testBytesRead);
+  CPPUNIT_TEST(testSeeks);
+  CPPUNIT_TEST(testMP4Atoms);
+  CPPUNIT_TEST(testOggPages);
+  CPPUNIT_TEST(testMPEGFalseSyncs);
+  CPPUNIT_TEST(testCancel);
+  CPPUNIT_TEST(testNoSave);
+  CPPUNIT_TEST(testSaveNotCharged);
+  CPPUNIT_TEST(testSaveAfterCancel);
+  CPPUNIT_TEST(testCancelWhileSaving);
+  CPPUNIT_TEST(testReset);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testUnlimited()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    Budget budget;
+    BudgetStream stream(&fileStream, &budget);
+    MP4::File f(&stream);
+
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(&budget, f.budget());
+    CPPUNIT_ASSERT_EQUAL(String("Test Artist"), f.tag()->artist());
+    CPPUNIT_ASSERT_EQUAL(Budget::NotExhausted, budget.reason());
+    CPPUNIT_ASSERT(budget.bytesRead() > 0);
+    CPPUNIT_ASSERT(budget.seeks() > 0);
+    CPPUNIT_ASSERT(budget.objects() > 0);
+
+    InstrumentedStream instrumented(&stream);
+    MP4::File g(&instrumented);
+    CPPUNIT_ASSERT_EQUAL(&budget, g.budget());
+
+    MP4::File plain(TEST_FILE_PATH_C("has-tags.m4a"));
+    CPPUNIT_ASSERT(!plain.budget());
+  }
+
+  void testBytesRead()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    Budget budget;
+    budget.setMaxBytesRead(100);
+    BudgetStream stream(&fileStream, &budget);
+    MP4::File f(&stream);
+
+    CPPUNIT_ASSERT_EQUAL(Budget::BytesRead, budget.reason());
+    CPPUNIT_ASSERT(budget.bytesRead() > 100);
+    CPPUNIT_ASSERT(budget.bytesRead() < 200);
+    CPPUNIT_ASSERT(stream.readBlock(10).isEmpty());
+  }
+
+  void testSeeks()
+  {
+    ByteVector data(1000, 'x');
+    ByteVectorStream memory(data);
+    Budget budget;
+    budget.setMaxSeeks(2);
+    BudgetStream stream(&memory, &budget);
+
+    stream.seek(10);
+    stream.seek(20);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("xx"), stream.readBlock(2));
+    stream.seek(30);
+    CPPUNIT_ASSERT_EQUAL(Budget::Seeks, budget.reason());
+    CPPUNIT_ASSERT(stream.readBlock(2).isEmpty());
+  }
+
+  void testMP4Atoms()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    Budget budget;
+    budget.setMaxObjects(3);
+    BudgetStream stream(&fileStream, &budget);
+    MP4::File f(&stream);
+
+    CPPUNIT_ASSERT_EQUAL(Budget::Objects, budget.reason());
+    CPPUNIT_ASSERT_EQUAL(3ULL, budget.objects());
+    CPPUNIT_ASSERT_EQUAL(String(), f.tag() ? f.tag()->artist() : String());
+  }
+
+  void testOggPages()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("test.ogg"), true);
+    Budget budget;
+    budget.setMaxObjects(1);
+    BudgetStream stream(&fileStream, &budget);
+    Ogg::Vorbis::File f(&stream);
+
+    // The comment header is in the second page.
+
+    CPPUNIT_ASSERT_EQUAL(Budget::Objects, budget.reason());
+    CPPUNIT_ASSERT(!f.isValid());
+  }
+
+  void testMPEGFalseSyncs()
+  {
+    // Frame syncs every 4 bytes, none of which is followed by another frame.
+
+    ByteVector data;
+    for(int i = 0; i < 64 * 1024; ++i)
+      data.append(ByteVector("\xFF\xFB\x90\x00", 4));
+
+    {
+      ByteVectorStream memory(data);
+      MPEG::File f(&memory, ID3v2::FrameFactory::instance());
+      CPPUNIT_ASSERT_EQUAL(-1L, f.firstFrameOffset());
+    }
+    {
+      ByteVectorStream memory(data);
+      Budget budget;
+      budget.setMaxObjects(1000);
+      BudgetStream stream(&memory, &budget);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance());
+
+      CPPUNIT_ASSERT_EQUAL(Budget::Objects, budget.reason());
+      CPPUNIT_ASSERT_EQUAL(1000ULL, budget.objects());
+      CPPUNIT_ASSERT_EQUAL(-1L, f.firstFrameOffset());
+    }
+  }
+
+  void testCancel()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    Budget budget;
+    budget.cancel();
+    BudgetStream stream(&fileStream, &budget);
+    MP4::File f(&stream);
+
+    CPPUNIT_ASSERT(!f.isValid());
+    CPPUNIT_ASSERT_EQUAL(Budget::Cancelled, budget.reason());
+    CPPUNIT_ASSERT_EQUAL(0ULL, budget.bytesRead());
+  }
+
+  void testNoSave()
+  {
+    ScopedFileCopy copy("has-tags", ".m4a");
+    {
+      FileStream fileStream(copy.fileName().c_str());
+      Budget budget;
+      budget.setMaxObjects(3);
+      BudgetStream stream(&fileStream, &budget);
+      MP4::File f(&stream);
+
+      CPPUNIT_ASSERT(stream.readOnly());
+      CPPUNIT_ASSERT(f.readOnly());
+      f.tag()->setArtist("Partial");
+      CPPUNIT_ASSERT(!f.save());
+    }
+    {
+      MP4::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("Test Artist"), f.tag()->artist());
+    }
+  }
+
+  void testSaveNotCharged()
+  {
+    // A budget which is nearly used up by parsing does not cut the save short.
+
+    const char *files[][2] = {
+      { "has-tags", ".m4a" },
+      { "empty",    ".ogg" }
+    };
+
+    for(size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+      ScopedFileCopy copy(files[i][0], files[i][1]);
+      {
+        FileStream fileStream(copy.fileName().c_str());
+        Budget budget;
+        BudgetStream stream(&fileStream, &budget);
+        FileRef f(&stream);
+        CPPUNIT_ASSERT(!f.isNull());
+
+        const unsigned long long bytesRead = budget.bytesRead();
+        budget.setMaxBytesRead(bytesRead + 1);
+        budget.setMaxSeeks(budget.seeks() + 1);
+
+        f.tag()->setTitle(String(std::string(5000, 'x')));
+        CPPUNIT_ASSERT(f.save());
+        CPPUNIT_ASSERT_EQUAL(Budget::NotExhausted, budget.reason());
+        CPPUNIT_ASSERT_EQUAL(bytesRead, budget.bytesRead());
+      }
+      {
+        FileRef f(copy.fileName().c_str());
+        CPPUNIT_ASSERT(f.file()->isValid());
+        CPPUNIT_ASSERT_EQUAL(String(std::string(5000, 'x')), f.tag()->title());
+      }
+    }
+  }
+
+  void testSaveAfterCancel()
+  {
+    // Only a budget exhausted while parsing makes the file read only.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      FileStream fileStream(copy.fileName().c_str());
+      Budget budget;
+      BudgetStream stream(&fileStream, &budget);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance());
+      CPPUNIT_ASSERT(f.isValid());
+
+      budget.cancel();
+      CPPUNIT_ASSERT(!stream.readOnly());
+      f.tag()->setTitle("Saved");
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("Saved"), f.tag()->title());
+    }
+  }
+
+  void testCancelWhileSaving()
+  {
+    // Stripping the ID3v1 tag truncates the file and cancels the budget.
+    // strip() then checks readOnly() again before removing the ID3v2 tag.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      MPEG::File f(copy.fileName().c_str());
+      f.ID3v1Tag(true)->setTitle("ID3v1");
+      f.ID3v2Tag(true)->setTitle("ID3v2");
+      CPPUNIT_ASSERT(f.save(MPEG::File::ID3v1 | MPEG::File::ID3v2));
+    }
+    {
+      Budget budget;
+      CancellingStream fileStream(copy.fileName().c_str(), &budget);
+      BudgetStream stream(&fileStream, &budget);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance());
+      CPPUNIT_ASSERT(f.hasID3v1Tag());
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+
+      f.ID3v2Tag()->setTitle("");
+      CPPUNIT_ASSERT(f.save(MPEG::File::ID3v2, true));
+      CPPUNIT_ASSERT(budget.isExhausted());
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(!f.hasID3v1Tag());
+      CPPUNIT_ASSERT(!f.hasID3v2Tag());
+    }
+  }
+
+  void testReset()
+  {
+    ByteVector data(1000, 'x');
+    ByteVectorStream memory(data);
+    Budget budget;
+    budget.setMaxBytesRead(10);
+    BudgetStream stream(&memory, &budget);
+
+    stream.readBlock(20);
+    CPPUNIT_ASSERT(budget.isExhausted());
+    budget.reset();
+    CPPUNIT_ASSERT(!budget.isExhausted());
+    CPPUNIT_ASSERT_EQUAL(0ULL, budget.bytesRead());
+    CPPUNIT_ASSERT_EQUAL(10ULL, budget.maxBytesRead());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(5, 'x'), stream.readBlock(5));
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBudgetStream);
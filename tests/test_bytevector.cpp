@@ -52,6 +52,7 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testAppend1);
   CPPUNIT_TEST(testAppend2);
   CPPUNIT_TEST(testBase64);
+  CPPUNIT_TEST(testRawData);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -594,6 +595,46 @@ public:
 
   }
 
+  void testRawData()
+  {
+    char data[] = "abcdefabc";
+    const ByteVector v = ByteVector::fromRawData(data, 9);
+    const ByteVector m = v.mid(3, 3);
+
+    // Reading refers to the memory.
+
+    CPPUNIT_ASSERT(v.data() == data);
+    CPPUNIT_ASSERT(m.data() == data + 3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("def"), m);
+    CPPUNIT_ASSERT_EQUAL(6, v.find("abc", 1));
+    CPPUNIT_ASSERT_EQUAL(6, v.rfind("abc"));
+    CPPUNIT_ASSERT_EQUAL('e', m[1]);
+    CPPUNIT_ASSERT(v.data() == data);
+
+    // Writing copies the memory first.
+
+    ByteVector w = v;
+    w[0] = 'x';
+    CPPUNIT_ASSERT(w.data() != data);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("xbcdefabc"), w);
+    CPPUNIT_ASSERT_EQUAL('a', data[0]);
+
+    ByteVector a = m;
+    a.append('g');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("defg"), a);
+    CPPUNIT_ASSERT_EQUAL('a', data[6]);
+
+    // So does iterating, which the iterator types require.
+
+    ByteVector i = v;
+    const ByteVector &c = i;
+    CPPUNIT_ASSERT_EQUAL('a', *c.begin());
+    CPPUNIT_ASSERT(c.data() != data);
+    CPPUNIT_ASSERT(v.data() == data);
+
+    CPPUNIT_ASSERT(ByteVector::fromRawData(data, 0).isEmpty());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVector);
@@ -0,0 +1,170 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <tbytevector.h>
+#include <tbytevectorbuilder.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace std;
+using namespace TagLib;
+
+class TestByteVectorBuilder : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestByteVectorBuilder);
+  CPPUNIT_TEST(testAppend);
+  CPPUNIT_TEST(testSharedPieces);
+  CPPUNIT_TEST(testPlaceholder);
+  CPPUNIT_TEST(testSetAcrossPieces);
+  CPPUNIT_TEST(testSetManyPieces);
+  CPPUNIT_TEST(testNested);
+  CPPUNIT_TEST(testClear);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testAppend()
+  {
+    ByteVectorBuilder builder;
+    CPPUNIT_ASSERT(builder.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), builder.toByteVector());
+
+    builder.append(ByteVector("abc")).append('d').append(ByteVector()).append(ByteVector("ef"));
+    CPPUNIT_ASSERT(!builder.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(6U, builder.size());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), builder.toByteVector());
+    CPPUNIT_ASSERT_EQUAL(1U, builder.blocks().size());
+  }
+
+  void testSharedPieces()
+  {
+    const ByteVector large(4096, 'x');
+
+    ByteVectorBuilder builder(16);
+    builder.append(ByteVector("head"));
+    builder.append(large);
+    builder.append(ByteVector("tail"));
+    CPPUNIT_ASSERT_EQUAL(4104U, builder.size());
+
+    const ByteVectorList blocks = builder.blocks();
+    CPPUNIT_ASSERT_EQUAL(3U, blocks.size());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("head"), blocks[0]);
+    CPPUNIT_ASSERT(blocks[1].data() == large.data());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("tail"), blocks[2]);
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("head") + large + ByteVector("tail"),
+                         builder.toByteVector());
+  }
+
+  void testPlaceholder()
+  {
+    ByteVectorBuilder builder;
+    builder.append(ByteVector("ab"));
+    const unsigned int size = builder.appendPlaceholder(4);
+    builder.append(ByteVector("cd"));
+    const unsigned int value = builder.appendPlaceholder(8);
+    CPPUNIT_ASSERT_EQUAL(2U, size);
+    CPPUNIT_ASSERT_EQUAL(8U, value);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ab") + ByteVector(4, '\0') + ByteVector("cd") + ByteVector(8, '\0'),
+                         builder.toByteVector());
+
+    builder.setUInt(size, builder.size());
+    builder.setLongLong(value, 0x0102030405060708LL, false);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ab") + ByteVector::fromUInt(16) + ByteVector("cd") +
+                         ByteVector::fromLongLong(0x0102030405060708LL, false),
+                         builder.toByteVector());
+  }
+
+  void testSetAcrossPieces()
+  {
+    const ByteVector large(2048, 'x');
+
+    ByteVectorBuilder builder;
+    builder.append(ByteVector("abcd"));
+    builder.append(large);
+    builder.append(ByteVector("efgh"));
+
+    // Overwrites the end of the first piece, all of the shared one and the
+    // start of the last one.
+
+    builder.set(2, ByteVector(2052, 'y'));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ab") + ByteVector(2052, 'y') + ByteVector("gh"),
+                         builder.toByteVector());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(2048, 'x'), large);
+  }
+
+  void testSetManyPieces()
+  {
+    // Each size field is in a buffer between two shared pieces.
+
+    ByteVectorBuilder builder;
+    ByteVector expected;
+    for(unsigned int i = 0; i < 100; ++i) {
+      const ByteVector piece(1024 + i, static_cast<char>('a' + i % 26));
+      const unsigned int offset = builder.appendPlaceholder(4);
+      builder.append(piece);
+      builder.setUInt(offset, i);
+      expected.append(ByteVector::fromUInt(i));
+      expected.append(piece);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(200U, builder.blocks().size());
+    CPPUNIT_ASSERT_EQUAL(expected, builder.toByteVector());
+  }
+
+  void testNested()
+  {
+    // An MP4 style atom containing another one and a shared piece.
+
+    const ByteVector picture(1500, 'p');
+
+    ByteVectorBuilder builder;
+    const unsigned int outer = builder.appendPlaceholder(4);
+    builder.append(ByteVector("covr"));
+    const unsigned int inner = builder.appendPlaceholder(4);
+    builder.append(ByteVector("data"));
+    builder.append(picture);
+    builder.setUInt(inner, builder.size() - inner);
+    builder.setUInt(outer, builder.size() - outer);
+
+    const ByteVector expected = ByteVector::fromUInt(1516) + ByteVector("covr") +
+                                ByteVector::fromUInt(1508) + ByteVector("data") + picture;
+    CPPUNIT_ASSERT_EQUAL(expected, builder.toByteVector());
+  }
+
+  void testClear()
+  {
+    ByteVectorBuilder builder;
+    builder.append(ByteVector(1024, 'a'));
+    builder.append(ByteVector("b"));
+    builder.clear();
+    CPPUNIT_ASSERT(builder.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0U, builder.blocks().size());
+
+    builder.append(ByteVector("c"));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("c"), builder.toByteVector());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVectorBuilder);
@@ -24,6 +24,11 @@
  ***************************************************************************/
 
 #include <tfile.h>
+#include <tfilestream.h>
+#include <tbytevectorstream.h>
+#include <tinstrumentedstream.h>
+#include <fileref.h>
+#include <tpropertymap.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -33,6 +38,7 @@ using namespace TagLib;
 class PlainFile : public File {
 public:
   PlainFile(FileName name) : File(name) { }
+  PlainFile(IOStream *stream) : File(stream) { }
   Tag *tag() const { return NULL; }
   AudioProperties *audioProperties() const { return NULL; }
   bool save(){ return false; }
@@ -46,6 +52,15 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST(testRFindInSmallFile);
   CPPUNIT_TEST(testSeek);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testAudioDataOfPlainFile);
+  CPPUNIT_TEST(testAudioDataRanges);
+  CPPUNIT_TEST(testAudioDataHashOfSameRecording);
+  CPPUNIT_TEST(testAudioDataHashAfterRetag);
+  CPPUNIT_TEST(testAudioDataHashWithLyrics3);
+  CPPUNIT_TEST(testAudioDataHashOfTruncatedFile);
+  CPPUNIT_TEST(testFindWithGrowingBuffer);
+  CPPUNIT_TEST(testScanBufferSize);
+  CPPUNIT_TEST(testCopyBufferSize);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -148,6 +163,219 @@ public:
     }
   }
 
+  void testAudioDataOfPlainFile()
+  {
+    PlainFile f(TEST_FILE_PATH_C("empty.ogg"));
+    CPPUNIT_ASSERT(f.audioDataRanges().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0ULL, f.audioDataHash());
+
+    FileRef module(TEST_FILE_PATH_C("test.xm"));
+    CPPUNIT_ASSERT(module.file()->audioDataRanges().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0ULL, module.file()->audioDataHash());
+  }
+
+  void testAudioDataRanges()
+  {
+    {
+      FileRef f(TEST_FILE_PATH_C("silence-44-s.flac"));
+      const File::RangeList ranges = f.file()->audioDataRanges();
+      CPPUNIT_ASSERT_EQUAL(1U, ranges.size());
+      CPPUNIT_ASSERT_EQUAL(4186L, ranges.front().offset);
+      CPPUNIT_ASSERT_EQUAL(46718L, ranges.front().length);
+    }
+    {
+      // The header packets end with the second page, the third one holds
+      // the audio.
+
+      FileRef f(TEST_FILE_PATH_C("empty.ogg"));
+      const File::RangeList ranges = f.file()->audioDataRanges();
+      CPPUNIT_ASSERT_EQUAL(1U, ranges.size());
+      CPPUNIT_ASSERT_EQUAL(4167L, ranges.front().offset);
+      CPPUNIT_ASSERT_EQUAL(161L, ranges.front().length);
+    }
+    {
+      FileRef f(TEST_FILE_PATH_C("empty.wav"));
+      const File::RangeList ranges = f.file()->audioDataRanges();
+      CPPUNIT_ASSERT_EQUAL(1U, ranges.size());
+      f.file()->seek(ranges.front().offset - 8);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("data"), f.file()->readBlock(4));
+    }
+    {
+      FileRef f(TEST_FILE_PATH_C("test.mod"));
+      CPPUNIT_ASSERT(f.file()->audioDataRanges().isEmpty());
+    }
+  }
+
+  void testAudioDataHashOfSameRecording()
+  {
+    // ape-id3v2.mp3 is xing.mp3 with an ID3v2 and an APE tag.
+
+    FileRef tagged(TEST_FILE_PATH_C("ape-id3v2.mp3"));
+    FileRef untagged(TEST_FILE_PATH_C("xing.mp3"));
+    CPPUNIT_ASSERT_EQUAL(0x84C62CCEC163C8DBULL, untagged.file()->audioDataHash());
+    CPPUNIT_ASSERT_EQUAL(0x84C62CCEC163C8DBULL, tagged.file()->audioDataHash());
+  }
+
+  void testAudioDataHashAfterRetag()
+  {
+    const char *files[][2] = {
+      { "xing",            ".mp3"  },
+      { "ape-id3v2",       ".mp3"  },
+      { "silence-44-s",    ".flac" },
+      { "has-tags",        ".m4a"  },
+      { "empty",           ".ogg"  },
+      { "empty_flac",      ".oga"  },
+      { "correctness_gain_silent_output", ".opus" },
+      { "empty",           ".spx"  },
+      { "empty",           ".wav"  },
+      { "empty",           ".aiff" },
+      { "mac-399",         ".ape"  },
+      { "click",           ".mpc"  },
+      { "tagged",          ".wv"   },
+      { "empty",           ".tta"  },
+      { "silence-1",       ".wma"  },
+      { "empty10ms",       ".dsf"  },
+      { "empty10ms",       ".dff"  }
+    };
+
+    for(size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+      ScopedFileCopy copy(files[i][0], files[i][1]);
+
+      unsigned long long hash;
+      {
+        FileRef f(copy.fileName().c_str());
+        CPPUNIT_ASSERT(!f.isNull());
+        CPPUNIT_ASSERT(!f.file()->audioDataRanges().isEmpty());
+
+        hash = f.file()->audioDataHash();
+        CPPUNIT_ASSERT_EQUAL(hash, f.file()->audioDataHash(100));
+
+        f.tag()->setTitle(String(std::string(5000, 'x')));
+        f.tag()->setArtist("artist");
+        f.save();
+
+        CPPUNIT_ASSERT_EQUAL(hash, f.file()->audioDataHash());
+      }
+      {
+        FileRef f(copy.fileName().c_str());
+        CPPUNIT_ASSERT_EQUAL(String(std::string(5000, 'x')), f.tag()->title());
+        CPPUNIT_ASSERT_EQUAL(hash, f.file()->audioDataHash());
+      }
+    }
+  }
+
+  void testAudioDataHashWithLyrics3()
+  {
+    // A Lyrics3v2 tag between the audio data and an ID3v1 tag is not part of
+    // the audio data.
+
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      FileStream stream(copy.fileName().c_str());
+      stream.seek(0, IOStream::End);
+      stream.writeBlock("LYRICSBEGINLYR00005hello000024LYRICS200");
+      stream.writeBlock(ByteVector("TAG") + ByteVector(125, '\0'));
+    }
+
+    FileRef f(copy.fileName().c_str());
+    CPPUNIT_ASSERT_EQUAL(0x84C62CCEC163C8DBULL, f.file()->audioDataHash());
+  }
+
+  void testAudioDataHashOfTruncatedFile()
+  {
+    ScopedFileCopy copy("empty10ms", ".dsf");
+
+    FileStream stream(copy.fileName().c_str());
+    FileRef f(&stream);
+    CPPUNIT_ASSERT(f.file()->audioDataHash() != 0);
+
+    stream.truncate(stream.length() - 100);
+    CPPUNIT_ASSERT_EQUAL(0ULL, f.file()->audioDataHash());
+  }
+
+  void testFindWithGrowingBuffer()
+  {
+    // Matches across the boundaries of the growing blocks, which start at
+    // 1024, 3072 and 7168, are found.
+
+    const ByteVector pattern("PATTERN");
+    const long offsets[] = { 10, 1020, 1023, 3070, 7166, 150000, 299993 };
+    for(size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+      ByteVector data(300000, 'x');
+      std::copy(pattern.begin(), pattern.end(), data.begin() + offsets[i]);
+
+      ByteVectorStream stream(data);
+      InstrumentedStream instrumented(&stream);
+      PlainFile file(&instrumented);
+      CPPUNIT_ASSERT_EQUAL(offsets[i], file.find(pattern));
+      CPPUNIT_ASSERT_EQUAL(-1L, file.find(pattern, offsets[i] + 1));
+      CPPUNIT_ASSERT_EQUAL(offsets[i], file.rfind(pattern));
+    }
+
+    ByteVector data(300000, 'x');
+    data.append("PATTERN");
+    ByteVectorStream stream(data);
+    InstrumentedStream instrumented(&stream);
+    PlainFile file(&instrumented);
+    CPPUNIT_ASSERT_EQUAL(300000L, file.find("PATTERN"));
+    CPPUNIT_ASSERT(instrumented.statistics().total().readCalls <= 12);
+  }
+
+  void testScanBufferSize()
+  {
+    ByteVector data(5000, 'x');
+    data.append("PATTERN");
+
+    ByteVectorStream stream(data);
+    PlainFile file(&stream);
+    CPPUNIT_ASSERT_EQUAL(1024U, file.scanBufferSize());
+
+    file.setScanBufferSize(4);
+    CPPUNIT_ASSERT_EQUAL(4U, file.scanBufferSize());
+    CPPUNIT_ASSERT_EQUAL(-1L, file.find("PATTERN"));
+
+    file.setScanBufferSize(16);
+    CPPUNIT_ASSERT_EQUAL(5000L, file.find("PATTERN"));
+
+    file.setScanBufferSize(0);
+    CPPUNIT_ASSERT_EQUAL(1024U, file.scanBufferSize());
+
+    File::setDefaultScanBufferSize(100000);
+    {
+      PlainFile other(&stream);
+      CPPUNIT_ASSERT_EQUAL(100000U, other.scanBufferSize());
+      CPPUNIT_ASSERT_EQUAL(5000L, other.find("PATTERN"));
+    }
+    File::setDefaultScanBufferSize(0);
+    CPPUNIT_ASSERT_EQUAL(1024U, File::defaultScanBufferSize());
+  }
+
+  void testCopyBufferSize()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+
+    ByteVector expected;
+    {
+      FileStream file(copy.fileName().c_str());
+      expected = file.readBlock(file.length());
+    }
+
+    FileStream file(copy.fileName().c_str());
+    CPPUNIT_ASSERT_EQUAL(64U * 1024, file.copyBufferSize());
+    file.setCopyBufferSize(100);
+    CPPUNIT_ASSERT_EQUAL(100U, file.copyBufferSize());
+
+    file.insert(ByteVector(250, 'a'), 10, 20);
+    expected = expected.mid(0, 10) + ByteVector(250, 'a') + expected.mid(30);
+    file.removeBlock(500, 333);
+    expected = expected.mid(0, 500) + expected.mid(833);
+    file.insert(ByteVector(3, 'b'), 1000, 7);
+    expected = expected.mid(0, 1000) + ByteVector(3, 'b') + expected.mid(1007);
+
+    file.seek(0);
+    CPPUNIT_ASSERT_EQUAL(expected, file.readBlock(file.length() + 1));
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
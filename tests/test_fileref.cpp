@@ -54,10 +54,16 @@ namespace
   class DummyResolver : public FileRef::FileTypeResolver
   {
   public:
+    DummyResolver() : enabled(false) {}
+
     virtual File *createFile(FileName fileName, bool, AudioProperties::ReadStyle) const
     {
+      if(!enabled)
+        return 0;
       return new Ogg::Vorbis::File(fileName);
     }
+
+    bool enabled;
   };
 }
 
@@ -332,11 +338,17 @@ public:
       CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != NULL);
     }
 
-    DummyResolver resolver;
-    FileRef::addFileTypeResolver(&resolver);
+    // Resolvers cannot be removed again, so this one stays registered for the
+    // tests which run later and only claims files while it is enabled.
+
+    static DummyResolver resolver;
+    static const FileRef::FileTypeResolver *added = FileRef::addFileTypeResolver(&resolver);
+    CPPUNIT_ASSERT(added == &resolver);
 
+    resolver.enabled = true;
     {
       FileRef f(TEST_FILE_PATH_C("xing.mp3"));
+      resolver.enabled = false;
       CPPUNIT_ASSERT(dynamic_cast<Ogg::Vorbis::File *>(f.file()) != NULL);
     }
   }
@@ -33,6 +33,12 @@
 #include <xiphcomment.h>
 #include <id3v1tag.h>
 #include <id3v2tag.h>
+#include <tfilestream.h>
+#include <tbytevectorstream.h>
+#include <fileref.h>
+#include <tinstrumentedstream.h>
+#include <tbudgetstream.h>
+#include <id3v2framefactory.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -64,6 +70,12 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testStripTags);
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
+  CPPUNIT_TEST(testSaveUnchanged);
+  CPPUNIT_TEST(testSkipPadding);
+  CPPUNIT_TEST(testShortDeferredBlock);
+  CPPUNIT_TEST(testDeferredBlockAfterID3v2Save);
+  CPPUNIT_TEST(testAccurateLength);
+  CPPUNIT_TEST(testAccurateLengthWithSeekTable);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -535,6 +547,188 @@ public:
     }
   }
 
+  void testSaveUnchanged()
+  {
+    checkSaveUnchanged("silence-44-s", ".flac");
+  }
+
+  void testShortDeferredBlock()
+  {
+    // The cue sheet at offset 331 is only read by save(), after the file has
+    // been truncated in the middle of it.  The save fails without writing.
+
+    FileStream file(TEST_FILE_PATH_C("silence-44-s.flac"), true);
+    ByteVectorStream stream(file.readBlock(file.length()));
+
+    FLAC::File f(&stream, ID3v2::FrameFactory::instance());
+    CPPUNIT_ASSERT(f.isValid());
+
+    stream.truncate(400);
+    const ByteVector data = *stream.data();
+
+    f.xiphComment()->setTitle("Title");
+    CPPUNIT_ASSERT(!f.save());
+    CPPUNIT_ASSERT_EQUAL(data, *stream.data());
+  }
+
+  // Returns the contents of the first metadata block of type \a type.
+
+  static ByteVector metadataBlock(const ByteVector &data, int type)
+  {
+    unsigned int offset = data.find("fLaC") + 4;
+    while(offset + 4 <= data.size()) {
+      const unsigned int length = data.toUInt(offset + 1, 3U);
+      if((data[offset] & 0x7F) == type)
+        return data.mid(offset + 4, length);
+      if(data[offset] & 0x80)
+        break;
+      offset += 4 + length;
+    }
+    return ByteVector();
+  }
+
+  void testDeferredBlockAfterID3v2Save()
+  {
+    // Once the comment has been normalised by a save, saving an ID3v2 tag
+    // moves the metadata without reading the seek table and the cue sheet.
+    // Saving the comment then writes them back from their new offsets.
+
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    {
+      FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.save());
+    }
+
+    ByteVector data;
+    {
+      FileStream stream(copy.fileName().c_str(), true);
+      data = stream.readBlock(stream.length());
+    }
+    const ByteVector seekTable = metadataBlock(data, FLAC::MetadataBlock::SeekTable);
+    const ByteVector cueSheet  = metadataBlock(data, FLAC::MetadataBlock::CueSheet);
+    CPPUNIT_ASSERT(!seekTable.isEmpty());
+    CPPUNIT_ASSERT(!cueSheet.isEmpty());
+
+    {
+      FLAC::File f(copy.fileName().c_str());
+      f.ID3v2Tag(true)->setTitle(String(ByteVector(4096, 'x')));
+      CPPUNIT_ASSERT(f.save());
+      f.xiphComment()->setTitle("Xiph title");
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      FileStream stream(copy.fileName().c_str(), true);
+      data = stream.readBlock(stream.length());
+    }
+    CPPUNIT_ASSERT_EQUAL(seekTable, metadataBlock(data, FLAC::MetadataBlock::SeekTable));
+    CPPUNIT_ASSERT_EQUAL(cueSheet, metadataBlock(data, FLAC::MetadataBlock::CueSheet));
+
+    FLAC::File f(copy.fileName().c_str());
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(String(ByteVector(4096, 'x')), f.ID3v2Tag()->title());
+    CPPUNIT_ASSERT_EQUAL(String("Xiph title"), f.xiphComment()->title());
+  }
+
+  void testSkipPadding()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    string newname = copy.fileName();
+
+    // Replace the padding at the end of the metadata with 1 MiB of padding.
+
+    ByteVector data;
+    {
+      FileStream stream(newname.c_str());
+      data = stream.readBlock(stream.length());
+      CPPUNIT_ASSERT_EQUAL(ByteVector("\x81\x00\x0b\xf4", 4), data.mid(1122, 4));
+
+      const ByteVector padding = ByteVector("\x81\x10\x00\x00", 4) + ByteVector(1024 * 1024, '\0');
+      stream.insert(padding, 1122, 4 + 3060);
+    }
+
+    const ByteVector seekTable = data.mid(46, 108);
+    const ByteVector cueSheet = data.mid(4 + 38 + 112 + 173 + 4, 588);
+    {
+      FileStream fileStream(newname.c_str());
+      InstrumentedStream stream(&fileStream);
+      FLAC::File f(&stream, ID3v2::FrameFactory::instance());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(3685, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(1U, f.pictureList().size());
+      CPPUNIT_ASSERT(stream.statistics().total().bytesRead < 16 * 1024);
+
+      f.tag()->setTitle("Title");
+      f.save();
+    }
+    {
+      FileStream stream(newname.c_str(), true);
+      const ByteVector saved = stream.readBlock(stream.length());
+      CPPUNIT_ASSERT(saved.size() < 64 * 1024);
+      CPPUNIT_ASSERT_EQUAL(46, saved.find(seekTable));
+      CPPUNIT_ASSERT(saved.find(cueSheet) > 0);
+
+      FLAC::File f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+    }
+  }
+
+  void testAccurateLength()
+  {
+    ScopedFileCopy copy("sinewave", ".flac");
+    checkAccurateLength(copy.fileName());
+  }
+
+  void testAccurateLengthWithSeekTable()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    checkAccurateLength(copy.fileName());
+
+    // The scan stops once the budget is exhausted.
+
+    FileStream fileStream(copy.fileName().c_str(), true);
+    Budget budget;
+    budget.cancel();
+    BudgetStream stream(&fileStream, &budget);
+    FLAC::File f(&stream, ID3v2::FrameFactory::instance(), true, AudioProperties::Accurate);
+    CPPUNIT_ASSERT(!f.audioProperties() || f.audioProperties()->sampleFrames() == 0);
+  }
+
+private:
+
+  // Clears the number of samples in the stream info of the file, as streams
+  // written on the fly do, and checks that it is found in the frames.
+
+  void checkAccurateLength(const string &fileName)
+  {
+    unsigned long long sampleFrames;
+    int length;
+    {
+      FLAC::File f(fileName.c_str());
+      sampleFrames = f.audioProperties()->sampleFrames();
+      length = f.audioProperties()->lengthInMilliseconds();
+      CPPUNIT_ASSERT(sampleFrames > 0);
+    }
+    {
+      FileStream stream(fileName.c_str());
+      stream.seek(21);
+      const char flags = stream.readBlock(1)[0];
+      stream.seek(21);
+      stream.writeBlock(ByteVector(1, static_cast<char>(flags & 0xF0)) + ByteVector(4, '\0'));
+    }
+    {
+      FLAC::File f(fileName.c_str());
+      CPPUNIT_ASSERT_EQUAL(0ULL, f.audioProperties()->sampleFrames());
+      CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->bitrate());
+    }
+    {
+      FLAC::File f(fileName.c_str(), true, AudioProperties::Accurate);
+      CPPUNIT_ASSERT_EQUAL(sampleFrames, f.audioProperties()->sampleFrames());
+      CPPUNIT_ASSERT_EQUAL(length, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT(f.audioProperties()->bitrate() > 0);
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
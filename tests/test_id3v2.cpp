@@ -120,6 +120,7 @@ class TestID3v2 : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyFrame);
   CPPUNIT_TEST(testDuplicateTags);
   CPPUNIT_TEST(testParseTOCFrameWithManyChildren);
+  CPPUNIT_TEST(testModified);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -1269,6 +1270,34 @@ public:
     CPPUNIT_ASSERT(f.isValid());
   }
 
+  void testModified()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    MPEG::File f(copy.fileName().c_str());
+    ID3v2::Tag *tag = f.ID3v2Tag(true);
+    CPPUNIT_ASSERT(!tag->isModified());
+
+    tag->setTitle("Title");
+    CPPUNIT_ASSERT(tag->isModified());
+    CPPUNIT_ASSERT(f.tag()->isModified());
+
+    f.save();
+    CPPUNIT_ASSERT(!tag->isModified());
+
+    tag->setTitle("Title");
+    tag->setProperties(tag->properties());
+    CPPUNIT_ASSERT(!tag->isModified());
+
+    ID3v2::Frame *frame = tag->frameList("TIT2").front();
+    frame->setText("Another title");
+    CPPUNIT_ASSERT(frame->isModified());
+    CPPUNIT_ASSERT(tag->isModified());
+
+    tag->setModified(false);
+    CPPUNIT_ASSERT(!frame->isModified());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestID3v2);
@@ -0,0 +1,194 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <incrementalparser.h>
+#include <tfilestream.h>
+#include <tpropertymap.h>
+#include <fileref.h>
+#include <tag.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestIncrementalParser : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestIncrementalParser);
+  CPPUNIT_TEST(testMPEG);
+  CPPUNIT_TEST(testFLAC);
+  CPPUNIT_TEST(testOgg);
+  CPPUNIT_TEST(testMP4);
+  CPPUNIT_TEST(testSmallBlocks);
+  CPPUNIT_TEST(testFeedInAdvance);
+  CPPUNIT_TEST(testOverlappingFeeds);
+  CPPUNIT_TEST(testUnsupported);
+  CPPUNIT_TEST(testName);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testMPEG()
+  {
+    checkParse("ape-id3v2.mp3");
+  }
+
+  void testFLAC()
+  {
+    checkParse("sinewave.flac");
+  }
+
+  void testOgg()
+  {
+    checkParse("test.ogg");
+  }
+
+  void testMP4()
+  {
+    checkParse("has-tags.m4a");
+  }
+
+  void testSmallBlocks()
+  {
+    // With small blocks the parser needs more rounds, but still only the
+    // metadata of the file.
+
+    const ByteVector data = readFile("sinewave.flac");
+    IncrementalParser parser(data.size(), true, AudioProperties::Average, 512);
+    run(parser, data);
+
+    CPPUNIT_ASSERT(parser.rounds() > 2);
+    CPPUNIT_ASSERT(parser.bytesFed() < static_cast<long>(data.size()) / 4);
+    CPPUNIT_ASSERT_EQUAL(FileRef(TEST_FILE_PATH_C("sinewave.flac")).file()->properties(),
+                         parser.fileRef().file()->properties());
+  }
+
+  void testFeedInAdvance()
+  {
+    const ByteVector data = readFile("has-tags.m4a");
+    IncrementalParser parser(data.size());
+    CPPUNIT_ASSERT(!parser.isComplete());
+    CPPUNIT_ASSERT_EQUAL(0L, parser.neededRange().offset);
+
+    // The end first, which does not unblock the parser, then the beginning.
+
+    CPPUNIT_ASSERT(!parser.feed(100, data.mid(100)));
+    CPPUNIT_ASSERT_EQUAL(1U, parser.rounds());
+    CPPUNIT_ASSERT(parser.feed(0, data.mid(0, 200)));
+    CPPUNIT_ASSERT_EQUAL(2U, parser.rounds());
+    CPPUNIT_ASSERT_EQUAL(static_cast<long>(data.size()), parser.bytesFed());
+    CPPUNIT_ASSERT_EQUAL(String("Test Artist"), parser.fileRef().tag()->artist());
+  }
+
+  void testOverlappingFeeds()
+  {
+    // Overlapping pieces fed from the end of the file give the same tags, and
+    // the bytes received twice are only counted once.
+
+    const ByteVector data = readFile("silence-44-s.flac");
+
+    IncrementalParser parser(data.size());
+    for(long offset = (data.size() / 700) * 700; offset >= 0; offset -= 700)
+      parser.feed(offset, data.mid(offset, 1000));
+
+    CPPUNIT_ASSERT(parser.isComplete());
+    CPPUNIT_ASSERT_EQUAL(static_cast<long>(data.size()), parser.bytesFed());
+    CPPUNIT_ASSERT_EQUAL(FileRef(TEST_FILE_PATH_C("silence-44-s.flac")).file()->properties(),
+                         parser.fileRef().file()->properties());
+  }
+
+  void testUnsupported()
+  {
+    const ByteVector data(1000, 'x');
+    IncrementalParser parser(data.size());
+    run(parser, data);
+    CPPUNIT_ASSERT(parser.fileRef().isNull());
+
+    IncrementalParser empty(0);
+    CPPUNIT_ASSERT(empty.isComplete());
+    CPPUNIT_ASSERT(empty.fileRef().isNull());
+  }
+
+  void testName()
+  {
+    // Tracker modules are only detected by their extension.
+
+    const ByteVector data = readFile("test.xm");
+    {
+      IncrementalParser parser(data.size());
+      run(parser, data);
+      CPPUNIT_ASSERT(parser.fileRef().isNull());
+    }
+    {
+      IncrementalParser parser(data.size(), "test.xm");
+      run(parser, data);
+      CPPUNIT_ASSERT(!parser.fileRef().isNull());
+      CPPUNIT_ASSERT_EQUAL(String("title of song"), parser.fileRef().tag()->title());
+    }
+  }
+
+private:
+
+  static ByteVector readFile(const string &filename)
+  {
+    FileStream file(TEST_FILE_PATH_C(filename), true);
+    return file.readBlock(file.length());
+  }
+
+  // Feeds the parser with the ranges it asks for until it is complete.
+
+  static void run(IncrementalParser &parser, const ByteVector &data)
+  {
+    for(int i = 0; i < 100 && !parser.isComplete(); ++i) {
+      const File::Range r = parser.neededRange();
+      CPPUNIT_ASSERT(r.length > 0);
+      CPPUNIT_ASSERT(r.offset + r.length <= static_cast<long>(data.size()));
+      parser.feed(r.offset, data.mid(r.offset, r.length));
+    }
+    CPPUNIT_ASSERT(parser.isComplete());
+    CPPUNIT_ASSERT_EQUAL(File::Range().length, parser.neededRange().length);
+  }
+
+  void checkParse(const string &filename)
+  {
+    const ByteVector data = readFile(filename);
+
+    IncrementalParser parser(data.size());
+    run(parser, data);
+
+    const FileRef expected(TEST_FILE_PATH_C(filename));
+    const FileRef actual = parser.fileRef();
+    CPPUNIT_ASSERT(!actual.isNull());
+    CPPUNIT_ASSERT(actual.file()->isValid());
+    CPPUNIT_ASSERT_EQUAL(expected.file()->properties(), actual.file()->properties());
+    CPPUNIT_ASSERT_EQUAL(expected.audioProperties()->lengthInMilliseconds(),
+                         actual.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(expected.audioProperties()->bitrate(),
+                         actual.audioProperties()->bitrate());
+    CPPUNIT_ASSERT(parser.rounds() <= 4);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestIncrementalParser);
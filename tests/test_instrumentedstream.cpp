@@ -0,0 +1,159 @@
+/***************************************************************************
+    copyright           : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <tinstrumentedstream.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <tbudgetstream.h>
+#include <fileref.h>
+#include <mpegfile.h>
+#include <id3v2framefactory.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestInstrumentedStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestInstrumentedStream);
+  CPPUNIT_TEST(testForwarding);
+  CPPUNIT_TEST(testShiftedBytes);
+  CPPUNIT_TEST(testPhaseScope);
+  CPPUNIT_TEST(testDetection);
+  CPPUNIT_TEST(testParseAndSave);
+  CPPUNIT_TEST(testWrappedByBudgetStream);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testForwarding()
+  {
+    ByteVectorStream data(ByteVector("abcdefgh"));
+    InstrumentedStream stream(&data);
+
+    stream.seek(2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cde"), stream.readBlock(3));
+    stream.writeBlock("XY");
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdeXYh"), *data.data());
+
+    const IOStatistics::Counters &c = stream.statistics().counters(IOStatistics::Other);
+    CPPUNIT_ASSERT_EQUAL(1ULL, c.seekCalls);
+    CPPUNIT_ASSERT_EQUAL(1ULL, c.readCalls);
+    CPPUNIT_ASSERT_EQUAL(3ULL, c.bytesRead);
+    CPPUNIT_ASSERT_EQUAL(1ULL, c.writeCalls);
+    CPPUNIT_ASSERT_EQUAL(2ULL, c.bytesWritten);
+    CPPUNIT_ASSERT_EQUAL(0ULL, c.bytesShifted);
+
+    stream.resetStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ULL, stream.statistics().total().bytesRead);
+  }
+
+  void testShiftedBytes()
+  {
+    ByteVectorStream data(ByteVector("abcdefgh"));
+    InstrumentedStream stream(&data);
+
+    stream.insert("XY", 2, 2);
+    CPPUNIT_ASSERT_EQUAL(0ULL, stream.statistics().total().bytesShifted);
+    stream.insert("XYZ", 2, 0);
+    CPPUNIT_ASSERT_EQUAL(6ULL, stream.statistics().total().bytesShifted);
+    stream.removeBlock(0, 1);
+    CPPUNIT_ASSERT_EQUAL(16ULL, stream.statistics().total().bytesShifted);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("bXYZXYefgh"), *data.data());
+  }
+
+  void testPhaseScope()
+  {
+    ByteVectorStream data(ByteVector("abcdefgh"));
+    InstrumentedStream stream(&data);
+    {
+      InstrumentedStream::PhaseScope scope(&stream, IOStatistics::Saving);
+      CPPUNIT_ASSERT_EQUAL(IOStatistics::Saving, stream.phase());
+      stream.readBlock(4);
+    }
+    CPPUNIT_ASSERT_EQUAL(IOStatistics::Other, stream.phase());
+    CPPUNIT_ASSERT_EQUAL(4ULL, stream.statistics().counters(IOStatistics::Saving).bytesRead);
+    CPPUNIT_ASSERT_EQUAL(0ULL, stream.statistics().counters(IOStatistics::Other).bytesRead);
+  }
+
+  void testDetection()
+  {
+    FileStream file(TEST_FILE_PATH_C("xing.mp3"), true);
+    ByteVectorStream data(file.readBlock(file.length()));
+    InstrumentedStream stream(&data);
+
+    FileRef f(&stream);
+    CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()));
+
+    const IOStatistics s = f.ioStatistics();
+    CPPUNIT_ASSERT(s.counters(IOStatistics::Detection).readCalls > 0);
+    CPPUNIT_ASSERT(s.counters(IOStatistics::TagParsing).bytesRead > 0);
+    CPPUNIT_ASSERT(s.counters(IOStatistics::PropertiesParsing).bytesRead > 0);
+    CPPUNIT_ASSERT_EQUAL(0ULL, s.total().writeCalls);
+  }
+
+  void testParseAndSave()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    FileStream file(copy.fileName().c_str());
+    InstrumentedStream stream(&file);
+
+    MPEG::File f(&stream, ID3v2::FrameFactory::instance());
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(0ULL, f.ioStatistics().counters(IOStatistics::Detection).readCalls);
+    CPPUNIT_ASSERT(f.ioStatistics().counters(IOStatistics::TagParsing).bytesRead > 0);
+    CPPUNIT_ASSERT(f.ioStatistics().counters(IOStatistics::PropertiesParsing).bytesRead > 0);
+
+    f.tag()->setTitle("Title");
+    CPPUNIT_ASSERT(f.save());
+
+    const IOStatistics::Counters c = f.ioStatistics().counters(IOStatistics::Saving);
+    CPPUNIT_ASSERT(c.writeCalls > 0);
+    CPPUNIT_ASSERT(c.bytesWritten > 0);
+    CPPUNIT_ASSERT(c.bytesShifted > 0);
+    CPPUNIT_ASSERT_EQUAL(0ULL, f.ioStatistics().counters(IOStatistics::Other).writeCalls);
+  }
+
+  void testWrappedByBudgetStream()
+  {
+    FileStream file(TEST_FILE_PATH_C("xing.mp3"), true);
+    InstrumentedStream stream(&file);
+    Budget budget;
+    BudgetStream limited(&stream, &budget);
+
+    MPEG::File f(&limited, ID3v2::FrameFactory::instance());
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT(f.budget() == &budget);
+
+    const IOStatistics s = f.ioStatistics();
+    CPPUNIT_ASSERT(s.counters(IOStatistics::TagParsing).bytesRead > 0);
+    CPPUNIT_ASSERT(s.counters(IOStatistics::PropertiesParsing).bytesRead > 0);
+    CPPUNIT_ASSERT_EQUAL(0ULL, s.counters(IOStatistics::Other).bytesRead);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestInstrumentedStream);
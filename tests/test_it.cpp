@@ -26,6 +26,8 @@
 #include <itfile.h>
 #include <tstringlist.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
 #include "utils.h"
 
 using namespace std;
@@ -72,6 +74,7 @@ class TestIT : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestIT);
   CPPUNIT_TEST(testReadTags);
   CPPUNIT_TEST(testWriteTags);
+  CPPUNIT_TEST(testReadCalls);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -94,6 +97,19 @@ public:
     testRead(copy.fileName().c_str(), titleAfter, commentAfter);
   }
 
+  void testReadCalls()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("test.it"));
+    InstrumentedStream stream(&fileStream);
+    IT::File file(&stream);
+    CPPUNIT_ASSERT(file.isValid());
+
+    // One read for the header, one for the orders and offset tables and one
+    // for each sample header.
+    const unsigned long long expected = 2 + file.audioProperties()->sampleCount();
+    CPPUNIT_ASSERT_EQUAL(expected, stream.statistics().total().readCalls);
+  }
+
 private:
   void testRead(FileName fileName, const String &title, const String &comment)
   {
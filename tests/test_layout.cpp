@@ -0,0 +1,171 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+#include <algorithm>
+#include <tlayout.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <apefile.h>
+#include <mp4file.h>
+#include <vorbisfile.h>
+#include <wavpackfile.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  struct TestHeader
+  {
+    static const unsigned int size = 16;
+    typedef Layout::Bytes<0, 2> ID;
+    typedef Layout::U8<2>       Byte;
+    typedef Layout::U16L<3>     LittleShort;
+    typedef Layout::S16B<5>     BigShort;
+    typedef Layout::U32L<7>     LittleInt;
+    typedef Layout::U64B<8>     BigLongLong;
+  };
+
+  ByteVector readFile(const string &path)
+  {
+    FileStream stream(path.c_str(), true);
+    return stream.readBlock(stream.length());
+  }
+}
+
+class TestLayout : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestLayout);
+  CPPUNIT_TEST(testDecode);
+  CPPUNIT_TEST(testTooShort);
+  CPPUNIT_TEST(testOffset);
+  CPPUNIT_TEST(testTruncatedAPE);
+  CPPUNIT_TEST(testTruncatedMP4);
+  CPPUNIT_TEST(testTruncatedVorbis);
+  CPPUNIT_TEST(testTruncatedWavPack);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testDecode()
+  {
+    const ByteVector data("ID\x01\x02\x03\xFF\xFE\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C", 16);
+    const Layout::View<TestHeader> header(data);
+    CPPUNIT_ASSERT(header.isValid());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ID"), header.get<TestHeader::ID>());
+    CPPUNIT_ASSERT_EQUAL((unsigned char)0x01, header.get<TestHeader::Byte>());
+    CPPUNIT_ASSERT_EQUAL((unsigned short)0x0302, header.get<TestHeader::LittleShort>());
+    CPPUNIT_ASSERT_EQUAL((short)-2, header.get<TestHeader::BigShort>());
+    CPPUNIT_ASSERT_EQUAL(0x07060504U, header.get<TestHeader::LittleInt>());
+    CPPUNIT_ASSERT_EQUAL(0x05060708090A0B0CULL, header.get<TestHeader::BigLongLong>());
+
+    // The fields agree with the ByteVector accessors.
+    CPPUNIT_ASSERT_EQUAL(data.toUShort(3, false), header.get<TestHeader::LittleShort>());
+    CPPUNIT_ASSERT_EQUAL(data.toShort(5, true), header.get<TestHeader::BigShort>());
+    CPPUNIT_ASSERT_EQUAL(data.toUInt(7, false), header.get<TestHeader::LittleInt>());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long long>(data.toLongLong(8, true)),
+                         header.get<TestHeader::BigLongLong>());
+  }
+
+  void testTooShort()
+  {
+    const ByteVector data(16, 'x');
+    for(unsigned int i = 0; i < 16; ++i)
+      CPPUNIT_ASSERT(!Layout::View<TestHeader>(data.mid(0, i)).isValid());
+    CPPUNIT_ASSERT(!Layout::View<TestHeader>(ByteVector()).isValid());
+    CPPUNIT_ASSERT(Layout::View<TestHeader>(data).isValid());
+  }
+
+  void testOffset()
+  {
+    const ByteVector data = ByteVector("xyz") + ByteVector("ID\x2A", 3) + ByteVector(13, 0);
+    const Layout::View<TestHeader> header(data, 3);
+    CPPUNIT_ASSERT(header.isValid());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ID"), header.get<TestHeader::ID>());
+    CPPUNIT_ASSERT_EQUAL((unsigned char)0x2A, header.get<TestHeader::Byte>());
+
+    CPPUNIT_ASSERT(!Layout::View<TestHeader>(data, 4).isValid());
+    CPPUNIT_ASSERT(!Layout::View<TestHeader>(data, 100).isValid());
+  }
+
+  void testTruncatedAPE()
+  {
+    checkTruncated<APE::File>("mac-396.ape");
+    checkTruncated<APE::File>("mac-399.ape", 1024);
+  }
+
+  void testTruncatedMP4()
+  {
+    checkTruncated<MP4::File>("has-tags.m4a");
+    checkTruncated<MP4::File>("empty_alac.m4a");
+  }
+
+  void testTruncatedVorbis()
+  {
+    checkTruncated<Ogg::Vorbis::File>("empty.ogg");
+  }
+
+  void testTruncatedWavPack()
+  {
+    checkTruncated<WavPack::File>("click.wv");
+  }
+
+private:
+
+  // Opens every prefix of the file up to maxLength bytes, which must neither
+  // crash nor report properties that the complete file does not have.
+
+  template <class T>
+  void checkTruncated(const char *fileName, unsigned int maxLength = 0xFFFFFFFF)
+  {
+    const ByteVector data = readFile(TEST_FILE_PATH_C(fileName));
+
+    int sampleRate = 0;
+    int channels = 0;
+    {
+      ByteVectorStream stream(data);
+      T f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      sampleRate = f.audioProperties()->sampleRate();
+      channels   = f.audioProperties()->channels();
+    }
+
+    const unsigned int length = std::min(data.size(), maxLength);
+    for(unsigned int i = 0; i < length; ++i) {
+      ByteVectorStream stream(data.mid(0, i));
+      T f(&stream);
+      if(f.isValid() && f.audioProperties()) {
+        const int truncatedSampleRate = f.audioProperties()->sampleRate();
+        const int truncatedChannels   = f.audioProperties()->channels();
+        CPPUNIT_ASSERT(truncatedSampleRate == 0 || truncatedSampleRate == sampleRate);
+        CPPUNIT_ASSERT(truncatedChannels == 0 || truncatedChannels == channels);
+      }
+    }
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestLayout);
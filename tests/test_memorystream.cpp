@@ -0,0 +1,136 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <tmemorystream.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <tallocator.h>
+#include <fileref.h>
+#include <tag.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestMemoryStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestMemoryStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testParse);
+  CPPUNIT_TEST(testSharedBlocks);
+  CPPUNIT_TEST(testNoCopy);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    const char data[] = "abcdefgh";
+    MemoryStream stream(data, 8);
+    CPPUNIT_ASSERT_EQUAL(8L, stream.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), stream.readBlock(3));
+    CPPUNIT_ASSERT_EQUAL(3L, stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("defgh"), stream.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(8L, stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(1));
+  }
+
+  void testSeek()
+  {
+    const char data[] = "abcdefgh";
+    MemoryStream stream(data, 8);
+    stream.seek(-2, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("gh"), stream.readBlock(2));
+    stream.seek(-5, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("d"), stream.readBlock(1));
+    stream.seek(100);
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(1));
+  }
+
+  void testReadOnly()
+  {
+    const char data[] = "abcdefgh";
+    MemoryStream stream(data, 8);
+    CPPUNIT_ASSERT(stream.readOnly());
+
+    stream.writeBlock("xx");
+    stream.insert("xx", 0, 0);
+    stream.removeBlock(0, 2);
+    stream.truncate(2);
+    CPPUNIT_ASSERT_EQUAL(8L, stream.length());
+    CPPUNIT_ASSERT_EQUAL(string("abcdefgh"), string(stream.data(), 8));
+  }
+
+  void testParse()
+  {
+    FileStream file(TEST_FILE_PATH_C("has-tags.m4a"), true);
+    const ByteVector data = file.readBlock(file.length());
+
+    MemoryStream stream(data.data(), data.size());
+    FileRef f(&stream);
+    CPPUNIT_ASSERT(!f.isNull());
+    CPPUNIT_ASSERT_EQUAL(String("Test Artist"), f.tag()->artist());
+    CPPUNIT_ASSERT(!f.save());
+  }
+
+  void testSharedBlocks()
+  {
+    const char data[] = "abcdefgh";
+    MemoryStream stream(data, 8);
+    CPPUNIT_ASSERT(stream.data() == data);
+
+    // The blocks refer to the memory of the caller.
+
+    stream.seek(2);
+    const ByteVector block = stream.readBlock(3);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cde"), block);
+    CPPUNIT_ASSERT(block.data() == data + 2);
+  }
+
+  void testNoCopy()
+  {
+    if(!AllocationScope::isTrackingEnabled())
+      return;
+
+    FileStream file(TEST_FILE_PATH_C("sinewave.flac"), true);
+    const ByteVector data = file.readBlock(file.length());
+
+    // Neither the stream nor the blocks read by the parser copy the data, so
+    // parsing allocates much less than the size of the file.
+
+    AllocationScope scope;
+    {
+      MemoryStream stream(data.data(), data.size());
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(!f.isNull());
+    }
+    CPPUNIT_ASSERT(scope.bytesAllocated() < data.size() / 4);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMemoryStream);
@@ -31,6 +31,8 @@
 #include <tpropertymap.h>
 #include <mp4atom.h>
 #include <mp4file.h>
+#include <fileref.h>
+#include <tinstrumentedstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -54,11 +56,13 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(testCovrRead);
   CPPUNIT_TEST(testCovrWrite);
   CPPUNIT_TEST(testCovrRead2);
+  CPPUNIT_TEST(testCovrShrinkInPlace);
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testPropertiesMovement);
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testRepeatedSave);
   CPPUNIT_TEST(testWithZeroLengthAtom);
+  CPPUNIT_TEST(testSaveUnchanged);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -323,6 +327,40 @@ public:
     CPPUNIT_ASSERT_EQUAL((unsigned int)287, l[1].data().size());
   }
 
+  void testCovrShrinkInPlace()
+  {
+    ScopedFileCopy copy("has-tags", ".m4a");
+    string filename = copy.fileName();
+
+    long length = 0;
+    {
+      MP4::File f(filename.c_str());
+      MP4::CoverArtList l;
+      l.append(MP4::CoverArt(MP4::CoverArt::PNG, ByteVector(4096, 'a')));
+      f.tag()->setItem("covr", l);
+      f.save();
+      length = f.length();
+    }
+    {
+      // The smaller cover leaves padding behind and is written in place.
+      MP4::File f(filename.c_str());
+      MP4::CoverArtList l;
+      l.append(MP4::CoverArt(MP4::CoverArt::JPEG, ByteVector(2048, 'b')));
+      f.tag()->setItem("covr", l);
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      CPPUNIT_ASSERT_EQUAL(1U, l.size());
+      CPPUNIT_ASSERT_EQUAL(MP4::CoverArt::JPEG, l[0].format());
+      CPPUNIT_ASSERT_EQUAL(ByteVector(2048, 'b'), l[0].data());
+      CPPUNIT_ASSERT_EQUAL(String("Test Artist"), f.tag()->artist());
+    }
+  }
+
   void testProperties()
   {
     MP4::File f(TEST_FILE_PATH_C("has-tags.m4a"));
@@ -458,6 +496,11 @@ public:
     CPPUNIT_ASSERT_EQUAL(22050, f.audioProperties()->sampleRate());
   }
 
+  void testSaveUnchanged()
+  {
+    checkSaveUnchanged("has-tags", ".m4a");
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMP4);
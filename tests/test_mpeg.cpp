@@ -34,6 +34,9 @@
 #include <mpegproperties.h>
 #include <xingheader.h>
 #include <mpegheader.h>
+#include <tfilestream.h>
+#include <fileref.h>
+#include <tinstrumentedstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -65,6 +68,9 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyID3v1);
   CPPUNIT_TEST(testEmptyAPE);
   CPPUNIT_TEST(testIgnoreGarbage);
+  CPPUNIT_TEST(testSaveUnchanged);
+  CPPUNIT_TEST(testAppendedID3v2);
+  CPPUNIT_TEST(testLyrics3v2);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -438,6 +444,101 @@ public:
     }
   }
 
+  void testSaveUnchanged()
+  {
+    checkSaveUnchanged("xing", ".mp3");
+  }
+
+  void testAppendedID3v2()
+  {
+    ScopedFileCopy copy("bladeenc", ".mp3");
+    string newname = copy.fileName();
+
+    // An ID3v2.4 tag with a footer after the audio data, followed by ID3v1.
+
+    ID3v2::Tag id3v2;
+    id3v2.setTitle("Appended");
+    ByteVector data = id3v2.render();
+    data[5] = static_cast<char>(data[5] | 0x10);
+    ByteVector footer = data.mid(0, 10);
+    footer[0] = '3';
+    footer[1] = 'D';
+    footer[2] = 'I';
+    data.append(footer);
+
+    ID3v1::Tag id3v1;
+    id3v1.setTitle("ID3v1");
+    data.append(id3v1.render());
+
+    appendToFile(newname, data);
+
+    {
+      MPEG::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT(f.hasID3v1Tag());
+      CPPUNIT_ASSERT_EQUAL(String("Appended"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("ID3v1"), f.ID3v1Tag()->title());
+      CPPUNIT_ASSERT_EQUAL(0L, f.firstFrameOffset());
+      CPPUNIT_ASSERT_EQUAL(28213L, f.lastFrameOffset());
+      CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+
+      f.ID3v2Tag()->setTitle("Moved");
+      f.save();
+    }
+    {
+      // The tag is written in front of the audio data when saved.
+
+      MPEG::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL(String("Moved"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("ID3v1"), f.ID3v1Tag()->title());
+      CPPUNIT_ASSERT_EQUAL(28213L, f.lastFrameOffset() - f.firstFrameOffset());
+      CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+
+      f.seek(0);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("ID3"), f.readBlock(3));
+    }
+  }
+
+  void testLyrics3v2()
+  {
+    ScopedFileCopy copy("bladeenc", ".mp3");
+    string newname = copy.fileName();
+
+    // APE, Lyrics3v2 and ID3v1 tags after the audio data.
+
+    APE::Tag ape;
+    ape.setTitle("APE");
+    ByteVector data = ape.render();
+
+    const ByteVector lyrics("LYRICSBEGININD0000210LYR00005Hello");
+    CPPUNIT_ASSERT_EQUAL(34U, lyrics.size());
+    data.append(lyrics);
+    data.append("000034LYRICS200");
+
+    ID3v1::Tag id3v1;
+    id3v1.setTitle("ID3v1");
+    data.append(id3v1.render());
+
+    appendToFile(newname, data);
+
+    MPEG::File f(newname.c_str());
+    CPPUNIT_ASSERT(f.hasAPETag());
+    CPPUNIT_ASSERT(f.hasID3v1Tag());
+    CPPUNIT_ASSERT_EQUAL(String("APE"), f.APETag()->title());
+    CPPUNIT_ASSERT_EQUAL(28213L, f.lastFrameOffset());
+    CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+  }
+
+private:
+
+  static void appendToFile(const string &filename, const ByteVector &data)
+  {
+    FileStream stream(filename.c_str());
+    stream.seek(0, IOStream::End);
+    stream.writeBlock(data);
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMPEG);
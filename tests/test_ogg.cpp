@@ -32,6 +32,8 @@
 #include <oggfile.h>
 #include <vorbisfile.h>
 #include <oggpageheader.h>
+#include <fileref.h>
+#include <tinstrumentedstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -48,6 +50,7 @@ class TestOGG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDictInterface2);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testPageChecksum);
+  CPPUNIT_TEST(testSaveUnchanged);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -223,6 +226,11 @@ public:
 
   }
 
+  void testSaveUnchanged()
+  {
+    checkSaveUnchanged("empty", ".ogg");
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOGG);
@@ -28,7 +28,10 @@
 #include <tag.h>
 #include <tbytevectorlist.h>
 #include <opusfile.h>
+#include <oggpage.h>
 #include <oggpageheader.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -42,6 +45,7 @@ class TestOpus : public CppUnit::TestFixture
   CPPUNIT_TEST(testReadComments);
   CPPUNIT_TEST(testWriteComments);
   CPPUNIT_TEST(testSplitPackets);
+  CPPUNIT_TEST(testRenumberPages);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -133,6 +137,42 @@ public:
     }
   }
 
+  void testRenumberPages()
+  {
+    ScopedFileCopy copy("correctness_gain_silent_output", ".opus");
+    string newname = copy.fileName();
+
+    {
+      // Splitting the comment packet shifts the numbers of all the audio
+      // pages, but their checksums are patched without reading them.
+
+      FileStream fileStream(newname.c_str());
+      InstrumentedStream stream(&fileStream);
+      Ogg::Opus::File f(&stream);
+      f.tag()->setTitle(longText(128 * 1024, true));
+      stream.resetStatistics();
+      CPPUNIT_ASSERT(f.save());
+      CPPUNIT_ASSERT(stream.statistics().total().bytesRead < 4 * 1024);
+    }
+    {
+      Ogg::Opus::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+
+      long offset = 0;
+      int sequenceNumber = 0;
+      while(offset < f.length()) {
+        const Ogg::Page page(&f, offset);
+        CPPUNIT_ASSERT(page.header()->isValid());
+        CPPUNIT_ASSERT_EQUAL(sequenceNumber++, page.pageSequenceNumber());
+
+        f.seek(offset);
+        CPPUNIT_ASSERT_EQUAL(page.render(), f.readBlock(page.size()));
+        offset += page.size();
+      }
+      CPPUNIT_ASSERT_EQUAL(28, sequenceNumber);
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOpus);
@@ -0,0 +1,172 @@
+/***************************************************************************
+    copyright           : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <toverlaystream.h>
+#include <tbytevectorstream.h>
+#include <tfilestream.h>
+#include <fileref.h>
+#include <tag.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestOverlayStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestOverlayStream);
+  CPPUNIT_TEST(testEdit);
+  CPPUNIT_TEST(testWriteTo);
+  CPPUNIT_TEST(testManyEdits);
+  CPPUNIT_TEST(testCopyMatchesSave);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testEdit()
+  {
+    ByteVectorStream data(ByteVector("abcdefgh"));
+    OverlayStream stream(&data);
+    CPPUNIT_ASSERT(!stream.isModified());
+
+    stream.insert("XYZ", 2, 1);
+    stream.removeBlock(0, 1);
+    stream.seek(0, IOStream::End);
+    stream.writeBlock("!");
+    CPPUNIT_ASSERT(stream.isModified());
+    CPPUNIT_ASSERT_EQUAL(10L, stream.length());
+
+    stream.seek(0);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("bXYZdefgh!"), stream.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(1));
+
+    stream.truncate(4);
+    stream.seek(1);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("XYZ"), stream.readBlock(100));
+
+    // The underlying stream is never written to.
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdefgh"), *data.data());
+  }
+
+  void testWriteTo()
+  {
+    ByteVectorStream data(ByteVector("0123456789"));
+    OverlayStream stream(&data);
+    stream.insert("abc", 3, 4);
+
+    ByteVectorStream sink((ByteVector()));
+    CPPUNIT_ASSERT(stream.writeTo(&sink, 2));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("012abc789"), *sink.data());
+  }
+
+  void testManyEdits()
+  {
+    // The same edits on a ByteVectorStream give the expected content.
+
+    ByteVector original;
+    for(int i = 0; i < 1000; ++i)
+      original.append(static_cast<char>('a' + i % 26));
+
+    ByteVectorStream data(original);
+    OverlayStream stream(&data);
+    ByteVectorStream expected(original);
+
+    unsigned int seed = 1;
+    for(int i = 0; i < 2000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      const unsigned long start  = (seed >> 8) % (expected.length() + 1);
+      const unsigned long length = std::min<unsigned long>((seed >> 4) % 16, expected.length() - start);
+      if(length == 0)
+        continue;
+
+      const ByteVector block(static_cast<unsigned int>(length), static_cast<char>('A' + i % 26));
+
+      switch(seed % 4) {
+      case 0:
+        stream.insert(block, start, length / 2);
+        expected.insert(block, start, length / 2);
+        break;
+      case 1:
+        stream.removeBlock(start, length);
+        expected.removeBlock(start, length);
+        break;
+      default:
+        stream.seek(start);
+        stream.writeBlock(block);
+        expected.seek(start);
+        expected.writeBlock(block);
+        break;
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(expected.length(), stream.length());
+    stream.seek(0);
+    CPPUNIT_ASSERT_EQUAL(*expected.data(), stream.readBlock(stream.length()));
+  }
+
+  void testCopyMatchesSave()
+  {
+    // Saving a file into an OverlayStream and writing it out must give the
+    // same file as saving in place, including the MP4 chunk offsets and the
+    // renumbered Ogg pages.
+
+    const char *files[][2] = {
+      { "has-tags",     ".m4a"  },
+      { "empty",        ".ogg"  },
+      { "xing",         ".mp3"  },
+      { "silence-44-s", ".flac" },
+      { "empty",        ".wav"  }
+    };
+
+    for(size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+      const String title(std::string(10000, 'x'));
+
+      ScopedFileCopy copy(files[i][0], files[i][1]);
+      {
+        FileRef f(copy.fileName().c_str());
+        f.tag()->setTitle(title);
+        CPPUNIT_ASSERT(f.save());
+      }
+
+      ByteVectorStream sink((ByteVector()));
+      {
+        FileStream stream(TEST_FILE_PATH_C(std::string(files[i][0]) + files[i][1]), true);
+        OverlayStream overlay(&stream);
+        {
+          FileRef f(&overlay);
+          f.tag()->setTitle(title);
+          CPPUNIT_ASSERT(f.save());
+        }
+        CPPUNIT_ASSERT(overlay.writeTo(&sink, 1024));
+      }
+
+      FileStream expected(copy.fileName().c_str(), true);
+      CPPUNIT_ASSERT_EQUAL(expected.readBlock(expected.length()), *sink.data());
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestOverlayStream);
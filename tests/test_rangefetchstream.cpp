@@ -0,0 +1,234 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+#include <trangefetchstream.h>
+#include <tfilestream.h>
+#include <tpropertymap.h>
+#include <fileref.h>
+#include <tag.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  // Serves the ranges of a file held in memory, like a server answering
+  // range requests, and counts the requests.
+
+  class MemoryFetcher : public RangeFetchStream::Fetcher
+  {
+  public:
+    explicit MemoryFetcher(const ByteVector &data, bool multiRange = false) :
+      requests(0),
+      data(data),
+      multiRange(multiRange) {}
+
+    ByteVector fetch(long offset, unsigned long length)
+    {
+      requests++;
+      return data.mid(offset, length);
+    }
+
+    ByteVectorList fetchRanges(const File::RangeList &ranges)
+    {
+      if(!multiRange)
+        return RangeFetchStream::Fetcher::fetchRanges(ranges);
+
+      requests++;
+      ByteVectorList result;
+      for(File::RangeList::ConstIterator it = ranges.begin(); it != ranges.end(); ++it)
+        result.append(data.mid(it->offset, it->length));
+      return result;
+    }
+
+    unsigned int requests;
+
+  private:
+    const ByteVector data;
+    const bool multiRange;
+  };
+
+  ByteVector pattern(unsigned int length)
+  {
+    ByteVector v(length, '\0');
+    for(unsigned int i = 0; i < length; ++i)
+      v[i] = static_cast<char>(i * 7 + i / 251);
+    return v;
+  }
+}
+
+class TestRangeFetchStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestRangeFetchStream);
+  CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testPrefetch);
+  CPPUNIT_TEST(testSequentialReads);
+  CPPUNIT_TEST(testNearbyReads);
+  CPPUNIT_TEST(testBackwardReads);
+  CPPUNIT_TEST(testShortFetch);
+  CPPUNIT_TEST(testFileRef);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testRead()
+  {
+    const ByteVector data = pattern(1024 * 1024);
+    MemoryFetcher fetcher(data);
+    RangeFetchStream stream(&fetcher, data.size(), "", 4096);
+
+    const long offsets[] = { 0, 500000, 3, 1048000, 499000, 700000, 1048575, 1048576 };
+    for(size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+      stream.seek(offsets[i]);
+      CPPUNIT_ASSERT_EQUAL(data.mid(offsets[i], 20000), stream.readBlock(20000));
+      CPPUNIT_ASSERT_EQUAL(std::min<long>(offsets[i] + 20000, data.size()), stream.tell());
+    }
+
+    stream.seek(-10, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(data.mid(data.size() - 10), stream.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(fetcher.requests, stream.roundTrips() + 1);
+  }
+
+  void testPrefetch()
+  {
+    const ByteVector data = pattern(1024 * 1024);
+    {
+      MemoryFetcher fetcher(data, true);
+      RangeFetchStream stream(&fetcher, data.size());
+
+      stream.readBlock(10);
+      stream.seek(-128, IOStream::End);
+      stream.readBlock(128);
+      stream.seek(-128 * 1024, IOStream::End);
+      stream.readBlock(1024);
+      stream.seek(60000);
+      stream.readBlock(1000);
+
+      CPPUNIT_ASSERT_EQUAL(1U, fetcher.requests);
+      CPPUNIT_ASSERT_EQUAL(1U, stream.roundTrips());
+      CPPUNIT_ASSERT_EQUAL(192L * 1024, stream.bytesFetched());
+    }
+    {
+      // Small files are fetched at once.
+
+      MemoryFetcher fetcher(data.mid(0, 200000));
+      RangeFetchStream stream(&fetcher, 200000);
+      stream.seek(100000);
+      CPPUNIT_ASSERT_EQUAL(data.mid(100000, 10), stream.readBlock(10));
+      CPPUNIT_ASSERT_EQUAL(1U, fetcher.requests);
+      CPPUNIT_ASSERT_EQUAL(200000L, stream.bytesFetched());
+    }
+  }
+
+  void testSequentialReads()
+  {
+    const ByteVector data = pattern(1024 * 1024);
+    MemoryFetcher fetcher(data, true);
+    RangeFetchStream stream(&fetcher, data.size(), "", 4096);
+
+    stream.seek(100000);
+    for(int i = 0; i < 1000; ++i)
+      CPPUNIT_ASSERT_EQUAL(data.mid(100000 + i * 100, 100), stream.readBlock(100));
+
+    CPPUNIT_ASSERT_EQUAL(1U + 100000 / 4096 + 1, stream.roundTrips());
+  }
+
+  void testNearbyReads()
+  {
+    const ByteVector data = pattern(1024 * 1024);
+    MemoryFetcher fetcher(data, true);
+    RangeFetchStream stream(&fetcher, data.size(), "", 4096);
+
+    // The gap between the two reads is fetched along with the second one, so
+    // that reading it later is free.
+
+    stream.seek(300000);
+    stream.readBlock(100);
+    stream.seek(310000);
+    stream.readBlock(100);
+    CPPUNIT_ASSERT_EQUAL(3U, stream.roundTrips());
+
+    stream.seek(300000);
+    CPPUNIT_ASSERT_EQUAL(data.mid(300000, 10100), stream.readBlock(10100));
+    CPPUNIT_ASSERT_EQUAL(3U, stream.roundTrips());
+  }
+
+  void testBackwardReads()
+  {
+    const ByteVector data = pattern(1024 * 1024);
+    MemoryFetcher fetcher(data, true);
+    RangeFetchStream stream(&fetcher, data.size(), "", 4096);
+
+    for(long offset = 500000; offset > 400000; offset -= 1024) {
+      stream.seek(offset);
+      CPPUNIT_ASSERT_EQUAL(data.mid(offset, 1024), stream.readBlock(1024));
+    }
+
+    CPPUNIT_ASSERT(stream.roundTrips() <= 1 + 100000 / 4096 + 2);
+  }
+
+  void testShortFetch()
+  {
+    // The server has less data than announced.
+
+    const ByteVector data = pattern(500000);
+    MemoryFetcher fetcher(data, true);
+    RangeFetchStream stream(&fetcher, 600000);
+
+    stream.seek(400000);
+    CPPUNIT_ASSERT_EQUAL(data.mid(400000), stream.readBlock(200000));
+    CPPUNIT_ASSERT_EQUAL(500000L, stream.tell());
+    CPPUNIT_ASSERT(stream.readBlock(100).isEmpty());
+  }
+
+  void testFileRef()
+  {
+    const char *files[] = {
+      "ape-id3v2.mp3", "sinewave.flac", "test.ogg", "has-tags.m4a", "mac-399-tagged.ape",
+      "tagged.wv", "lossless.wma", "test.xm"
+    };
+
+    for(size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+      FileStream file(TEST_FILE_PATH_C(files[i]), true);
+      const ByteVector data = file.readBlock(file.length());
+
+      MemoryFetcher fetcher(data, true);
+      RangeFetchStream stream(&fetcher, data.size(), files[i], 4096);
+      const FileRef actual(&stream);
+      const FileRef expected(TEST_FILE_PATH_C(files[i]));
+
+      CPPUNIT_ASSERT(!actual.isNull());
+      CPPUNIT_ASSERT_EQUAL(expected.file()->properties(), actual.file()->properties());
+      CPPUNIT_ASSERT_EQUAL(expected.audioProperties()->lengthInMilliseconds(),
+                           actual.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(1U, stream.roundTrips());
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestRangeFetchStream);
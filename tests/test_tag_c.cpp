@@ -0,0 +1,393 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <tag_c.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+
+namespace
+{
+  vector<string> toVector(char **strings)
+  {
+    vector<string> v;
+    for(; *strings; ++strings)
+      v.push_back(*strings);
+    return v;
+  }
+
+  string readFile(const string &path)
+  {
+    ifstream in(path.c_str(), ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+}
+
+class TestTagC : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestTagC);
+  CPPUNIT_TEST(testGlobalStrings);
+  CPPUNIT_TEST(testStringManagementDisabled);
+  CPPUNIT_TEST(testLatin1);
+  CPPUNIT_TEST(testFileStrings);
+  CPPUNIT_TEST(testFreeFileStrings);
+  CPPUNIT_TEST(testInto);
+  CPPUNIT_TEST(testProperties);
+  CPPUNIT_TEST(testPictures);
+  CPPUNIT_TEST(testMemory);
+  CPPUNIT_TEST(testInfo);
+  CPPUNIT_TEST(testInfoArenaFull);
+  CPPUNIT_TEST(testInfoBatch);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testGlobalStrings()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    CPPUNIT_ASSERT(file);
+    TagLib_Tag *tag = taglib_file_tag(file);
+    taglib_tag_set_title(tag, "Title");
+    taglib_tag_set_artist(tag, "Artist");
+    char *title = taglib_tag_title(tag);
+    char *artist = taglib_tag_artist(tag);
+    taglib_file_free(file);
+
+    // The strings are not owned by the file, so they outlive it.
+
+    CPPUNIT_ASSERT_EQUAL(string("Title"), string(title));
+    CPPUNIT_ASSERT_EQUAL(string("Artist"), string(artist));
+    taglib_tag_free_strings();
+  }
+
+  void testStringManagementDisabled()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    TagLib_Tag *tag = taglib_file_tag(file);
+    taglib_tag_set_title(tag, "Title");
+
+    taglib_set_string_management_enabled(0);
+    char *title = taglib_tag_title(tag);
+    taglib_set_string_management_enabled(1);
+
+    taglib_tag_free_strings();
+    taglib_file_free(file);
+
+    CPPUNIT_ASSERT_EQUAL(string("Title"), string(title));
+    taglib_free(title);
+  }
+
+  void testLatin1()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    TagLib_Tag *tag = taglib_file_tag(file);
+
+    taglib_set_strings_unicode(0);
+    taglib_tag_set_title(tag, "\xE9t\xE9");
+    const string latin1 = taglib_tag_title(tag);
+    taglib_set_strings_unicode(1);
+
+    CPPUNIT_ASSERT_EQUAL(string("\xE9t\xE9"), latin1);
+    CPPUNIT_ASSERT_EQUAL(string("\xC3\xA9t\xC3\xA9"), string(taglib_tag_title(tag)));
+
+    // The strings owned by the file are always UTF-8.
+
+    taglib_set_strings_unicode(0);
+    const string utf8 = taglib_tag_title_ref(tag);
+    taglib_set_strings_unicode(1);
+
+    CPPUNIT_ASSERT_EQUAL(string("\xC3\xA9t\xC3\xA9"), utf8);
+
+    taglib_tag_free_strings();
+    taglib_file_free(file);
+  }
+
+  void testFileStrings()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    TagLib_Tag *tag = taglib_file_tag(file);
+    taglib_tag_set_title(tag, "\xE2\x99\xAB \xF0\x9D\x84\x9E");
+    taglib_tag_set_album(tag, "Album");
+    taglib_tag_set_genre(tag, string(5000, 'g').c_str());
+
+    const char *title = taglib_tag_title_ref(tag);
+    const char *album = taglib_tag_album_ref(tag);
+    const char *genre = taglib_tag_genre_ref(tag);
+    const char *artist = taglib_tag_artist_ref(tag);
+
+    // Freeing the global strings does not touch the strings of the file.
+
+    taglib_tag_free_strings();
+
+    CPPUNIT_ASSERT_EQUAL(string("\xE2\x99\xAB \xF0\x9D\x84\x9E"), string(title));
+    CPPUNIT_ASSERT_EQUAL(string("Album"), string(album));
+    CPPUNIT_ASSERT_EQUAL(string(5000, 'g'), string(genre));
+    CPPUNIT_ASSERT_EQUAL(string(), string(artist));
+
+    taglib_file_free(file);
+  }
+
+  void testFreeFileStrings()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    TagLib_Tag *tag = taglib_file_tag(file);
+    taglib_tag_set_comment(tag, "Comment");
+
+    for(int i = 0; i < 10000; ++i) {
+      CPPUNIT_ASSERT_EQUAL(string("Comment"), string(taglib_tag_comment_ref(tag)));
+      if(i % 100 == 0)
+        taglib_file_free_strings(file);
+    }
+
+    taglib_file_free(file);
+  }
+
+  void testInto()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    TagLib_Tag *tag = taglib_file_tag(file);
+    taglib_tag_set_title(tag, "ab\xE2\x99\xAB");
+
+    char buffer[16];
+    CPPUNIT_ASSERT_EQUAL(5U, taglib_tag_title_into(tag, buffer, sizeof(buffer)));
+    CPPUNIT_ASSERT_EQUAL(string("ab\xE2\x99\xAB"), string(buffer));
+
+    // A character which does not fit completely is left out.
+
+    memset(buffer, 'x', sizeof(buffer));
+    CPPUNIT_ASSERT_EQUAL(5U, taglib_tag_title_into(tag, buffer, 5));
+    CPPUNIT_ASSERT_EQUAL(string("ab"), string(buffer));
+    CPPUNIT_ASSERT_EQUAL('x', buffer[3]);
+
+    CPPUNIT_ASSERT_EQUAL(5U, taglib_tag_title_into(tag, buffer, 6));
+    CPPUNIT_ASSERT_EQUAL(string("ab\xE2\x99\xAB"), string(buffer));
+
+    CPPUNIT_ASSERT_EQUAL(0U, taglib_tag_artist_into(tag, buffer, sizeof(buffer)));
+    CPPUNIT_ASSERT_EQUAL(string(), string(buffer));
+    CPPUNIT_ASSERT_EQUAL(5U, taglib_tag_title_into(tag, 0, 0));
+
+    taglib_file_free(file);
+  }
+
+  void testProperties()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+
+    TagLib_File *file = taglib_file_new(copy.fileName().c_str());
+    const vector<string> keys = toVector(taglib_property_keys(file));
+    CPPUNIT_ASSERT_EQUAL(size_t(6), keys.size());
+    CPPUNIT_ASSERT_EQUAL(string("ALBUM"), keys[0]);
+    CPPUNIT_ASSERT_EQUAL(string("TRACKNUMBER"), keys[5]);
+
+    const vector<string> artists = toVector(taglib_property_get(file, "ARTIST"));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), artists.size());
+    CPPUNIT_ASSERT_EQUAL(string("piman"), artists[0]);
+    CPPUNIT_ASSERT_EQUAL(string("jzig"), artists[1]);
+    CPPUNIT_ASSERT(!*taglib_property_get(file, "MUSICBRAINZ_TRACKID"));
+
+    taglib_property_set(file, "MUSICBRAINZ_TRACKID", "\xE2\x99\xAB");
+    taglib_property_set_append(file, "ARTIST", "someone");
+    taglib_property_set(file, "GENRE", 0);
+    CPPUNIT_ASSERT(taglib_file_save(file));
+    taglib_file_free(file);
+
+    file = taglib_file_new(copy.fileName().c_str());
+    CPPUNIT_ASSERT_EQUAL(string("\xE2\x99\xAB"), string(taglib_property_get(file, "MUSICBRAINZ_TRACKID")[0]));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), toVector(taglib_property_get(file, "ARTIST")).size());
+    CPPUNIT_ASSERT(!*taglib_property_get(file, "GENRE"));
+    taglib_file_free(file);
+  }
+
+  void testPictures()
+  {
+    TagLib_File *file = taglib_file_new(TEST_FILE_PATH_C("silence-44-s.flac"));
+    CPPUNIT_ASSERT_EQUAL(1U, taglib_picture_count(file));
+
+    TagLib_Picture picture;
+    CPPUNIT_ASSERT(taglib_picture_get(file, 0, &picture));
+    CPPUNIT_ASSERT_EQUAL(string("image/png"), string(picture.mime_type));
+    CPPUNIT_ASSERT_EQUAL(string("A pixel."), string(picture.description));
+    CPPUNIT_ASSERT_EQUAL(3, picture.type);
+    CPPUNIT_ASSERT_EQUAL(150U, picture.size);
+    CPPUNIT_ASSERT_EQUAL(string("\x89PNG"), string(picture.data, 4));
+    CPPUNIT_ASSERT(!taglib_picture_get(file, 1, &picture));
+    taglib_file_free(file);
+
+    file = taglib_file_new(TEST_FILE_PATH_C("has-tags.m4a"));
+    CPPUNIT_ASSERT_EQUAL(2U, taglib_picture_count(file));
+    CPPUNIT_ASSERT(taglib_picture_get(file, 1, &picture));
+    CPPUNIT_ASSERT_EQUAL(287U, picture.size);
+    taglib_file_free(file);
+
+    file = taglib_file_new(TEST_FILE_PATH_C("xing.mp3"));
+    CPPUNIT_ASSERT_EQUAL(0U, taglib_picture_count(file));
+    taglib_file_free(file);
+  }
+
+  void testMemory()
+  {
+    const string data = readFile(TEST_FILE_PATH_C("silence-44-s.flac"));
+
+    TagLib_File *file = taglib_file_new_memory(data.data(), static_cast<unsigned int>(data.size()));
+    CPPUNIT_ASSERT(file);
+    CPPUNIT_ASSERT(taglib_file_is_valid(file));
+    CPPUNIT_ASSERT_EQUAL(string("Silence"), string(taglib_tag_title_ref(taglib_file_tag(file))));
+    taglib_file_free(file);
+
+    file = taglib_file_new_memory_shared(data.data(), static_cast<unsigned int>(data.size()));
+    CPPUNIT_ASSERT(file);
+    CPPUNIT_ASSERT_EQUAL(string("piman"), string(taglib_property_get(file, "ARTIST")[0]));
+    CPPUNIT_ASSERT_EQUAL(1U, taglib_picture_count(file));
+    taglib_file_free(file);
+
+    CPPUNIT_ASSERT(!taglib_file_new_memory("garbage", 7));
+  }
+
+  void testInfo()
+  {
+    char arena[256];
+    size_t used = 10;
+    TagLib_Info info;
+
+    CPPUNIT_ASSERT(taglib_info_read(TEST_FILE_PATH_C("silence-44-s.flac"), &info, arena, sizeof(arena), &used));
+    CPPUNIT_ASSERT_EQUAL(TagLib_Info_OK, info.status);
+    CPPUNIT_ASSERT_EQUAL(string("FLAC"), string(info.format));
+    CPPUNIT_ASSERT_EQUAL(string("Silence"), string(info.title));
+    CPPUNIT_ASSERT_EQUAL(string("piman jzig"), string(info.artist));
+    CPPUNIT_ASSERT_EQUAL(string("Quod Libet Test Data"), string(info.album));
+    CPPUNIT_ASSERT_EQUAL(string(""), string(info.comment));
+    CPPUNIT_ASSERT_EQUAL(string("Silence"), string(info.genre));
+    CPPUNIT_ASSERT_EQUAL(2004U, info.year);
+    CPPUNIT_ASSERT_EQUAL(2U, info.track);
+    CPPUNIT_ASSERT_EQUAL(3685, info.length);
+    CPPUNIT_ASSERT_EQUAL(44100, info.samplerate);
+    CPPUNIT_ASSERT_EQUAL(2, info.channels);
+
+    // The strings follow the part of the arena which was used before.
+
+    CPPUNIT_ASSERT(info.title == arena + 10);
+    CPPUNIT_ASSERT_EQUAL(size_t(10 + 8 + 11 + 21 + 1 + 8), used);
+
+    CPPUNIT_ASSERT(!taglib_info_read(TEST_FILE_PATH_C("no-extension"), &info, arena, sizeof(arena), &used));
+    CPPUNIT_ASSERT_EQUAL(TagLib_Info_Invalid, info.status);
+    CPPUNIT_ASSERT(!info.format);
+    CPPUNIT_ASSERT(!info.title);
+  }
+
+  void testInfoArenaFull()
+  {
+    char arena[40];
+    size_t used = 0;
+    TagLib_Info info;
+
+    // The strings of the file need 49 bytes and are left out together.
+
+    CPPUNIT_ASSERT(!taglib_info_read(TEST_FILE_PATH_C("silence-44-s.flac"), &info, arena, sizeof(arena), &used));
+    CPPUNIT_ASSERT_EQUAL(TagLib_Info_ArenaFull, info.status);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), used);
+    CPPUNIT_ASSERT(!info.title);
+    CPPUNIT_ASSERT_EQUAL(3685, info.length);
+
+    CPPUNIT_ASSERT(!taglib_info_read(TEST_FILE_PATH_C("silence-44-s.flac"), &info, 0, 0, 0));
+    CPPUNIT_ASSERT_EQUAL(TagLib_Info_ArenaFull, info.status);
+  }
+
+  void testInfoBatch()
+  {
+    const char *const names[] = {
+      "silence-44-s.flac", "xing.mp3", "has-tags.m4a", "no-extension", "empty.ogg", "test.xm", "lossless.wma"
+    };
+    const char *const formats[] = {
+      "FLAC", "MPEG", "MP4", 0, "OggVorbis", "XM", "ASF"
+    };
+    const unsigned int count = sizeof(names) / sizeof(names[0]);
+
+    vector<string> paths;
+    for(unsigned int i = 0; i < 100 * count; ++i)
+      paths.push_back(TEST_FILE_PATH_C(names[i % count]));
+
+    vector<const char *> filenames;
+    for(vector<string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+      filenames.push_back(it->c_str());
+
+    vector<TagLib_Info> infos(paths.size());
+    vector<char> arena(100000);
+    size_t used = 0;
+
+    const unsigned int read = taglib_info_read_batch(&filenames[0], static_cast<unsigned int>(filenames.size()),
+                                                     &infos[0], &arena[0], arena.size(), &used, 8);
+    CPPUNIT_ASSERT_EQUAL(600U, read);
+    CPPUNIT_ASSERT(used > 0 && used <= arena.size());
+
+    for(unsigned int i = 0; i < infos.size(); ++i) {
+      const TagLib_Info &info = infos[i];
+      if(!formats[i % count]) {
+        CPPUNIT_ASSERT_EQUAL(TagLib_Info_Invalid, info.status);
+        continue;
+      }
+
+      CPPUNIT_ASSERT_EQUAL(TagLib_Info_OK, info.status);
+      CPPUNIT_ASSERT_EQUAL(string(formats[i % count]), string(info.format));
+      CPPUNIT_ASSERT(info.title >= &arena[0] && info.genre < &arena[0] + used);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(string("Silence"), string(infos[0].title));
+    CPPUNIT_ASSERT_EQUAL(string("Test Artist"), string(infos[2 + count].artist));
+
+    // Once the arena is full, the entries are filled in without strings.
+
+    used = arena.size() - 100;
+    taglib_info_read_batch(&filenames[0], static_cast<unsigned int>(filenames.size()),
+                           &infos[0], &arena[0], arena.size(), &used, 8);
+
+    unsigned int full = 0;
+    for(unsigned int i = 0; i < infos.size(); ++i) {
+      if(infos[i].status == TagLib_Info_ArenaFull)
+        ++full;
+    }
+    CPPUNIT_ASSERT(full > 500);
+    CPPUNIT_ASSERT(used <= arena.size());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestTagC);
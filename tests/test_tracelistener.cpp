@@ -0,0 +1,152 @@
+/***************************************************************************
+    copyright           : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ttracelistener.h>
+#include <tag.h>
+#include <fileref.h>
+#include <tthreads.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  class RecordingListener : public TraceListener
+  {
+  public:
+    void traceEvent(const char *name, unsigned long long, unsigned long long)
+    {
+      names.push_back(name);
+    }
+
+    bool contains(const string &name) const
+    {
+      for(vector<string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+        if(*it == name)
+          return true;
+      }
+      return false;
+    }
+
+    vector<string> names;
+  };
+
+#ifndef _WIN32
+  void *writeEvents(void *writer)
+  {
+    for(int i = 0; i < 1000; ++i)
+      static_cast<ChromeTraceWriter *>(writer)->traceEvent("event", i, 1);
+    return 0;
+  }
+#endif
+}
+
+class TestTraceListener : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestTraceListener);
+  CPPUNIT_TEST(testChromeTraceWriter);
+  CPPUNIT_TEST(testChromeTraceWriterThreads);
+  CPPUNIT_TEST(testFileRefEvents);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testChromeTraceWriter()
+  {
+    ostringstream out;
+    {
+      ChromeTraceWriter writer(out);
+      writer.traceEvent("a\"b", 1234567, 89);
+      writer.traceEvent("c", 2000000, 1000);
+    }
+
+    ostringstream ids;
+    ids << "\"pid\": " << Utils::currentProcessId() << ", \"tid\": " << Utils::currentThreadId();
+
+    CPPUNIT_ASSERT_EQUAL(
+      "{\"traceEvents\": [\n"
+      "{\"name\": \"a\\\"b\", \"cat\": \"taglib\", \"ph\": \"X\", \"ts\": 1234.567, \"dur\": 0.089, " + ids.str() + "},\n"
+      "{\"name\": \"c\", \"cat\": \"taglib\", \"ph\": \"X\", \"ts\": 2000.000, \"dur\": 1.000, " + ids.str() + "}\n"
+      "], \"displayTimeUnit\": \"ns\"}\n", out.str());
+  }
+
+  void testChromeTraceWriterThreads()
+  {
+#ifndef _WIN32
+    ostringstream out;
+    {
+      ChromeTraceWriter writer(out);
+      pthread_t threads[4];
+      for(int i = 0; i < 4; ++i)
+        pthread_create(&threads[i], 0, writeEvents, &writer);
+      for(int i = 0; i < 4; ++i)
+        pthread_join(threads[i], 0);
+    }
+
+    // Every event has to end up on a line of its own.
+    istringstream in(out.str());
+    string line;
+    getline(in, line);
+    CPPUNIT_ASSERT_EQUAL(string("{\"traceEvents\": ["), line);
+    int events = 0;
+    while(getline(in, line) && line[0] == '{') {
+      CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(line.find("{\"name\": \"event\", ")));
+      CPPUNIT_ASSERT_EQUAL(string::npos, line.find('{', 1));
+      ++events;
+    }
+    CPPUNIT_ASSERT_EQUAL(4000, events);
+    CPPUNIT_ASSERT_EQUAL(string("], \"displayTimeUnit\": \"ns\"}"), line);
+#endif
+  }
+
+  void testFileRefEvents()
+  {
+    RecordingListener listener;
+    setTraceListener(&listener);
+    {
+      FileRef f(TEST_FILE_PATH_C("xing.mp3"));
+      CPPUNIT_ASSERT(!f.isNull());
+    }
+    setTraceListener(0);
+
+    if(isTracingEnabled()) {
+      CPPUNIT_ASSERT(listener.contains("FileRef::parse"));
+      CPPUNIT_ASSERT(listener.contains("MPEG::Properties::read"));
+
+      // Nested phases are reported first.
+      CPPUNIT_ASSERT_EQUAL(string("FileRef::parse"), listener.names.back());
+    }
+    else {
+      CPPUNIT_ASSERT(listener.names.empty());
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestTraceListener);
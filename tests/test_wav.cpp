@@ -30,6 +30,8 @@
 #include <tbytevectorlist.h>
 #include <tpropertymap.h>
 #include <wavfile.h>
+#include <fileref.h>
+#include <tinstrumentedstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -51,6 +53,7 @@ class TestWAV : public CppUnit::TestFixture
   CPPUNIT_TEST(testFuzzedFile2);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testPCMWithFactChunk);
+  CPPUNIT_TEST(testSaveUnchanged);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -289,6 +292,11 @@ public:
     CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->format());
   }
 
+  void testSaveUnchanged()
+  {
+    checkSaveUnchanged("empty", ".wav");
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestWAV);
@@ -25,6 +25,8 @@
 
 #include <xmfile.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
 #include "utils.h"
 
 using namespace std;
@@ -110,6 +112,7 @@ class TestXM : public CppUnit::TestFixture
   CPPUNIT_TEST(testReadStrippedTags);
   CPPUNIT_TEST(testWriteTagsShort);
   CPPUNIT_TEST(testWriteTagsLong);
+  CPPUNIT_TEST(testReadCalls);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -162,6 +165,20 @@ public:
     testWriteTags(newCommentLong);
   }
 
+  void testReadCalls()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("test.xm"));
+    InstrumentedStream stream(&fileStream);
+    XM::File file(&stream);
+    CPPUNIT_ASSERT(file.isValid());
+
+    // One read for the module header and one for each pattern, instrument
+    // and sample header.
+    const unsigned long long expected = 1 + file.audioProperties()->patternCount()
+      + file.audioProperties()->instrumentCount() + file.audioProperties()->sampleCount();
+    CPPUNIT_ASSERT_EQUAL(expected, stream.statistics().total().readCalls);
+  }
+
 private:
   void testRead(FileName fileName, const String &title,
                 const String &comment, const String &trackerName)
@@ -148,3 +148,47 @@ private:
   const bool m_deleteFile;
   const string m_filename;
 };
+
+#if defined(TAGLIB_FILEREF_H) && defined(TAGLIB_INSTRUMENTEDSTREAM_H) && defined(CPPUNIT_ASSERT)
+
+#include <tfilestream.h>
+#include <tpropertymap.h>
+
+// Saves a copy of the file without changing its tags, and after setting the
+// properties it already has, and checks that neither writes to the file.
+
+inline void checkSaveUnchanged(const string &filename, const string &ext)
+{
+  using namespace TagLib;
+
+  ScopedFileCopy copy(filename, ext);
+  const string newname = copy.fileName();
+
+  {
+    FileRef f(newname.c_str());
+    PropertyMap properties = f.file()->properties();
+    properties["TITLE"] = String("Title");
+    f.file()->setProperties(properties);
+    f.save();
+  }
+  {
+    FileStream fileStream(newname.c_str());
+    InstrumentedStream stream(&fileStream);
+    FileRef f(&stream);
+
+    f.save();
+    f.file()->setProperties(f.file()->properties());
+    f.save();
+    CPPUNIT_ASSERT_EQUAL(0ULL, stream.statistics().counters(IOStatistics::Saving).writeCalls);
+
+    f.tag()->setTitle("Another title");
+    f.save();
+    CPPUNIT_ASSERT(stream.statistics().counters(IOStatistics::Saving).writeCalls > 0);
+  }
+  {
+    FileRef f(newname.c_str());
+    CPPUNIT_ASSERT_EQUAL(String("Another title"), f.tag()->title());
+  }
+}
+
+#endif
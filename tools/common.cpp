@@ -0,0 +1,316 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <tfile.h>
+#include <tclock.h>
+#include <fileref.h>
+#include <formatutils.h>
+
+#include "common.h"
+
+using namespace TagLib;
+
+namespace
+{
+  std::string lowerExtension(const std::string &path)
+  {
+    const std::string::size_type dot = path.rfind('.');
+    const std::string::size_type slash = path.find_last_of("/\\");
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+      return std::string();
+
+    std::string extension = path.substr(dot + 1);
+    for(std::string::iterator it = extension.begin(); it != extension.end(); ++it) {
+      if(*it >= 'A' && *it <= 'Z')
+        *it = *it - 'A' + 'a';
+    }
+    return extension;
+  }
+
+  bool isAudioFile(const std::string &path)
+  {
+    static const StringList extensions = FileRef::defaultFileExtensions();
+    const std::string extension = lowerExtension(path);
+    return !extension.empty() && extensions.contains(extension);
+  }
+
+  void collect(const std::string &path, bool allFiles, std::vector<std::string> &files);
+
+#ifdef _WIN32
+
+  void collectDirectory(const std::string &path, bool allFiles, std::vector<std::string> &files)
+  {
+    WIN32_FIND_DATAA data;
+    const HANDLE handle = FindFirstFileA((path + "\\*").c_str(), &data);
+    if(handle == INVALID_HANDLE_VALUE)
+      return;
+
+    do {
+      const std::string name = data.cFileName;
+      if(name == "." || name == "..")
+        continue;
+      if(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+        continue;
+
+      collect(path + "\\" + name, allFiles, files);
+    } while(FindNextFileA(handle, &data));
+
+    FindClose(handle);
+  }
+
+  void collect(const std::string &path, bool allFiles, std::vector<std::string> &files)
+  {
+    const DWORD attributes = GetFileAttributesA(path.c_str());
+    if(attributes == INVALID_FILE_ATTRIBUTES)
+      return;
+
+    if(attributes & FILE_ATTRIBUTE_DIRECTORY)
+      collectDirectory(path, allFiles, files);
+    else if(allFiles || isAudioFile(path))
+      files.push_back(path);
+  }
+
+#else
+
+  void collectDirectory(const std::string &path, bool allFiles, std::vector<std::string> &files)
+  {
+    DIR *dir = opendir(path.c_str());
+    if(!dir)
+      return;
+
+    // Sort the entries so that the order of the output does not depend on
+    // the file system.
+
+    std::vector<std::string> names;
+    while(const dirent *entry = readdir(dir)) {
+      const std::string name = entry->d_name;
+      if(name != "." && name != "..")
+        names.push_back(name);
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+
+    for(std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+      const std::string child = (path.empty() || path[path.size() - 1] != '/') ? path + "/" + *it : path + *it;
+
+      // Symbolic links to directories are not followed to avoid cycles.
+
+      struct stat st;
+      if(lstat(child.c_str(), &st) != 0)
+        continue;
+      if(S_ISLNK(st.st_mode) && stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+        continue;
+
+      collect(child, allFiles, files);
+    }
+  }
+
+  void collect(const std::string &path, bool allFiles, std::vector<std::string> &files)
+  {
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0)
+      return;
+
+    if(S_ISDIR(st.st_mode))
+      collectDirectory(path, allFiles, files);
+    else if(S_ISREG(st.st_mode) && (allFiles || isAudioFile(path)))
+      files.push_back(path);
+  }
+
+#endif
+}
+
+long long Tools::nanoseconds()
+{
+  return static_cast<long long>(TagLib::Utils::monotonicNanoseconds());
+}
+
+unsigned int Tools::processorCount()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#else
+  const long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? static_cast<unsigned int>(count) : 1;
+#endif
+}
+
+bool Tools::collectFiles(const std::string &path, bool allFiles, std::vector<std::string> &files)
+{
+  // Files named explicitly are collected regardless of their extension.
+
+#ifdef _WIN32
+  const DWORD attributes = GetFileAttributesA(path.c_str());
+  if(attributes == INVALID_FILE_ATTRIBUTES)
+    return false;
+
+  if(attributes & FILE_ATTRIBUTE_DIRECTORY)
+    collectDirectory(path, allFiles, files);
+  else
+    files.push_back(path);
+#else
+  struct stat st;
+  if(stat(path.c_str(), &st) != 0)
+    return false;
+
+  if(S_ISDIR(st.st_mode))
+    collectDirectory(path, allFiles, files);
+  else
+    files.push_back(path);
+#endif
+
+  return true;
+}
+
+long long Tools::fileSize(const std::string &path)
+{
+#ifdef _WIN32
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if(!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data) ||
+     (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    return -1;
+  return (static_cast<long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+#else
+  struct stat st;
+  if(stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    return -1;
+  return st.st_size;
+#endif
+}
+
+bool Tools::adviseWillNeed(const std::string &path, long long offset, long long length)
+{
+#if defined(_WIN32) || !defined(POSIX_FADV_WILLNEED)
+  (void)path;
+  (void)offset;
+  (void)length;
+  return false;
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  const bool advised = (posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED) == 0);
+  close(fd);
+  return advised;
+#endif
+}
+
+bool Tools::evictFromCache(const std::string &path)
+{
+#if defined(_WIN32) || !defined(POSIX_FADV_DONTNEED)
+  (void)path;
+  return false;
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+
+  const bool evicted = (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+  close(fd);
+  return evicted;
+#endif
+}
+
+bool Tools::parseReadStyle(const std::string &name, AudioProperties::ReadStyle &style)
+{
+  if(name == "fast")
+    style = AudioProperties::Fast;
+  else if(name == "average")
+    style = AudioProperties::Average;
+  else if(name == "accurate")
+    style = AudioProperties::Accurate;
+  else
+    return false;
+
+  return true;
+}
+
+const char *Tools::formatName(const File *file)
+{
+  const char *name = Utils::formatName(file);
+  return name ? name : "unknown";
+}
+
+std::string Tools::jsonString(const std::string &s)
+{
+  std::string result;
+  result.reserve(s.size() + 2);
+  result += '"';
+
+  for(std::string::const_iterator it = s.begin(); it != s.end(); ++it) {
+    const unsigned char c = static_cast<unsigned char>(*it);
+    switch(c) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\r':
+      result += "\\r";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    default:
+      if(c < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        result += escaped;
+      }
+      else {
+        result += static_cast<char>(c);
+      }
+      break;
+    }
+  }
+
+  result += '"';
+  return result;
+}
+
+std::string Tools::jsonString(const String &s)
+{
+  return jsonString(s.to8Bit(true));
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_TOOLS_COMMON_H
+#define TAGLIB_TOOLS_COMMON_H
+
+#include <string>
+#include <vector>
+
+#include <tstring.h>
+#include <audioproperties.h>
+
+namespace TagLib
+{
+  class File;
+}
+
+namespace Tools
+{
+  /*!
+   * Returns a monotonic time stamp in nanoseconds.
+   */
+  long long nanoseconds();
+
+  /*!
+   * Returns the number of processors available, or 1 if it is unknown.
+   */
+  unsigned int processorCount();
+
+  /*!
+   * Appends \a path to \a files if it is a file, or all the files below it if
+   * it is a directory.  Unless \a allFiles is true, only the files with one of
+   * FileRef::defaultFileExtensions() are collected.  Returns false if \a path
+   * does not exist.
+   */
+  bool collectFiles(const std::string &path, bool allFiles, std::vector<std::string> &files);
+
+  /*!
+   * Returns the size of the file \a path, or -1 if it can not be read.
+   */
+  long long fileSize(const std::string &path);
+
+  /*!
+   * Asks the operating system to start reading the \a length bytes at
+   * \a offset of the file \a path into the page cache in the background.
+   * Returns false if this is not supported or the file can not be opened.
+   */
+  bool adviseWillNeed(const std::string &path, long long offset, long long length);
+
+  /*!
+   * Asks the operating system to drop the file \a path from the page cache,
+   * so that it is read from the device again.  Returns false if this is not
+   * supported or the file can not be opened.
+   */
+  bool evictFromCache(const std::string &path);
+
+  /*!
+   * Parses "fast", "average" or "accurate" into \a style.
+   */
+  bool parseReadStyle(const std::string &name, TagLib::AudioProperties::ReadStyle &style);
+
+  /*!
+   * Returns the name of the format of \a file, e.g. "MPEG", or "unknown".
+   */
+  const char *formatName(const TagLib::File *file);
+
+  /*!
+   * Returns \a s as a quoted and escaped JSON string.
+   */
+  std::string jsonString(const std::string &s);
+
+  /*!
+   * Returns \a s as a quoted and escaped JSON string.
+   */
+  std::string jsonString(const TagLib::String &s);
+}
+
+#endif
@@ -0,0 +1,420 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <cstdlib>
+#include <sstream>
+
+#include "mapping.h"
+
+using namespace TagLib;
+using namespace Tools;
+
+namespace
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  // CSV
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Reads a record as described in RFC 4180.  Quoted fields may contain
+  // commas, doubled quotes and line breaks.  Returns false at the end of the
+  // input.
+
+  bool readRecord(std::istream &in, std::vector<std::string> &fields)
+  {
+    fields.clear();
+
+    if(in.peek() == std::char_traits<char>::eof())
+      return false;
+
+    std::string field;
+    bool quoted = false;
+    char c;
+
+    while(in.get(c)) {
+      if(quoted) {
+        if(c == '"') {
+          if(in.peek() == '"') {
+            in.get(c);
+            field += '"';
+          }
+          else {
+            quoted = false;
+          }
+        }
+        else {
+          field += c;
+        }
+      }
+      else if(c == '"') {
+        quoted = true;
+      }
+      else if(c == ',') {
+        fields.push_back(field);
+        field.clear();
+      }
+      else if(c == '\n') {
+        break;
+      }
+      else if(c != '\r') {
+        field += c;
+      }
+    }
+
+    fields.push_back(field);
+    return true;
+  }
+
+  bool isBlank(const std::vector<std::string> &fields)
+  {
+    return fields.size() == 1 && fields[0].empty();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // JSON
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // A reader for the subset of JSON needed to read a mapping.  Values which
+  // are not needed are skipped.
+
+  class JSONReader
+  {
+  public:
+    explicit JSONReader(const std::string &text) :
+      text(text),
+      position(0) {}
+
+    bool atEnd()
+    {
+      skipSpace();
+      return position >= text.size();
+    }
+
+    bool consume(char c)
+    {
+      skipSpace();
+      if(position < text.size() && text[position] == c) {
+        ++position;
+        return true;
+      }
+      return false;
+    }
+
+    char peek()
+    {
+      skipSpace();
+      return position < text.size() ? text[position] : '\0';
+    }
+
+    bool readString(std::string &s)
+    {
+      s.clear();
+      if(!consume('"'))
+        return false;
+
+      while(position < text.size()) {
+        const char c = text[position++];
+        if(c == '"')
+          return true;
+
+        if(c != '\\') {
+          s += c;
+          continue;
+        }
+
+        if(position >= text.size())
+          return false;
+
+        const char e = text[position++];
+        switch(e) {
+        case '"':
+        case '\\':
+        case '/':
+          s += e;
+          break;
+        case 'b':
+          s += '\b';
+          break;
+        case 'f':
+          s += '\f';
+          break;
+        case 'n':
+          s += '\n';
+          break;
+        case 'r':
+          s += '\r';
+          break;
+        case 't':
+          s += '\t';
+          break;
+        case 'u': {
+          unsigned int code;
+          if(!readHex(code))
+            return false;
+          if(code >= 0xD800 && code < 0xDC00) {
+            unsigned int low;
+            if(text.compare(position, 2, "\\u") != 0)
+              return false;
+            position += 2;
+            if(!readHex(low) || low < 0xDC00 || low >= 0xE000)
+              return false;
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          appendUTF8(s, code);
+          break;
+        }
+        default:
+          return false;
+        }
+      }
+
+      return false;
+    }
+
+    // Reads a string, an array of strings or null into values.  Numbers and
+    // booleans are kept as written.
+
+    bool readValues(StringList &values)
+    {
+      values.clear();
+
+      std::string s;
+      const char c = peek();
+
+      if(c == '"') {
+        if(!readString(s))
+          return false;
+        values.append(String(s, String::UTF8));
+        return true;
+      }
+
+      if(c == '[') {
+        consume('[');
+        if(consume(']'))
+          return true;
+        do {
+          if(!readString(s))
+            return false;
+          values.append(String(s, String::UTF8));
+        } while(consume(','));
+        return consume(']');
+      }
+
+      if(readLiteral(s)) {
+        if(s != "null")
+          values.append(String(s, String::UTF8));
+        return true;
+      }
+
+      return false;
+    }
+
+    bool skipValue()
+    {
+      std::string s;
+      const char c = peek();
+
+      if(c == '"')
+        return readString(s);
+
+      if(c == '[' || c == '{') {
+        const char close = (c == '[') ? ']' : '}';
+        consume(c);
+        if(consume(close))
+          return true;
+        do {
+          if(c == '{' && (!readString(s) || !consume(':')))
+            return false;
+          if(!skipValue())
+            return false;
+        } while(consume(','));
+        return consume(close);
+      }
+
+      return readLiteral(s);
+    }
+
+  private:
+    void skipSpace()
+    {
+      while(position < text.size() &&
+            (text[position] == ' ' || text[position] == '\t' ||
+             text[position] == '\r' || text[position] == '\n'))
+        ++position;
+    }
+
+    bool readHex(unsigned int &code)
+    {
+      if(position + 4 > text.size())
+        return false;
+
+      char *end;
+      const std::string digits = text.substr(position, 4);
+      code = static_cast<unsigned int>(std::strtoul(digits.c_str(), &end, 16));
+      position += 4;
+      return *end == '\0';
+    }
+
+    // Reads a number, true, false or null.
+
+    bool readLiteral(std::string &s)
+    {
+      skipSpace();
+      const std::string::size_type start = position;
+      while(position < text.size() && std::string(",]} \t\r\n").find(text[position]) == std::string::npos)
+        ++position;
+
+      s = text.substr(start, position - start);
+      return !s.empty();
+    }
+
+    static void appendUTF8(std::string &s, unsigned int code)
+    {
+      if(code < 0x80) {
+        s += static_cast<char>(code);
+      }
+      else if(code < 0x800) {
+        s += static_cast<char>(0xC0 | (code >> 6));
+        s += static_cast<char>(0x80 | (code & 0x3F));
+      }
+      else if(code < 0x10000) {
+        s += static_cast<char>(0xE0 | (code >> 12));
+        s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (code & 0x3F));
+      }
+      else {
+        s += static_cast<char>(0xF0 | (code >> 18));
+        s += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        s += static_cast<char>(0x80 | (code & 0x3F));
+      }
+    }
+
+    const std::string &text;
+    std::string::size_type position;
+  };
+
+  bool readEdit(JSONReader &reader, Edit &edit)
+  {
+    if(!reader.consume('{'))
+      return false;
+    if(reader.consume('}'))
+      return true;
+
+    std::string name;
+    do {
+      if(!reader.readString(name) || !reader.consume(':'))
+        return false;
+
+      if(name == "path") {
+        if(!reader.readString(edit.path))
+          return false;
+      }
+      else if(name == "properties") {
+        if(!reader.consume('{'))
+          return false;
+        if(reader.consume('}'))
+          continue;
+
+        std::string key;
+        do {
+          StringList values;
+          if(!reader.readString(key) || !reader.consume(':') || !reader.readValues(values))
+            return false;
+          edit.properties.replace(String(key, String::UTF8), values);
+        } while(reader.consume(','));
+
+        if(!reader.consume('}'))
+          return false;
+      }
+      else if(!reader.skipValue()) {
+        return false;
+      }
+    } while(reader.consume(','));
+
+    return reader.consume('}');
+  }
+
+  std::string lineError(unsigned int line, const std::string &message)
+  {
+    std::ostringstream s;
+    s << "line " << line << ": " << message;
+    return s.str();
+  }
+}
+
+bool Tools::readCSV(std::istream &in, std::vector<Edit> &edits, std::string &error)
+{
+  std::vector<std::string> header;
+  if(!readRecord(in, header) || header.empty() || header[0] != "path") {
+    error = lineError(1, "the first column must be \"path\"");
+    return false;
+  }
+
+  std::vector<std::string> fields;
+  for(unsigned int line = 2; readRecord(in, fields); ++line) {
+    if(isBlank(fields))
+      continue;
+
+    if(fields.size() != header.size()) {
+      error = lineError(line, "wrong number of columns");
+      return false;
+    }
+
+    Edit edit;
+    edit.path = fields[0];
+    for(size_t i = 1; i < fields.size(); ++i) {
+      if(!fields[i].empty())
+        edit.properties.replace(String(header[i], String::UTF8), String(fields[i], String::UTF8));
+    }
+    edits.push_back(edit);
+  }
+
+  return true;
+}
+
+bool Tools::readNDJSON(std::istream &in, std::vector<Edit> &edits, std::string &error)
+{
+  std::string text;
+  for(unsigned int line = 1; std::getline(in, text); ++line) {
+    JSONReader reader(text);
+    if(reader.atEnd())
+      continue;
+
+    Edit edit;
+    if(!readEdit(reader, edit) || !reader.atEnd()) {
+      error = lineError(line, "malformed JSON");
+      return false;
+    }
+
+    if(edit.path.empty()) {
+      error = lineError(line, "missing \"path\"");
+      return false;
+    }
+
+    edits.push_back(edit);
+  }
+
+  return true;
+}
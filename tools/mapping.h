@@ -0,0 +1,73 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_TOOLS_MAPPING_H
+#define TAGLIB_TOOLS_MAPPING_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <tpropertymap.h>
+
+namespace Tools
+{
+  //! The new properties of a file.
+
+  struct Edit
+  {
+    //! The path of the file.
+    std::string path;
+
+    /*!
+     * The properties to set.  The other properties of the file are kept.  A
+     * property with an empty list of values is removed.
+     */
+    TagLib::PropertyMap properties;
+  };
+
+  /*!
+   * Reads a mapping in CSV format from \a in.  The first line names the
+   * columns: "path" followed by the property names.  Each other line gives a
+   * path and the values of the properties; empty cells are left unchanged.
+   * Returns false and sets \a error if the input is malformed.
+   */
+  bool readCSV(std::istream &in, std::vector<Edit> &edits, std::string &error);
+
+  /*!
+   * Reads a mapping in NDJSON format from \a in, one object per line:
+   *
+   * \code
+   * {"path": "a.mp3", "properties": {"TITLE": "Title", "ARTIST": ["A", "B"], "COMMENT": null}}
+   * \endcode
+   *
+   * A property can be a string, an array of strings or null to remove it.
+   * Other members are ignored, so that the records of taglib-scan can be read.
+   * Returns false and sets \a error if the input is malformed.
+   */
+  bool readNDJSON(std::istream &in, std::vector<Edit> &edits, std::string &error);
+}
+
+#endif
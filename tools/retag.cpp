@@ -0,0 +1,434 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tfile.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
+#include <toverlaystream.h>
+#include <tthreads.h>
+#include <tpropertymap.h>
+#include <fileref.h>
+
+#include "common.h"
+#include "mapping.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Options
+  {
+    Options() :
+      threads(Tools::processorCount()),
+      dryRun(false) {}
+
+    unsigned int threads;
+    bool dryRun;
+    std::string copyTo;
+  };
+
+  // How a file was, or would be, saved.
+
+  enum Strategy {
+    // The properties were already set, nothing was written.
+    Unchanged,
+    // The tags fit in the space they took before, e.g. thanks to padding.
+    InPlace,
+    // The size of the file changed, but no data had to be moved.
+    Append,
+    // Data after the tags had to be moved.
+    Rewrite,
+    StrategyCount
+  };
+
+  const char *const strategyNames[] = {
+    "unchanged", "in_place", "append", "rewrite"
+  };
+
+  struct Result
+  {
+    Result() :
+      strategy(Unchanged),
+      bytesWritten(0),
+      bytesShifted(0),
+      sizeDelta(0) {}
+
+    std::string error;
+    std::string format;
+    std::string copy;
+    Strategy strategy;
+    unsigned long long bytesWritten;
+    unsigned long long bytesShifted;
+    long sizeDelta;
+    StringList rejected;
+  };
+
+  // The state shared by the rewriting threads.
+
+  struct Retag
+  {
+    Retag(const std::vector<Tools::Edit> &edits, const Options &options, std::ostream &out) :
+      edits(edits),
+      options(options),
+      out(out),
+      next(0),
+      errors(0),
+      bytesWritten(0),
+      bytesShifted(0)
+    {
+      std::fill(strategies, strategies + StrategyCount, 0);
+    }
+
+    const std::vector<Tools::Edit> &edits;
+    const Options &options;
+    std::ostream &out;
+
+    Utils::Mutex mutex;
+    size_t next;
+    size_t errors;
+    size_t strategies[StrategyCount];
+    unsigned long long bytesWritten;
+    unsigned long long bytesShifted;
+  };
+
+  std::string baseName(const std::string &path)
+  {
+    const std::string::size_type slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? path : path.substr(slash + 1);
+  }
+
+  // Returns the path of the copy of the file at path in the --copy-to directory.
+
+  std::string copyPath(const Options &options, const std::string &path)
+  {
+    return options.copyTo + "/" + baseName(path);
+  }
+
+  // Finds two edits whose copies would be written to the same path, which
+  // happens for files with the same name in different directories.
+
+  bool findCopyCollision(const std::vector<Tools::Edit> &edits, const Options &options,
+                         std::string &first, std::string &second)
+  {
+    std::map<std::string, std::string> copies;
+
+    for(size_t i = 0; i < edits.size(); ++i) {
+      const std::string copy = copyPath(options, edits[i].path);
+      std::map<std::string, std::string>::const_iterator it = copies.find(copy);
+      if(it != copies.end()) {
+        first  = it->second;
+        second = edits[i].path;
+        return true;
+      }
+      copies[copy] = edits[i].path;
+    }
+
+    return false;
+  }
+
+  // Writes the content of overlay to a new file at path.
+
+  bool writeCopy(OverlayStream &overlay, const std::string &path)
+  {
+    std::ofstream create(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!create)
+      return false;
+    create.close();
+
+    FileStream sink(path.c_str());
+    return !sink.readOnly() && overlay.writeTo(&sink);
+  }
+
+  // Applies an edit to a file.  In a dry run, or when copying, the file is
+  // saved to an OverlayStream, which keeps the changes in memory, so that the
+  // cost of saving is measured by the format's own save() without touching
+  // the file.  A copy is then written from the OverlayStream in one pass.
+
+  Result apply(const Tools::Edit &edit, const Options &options)
+  {
+    Result result;
+
+    const bool overlaid = options.dryRun || !options.copyTo.empty();
+
+    FileStream fileStream(edit.path.c_str(), overlaid);
+    if(!fileStream.isOpen()) {
+      result.error = "could not open the file";
+      return result;
+    }
+    if(!overlaid && fileStream.readOnly()) {
+      result.error = "the file is not writable";
+      return result;
+    }
+
+    OverlayStream overlay(&fileStream);
+    InstrumentedStream stream(overlaid ? static_cast<IOStream *>(&overlay) : &fileStream);
+
+    FileRef ref(&stream, false);
+    if(ref.isNull() || !ref.file()->isValid()) {
+      result.error = "unsupported or invalid file";
+      return result;
+    }
+
+    result.format = Tools::formatName(ref.file());
+
+    const PropertyMap original = ref.file()->properties();
+    PropertyMap properties = original;
+
+    for(PropertyMap::ConstIterator it = edit.properties.begin(); it != edit.properties.end(); ++it) {
+      if(it->second.isEmpty())
+        properties.erase(it->first);
+      else
+        properties.replace(it->first, it->second);
+    }
+
+    if(properties != original) {
+      const PropertyMap rejected = ref.file()->setProperties(properties);
+      for(PropertyMap::ConstIterator it = rejected.begin(); it != rejected.end(); ++it)
+        result.rejected.append(it->first);
+
+      const long length = stream.length();
+      stream.resetStatistics();
+
+      if(!ref.save()) {
+        result.error = "could not save the file";
+        return result;
+      }
+
+      const IOStatistics::Counters c = stream.statistics().total();
+      result.bytesWritten = c.bytesWritten;
+      result.bytesShifted = c.bytesShifted;
+      result.sizeDelta    = stream.length() - length;
+
+      if(c.bytesShifted > 0)
+        result.strategy = Rewrite;
+      else if(result.sizeDelta != 0)
+        result.strategy = Append;
+      else
+        result.strategy = InPlace;
+    }
+
+    if(!options.dryRun && !options.copyTo.empty()) {
+      result.copy = copyPath(options, edit.path);
+      if(!writeCopy(overlay, result.copy))
+        result.error = "could not write " + result.copy;
+    }
+
+    return result;
+  }
+
+  std::string record(const Tools::Edit &edit, const Result &result)
+  {
+    std::ostringstream s;
+    s << "{\"path\": " << Tools::jsonString(edit.path);
+
+    if(!result.error.empty()) {
+      s << ", \"error\": " << Tools::jsonString(result.error) << "}";
+      return s.str();
+    }
+
+    s << ", \"format\": \"" << result.format << "\""
+      << ", \"strategy\": \"" << strategyNames[result.strategy] << "\""
+      << ", \"bytes_written\": " << result.bytesWritten
+      << ", \"bytes_shifted\": " << result.bytesShifted
+      << ", \"size_delta\": " << result.sizeDelta;
+
+    if(!result.copy.empty())
+      s << ", \"copy\": " << Tools::jsonString(result.copy);
+
+    if(!result.rejected.isEmpty()) {
+      s << ", \"rejected\": [";
+      for(StringList::ConstIterator it = result.rejected.begin(); it != result.rejected.end(); ++it)
+        s << (it == result.rejected.begin() ? "" : ", ") << Tools::jsonString(*it);
+      s << "]";
+    }
+
+    s << "}";
+    return s.str();
+  }
+
+  void runRetag(void *context)
+  {
+    Retag *retag = static_cast<Retag *>(context);
+
+    for(;;) {
+      size_t i;
+      {
+        Utils::MutexLocker locker(retag->mutex);
+        i = retag->next++;
+      }
+
+      if(i >= retag->edits.size())
+        break;
+
+      const Result result = apply(retag->edits[i], retag->options);
+      const std::string line = record(retag->edits[i], result);
+
+      Utils::MutexLocker locker(retag->mutex);
+
+      retag->out << line << '\n';
+
+      if(!result.error.empty()) {
+        retag->errors++;
+      }
+      else {
+        retag->strategies[result.strategy]++;
+        retag->bytesWritten += result.bytesWritten;
+        retag->bytesShifted += result.bytesShifted;
+      }
+    }
+  }
+
+  void writeSummary(std::ostream &out, const Retag &retag, long long elapsed)
+  {
+    out.setf(std::ios::fixed);
+    out.precision(2);
+
+    out << "files:         " << retag.edits.size() << " (" << retag.errors << " errors)"
+        << (retag.options.dryRun ? ", dry run" : "") << "\n";
+    for(int i = 0; i < StrategyCount; ++i)
+      out << "  " << strategyNames[i] << ":" << std::string(12 - std::string(strategyNames[i]).size(), ' ')
+          << retag.strategies[i] << "\n";
+    out << "bytes written: " << retag.bytesWritten << "\n"
+        << "bytes shifted: " << retag.bytesShifted << "\n"
+        << "wall time:     " << elapsed / 1.0e9 << " s\n";
+  }
+
+  bool endsWith(const std::string &s, const std::string &suffix)
+  {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  void usage()
+  {
+    std::cerr << "Usage: taglib-retag [OPTIONS] MAPPING\n"
+              << "\n"
+              << "Sets the properties of many files, in parallel, as given by MAPPING, and\n"
+              << "writes one JSON record per file with the cost of saving it, followed by a\n"
+              << "summary on standard error.\n"
+              << "\n"
+              << "MAPPING is a CSV file with a \"path\" column and a column per property, or\n"
+              << "an NDJSON file with {\"path\": ..., \"properties\": {...}} records, such as\n"
+              << "the output of taglib-scan.  \"-\" reads the mapping from standard input.\n"
+              << "\n"
+              << "  --dry-run          only report what saving the files would cost\n"
+              << "  --copy-to DIR      leave the files untouched and write retagged copies to DIR;\n"
+              << "                     the file names must be unique\n"
+              << "  --format FORMAT    csv or ndjson (default: csv if MAPPING ends with .csv)\n"
+              << "  --threads N        number of threads (default: number of processors)\n"
+              << "  --output FILE      write the records to FILE instead of stdout\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  std::string mapping;
+  std::string format;
+  std::string output;
+
+  for(int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if(arg == "--dry-run")
+      options.dryRun = true;
+    else if(arg == "--copy-to" && i + 1 < argc)
+      options.copyTo = argv[++i];
+    else if(arg == "--format" && i + 1 < argc)
+      format = argv[++i];
+    else if(arg == "--threads" && i + 1 < argc)
+      options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+    else if(arg == "--output" && i + 1 < argc)
+      output = argv[++i];
+    else if(mapping.empty() && (arg == "-" || (!arg.empty() && arg[0] != '-')))
+      mapping = arg;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if(format.empty())
+    format = endsWith(mapping, ".csv") ? "csv" : "ndjson";
+
+  if(mapping.empty() || options.threads == 0 || (format != "csv" && format != "ndjson")) {
+    usage();
+    return 1;
+  }
+
+  std::ifstream mappingFile;
+  if(mapping != "-") {
+    mappingFile.open(mapping.c_str(), std::ios::in | std::ios::binary);
+    if(!mappingFile) {
+      std::cerr << "taglib-retag: could not open " << mapping << std::endl;
+      return 1;
+    }
+  }
+
+  std::istream &in = (mapping == "-") ? std::cin : mappingFile;
+
+  std::vector<Tools::Edit> edits;
+  std::string error;
+  const bool read = (format == "csv") ? Tools::readCSV(in, edits, error) : Tools::readNDJSON(in, edits, error);
+  if(!read) {
+    std::cerr << "taglib-retag: " << mapping << ": " << error << std::endl;
+    return 1;
+  }
+
+  std::string first;
+  std::string second;
+  if(!options.copyTo.empty() && findCopyCollision(edits, options, first, second)) {
+    std::cerr << "taglib-retag: " << first << " and " << second
+              << " would both be copied to " << copyPath(options, first) << std::endl;
+    return 1;
+  }
+
+  std::ofstream file;
+  if(!output.empty()) {
+    file.open(output.c_str());
+    if(!file) {
+      std::cerr << "taglib-retag: could not open " << output << std::endl;
+      return 1;
+    }
+  }
+
+  Retag retag(edits, options, output.empty() ? std::cout : file);
+
+  const long long start = Tools::nanoseconds();
+  Utils::runParallel(std::min<size_t>(options.threads, std::max<size_t>(edits.size(), 1)), runRetag, &retag);
+  const long long elapsed = Tools::nanoseconds() - start;
+
+  retag.out.flush();
+  writeSummary(std::cerr, retag, elapsed);
+
+  return retag.errors == 0 ? 0 : 2;
+}
@@ -0,0 +1,614 @@
+/***************************************************************************
+    copyright            : (C) 2026 by TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tfile.h>
+#include <tfilestream.h>
+#include <tinstrumentedstream.h>
+#include <trangefetchstream.h>
+#include <tbudgetstream.h>
+#include <tthreads.h>
+#include <tpropertymap.h>
+#include <fileref.h>
+#include <audioproperties.h>
+#include <formatutils.h>
+
+#include "common.h"
+
+using namespace TagLib;
+
+namespace
+{
+  ////////////////////////////////////////////////////////////////////////////////
+  // scanner
+  ////////////////////////////////////////////////////////////////////////////////
+
+  struct Options
+  {
+    Options() :
+      threads(Tools::processorCount()),
+      readAudioProperties(true),
+      readStyle(AudioProperties::Average),
+      allFiles(false),
+      records(true),
+      prefetch(0),
+      cold(false),
+      timeout(0),
+      maxRead(0) {}
+
+    unsigned int threads;
+    bool readAudioProperties;
+    AudioProperties::ReadStyle readStyle;
+    bool allFiles;
+    bool records;
+    unsigned int prefetch;
+    bool cold;
+    unsigned long long timeout;
+    unsigned long long maxRead;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // prefetching
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // The head and the tail of a file, which RangeFetchStream fetches on its
+  // first read.  If they are close, the whole file is read instead.
+
+  const long long HeadSize      = 64 * 1024;
+  const long long TailSize      = 128 * 1024;
+  const long long MergeDistance = 16 * 1024;
+
+  struct Block
+  {
+    long long offset;
+    ByteVector data;
+  };
+
+  struct Prefetched
+  {
+    long long length;
+    std::vector<Block> blocks;
+  };
+
+  std::vector<Block> prefetchRanges(long long length)
+  {
+    std::vector<Block> blocks(1);
+    blocks[0].offset = 0;
+
+    const long long tailStart = std::max<long long>(length - TailSize, 0);
+    if(tailStart - HeadSize > MergeDistance) {
+      blocks.resize(2);
+      blocks[1].offset = tailStart;
+    }
+
+    return blocks;
+  }
+
+  long long blockLength(const std::vector<Block> &blocks, size_t i, long long length)
+  {
+    return (blocks.size() == 1) ? length : (i == 0 ? HeadSize : length - blocks[i].offset);
+  }
+
+  // Reads the blocks of a file.  Returns false if it can not be read.
+
+  bool readPrefetched(const std::string &path, Prefetched &prefetched)
+  {
+    FileStream stream(path.c_str(), true);
+    if(!stream.isOpen())
+      return false;
+
+    prefetched.length = stream.length();
+    prefetched.blocks = prefetchRanges(prefetched.length);
+    for(size_t i = 0; i < prefetched.blocks.size(); ++i) {
+      stream.seek(static_cast<long>(prefetched.blocks[i].offset));
+      prefetched.blocks[i].data = stream.readBlock(
+        static_cast<unsigned long>(blockLength(prefetched.blocks, i, prefetched.length)));
+    }
+
+    return true;
+  }
+
+  // Serves the reads of a RangeFetchStream from the prefetched blocks, and
+  // the others from the file.
+
+  class PrefetchedFetcher : public RangeFetchStream::Fetcher
+  {
+  public:
+    PrefetchedFetcher(const std::string &path, const Prefetched &prefetched) :
+      m_path(path),
+      m_prefetched(prefetched),
+      m_stream(0),
+      m_misses(0) {}
+
+    ~PrefetchedFetcher()
+    {
+      delete m_stream;
+    }
+
+    ByteVector fetch(long offset, unsigned long length)
+    {
+      for(std::vector<Block>::const_iterator it = m_prefetched.blocks.begin();
+          it != m_prefetched.blocks.end(); ++it) {
+        if(offset >= it->offset && offset + static_cast<long long>(length) <= it->offset + it->data.size())
+          return it->data.mid(static_cast<unsigned int>(offset - it->offset), length);
+      }
+
+      m_misses++;
+
+      if(!m_stream)
+        m_stream = new FileStream(m_path.c_str(), true);
+      if(!m_stream->isOpen())
+        return ByteVector();
+
+      m_stream->seek(offset);
+      return m_stream->readBlock(length);
+    }
+
+    // The number of fetches which were not served by the prefetched blocks.
+
+    unsigned int misses() const
+    {
+      return m_misses;
+    }
+
+  private:
+    const std::string m_path;
+    const Prefetched &m_prefetched;
+    FileStream *m_stream;
+    unsigned int m_misses;
+  };
+
+  // The state shared by the scanning threads.
+
+  struct Scan
+  {
+    Scan(const std::vector<std::string> &files, const Options &options, std::ostream &out) :
+      files(files),
+      options(options),
+      out(out),
+      next(0),
+      errors(0),
+      bytes(0),
+      prefetchedFiles(0),
+      prefetchMisses(0) {}
+
+    const std::vector<std::string> &files;
+    const Options &options;
+    std::ostream &out;
+
+    Utils::Mutex mutex;
+    size_t next;
+    size_t errors;
+    unsigned long long bytes;
+    std::vector<long long> latencies;
+    IOStatistics statistics;
+
+    // The files read ahead of the workers, by index.  The prefetching thread
+    // waits on the condition while it is options.prefetch files ahead.
+
+    Utils::Condition condition;
+    std::map<size_t, Prefetched> prefetched;
+    size_t prefetchedFiles;
+    unsigned long long prefetchMisses;
+  };
+
+  // Keeps reading the head and the tail of the next files, up to
+  // options.prefetch files ahead of the workers.  Before reading a file the
+  // device is asked to read the whole window in the background, so that it
+  // is given many requests at a time instead of one per file.
+
+  void runPrefetch(void *context)
+  {
+    Scan *scan = static_cast<Scan *>(context);
+    const size_t depth = scan->options.prefetch;
+
+    size_t advised = 0;
+    for(size_t i = 0; i < scan->files.size(); ++i) {
+      {
+        Utils::MutexLocker locker(scan->mutex);
+        while(i >= scan->next + depth)
+          scan->condition.wait(scan->mutex);
+
+        // The workers have overtaken the prefetching.
+
+        if(i < scan->next)
+          continue;
+      }
+
+      for(advised = std::max(advised, i); advised < std::min(i + depth, scan->files.size()); ++advised) {
+        const std::string &path = scan->files[advised];
+        const long long size = Tools::fileSize(path);
+        const std::vector<Block> blocks = prefetchRanges(size);
+        for(size_t j = 0; size > 0 && j < blocks.size(); ++j)
+          Tools::adviseWillNeed(path, blocks[j].offset, blockLength(blocks, j, size));
+      }
+
+      Prefetched prefetched;
+      if(!readPrefetched(scan->files[i], prefetched))
+        continue;
+
+      Utils::MutexLocker locker(scan->mutex);
+      if(i >= scan->next) {
+        scan->prefetched[i] = prefetched;
+        scan->prefetchedFiles++;
+      }
+    }
+  }
+
+  void writeProperties(std::ostream &s, const PropertyMap &properties)
+  {
+    s << "\"properties\": {";
+    for(PropertyMap::ConstIterator it = properties.begin(); it != properties.end(); ++it) {
+      s << (it == properties.begin() ? "" : ", ") << Tools::jsonString(it->first) << ": [";
+      for(StringList::ConstIterator value = it->second.begin(); value != it->second.end(); ++value)
+        s << (value == it->second.begin() ? "" : ", ") << Tools::jsonString(*value);
+      s << "]";
+    }
+    s << "}";
+
+    if(!properties.unsupportedData().isEmpty()) {
+      const StringList &unsupported = properties.unsupportedData();
+      s << ", \"unsupported\": [";
+      for(StringList::ConstIterator it = unsupported.begin(); it != unsupported.end(); ++it)
+        s << (it == unsupported.begin() ? "" : ", ") << Tools::jsonString(*it);
+      s << "]";
+    }
+  }
+
+  void writeAudioProperties(std::ostream &s, const AudioProperties *properties)
+  {
+    s << "\"audio\": ";
+    if(!properties) {
+      s << "null";
+      return;
+    }
+
+    s << "{\"length_ms\": " << properties->lengthInMilliseconds()
+      << ", \"bitrate\": " << properties->bitrate()
+      << ", \"sample_rate\": " << properties->sampleRate()
+      << ", \"channels\": " << properties->channels() << "}";
+  }
+
+  void writeIO(std::ostream &s, const IOStatistics::Counters &c)
+  {
+    s << "\"io\": {\"reads\": " << c.readCalls
+      << ", \"bytes_read\": " << c.bytesRead
+      << ", \"seeks\": " << c.seekCalls << "}";
+  }
+
+  const char *budgetReason(Budget::Reason reason)
+  {
+    switch(reason) {
+    case Budget::BytesRead:
+      return "bytes_read";
+    case Budget::Seeks:
+      return "seeks";
+    case Budget::Objects:
+      return "objects";
+    case Budget::Time:
+      return "time";
+    case Budget::Cancelled:
+      return "cancelled";
+    default:
+      return "none";
+    }
+  }
+
+  // Reads a single file from input, which was opened at the time start, and
+  // returns its NDJSON record.  The time spent is stored in latency, which is
+  // -1 if the file could not be read.
+
+  std::string scanFile(const std::string &path, const Options &options, IOStream *input,
+                       long long start, long long &latency, IOStatistics &statistics)
+  {
+    std::ostringstream s;
+    s << "{\"path\": " << Tools::jsonString(path);
+
+    const long long size = Tools::fileSize(path);
+    if(size >= 0)
+      s << ", \"size\": " << size;
+
+    latency = -1;
+
+    if(!input->isOpen()) {
+      s << ", \"error\": \"could not open the file\"}";
+      return s.str();
+    }
+
+    Budget budget;
+    budget.setMaxMilliseconds(options.timeout);
+    budget.setMaxBytesRead(options.maxRead);
+
+    BudgetStream budgetStream(input, &budget);
+    InstrumentedStream stream(&budgetStream);
+    const FileRef ref(&stream, options.readAudioProperties, options.readStyle);
+
+    if(budget.reason() != Budget::NotExhausted)
+      s << ", \"budget\": \"" << budgetReason(budget.reason()) << "\"";
+
+    if(ref.isNull() || !ref.file()->isValid()) {
+      s << ", \"error\": \"unsupported or invalid file\"}";
+      return s.str();
+    }
+
+    const PropertyMap properties = ref.file()->properties();
+    const Utils::EmbeddedPictureList pictures = Utils::embeddedPictures(ref.file());
+
+    latency = Tools::nanoseconds() - start;
+    statistics = stream.statistics();
+
+    s << ", \"format\": \"" << Tools::formatName(ref.file()) << "\""
+      << ", \"us\": " << latency / 1000 << ", ";
+    writeProperties(s, properties);
+    s << ", ";
+    writeAudioProperties(s, options.readAudioProperties ? ref.audioProperties() : 0);
+    s << ", \"pictures\": [";
+    for(size_t i = 0; i < pictures.size(); ++i)
+      s << (i == 0 ? "" : ", ") << pictures[i].data.size();
+    s << "], ";
+    writeIO(s, statistics.total());
+    s << "}";
+
+    return s.str();
+  }
+
+  void runScan(void *context)
+  {
+    Scan *scan = static_cast<Scan *>(context);
+
+    for(;;) {
+      size_t i;
+      Prefetched prefetched;
+      bool isPrefetched = false;
+      {
+        Utils::MutexLocker locker(scan->mutex);
+        i = scan->next++;
+
+        // Take the prefetched blocks of the file, if any, and let the
+        // prefetching thread move on.
+
+        const std::map<size_t, Prefetched>::iterator it = scan->prefetched.find(i);
+        if(it != scan->prefetched.end()) {
+          prefetched = it->second;
+          isPrefetched = true;
+          scan->prefetched.erase(it);
+        }
+        scan->condition.wakeAll();
+      }
+
+      if(i >= scan->files.size())
+        break;
+
+      const std::string &path = scan->files[i];
+      const long long start = Tools::nanoseconds();
+
+      long long latency;
+      IOStatistics statistics;
+      std::string record;
+      unsigned int misses = 0;
+
+      if(isPrefetched) {
+        PrefetchedFetcher fetcher(path, prefetched);
+        RangeFetchStream stream(&fetcher, static_cast<long>(prefetched.length), path.c_str());
+        record = scanFile(path, scan->options, &stream, start, latency, statistics);
+        misses = fetcher.misses();
+      }
+      else {
+        FileStream stream(path.c_str(), true);
+        record = scanFile(path, scan->options, &stream, start, latency, statistics);
+      }
+
+      Utils::MutexLocker locker(scan->mutex);
+
+      scan->prefetchMisses += misses;
+
+      if(scan->options.records)
+        scan->out << record << '\n';
+
+      if(latency < 0) {
+        scan->errors++;
+      }
+      else {
+        scan->latencies.push_back(latency);
+        scan->bytes += statistics.total().bytesRead;
+        for(int phase = 0; phase < IOStatistics::PhaseCount; ++phase) {
+          const IOStatistics::Phase p = static_cast<IOStatistics::Phase>(phase);
+          scan->statistics.counters(p) += statistics.counters(p);
+        }
+      }
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  // output
+  ////////////////////////////////////////////////////////////////////////////////
+
+  double percentile(const std::vector<long long> &sorted, double p)
+  {
+    if(sorted.empty())
+      return 0.0;
+
+    const size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[i] / 1.0e6;
+  }
+
+  void writeSummary(std::ostream &out, const Scan &scan, long long elapsed)
+  {
+    std::vector<long long> latencies = scan.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    const double seconds = elapsed / 1.0e9;
+
+    out.setf(std::ios::fixed);
+    out.precision(2);
+
+    out << "files:       " << scan.files.size() << " (" << scan.errors << " errors)\n"
+        << "threads:     " << scan.options.threads << "\n"
+        << "wall time:   " << seconds << " s" << (scan.options.cold ? " (cold cache)" : "") << "\n"
+        << "throughput:  " << (seconds > 0 ? scan.files.size() / seconds : 0.0) << " files/s, "
+        << (seconds > 0 ? scan.bytes / seconds / (1024 * 1024) : 0.0) << " MiB/s read\n"
+        << "latency:     p50 " << percentile(latencies, 0.50) << " ms, p99 "
+        << percentile(latencies, 0.99) << " ms, max "
+        << (latencies.empty() ? 0.0 : latencies.back() / 1.0e6) << " ms\n";
+
+    if(scan.options.prefetch > 0) {
+      out << "prefetch:    " << scan.prefetchedFiles << " of " << scan.files.size()
+          << " files read ahead, " << scan.prefetchMisses << " reads outside the blocks read ahead\n";
+    }
+
+    static const char *const phases[] = {
+      "detection", "tags", "properties", "saving", "other"
+    };
+
+    out << "I/O:         phase         reads        bytes        seeks\n";
+    for(int phase = 0; phase < IOStatistics::PhaseCount; ++phase) {
+      const IOStatistics::Counters &c = scan.statistics.counters(static_cast<IOStatistics::Phase>(phase));
+      char line[128];
+      std::snprintf(line, sizeof(line), "             %-10s %8llu %12llu %12llu\n",
+                    phases[phase], c.readCalls, c.bytesRead, c.seekCalls);
+      out << line;
+    }
+  }
+
+  void usage()
+  {
+    std::cerr << "Usage: taglib-scan [OPTIONS] PATH...\n"
+              << "\n"
+              << "Reads the files and directories given, in parallel, and writes one JSON\n"
+              << "record per file followed by a summary on standard error.\n"
+              << "\n"
+              << "  --threads N              number of threads (default: number of processors)\n"
+              << "  --read-style STYLE       fast, average or accurate (default: average)\n"
+              << "  --no-audio-properties    do not read the audio properties\n"
+              << "  --all-files              try every file, not just the known extensions\n"
+              << "  --prefetch N             read the head and the tail of up to N files ahead\n"
+              << "                           of the threads on a background thread (default: 0)\n"
+              << "  --cold                   drop the files from the page cache first\n"
+              << "  --timeout MS             stop parsing a file after MS milliseconds\n"
+              << "  --max-read BYTES         stop parsing a file after reading BYTES bytes\n"
+              << "  --output FILE            write the records to FILE instead of stdout\n"
+              << "  --summary-only           only print the summary\n";
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  std::vector<std::string> paths;
+  std::string output;
+
+  for(int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if(arg == "--threads" && i + 1 < argc)
+      options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+    else if(arg == "--read-style" && i + 1 < argc) {
+      if(!Tools::parseReadStyle(argv[++i], options.readStyle)) {
+        usage();
+        return 1;
+      }
+    }
+    else if(arg == "--no-audio-properties")
+      options.readAudioProperties = false;
+    else if(arg == "--all-files")
+      options.allFiles = true;
+    else if(arg == "--prefetch" && i + 1 < argc)
+      options.prefetch = static_cast<unsigned int>(std::atoi(argv[++i]));
+    else if(arg == "--cold")
+      options.cold = true;
+    else if(arg == "--timeout" && i + 1 < argc)
+      options.timeout = static_cast<unsigned long long>(std::atol(argv[++i]));
+    else if(arg == "--max-read" && i + 1 < argc)
+      options.maxRead = static_cast<unsigned long long>(std::atol(argv[++i]));
+    else if(arg == "--output" && i + 1 < argc)
+      output = argv[++i];
+    else if(arg == "--summary-only")
+      options.records = false;
+    else if(!arg.empty() && arg[0] != '-')
+      paths.push_back(arg);
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if(paths.empty() || options.threads == 0) {
+    usage();
+    return 1;
+  }
+
+  std::vector<std::string> files;
+  for(std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+    if(!Tools::collectFiles(*it, options.allFiles, files))
+      std::cerr << "taglib-scan: " << *it << ": no such file or directory" << std::endl;
+  }
+
+  std::ofstream file;
+  if(!output.empty()) {
+    file.open(output.c_str());
+    if(!file) {
+      std::cerr << "taglib-scan: could not open " << output << std::endl;
+      return 1;
+    }
+  }
+
+  if(options.cold) {
+    for(std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it) {
+      if(!Tools::evictFromCache(*it)) {
+        std::cerr << "taglib-scan: could not drop " << *it << " from the page cache" << std::endl;
+        break;
+      }
+    }
+  }
+
+  Scan scan(files, options, output.empty() ? std::cout : file);
+
+  const long long start = Tools::nanoseconds();
+  {
+    Utils::Thread *prefetch = 0;
+    if(options.prefetch > 0)
+      prefetch = new Utils::Thread(runPrefetch, &scan);
+
+    Utils::runParallel(std::min<size_t>(options.threads, std::max<size_t>(files.size(), 1)), runScan, &scan);
+
+    // The prefetching thread returns once the workers have taken all the files.
+
+    delete prefetch;
+  }
+  const long long elapsed = Tools::nanoseconds() - start;
+
+  scan.out.flush();
+  writeSummary(std::cerr, scan, elapsed);
+
+  return scan.errors == 0 ? 0 : 2;
+}